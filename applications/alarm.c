@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        event-driven alarms with hysteresis and dwell
+ * 2026-10-17     khair        crossing to the other limit re-arms at once
+ */
+/*
+ * Temperature and humidity alarms, evaluated on every sample.
+ *
+ * The sampling thread hands each reading to alarm_feed(), which runs the
+ * channel's state machine and returns at once:
+ *
+ *   NORMAL --out of range--> PENDING --ALARM_DWELL_S--> ACTIVE (raise)
+ *     ^  ^                        |                        |   ^
+ *     |  +--back in range first---+    in range by the     |   | out
+ *     |        (filtered)              hysteresis          v   | again
+ *     +------------------ALARM_DWELL_S------------------ CLEARING (clear)
+ *
+ * A value beyond the opposite limit takes ACTIVE or CLEARING straight to
+ * PENDING for that side.
+ *
+ * Raising, reminding and clearing post a notice to a mailbox. A notifier
+ * thread blocks on it and sends the text, so the seconds an SMS takes
+ * never hold up sampling, and a notice goes out as soon as the sample
+ * that completes the dwell arrives.
+ *
+ * An active alarm that is not acknowledged is raised again every
+ * ALARM_ESCALATE_S, one level higher each time, up to ALARM_LEVEL_MAX.
+ * Acknowledging stops the reminders; the alarm still clears and re-arms by
+ * itself once the value has been back in range for the dwell time.
+ */
+#include <stdlib.h>
+#include <rtthread.h>
+
+#include "alarm.h"
+
+#define DBG_TAG "alarm"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#define ALARM_DWELL_TICKS       (ALARM_DWELL_S * RT_TICK_PER_SECOND)
+#define ALARM_ESCALATE_TICKS    (ALARM_ESCALATE_S * RT_TICK_PER_SECOND)
+#define ALARM_TEXT_MAX          64
+
+/* a notice in one mailbox word: value:16, level:8, kind:4, channel:4 */
+enum alarm_notice_kind
+{
+    ALARM_NOTICE_HIGH = 0,
+    ALARM_NOTICE_LOW,
+    ALARM_NOTICE_CLEAR,
+};
+
+#define ALARM_NOTICE(ch, kind, level, value) \
+    ((rt_ubase_t)(rt_uint16_t)(value) | (rt_ubase_t)(level) << 16 | (rt_ubase_t)(kind) << 24 | (rt_ubase_t)(ch) << 28)
+#define ALARM_NOTICE_VALUE(n)   ((rt_int16_t)((n) & 0xffff))
+#define ALARM_NOTICE_LEVEL(n)   (((n) >> 16) & 0xff)
+#define ALARM_NOTICE_KIND(n)    (((n) >> 24) & 0xf)
+#define ALARM_NOTICE_CHANNEL(n) (((n) >> 28) & 0xf)
+
+struct alarm_channel
+{
+    const char *name;
+    const char *unit;
+    struct alarm_status status;
+    rt_tick_t since;                /* entered PENDING or CLEARING */
+    rt_tick_t notified;             /* last raise, for reminders */
+};
+
+static struct alarm_channel alarm_channels[ALARM_CHANNEL_MAX] =
+{
+    [ALARM_TEMP] = {"Temperature", " C", {.limits = {ALARM_TEMP_LOW, ALARM_TEMP_HIGH, ALARM_TEMP_HYSTERESIS}}},
+    [ALARM_HUMID] = {"Humidity", " %", {.limits = {ALARM_HUMID_LOW, ALARM_HUMID_HIGH, ALARM_HUMID_HYSTERESIS}}},
+};
+
+static struct rt_mutex alarm_lock;
+static struct rt_mailbox alarm_mb;
+static rt_ubase_t alarm_mb_pool[ALARM_QUEUE_LEN];
+static alarm_notify_t alarm_notify;
+static rt_uint32_t alarm_dropped;
+
+static void alarm_post(enum alarm_channel_id ch, enum alarm_notice_kind kind, rt_uint8_t level, rt_int32_t value)
+{
+    if (value > 32767)
+        value = 32767;
+    else if (value < -32768)
+        value = -32768;
+
+    /* never waits: the sampling thread is the caller */
+    if (rt_mb_send(&alarm_mb, ALARM_NOTICE(ch, kind, level, value)) != RT_EOK)
+        alarm_dropped++;
+}
+
+/* which limit the value is beyond: -1 low, +1 high, 0 in range */
+static int alarm_side(const struct alarm_limits *limits, rt_int32_t value)
+{
+    if (value > limits->high)
+        return 1;
+    if (value < limits->low)
+        return -1;
+    return 0;
+}
+
+/* back inside the limit that was crossed by at least the hysteresis */
+static rt_bool_t alarm_inside(const struct alarm_status *status, rt_int32_t value)
+{
+    if (status->side > 0)
+        return value <= status->limits.high - status->limits.hysteresis;
+    return value >= status->limits.low + status->limits.hysteresis;
+}
+
+static void alarm_step(enum alarm_channel_id id, rt_int32_t value, rt_tick_t tick)
+{
+    struct alarm_channel *ch = &alarm_channels[id];
+    struct alarm_status *st = &ch->status;
+    int side = alarm_side(&st->limits, value);
+
+    st->value = value;
+
+    /* straight past the opposite limit: the raised alarm is over, and the
+     * new excursion starts its dwell now rather than after the clear one.
+     * No clear notice goes out, the raise for the new side follows it. */
+    if (side != 0 && side == -st->side && st->state >= ALARM_ACTIVE)
+    {
+        st->state = ALARM_NORMAL;
+        st->level = 0;
+        st->cleared++;
+    }
+
+    switch (st->state)
+    {
+    case ALARM_PENDING:
+        if (side == st->side)
+            break;
+        st->filtered++;
+        st->state = ALARM_NORMAL;
+        /* fall through, it may have crossed straight to the other limit */
+    case ALARM_NORMAL:
+        if (side == 0)
+            return;
+        st->state = ALARM_PENDING;
+        st->side = side;
+        ch->since = tick;
+        break;
+
+    case ALARM_ACTIVE:
+        if (alarm_inside(st, value))
+        {
+            st->state = ALARM_CLEARING;
+            ch->since = tick;
+            break;
+        }
+        if (!st->acked && st->level < ALARM_LEVEL_MAX && tick - ch->notified >= ALARM_ESCALATE_TICKS)
+        {
+            st->level++;
+            ch->notified = tick;
+            alarm_post(id, st->side > 0 ? ALARM_NOTICE_HIGH : ALARM_NOTICE_LOW, st->level, value);
+        }
+        return;
+
+    case ALARM_CLEARING:
+        if (!alarm_inside(st, value))
+            st->state = ALARM_ACTIVE;
+        break;
+    }
+
+    /* a zero dwell acts on the sample that started it */
+    if (tick - ch->since < ALARM_DWELL_TICKS)
+        return;
+
+    if (st->state == ALARM_PENDING)
+    {
+        st->state = ALARM_ACTIVE;
+        st->level = 1;
+        st->acked = RT_FALSE;
+        st->raised++;
+        ch->notified = tick;
+        alarm_post(id, st->side > 0 ? ALARM_NOTICE_HIGH : ALARM_NOTICE_LOW, st->level, value);
+    }
+    else if (st->state == ALARM_CLEARING)
+    {
+        st->state = ALARM_NORMAL;
+        st->side = 0;
+        st->level = 0;
+        st->cleared++;
+        alarm_post(id, ALARM_NOTICE_CLEAR, 0, value);
+    }
+}
+
+/**
+ * Run one sample, in 0.01 units, through a channel's alarm. Called from the
+ * sampling thread for every reading, in time order; never blocks on the
+ * notifier.
+ */
+void alarm_feed(enum alarm_channel_id channel, rt_int32_t value, rt_tick_t tick)
+{
+    RT_ASSERT(channel < ALARM_CHANNEL_MAX);
+
+    rt_mutex_take(&alarm_lock, RT_WAITING_FOREVER);
+    alarm_step(channel, value, tick);
+    rt_mutex_release(&alarm_lock);
+}
+
+/**
+ * Acknowledge a channel's active alarm, which stops its reminders.
+ *
+ * @return RT_EOK, or -RT_ERROR when the channel has no alarm raised.
+ */
+rt_err_t alarm_ack(enum alarm_channel_id channel)
+{
+    struct alarm_status *st;
+    rt_err_t result = -RT_ERROR;
+
+    if (channel >= ALARM_CHANNEL_MAX)
+        return -RT_EINVAL;
+
+    rt_mutex_take(&alarm_lock, RT_WAITING_FOREVER);
+    st = &alarm_channels[channel].status;
+    if (st->state == ALARM_ACTIVE || st->state == ALARM_CLEARING)
+    {
+        st->acked = RT_TRUE;
+        result = RT_EOK;
+    }
+    rt_mutex_release(&alarm_lock);
+
+    return result;
+}
+
+/**
+ * Change a channel's limits. A raised alarm keeps its state and is judged
+ * against the new limits from the next sample on.
+ */
+rt_err_t alarm_set_limits(enum alarm_channel_id channel, const struct alarm_limits *limits)
+{
+    if (channel >= ALARM_CHANNEL_MAX || limits->low > limits->high || limits->hysteresis < 0)
+        return -RT_EINVAL;
+
+    rt_mutex_take(&alarm_lock, RT_WAITING_FOREVER);
+    alarm_channels[channel].status.limits = *limits;
+    rt_mutex_release(&alarm_lock);
+
+    return RT_EOK;
+}
+
+rt_err_t alarm_get_status(enum alarm_channel_id channel, struct alarm_status *status)
+{
+    if (channel >= ALARM_CHANNEL_MAX)
+        return -RT_EINVAL;
+
+    rt_mutex_take(&alarm_lock, RT_WAITING_FOREVER);
+    *status = alarm_channels[channel].status;
+    rt_mutex_release(&alarm_lock);
+
+    return RT_EOK;
+}
+
+/* bit n set while channel n has an alarm raised */
+rt_uint32_t alarm_active_mask(void)
+{
+    rt_uint32_t mask = 0;
+    int i;
+
+    for (i = 0; i < ALARM_CHANNEL_MAX; i++)
+    {
+        if (alarm_channels[i].status.state >= ALARM_ACTIVE)
+            mask |= 1u << i;
+    }
+
+    return mask;
+}
+
+static int alarm_format_value(char *buf, rt_size_t size, const struct alarm_channel *ch, rt_int32_t value)
+{
+    rt_uint32_t mag = value < 0 ? -(rt_uint32_t)value : (rt_uint32_t)value;
+
+    return rt_snprintf(buf, size, "%s%u.%02u%s", value < 0 ? "-" : "", mag / 100, mag % 100, ch->unit);
+}
+
+static void alarm_thread_entry(void *parameter)
+{
+    static char text[ALARM_TEXT_MAX];
+    const struct alarm_channel *ch;
+    rt_ubase_t notice;
+    int len;
+
+    while (1)
+    {
+        if (rt_mb_recv(&alarm_mb, &notice, RT_WAITING_FOREVER) != RT_EOK)
+            continue;
+
+        ch = &alarm_channels[ALARM_NOTICE_CHANNEL(notice)];
+        if (ALARM_NOTICE_KIND(notice) == ALARM_NOTICE_CLEAR)
+        {
+            len = rt_snprintf(text, sizeof(text), "%s is back to normal: ", ch->name);
+        }
+        else
+        {
+            len = rt_snprintf(text, sizeof(text), "%s is %s than normal: ", ch->name,
+                              ALARM_NOTICE_KIND(notice) == ALARM_NOTICE_LOW ? "lower" : "higher");
+        }
+        len += alarm_format_value(text + len, sizeof(text) - len, ch, ALARM_NOTICE_VALUE(notice));
+        if (ALARM_NOTICE_LEVEL(notice) > 1)
+            rt_snprintf(text + len, sizeof(text) - len, " (level %d)", ALARM_NOTICE_LEVEL(notice));
+
+        LOG_W("%s", text);
+        if (alarm_notify)
+            alarm_notify(text);
+    }
+}
+
+/**
+ * Set up the alarms and start the notifier thread, which hands the text of
+ * every notice to `notify`.
+ */
+int alarm_init(alarm_notify_t notify)
+{
+    rt_thread_t tid;
+
+    alarm_notify = notify;
+    rt_mutex_init(&alarm_lock, "alarm", RT_IPC_FLAG_PRIO);
+    rt_mb_init(&alarm_mb, "alarm", alarm_mb_pool, ALARM_QUEUE_LEN, RT_IPC_FLAG_FIFO);
+
+    tid = rt_thread_create("alarm", alarm_thread_entry, RT_NULL, 768, 2, 20);
+    if (tid == RT_NULL)
+        return -RT_ENOMEM;
+
+    return rt_thread_startup(tid);
+}
+
+#ifdef RT_USING_FINSH
+static int alarm_channel_arg(const char *arg)
+{
+    if (!rt_strcmp(arg, "t") || !rt_strcmp(arg, "temp"))
+        return ALARM_TEMP;
+    if (!rt_strcmp(arg, "h") || !rt_strcmp(arg, "humid"))
+        return ALARM_HUMID;
+    return -1;
+}
+
+static void alarm_cmd(int argc, char **argv)
+{
+    static const char *const states[] = {"normal", "pending", "ACTIVE", "clearing"};
+    struct alarm_status st;
+    struct alarm_limits limits;
+    int i, ch = -1;
+
+    if (argc >= 3)
+        ch = alarm_channel_arg(argv[2]);
+
+    if (argc >= 2 && !rt_strcmp(argv[1], "ack"))
+    {
+        for (i = 0; i < ALARM_CHANNEL_MAX; i++)
+        {
+            if ((ch < 0 || ch == i) && alarm_ack(i) == RT_EOK)
+                rt_kprintf("%s acknowledged\n", alarm_channels[i].name);
+        }
+        return;
+    }
+
+    if (argc >= 5 && !rt_strcmp(argv[1], "set") && ch >= 0)
+    {
+        alarm_get_status(ch, &st);
+        limits.low = atoi(argv[3]);
+        limits.high = atoi(argv[4]);
+        limits.hysteresis = argc >= 6 ? atoi(argv[5]) : st.limits.hysteresis;
+        if (alarm_set_limits(ch, &limits) != RT_EOK)
+            rt_kprintf("bad limits\n");
+        return;
+    }
+
+    if (argc >= 2)
+    {
+        rt_kprintf("usage: alarm [ack [t|h]] [set t|h <low> <high> [hysteresis]] (0.01 units)\n");
+        return;
+    }
+
+    rt_kprintf("dwell %d s, reminders every %d s up to level %d, %d notices dropped\n",
+               ALARM_DWELL_S, ALARM_ESCALATE_S, ALARM_LEVEL_MAX, alarm_dropped);
+    for (i = 0; i < ALARM_CHANNEL_MAX; i++)
+    {
+        alarm_get_status(i, &st);
+        rt_kprintf("%-12s %-8s level %d%s, value %d, limits %d..%d hyst %d, "
+                   "raised %d, cleared %d, filtered %d\n",
+                   alarm_channels[i].name, states[st.state], st.level, st.acked ? " acked" : "",
+                   st.value, st.limits.low, st.limits.high, st.limits.hysteresis,
+                   st.raised, st.cleared, st.filtered);
+    }
+}
+MSH_CMD_EXPORT_ALIAS(alarm_cmd, alarm, show or acknowledge alarms);
+#endif /* RT_USING_FINSH */
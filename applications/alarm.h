@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        event-driven alarms with hysteresis and dwell
+ */
+#ifndef APPLICATIONS_ALARM_H_
+#define APPLICATIONS_ALARM_H_
+
+#include <rtthread.h>
+
+#ifndef ALARM_TEMP_LOW
+#define ALARM_TEMP_LOW              0       /* 0.01 degC */
+#endif
+#ifndef ALARM_TEMP_HIGH
+#define ALARM_TEMP_HIGH             400
+#endif
+#ifndef ALARM_TEMP_HYSTERESIS
+#define ALARM_TEMP_HYSTERESIS       50
+#endif
+#ifndef ALARM_HUMID_LOW
+#define ALARM_HUMID_LOW             0       /* 0.01 %RH */
+#endif
+#ifndef ALARM_HUMID_HIGH
+#define ALARM_HUMID_HIGH            5000
+#endif
+#ifndef ALARM_HUMID_HYSTERESIS
+#define ALARM_HUMID_HYSTERESIS      200
+#endif
+#ifndef ALARM_DWELL_S
+#define ALARM_DWELL_S               10      /* out of range this long to raise */
+#endif
+#ifndef ALARM_ESCALATE_S
+#define ALARM_ESCALATE_S            900     /* unacknowledged this long to remind */
+#endif
+#ifndef ALARM_LEVEL_MAX
+#define ALARM_LEVEL_MAX             3
+#endif
+
+/* notices waiting for the notifier, more are dropped and counted */
+#define ALARM_QUEUE_LEN             8
+
+enum alarm_channel_id
+{
+    ALARM_TEMP = 0,
+    ALARM_HUMID,
+
+    ALARM_CHANNEL_MAX
+};
+
+enum alarm_state
+{
+    ALARM_NORMAL = 0,               /* in range, armed */
+    ALARM_PENDING,                  /* out of range, waiting out the dwell */
+    ALARM_ACTIVE,                   /* raised */
+    ALARM_CLEARING,                 /* back in range, waiting out the dwell */
+};
+
+struct alarm_limits
+{
+    rt_int32_t low;                 /* out of range below low or above high */
+    rt_int32_t high;
+    rt_int32_t hysteresis;          /* distance back inside a limit to clear */
+};
+
+struct alarm_status
+{
+    enum alarm_state state;
+    rt_int8_t side;                 /* -1 low, +1 high, 0 none */
+    rt_uint8_t level;               /* 1 when raised, +1 per reminder */
+    rt_bool_t acked;
+    rt_int32_t value;               /* last sample */
+    struct alarm_limits limits;
+
+    rt_uint32_t raised;
+    rt_uint32_t cleared;
+    rt_uint32_t filtered;           /* excursions shorter than the dwell */
+};
+
+/* sends the text of one notice, may block */
+typedef void (*alarm_notify_t)(const char *text);
+
+int alarm_init(alarm_notify_t notify);
+void alarm_feed(enum alarm_channel_id channel, rt_int32_t value, rt_tick_t tick);
+rt_err_t alarm_ack(enum alarm_channel_id channel);
+rt_err_t alarm_set_limits(enum alarm_channel_id channel, const struct alarm_limits *limits);
+rt_err_t alarm_get_status(enum alarm_channel_id channel, struct alarm_status *status);
+rt_uint32_t alarm_active_mask(void);
+
+#endif /* APPLICATIONS_ALARM_H_ */
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        core1 worker for sampling and the display
+ * 2026-10-17     khair        trace the display flush
+ */
+/*
+ * RT-Thread runs on core0 only. Core1 runs a plain loop that owns the ADC
+ * capture and the SSD1306, so sampling and drawing keep their pace while
+ * core0 sits in modem and network waits.
+ *
+ *   core1 -> core0   decimated ADC blocks, in the sample ring
+ *   core0 -> core1   display commands (set a widget, refresh), in the UI ring
+ *
+ * Each ring has one producer and one consumer, one per core, and needs no
+ * lock: the producer only writes head, the consumer only writes tail, and
+ * a barrier orders the entry against the index. The SIO FIFO only carries
+ * doorbells saying "look at the ring". A doorbell is skipped when the FIFO
+ * is full, because the ones still queued wake the other side anyway, so
+ * neither core ever waits on the other.
+ *
+ * On core0 the doorbell raises SIO_IRQ_PROC0, which wakes the reader of
+ * the sample ring. Core1 sleeps in WFE and is woken by its DMA interrupt
+ * or by the event that core0 sends after each doorbell.
+ *
+ * Core1 runs from flash, which is unreadable while core0 erases or
+ * programs it. For that core0 raises `lockout` and waits until core1 sits
+ * in a loop in RAM with its interrupts off.
+ */
+#include <rtthread.h>
+#include <rthw.h>
+
+#include "hardware/irq.h"
+#include "hardware/structs/scb.h"
+#include "hardware/structs/sio.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "pico/multicore.h"
+
+#include "core1.h"
+#include "drv_flash.h"
+#include "trace.h"
+
+#ifdef CORE1_USING_WORKER
+
+#define DBG_TAG "core1"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#if (CORE1_SAMPLE_RING & (CORE1_SAMPLE_RING - 1)) || (CORE1_UI_RING & (CORE1_UI_RING - 1))
+#error "core1 ring sizes must be powers of two"
+#endif
+
+/* SIO FIFO doorbells */
+#define CORE1_MSG_SAMPLE        0x53414d50  /* core1 -> core0: sample ring */
+#define CORE1_MSG_UI            0x55494344  /* core0 -> core1: UI ring */
+
+/* UI ring command that is not a widget id */
+#define CORE1_UI_REFRESH        0xffffffffu
+
+struct core1_ring
+{
+    volatile rt_uint32_t head;      /* written by the producer only */
+    volatile rt_uint32_t tail;      /* written by the consumer only */
+    rt_uint32_t mask;
+    rt_uint32_t item_size;
+    rt_uint8_t *items;
+};
+
+struct core1_ui_cmd
+{
+    rt_uint32_t id;
+    rt_int32_t value;
+};
+
+struct core1_worker
+{
+    const struct core1_display_ops *display;
+    struct core1_ring samples;
+    struct core1_ring ui;
+    struct rt_semaphore sample_sem;
+    struct core1_stat stat;
+    volatile rt_uint32_t running;
+    volatile rt_uint32_t lockout;   /* core0 wants flash to itself */
+    volatile rt_uint32_t parked;    /* core1 is off flash */
+
+    struct pico_adc_block sample_buf[CORE1_SAMPLE_RING];
+    struct core1_ui_cmd ui_buf[CORE1_UI_RING];
+    rt_align(8) rt_uint32_t stack[CORE1_STACK_SIZE / sizeof(rt_uint32_t)];
+};
+
+static struct core1_worker core1;
+
+static void core1_ring_init(struct core1_ring *ring, void *items, rt_uint32_t count, rt_uint32_t item_size)
+{
+    ring->head = 0;
+    ring->tail = 0;
+    ring->mask = count - 1;
+    ring->item_size = item_size;
+    ring->items = items;
+}
+
+static rt_bool_t core1_ring_put(struct core1_ring *ring, const void *item)
+{
+    rt_uint32_t head = ring->head;
+
+    if (head - ring->tail > ring->mask)
+        return RT_FALSE;
+
+    rt_memcpy(ring->items + (head & ring->mask) * ring->item_size, item, ring->item_size);
+    __dmb();                                /* entry before index */
+    ring->head = head + 1;
+
+    return RT_TRUE;
+}
+
+static rt_bool_t core1_ring_get(struct core1_ring *ring, void *item)
+{
+    rt_uint32_t tail = ring->tail;
+
+    if (ring->head == tail)
+        return RT_FALSE;
+
+    __dmb();                                /* index before entry */
+    rt_memcpy(item, ring->items + (tail & ring->mask) * ring->item_size, ring->item_size);
+    __dmb();                                /* entry read before the slot is freed */
+    ring->tail = tail + 1;
+
+    return RT_TRUE;
+}
+
+/* never waits: a full FIFO already holds doorbells for the other side */
+static void core1_doorbell(rt_uint32_t msg)
+{
+    if (multicore_fifo_wready())
+        multicore_fifo_push_blocking(msg);  /* pushes, then sends an event */
+}
+
+/* runs from RAM and touches nothing in flash until `lockout` drops */
+static void __not_in_flash_func(core1_park)(void)
+{
+    rt_uint32_t irq = save_and_disable_interrupts();
+
+    core1.parked = 1;
+    __dmb();
+    while (core1.lockout)
+        ;
+    core1.parked = 0;
+    restore_interrupts(irq);
+}
+
+static void core1_entry(void)
+{
+    struct pico_adc_block block;
+    struct core1_ui_cmd cmd;
+    rt_bool_t refresh;
+    rt_uint32_t start, us;
+
+    pico_adc_capture_start();
+#ifdef BSP_USING_PM
+    /* the chip only gates the clocks drv_pm leaves out while both cores
+     * sleep deeply; WFE is as good a deep sleep as any for this loop */
+    scb_hw->scr |= M0PLUS_SCR_SLEEPDEEP_BITS;
+#endif
+    core1.running = 1;
+
+    while (1)
+    {
+        /* the DMA interrupt and core0's doorbells both send an event */
+        __wfe();
+
+        if (core1.lockout)
+            core1_park();
+
+        while (multicore_fifo_rvalid())
+            (void)multicore_fifo_pop_blocking();
+
+        if (pico_adc_capture_poll(&block))
+        {
+            if (core1_ring_put(&core1.samples, &block))
+            {
+                core1.stat.samples++;
+                core1_doorbell(CORE1_MSG_SAMPLE);
+            }
+            else
+            {
+                core1.stat.sample_drops++;
+            }
+        }
+
+        refresh = RT_FALSE;
+        while (core1_ring_get(&core1.ui, &cmd))
+        {
+            core1.stat.ui_cmds++;
+            if (cmd.id == CORE1_UI_REFRESH)
+                refresh = RT_TRUE;
+            else if (core1.display)
+                core1.display->set(cmd.id, cmd.value);
+        }
+
+        /* blocking I2C is fine here, core1 has nothing else to wait for */
+        if (refresh && core1.display)
+        {
+            start = time_us_32();
+            trace_begin(TRACE_DISPLAY_FLUSH, 0);
+            core1.display->refresh();
+            trace_end(TRACE_DISPLAY_FLUSH, 0);
+            us = time_us_32() - start;
+            if (us > core1.stat.max_refresh_us)
+                core1.stat.max_refresh_us = us;
+            core1.stat.refreshes++;
+        }
+    }
+}
+
+/* SIO_IRQ_PROC0: doorbells from core1 */
+static void core1_fifo_isr(void)
+{
+    rt_interrupt_enter();
+    while (multicore_fifo_rvalid())
+    {
+        if (multicore_fifo_pop_blocking() == CORE1_MSG_SAMPLE)
+            rt_sem_release(&core1.sample_sem);
+        core1.stat.doorbells++;
+    }
+    multicore_fifo_clear_irq();
+    rt_interrupt_leave();
+}
+
+/**
+ * Take the next ADC block decimated on core1, waiting up to `timeout`
+ * ticks for one. Blocks come out in order; for one reader thread.
+ */
+rt_err_t core1_adc_read(struct pico_adc_block *block, rt_int32_t timeout)
+{
+    rt_err_t err;
+
+    while (!core1_ring_get(&core1.samples, block))
+    {
+        err = rt_sem_take(&core1.sample_sem, timeout);
+        if (err != RT_EOK)
+            return err;
+    }
+
+    return RT_EOK;
+}
+
+static rt_err_t core1_ui_put(rt_uint32_t id, rt_int32_t value)
+{
+    struct core1_ui_cmd cmd = {id, value};
+
+    if (!core1_ring_put(&core1.ui, &cmd))
+    {
+        core1.stat.ui_drops++;
+        return -RT_EFULL;
+    }
+    core1_doorbell(CORE1_MSG_UI);
+
+    return RT_EOK;
+}
+
+/**
+ * Queue a widget update for core1, from one thread only. Never waits; a
+ * full ring drops the command and returns -RT_EFULL.
+ */
+rt_err_t core1_ui_set(rt_uint32_t id, rt_int32_t value)
+{
+    return core1_ui_put(id, value);
+}
+
+/**
+ * Ask core1 to redraw the changed widgets and flush them to the panel.
+ */
+rt_err_t core1_ui_refresh(void)
+{
+    return core1_ui_put(CORE1_UI_REFRESH, 0);
+}
+
+#ifdef BSP_USING_ON_CHIP_FLASH
+/* drv_flash: called on core0 before each erase or program */
+void pico_flash_lockout_begin(void)
+{
+    if (!core1.running)
+        return;
+
+    core1.lockout = 1;
+    __dmb();
+    __sev();
+    /* at most one display refresh, while the thread sleeps */
+    while (!core1.parked)
+        rt_thread_delay(1);
+    core1.stat.lockouts++;
+}
+
+void pico_flash_lockout_end(void)
+{
+    core1.lockout = 0;
+    __dmb();
+}
+#endif /* BSP_USING_ON_CHIP_FLASH */
+
+const struct core1_stat *core1_get_stat(void)
+{
+    return &core1.stat;
+}
+
+/**
+ * Start core1. From here on it owns the ADC capture and the display; call
+ * once, from core0, before anything reads samples.
+ */
+int core1_init(const struct core1_display_ops *display)
+{
+    core1.display = display;
+    core1_ring_init(&core1.samples, core1.sample_buf, CORE1_SAMPLE_RING, sizeof(core1.sample_buf[0]));
+    core1_ring_init(&core1.ui, core1.ui_buf, CORE1_UI_RING, sizeof(core1.ui_buf[0]));
+    rt_sem_init(&core1.sample_sem, "core1", 0, RT_IPC_FLAG_FIFO);
+
+    /* the launch handshake runs over the FIFO, so its interrupt comes after */
+    multicore_launch_core1_with_stack(core1_entry, core1.stack, sizeof(core1.stack));
+
+    multicore_fifo_clear_irq();
+    irq_set_exclusive_handler(SIO_IRQ_PROC0, core1_fifo_isr);
+    irq_set_enabled(SIO_IRQ_PROC0, true);
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_FINSH
+static void core1_cmd(int argc, char **argv)
+{
+    struct core1_stat *st = &core1.stat;
+
+    rt_kprintf("samples %d (dropped %d, waiting %d), doorbells %d\n", st->samples, st->sample_drops,
+               core1.samples.head - core1.samples.tail, st->doorbells);
+    rt_kprintf("display commands %d (dropped %d), refreshes %d, longest %d us\n", st->ui_cmds, st->ui_drops,
+               st->refreshes, st->max_refresh_us);
+    rt_kprintf("flash lockouts %d\n", st->lockouts);
+}
+MSH_CMD_EXPORT_ALIAS(core1_cmd, core1, show the core1 worker state);
+#endif /* RT_USING_FINSH */
+
+#endif /* CORE1_USING_WORKER */
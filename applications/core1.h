@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        core1 worker for sampling and the display
+ */
+#ifndef APPLICATIONS_CORE1_H_
+#define APPLICATIONS_CORE1_H_
+
+#include <rtthread.h>
+
+#include "drv_adc.h"
+
+/* entries in each shared ring, a power of two */
+#define CORE1_SAMPLE_RING           8
+#define CORE1_UI_RING               16
+
+#define CORE1_STACK_SIZE            2048
+
+/*
+ * What core1 does with display commands, called on core1 only. The panel
+ * is set up on core0 beforehand: it allocates, and the heap belongs to
+ * RT-Thread.
+ */
+struct core1_display_ops
+{
+    void (*set)(rt_uint32_t id, rt_int32_t value);
+    void (*refresh)(void);
+};
+
+struct core1_stat
+{
+    rt_uint32_t samples;            /* ADC blocks passed to core0 */
+    rt_uint32_t sample_drops;       /* blocks lost to a full sample ring */
+    rt_uint32_t ui_cmds;            /* display commands run on core1 */
+    rt_uint32_t ui_drops;           /* display commands lost to a full ring */
+    rt_uint32_t refreshes;
+    rt_uint32_t doorbells;          /* FIFO interrupts taken on core0 */
+    rt_uint32_t max_refresh_us;     /* longest render and flush on core1 */
+    rt_uint32_t lockouts;           /* times parked for a flash erase or program */
+};
+
+int core1_init(const struct core1_display_ops *display);
+rt_err_t core1_adc_read(struct pico_adc_block *block, rt_int32_t timeout);
+rt_err_t core1_ui_set(rt_uint32_t id, rt_int32_t value);
+rt_err_t core1_ui_refresh(void);
+const struct core1_stat *core1_get_stat(void);
+
+#endif /* APPLICATIONS_CORE1_H_ */
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        retained widgets for the monitoring screen
+ * 2026-10-17     khair        own translation unit, API in display_ui.h
+ */
+/*
+ * Retained-mode widgets on top of ssd1306_t.
+ *
+ * Every widget owns a rectangle of the screen and is bound to one value.
+ * ui_set() only records the value; ui_refresh() redraws the widgets whose
+ * value changed since they were last drawn (clear their rectangle, draw
+ * again) into the back buffer, ssd1306_t.buffer, and then shows once. The
+ * show compares against the front buffer, ssd1306_t.shadow, which holds
+ * what the panel displays, and sends only the changed window. Nothing is
+ * ever cleared on the panel itself, so there is no blank frame.
+ *
+ * Layout, 128x64:
+ *   page 0     alarm state (left), link icon (right)
+ *   rows 12-19 24 h MKT (left), minutes out of range in 24 h (right)
+ *   rows 24-39 temperature
+ *   rows 44-59 humidity
+ */
+#include <rtthread.h>
+
+#include "display_ui.h"
+#include "mkt.h"
+
+struct ui_widget
+{
+    uint8_t x, y, w, h;             /* area owned by the widget */
+    uint8_t scale;
+    const char *label;
+    const char *unit;
+    void (*draw)(ssd1306_t *p, const struct ui_widget *widget);
+
+    int32_t value;                  /* bound value, as last set */
+    int32_t shown;                  /* value drawn in the back buffer */
+    bool drawn;
+};
+
+/* link icons, one column byte per x, LSB on top */
+static const uint8_t ui_icon_link[][8] =
+{
+    {0x81, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x81},   /* down */
+    {0xc0, 0xc0, 0x00, 0x80, 0x80, 0x00, 0x80, 0x80},   /* bearer only */
+    {0xc0, 0xc0, 0x00, 0xf0, 0xf0, 0x00, 0xfc, 0xfc},   /* ready */
+};
+
+static void ui_draw_value(ssd1306_t *p, const struct ui_widget *widget)
+{
+    char text[20];
+    int32_t v = widget->shown;
+    uint32_t mag = v < 0 ? -(uint32_t)v : (uint32_t)v;
+
+    if (v == MKT_NONE)
+        rt_snprintf(text, sizeof(text), "%s--", widget->label);
+    else
+        rt_snprintf(text, sizeof(text), "%s%s%u.%02u%s", widget->label, v < 0 ? "-" : "",
+                    mag / 100, mag % 100, widget->unit);
+    ssd1306_draw_string(p, widget->x, widget->y, widget->scale, text);
+}
+
+static void ui_draw_minutes(ssd1306_t *p, const struct ui_widget *widget)
+{
+    char text[20];
+
+    rt_snprintf(text, sizeof(text), "%s%um", widget->label, (uint32_t)widget->shown);
+    ssd1306_draw_string(p, widget->x, widget->y, widget->scale, text);
+}
+
+static void ui_draw_alarm(ssd1306_t *p, const struct ui_widget *widget)
+{
+    static const char *const text[] = {"OK", "ALARM T", "ALARM H", "ALARM T H"};
+
+    ssd1306_draw_string(p, widget->x, widget->y, widget->scale, text[widget->shown & 3]);
+}
+
+static void ui_draw_link(ssd1306_t *p, const struct ui_widget *widget)
+{
+    uint32_t state = widget->shown;
+
+    if (state >= sizeof(ui_icon_link) / sizeof(ui_icon_link[0]))
+        state = 0;
+    for (uint32_t i = 0; i < 8; i++)
+        ssd1306_blit_column(p, widget->x + i, widget->y, ui_icon_link[state][i]);
+}
+
+static struct ui_widget ui_widgets[UI_WIDGET_MAX] =
+{
+    [UI_TEMPERATURE] = {8, 24, 120, 16, 2, "T: ", " C", ui_draw_value},
+    [UI_HUMIDITY]    = {8, 44, 120, 16, 2, "H: ", " %", ui_draw_value},
+    [UI_ALARM]       = {0, 0, 108, 8, 1, RT_NULL, RT_NULL, ui_draw_alarm},
+    [UI_LINK]        = {120, 0, 8, 8, 1, RT_NULL, RT_NULL, ui_draw_link},
+    [UI_MKT]         = {0, 12, 66, 8, 1, "MKT ", "C", ui_draw_value},
+    [UI_EXCURSION]   = {72, 12, 56, 8, 1, "EXC ", RT_NULL, ui_draw_minutes},
+};
+
+void ui_set(enum ui_widget_id id, int32_t value)
+{
+    ui_widgets[id].value = value;
+}
+
+/* redraw the widgets whose value changed and send the difference */
+void ui_refresh(ssd1306_t *p)
+{
+    bool changed = false;
+
+    for (int i = 0; i < UI_WIDGET_MAX; i++)
+    {
+        struct ui_widget *widget = &ui_widgets[i];
+
+        if (widget->drawn && widget->value == widget->shown)
+            continue;
+
+        widget->shown = widget->value;
+        ssd1306_clear_square(p, widget->x, widget->y, widget->w, widget->h);
+        widget->draw(p, widget);
+        widget->drawn = true;
+        changed = true;
+    }
+
+    if (changed)
+        ssd1306_show(p);
+}
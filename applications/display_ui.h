@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        retained widgets for the monitoring screen
+ */
+#ifndef APPLICATIONS_DISPLAY_UI_H_
+#define APPLICATIONS_DISPLAY_UI_H_
+
+#include <stdint.h>
+
+#include "ssd1306_lcd.h"
+#include "alarm.h"
+
+#define UI_REFRESH_MS       500
+
+enum ui_widget_id
+{
+    UI_TEMPERATURE = 0,             /* 0.01 degC */
+    UI_HUMIDITY,                    /* 0.01 %RH */
+    UI_ALARM,                       /* UI_ALARM_* bits */
+    UI_LINK,                        /* enum sim800_conn_state */
+    UI_MKT,                         /* 0.01 degC, MKT_NONE when unknown */
+    UI_EXCURSION,                   /* minutes */
+
+    UI_WIDGET_MAX
+};
+
+/* as alarm_active_mask() */
+#define UI_ALARM_TEMP       (1u << ALARM_TEMP)
+#define UI_ALARM_HUMID      (1u << ALARM_HUMID)
+
+void ui_set(enum ui_widget_id id, int32_t value);
+void ui_refresh(ssd1306_t *p);
+
+#endif /* APPLICATIONS_DISPLAY_UI_H_ */
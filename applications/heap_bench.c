@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        replay a heap trace on small mem and tlsf
+ */
+/*
+ * msh>heap_bench record [ops]
+ * msh>heap_bench stop
+ * msh>heap_bench [run] [pool]
+ *
+ * "record" hooks rt_malloc/rt_free and logs the application's own heap
+ * traffic, up to ops calls (1024 by default), until "stop" or the log is
+ * full. Blocks allocated before the recording started are not followed.
+ *
+ * "run" replays the log, or a synthetic trace of the same mix of sizes when
+ * nothing was recorded, against a private small memory heap and a private
+ * TLSF heap of the same pool size (by default 3/2 of the peak the trace
+ * needs), and reports for each:
+ *
+ *   alloc, free  CPU cycles avg/max, read from SysTick, IRQ-off per call
+ *   fail         allocations the heap could not satisfy
+ *   peak         the most the heap had in use, headers included
+ *   frag         share of the free memory left at the end of the trace that
+ *                the largest single allocation cannot reach
+ *
+ * Sleep modes are held off while it runs, so SysTick keeps counting.
+ */
+#include <stdlib.h>
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+
+#if defined(RT_USING_FINSH) && defined(HEAP_USING_BENCH)
+
+#define HEAP_BENCH_OPS          1024    /* default log length */
+#define HEAP_BENCH_SLOTS        128     /* blocks followed at once */
+#define HEAP_BENCH_FREE         0       /* size of a free in the log */
+
+struct heap_bench_op
+{
+    rt_uint32_t size;                   /* bytes allocated, HEAP_BENCH_FREE for a free */
+    rt_uint16_t slot;                   /* which block, shared by its alloc and free */
+};
+
+struct heap_bench_cost
+{
+    rt_uint32_t total;
+    rt_uint32_t count;
+    rt_uint32_t max;
+};
+
+struct heap_bench_algo
+{
+    const char *name;
+    rt_mem_t (*init)(const char *name, void *begin_addr, rt_size_t size);
+    void *(*alloc)(rt_mem_t m, rt_size_t size);
+    void (*free)(rt_mem_t m, void *ptr);
+    rt_err_t (*detach)(rt_mem_t m);
+};
+
+static struct heap_bench_op *heap_bench_log;
+static int heap_bench_max, heap_bench_len, heap_bench_dropped;
+static void *heap_bench_live[HEAP_BENCH_SLOTS];
+static rt_bool_t heap_bench_recording;
+static rt_uint32_t heap_bench_seed = 1;
+
+static rt_uint32_t heap_bench_rand(void)
+{
+    heap_bench_seed = heap_bench_seed * 1103515245 + 12345;
+    return heap_bench_seed >> 8;
+}
+
+/* SysTick counts CPU cycles down and reloads at zero */
+rt_inline rt_uint32_t heap_bench_cycles(void)
+{
+    return mpu_hw->cvr;
+}
+
+rt_inline rt_uint32_t heap_bench_elapsed(rt_uint32_t start)
+{
+    rt_uint32_t now = mpu_hw->cvr;
+
+    return start >= now ? start - now : start + mpu_hw->rvr + 1 - now;
+}
+
+static void heap_bench_add(struct heap_bench_cost *cost, rt_uint32_t cycles)
+{
+    cost->total += cycles;
+    cost->count++;
+    if (cycles > cost->max)
+        cost->max = cycles;
+}
+
+static void heap_bench_log_op(rt_uint32_t size, int slot)
+{
+    if (heap_bench_len < heap_bench_max)
+    {
+        heap_bench_log[heap_bench_len].size = size;
+        heap_bench_log[heap_bench_len].slot = slot;
+        heap_bench_len++;
+    }
+    else
+    {
+        heap_bench_dropped++;
+    }
+}
+
+/* the hooks run in the caller's context, on any thread */
+static void heap_bench_malloc_hook(void *ptr, rt_size_t size)
+{
+    rt_base_t level;
+    int i;
+
+    if (ptr == RT_NULL)
+        return;
+
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < HEAP_BENCH_SLOTS && heap_bench_live[i] != RT_NULL; i++);
+    if (i < HEAP_BENCH_SLOTS && heap_bench_len < heap_bench_max)
+    {
+        heap_bench_live[i] = ptr;
+        heap_bench_log_op(size, i);
+    }
+    else
+    {
+        heap_bench_dropped++;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+static void heap_bench_free_hook(void *ptr)
+{
+    rt_base_t level;
+    int i;
+
+    if (ptr == RT_NULL)
+        return;
+
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < HEAP_BENCH_SLOTS && heap_bench_live[i] != ptr; i++);
+    if (i < HEAP_BENCH_SLOTS)
+    {
+        heap_bench_live[i] = RT_NULL;
+        heap_bench_log_op(HEAP_BENCH_FREE, i);
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+static void heap_bench_stop(void)
+{
+    if (heap_bench_recording)
+    {
+        rt_malloc_sethook(RT_NULL);
+        rt_free_sethook(RT_NULL);
+        heap_bench_recording = RT_FALSE;
+        rt_kprintf("recorded %d heap calls, %d dropped\n", heap_bench_len, heap_bench_dropped);
+    }
+}
+
+static int heap_bench_reset(int ops)
+{
+    heap_bench_stop();
+    rt_free(heap_bench_log);
+    heap_bench_log = rt_malloc(ops * sizeof(struct heap_bench_op));
+    if (heap_bench_log == RT_NULL)
+    {
+        heap_bench_max = 0;
+        rt_kprintf("no memory for %d heap calls\n", ops);
+        return -RT_ENOMEM;
+    }
+    heap_bench_max = ops;
+    heap_bench_len = heap_bench_dropped = 0;
+    rt_memset(heap_bench_live, 0, sizeof(heap_bench_live));
+
+    return RT_EOK;
+}
+
+/*
+ * The application's mix: many small objects, AT command lines and HTTP
+ * bodies of a few hundred bytes, and the odd sample batch or thread stack
+ * of a kilobyte or more, each living for a random number of calls.
+ */
+static void heap_bench_synth(void)
+{
+    rt_uint32_t size, r;
+    int slot;
+
+    rt_memset(heap_bench_live, 0, sizeof(heap_bench_live));
+    heap_bench_len = heap_bench_dropped = 0;
+    while (heap_bench_len < heap_bench_max)
+    {
+        slot = heap_bench_rand() % HEAP_BENCH_SLOTS;
+        if (heap_bench_live[slot] != RT_NULL)
+        {
+            heap_bench_live[slot] = RT_NULL;
+            heap_bench_log_op(HEAP_BENCH_FREE, slot);
+            continue;
+        }
+
+        r = heap_bench_rand() % 100;
+        if (r < 55)
+            size = 8 + heap_bench_rand() % 56;
+        else if (r < 90)
+            size = 64 + heap_bench_rand() % 448;
+        else
+            size = 512 + heap_bench_rand() % 1536;
+        heap_bench_live[slot] = (void *)1;
+        heap_bench_log_op(size, slot);
+    }
+    rt_memset(heap_bench_live, 0, sizeof(heap_bench_live));
+}
+
+/* the most the trace has allocated at once, payload only */
+static rt_uint32_t heap_bench_peak(void)
+{
+    rt_uint32_t live[HEAP_BENCH_SLOTS] = {0};
+    rt_uint32_t now = 0, peak = 0;
+    int i;
+
+    for (i = 0; i < heap_bench_len; i++)
+    {
+        now -= live[heap_bench_log[i].slot];
+        live[heap_bench_log[i].slot] = heap_bench_log[i].size;
+        now += heap_bench_log[i].size;
+        if (now > peak)
+            peak = now;
+    }
+
+    return peak;
+}
+
+/* the largest block the heap can still hand out in one piece */
+static rt_size_t heap_bench_largest(const struct heap_bench_algo *algo, rt_mem_t m)
+{
+    rt_size_t lo = 0, hi = m->total, mid;
+    void *p;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo + 1) / 2;
+        p = algo->alloc(m, mid);
+        if (p != RT_NULL)
+        {
+            algo->free(m, p);
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+
+    return lo;
+}
+
+static void heap_bench_replay(const struct heap_bench_algo *algo, void *pool, rt_size_t size)
+{
+    struct heap_bench_cost alloc = {0}, release = {0};
+    void *blocks[HEAP_BENCH_SLOTS] = {0};
+    const struct heap_bench_op *op;
+    rt_size_t free_size, largest;
+    int i, fail = 0;
+    rt_base_t level;
+    rt_uint32_t c;
+    rt_mem_t m;
+
+    m = algo->init("hbench", pool, size);
+    if (m == RT_NULL)
+    {
+        rt_kprintf("%-5s: no heap in %d bytes\n", algo->name, size);
+        return;
+    }
+
+    for (i = 0; i < heap_bench_len; i++)
+    {
+        op = &heap_bench_log[i];
+        if (blocks[op->slot] != RT_NULL)
+        {
+            level = rt_hw_interrupt_disable();
+            c = heap_bench_cycles();
+            algo->free(m, blocks[op->slot]);
+            heap_bench_add(&release, heap_bench_elapsed(c));
+            rt_hw_interrupt_enable(level);
+            blocks[op->slot] = RT_NULL;
+        }
+        if (op->size != HEAP_BENCH_FREE)
+        {
+            level = rt_hw_interrupt_disable();
+            c = heap_bench_cycles();
+            blocks[op->slot] = algo->alloc(m, op->size);
+            heap_bench_add(&alloc, heap_bench_elapsed(c));
+            rt_hw_interrupt_enable(level);
+            if (blocks[op->slot] == RT_NULL)
+                fail++;
+        }
+    }
+
+    free_size = m->total - m->used;
+    largest = heap_bench_largest(algo, m);
+    for (i = 0; i < HEAP_BENCH_SLOTS; i++)
+        algo->free(m, blocks[i]);
+
+    rt_kprintf("%-5s: alloc %d/%d free %d/%d, fail %d, peak %d, frag %d%% (largest %d of %d free)\n",
+               algo->name,
+               alloc.count ? alloc.total / alloc.count : 0, alloc.max,
+               release.count ? release.total / release.count : 0, release.max,
+               fail, m->max,
+               free_size ? 100 - (int)(largest * 100 / free_size) : 0, largest, free_size);
+    algo->detach(m);
+}
+
+static void heap_bench_smem_free(rt_mem_t m, void *ptr)
+{
+    rt_smem_free(ptr);
+}
+
+static const struct heap_bench_algo heap_bench_algos[] =
+{
+    {"small", rt_smem_init, rt_smem_alloc, heap_bench_smem_free, rt_smem_detach},
+    {"tlsf", rt_tlsf_init, rt_tlsf_alloc, rt_tlsf_free, rt_tlsf_detach},
+};
+
+static void heap_bench_run(rt_size_t size)
+{
+    void *pool;
+    int i;
+
+    heap_bench_stop();
+    if (heap_bench_len == 0)
+    {
+        if (heap_bench_max == 0 && heap_bench_reset(HEAP_BENCH_OPS) != RT_EOK)
+            return;
+        heap_bench_synth();
+        rt_kprintf("synthetic trace");
+    }
+    else
+    {
+        rt_kprintf("recorded trace");
+    }
+    if (size == 0)
+        size = heap_bench_peak() * 3 / 2 + 2048;
+
+    pool = rt_malloc(size);
+    if (pool == RT_NULL)
+    {
+        rt_kprintf("\nno memory for a %d byte pool\n", size);
+        return;
+    }
+    rt_kprintf(", %d calls, %d byte pool, cycles avg/max at %d MHz\n",
+               heap_bench_len, size, clock_get_hz(clk_sys) / 1000000);
+
+#ifdef RT_USING_PM
+    rt_pm_request(PM_SLEEP_MODE_NONE);
+#endif
+    for (i = 0; i < sizeof(heap_bench_algos) / sizeof(heap_bench_algos[0]); i++)
+        heap_bench_replay(&heap_bench_algos[i], pool, size);
+#ifdef RT_USING_PM
+    rt_pm_release(PM_SLEEP_MODE_NONE);
+#endif
+
+    rt_free(pool);
+}
+
+static void heap_bench(int argc, char **argv)
+{
+    if (argc >= 2 && !rt_strcmp(argv[1], "record"))
+    {
+        if (heap_bench_reset(argc >= 3 ? atoi(argv[2]) : HEAP_BENCH_OPS) != RT_EOK)
+            return;
+        heap_bench_recording = RT_TRUE;
+        rt_malloc_sethook(heap_bench_malloc_hook);
+        rt_free_sethook(heap_bench_free_hook);
+        rt_kprintf("recording up to %d heap calls\n", heap_bench_max);
+    }
+    else if (argc >= 2 && !rt_strcmp(argv[1], "stop"))
+    {
+        heap_bench_stop();
+    }
+    else if (argc >= 2 && !rt_strcmp(argv[1], "run"))
+    {
+        heap_bench_run(argc >= 3 ? atoi(argv[2]) : 0);
+    }
+    else if (argc == 1 || (argc == 2 && atoi(argv[1]) > 0))
+    {
+        heap_bench_run(argc == 2 ? atoi(argv[1]) : 0);
+    }
+    else
+    {
+        rt_kprintf("usage: heap_bench record [ops] | stop | [run] [pool]\n");
+    }
+}
+MSH_CMD_EXPORT(heap_bench, replay a heap trace on small mem and tlsf: heap_bench record|stop|run);
+
+#endif /* RT_USING_FINSH && HEAP_USING_BENCH */
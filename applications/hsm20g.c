@@ -6,47 +6,526 @@
  * Change Logs:
  * Date           Author       Notes
  * 2023-05-19     Md. Khairul Alam       the first version
+ * 2026-10-17     khair        fixed-point conversion through interpolated tables
+ * 2026-10-17     khair        readings from the oversampled ADC capture
+ * 2026-10-17     khair        sensor framework devices with FIFO mode
+ * 2026-10-17     khair        trace marker for every reading
+ * 2026-10-17     khair        paired integer readings through hsm20g_read()
+ * 2026-10-17     khair        table accuracy check moved to tests/host
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <rtthread.h>
+#include <rtdevice.h>
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
 #include "drivers/adc.h"
+#include "drv_adc.h"
+#include "hsm20g.h"
+#include "trace.h"
+#ifdef CORE1_USING_WORKER
+#include "core1.h"
+#endif
 
 #define TEMP_PIN 26
 #define HUMID_PIN 27
+// ADC inputs as wired: humidity on input 0, temperature on input 1
+#define HSM20G_HUMID_INPUT 0
+#define HSM20G_TEMP_INPUT 1
 
-typedef struct{
-    float humidity;
-    float temperature;
-}sensor_reading;
+/*
+ * HSM-20G transfer curves, from the datasheet fit (v = sensor output in V):
+ *   temperature (degC) = 5.26 v^3 - 27.34 v^2 + 68.87 v - 7.81
+ *   humidity    (%RH)  = 3.71 v^3 - 20.65 v^2 + 64.81 v - 27.44
+ *
+ * Both are tabulated in 0.01 units at every 64th ADC code (65 knots cover
+ * codes 0..4096) and interpolated linearly in between, on 12.4 fixed-point
+ * codes so the extra resolution of the oversampled capture is kept. The tables are
+ * constant expressions, folded by the compiler, so no floating point runs
+ * on the target. Over all 4096 codes the result stays within 0.025 units
+ * of the polynomial (interpolation plus rounding); tests/host/hsm20g_test
+ * holds it to 0.05 at every 12.4 code.
+ */
+#define HSM20G_KNOT_SHIFT       6
+#define HSM20G_KNOTS            ((4096 >> HSM20G_KNOT_SHIFT) + 1)
+#define HSM20G_CODE_SHIFT       (HSM20G_KNOT_SHIFT + PICO_ADC_FRAC_BITS)
+
+#define HSM20G_V(k)             ((double)((k) << HSM20G_KNOT_SHIFT) * 3.3 / 4096)
+#define HSM20G_TEMP_POLY(v)     (5.26*(v)*(v)*(v) - 27.34*(v)*(v) + 68.87*(v) - 7.81)
+#define HSM20G_HUMID_POLY(v)    (3.71*(v)*(v)*(v) - 20.65*(v)*(v) + 64.81*(v) - 27.44)
+#define HSM20G_CENTI(x)         ((int32_t)((x) * 100.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+#define HSM20G_TEMP_KNOT(k)     HSM20G_CENTI(HSM20G_TEMP_POLY(HSM20G_V(k)))
+#define HSM20G_HUMID_KNOT(k)    HSM20G_CENTI(HSM20G_HUMID_POLY(HSM20G_V(k)))
+
+#define HSM20G_K8(f, n)         f(n), f((n)+1), f((n)+2), f((n)+3), f((n)+4), f((n)+5), f((n)+6), f((n)+7)
+#define HSM20G_K64(f)           HSM20G_K8(f, 0), HSM20G_K8(f, 8), HSM20G_K8(f, 16), HSM20G_K8(f, 24), \
+                                HSM20G_K8(f, 32), HSM20G_K8(f, 40), HSM20G_K8(f, 48), HSM20G_K8(f, 56), f(64)
+
+static const int32_t hsm20g_temp_table[HSM20G_KNOTS] = {HSM20G_K64(HSM20G_TEMP_KNOT)};
+static const int32_t hsm20g_humid_table[HSM20G_KNOTS] = {HSM20G_K64(HSM20G_HUMID_KNOT)};
+
+static void ADC_init(void);
+
+// ADC code (12.4 fixed point) to 0.01 units through one of the tables
+static inline int32_t hsm20g_convert(const int32_t *table, uint32_t code){
+    uint32_t k = code >> HSM20G_CODE_SHIFT;
+    int32_t f = code & ((1 << HSM20G_CODE_SHIFT) - 1);
+    int32_t d = table[k + 1] - table[k];
+
+    return table[k] + ((d * f + (1 << (HSM20G_CODE_SHIFT - 1))) >> HSM20G_CODE_SHIFT);
+}
+
+int32_t hsm20g_temperature(uint32_t code){
+    return hsm20g_convert(hsm20g_temp_table, code & 0xffff);
+}
+
+int32_t hsm20g_humidity(uint32_t code){
+    return hsm20g_convert(hsm20g_humid_table, code & 0xffff);
+}
+
+#ifdef BSP_USING_ADC
+// drv_adc streams both inputs; this blocks until the next decimated block
+int read_from_sensor(sensor_reading *result){
+    struct pico_adc_block block;
 
-void read_from_sensor(sensor_reading *result);
-void ADC_init(void);
+#ifdef CORE1_USING_WORKER
+    // decimated on core1 and handed over through its sample ring
+    if(core1_adc_read(&block, RT_WAITING_FOREVER) != RT_EOK)
+        return -RT_ERROR;
+#else
+    if(pico_adc_capture_read(&block, RT_WAITING_FOREVER) != RT_EOK)
+        return -RT_ERROR;
+#endif
 
-void read_from_sensor(sensor_reading *result){
+    result->temperature = hsm20g_temperature(block.code[HSM20G_TEMP_INPUT]);
+    result->humidity = hsm20g_humidity(block.code[HSM20G_HUMID_INPUT]);
+    result->tick = block.tick;
+    trace_mark(TRACE_SAMPLE, block.tick);
+    return RT_EOK;
+}
 
-    adc_select_input(0);
+static void ADC_init(void){
+    // set up and started by drv_adc
+}
+#else
+int read_from_sensor(sensor_reading *result){
+
+    adc_select_input(HSM20G_HUMID_INPUT);
     uint humid_raw = adc_read();
-    adc_select_input(1);
+    adc_select_input(HSM20G_TEMP_INPUT);
     uint temp_raw = adc_read();
 
+    result->temperature = hsm20g_temperature(temp_raw << PICO_ADC_FRAC_BITS);
+    result->humidity = hsm20g_humidity(humid_raw << PICO_ADC_FRAC_BITS);
+    result->tick = rt_tick_get();
+    trace_mark(TRACE_SAMPLE, result->tick);
+    return RT_EOK;
+}
+
+static void ADC_init(void){
+    adc_init();
+    adc_gpio_init(TEMP_PIN);
+    adc_gpio_init(HUMID_PIN);
+}
+#endif /* BSP_USING_ADC */
+
+#ifdef HSM20G_USING_SENSOR
+/*
+ * "tm-hsm" and "hm-hsm": one sensor framework module, fed by a thread that
+ * takes a reading per ADC capture block (or every HSM20G_POLL_MS without
+ * the capture).
+ *
+ * Polling mode returns the newest reading. In FIFO mode readings queue in
+ * the framework's data_buf, up to HSM20G_FIFO_MAX, and rx_indicate fires
+ * once HSM20G_CTRL_SET_WATERMARK readings are waiting, so one
+ * rt_device_read() returns the whole batch, each with the tick it was
+ * taken at. A full FIFO drops its oldest reading.
+ *
+ * While either device is in FIFO mode the same readings also queue here
+ * as sensor_readings, in 0.01 units and with both values of a reading
+ * together. hsm20g_read() takes them from that queue and the two device
+ * FIFOs in one go under the module lock, so temperature and humidity
+ * cannot come apart the way two rt_device_read()s can.
+ */
+#define HSM20G_POLL_MS          2000
+
+#ifdef BSP_USING_ADC
+#define HSM20G_PERIOD_MS        (BSP_ADC_DECIMATION * 1000 / BSP_ADC_SAMPLE_RATE)
+#else
+#define HSM20G_PERIOD_MS        HSM20G_POLL_MS
+#endif
+
+struct hsm20g_sensor{
+    struct rt_sensor_device parent;
+    struct rt_sensor_data latest;
+    rt_size_t watermark;
+};
+
+static struct hsm20g_sensor hsm20g_temp_sensor;
+static struct hsm20g_sensor hsm20g_humid_sensor;
+static struct rt_sensor_module hsm20g_module;
+static struct hsm20g_stat hsm20g_stat;
+
+// the readings hsm20g_read() has yet to take, oldest first
+static sensor_reading hsm20g_fifo[HSM20G_FIFO_MAX];
+static rt_size_t hsm20g_fifo_len;
+static sensor_reading hsm20g_newest;
+
+static rt_bool_t hsm20g_fifo_mode(struct hsm20g_sensor *sen){
+    return RT_SENSOR_MODE_GET_FETCH(sen->parent.info.mode) == RT_SENSOR_MODE_FETCH_FIFO && sen->parent.data_buf != RT_NULL;
+}
+
+// called with the module lock held
+static rt_size_t hsm20g_push(struct hsm20g_sensor *sen, rt_sensor_float_t value, rt_tick_t tick){
+    rt_sensor_t sensor = &sen->parent;
+    rt_size_t n;
+
+    sen->latest.timestamp = tick;
+    sen->latest.type = sensor->info.type;
+    if(sensor->info.type == RT_SENSOR_TYPE_TEMP)
+        sen->latest.data.temp = value;
+    else
+        sen->latest.data.humi = value;
+
+    if(!hsm20g_fifo_mode(sen))
+        return 0;
+
+    n = sensor->data_len / sizeof(struct rt_sensor_data);
+    if(n == sensor->info.fifo_max){
+        rt_memmove(sensor->data_buf, sensor->data_buf + 1, (n - 1) * sizeof(struct rt_sensor_data));
+        n--;
+    }
+    sensor->data_buf[n++] = sen->latest;
+    sensor->data_len = n * sizeof(struct rt_sensor_data);
+
+    return n >= sen->watermark ? n : 0;
+}
+
+// drops the oldest `n` readings of a device FIFO, called with the module lock held
+static void hsm20g_take(struct hsm20g_sensor *sen, rt_size_t n){
+    rt_sensor_t sensor = &sen->parent;
+    rt_size_t len = sensor->data_len / sizeof(struct rt_sensor_data);
+
+    if(n >= len){
+        sensor->data_len = 0;
+        return;
+    }
+    rt_memmove(sensor->data_buf, sensor->data_buf + n, (len - n) * sizeof(struct rt_sensor_data));
+    sensor->data_len = (len - n) * sizeof(struct rt_sensor_data);
+}
+
+static void hsm20g_entry(void *parameter){
+    sensor_reading reading;
+    rt_size_t nt, nh;
+
+    while(1){
+        if(read_from_sensor(&reading) != RT_EOK)
+            continue;
+
+        rt_mutex_take(hsm20g_module.lock, RT_WAITING_FOREVER);
+        // the framework's values are floats in degC and %RH
+        nt = hsm20g_push(&hsm20g_temp_sensor, reading.temperature / 100.0f, reading.tick);
+        nh = hsm20g_push(&hsm20g_humid_sensor, reading.humidity / 100.0f, reading.tick);
+        if(hsm20g_fifo_mode(&hsm20g_temp_sensor) || hsm20g_fifo_mode(&hsm20g_humid_sensor)){
+            if(hsm20g_fifo_len == HSM20G_FIFO_MAX){
+                rt_memmove(hsm20g_fifo, hsm20g_fifo + 1, (HSM20G_FIFO_MAX - 1) * sizeof(sensor_reading));
+                hsm20g_fifo_len--;
+                hsm20g_stat.dropped++;
+            }
+            hsm20g_fifo[hsm20g_fifo_len++] = reading;
+            if(hsm20g_fifo_len > hsm20g_stat.max_depth)
+                hsm20g_stat.max_depth = hsm20g_fifo_len;
+        }
+        hsm20g_newest = reading;
+        hsm20g_stat.readings++;
+        rt_mutex_release(hsm20g_module.lock);
+
+        if(nt && hsm20g_temp_sensor.parent.parent.rx_indicate)
+            hsm20g_temp_sensor.parent.parent.rx_indicate(&hsm20g_temp_sensor.parent.parent, nt);
+        if(nh && hsm20g_humid_sensor.parent.parent.rx_indicate)
+            hsm20g_humid_sensor.parent.parent.rx_indicate(&hsm20g_humid_sensor.parent.parent, nh);
+
+#ifndef BSP_USING_ADC
+        rt_thread_mdelay(HSM20G_POLL_MS);
+#endif
+    }
+}
+
+/**
+ * Takes up to `max` of the readings queued since the last call, oldest
+ * first, and the same readings from both device FIFOs. Needs one of the
+ * devices open in FIFO mode; rx_indicate of either says when to call.
+ *
+ * @return the number of readings in `buf`
+ */
+rt_size_t hsm20g_read(sensor_reading *buf, rt_size_t max){
+    rt_size_t n;
+
+    if(hsm20g_module.lock == RT_NULL)
+        return 0;
+
+    rt_mutex_take(hsm20g_module.lock, RT_WAITING_FOREVER);
+    n = hsm20g_fifo_len < max ? hsm20g_fifo_len : max;
+    rt_memcpy(buf, hsm20g_fifo, n * sizeof(sensor_reading));
+    rt_memmove(hsm20g_fifo, hsm20g_fifo + n, (hsm20g_fifo_len - n) * sizeof(sensor_reading));
+    hsm20g_fifo_len -= n;
+    hsm20g_take(&hsm20g_temp_sensor, n);
+    hsm20g_take(&hsm20g_humid_sensor, n);
+    rt_mutex_release(hsm20g_module.lock);
+
+    return n;
+}
+
+// only reached with an empty FIFO: polling gets the newest reading, FIFO nothing
+static rt_ssize_t hsm20g_fetch_data(rt_sensor_t sensor, rt_sensor_data_t buf, rt_size_t len){
+    struct hsm20g_sensor *sen = (struct hsm20g_sensor *)sensor;
+
+    if(RT_SENSOR_MODE_GET_FETCH(sensor->info.mode) != RT_SENSOR_MODE_FETCH_POLLING || sen->latest.type == RT_SENSOR_TYPE_NONE)
+        return 0;
+
+    *buf = sen->latest;
+    return 1;
+}
+
+static rt_err_t hsm20g_control(rt_sensor_t sensor, int cmd, void *arg){
+    struct hsm20g_sensor *sen = (struct hsm20g_sensor *)sensor;
+
+    switch(cmd){
+    case RT_SENSOR_CTRL_SET_FETCH_MODE:
+        if((rt_ubase_t)arg == RT_SENSOR_MODE_FETCH_INT)
+            return -RT_EINVAL;
+        sensor->data_len = 0;
+        return RT_EOK;
+    case HSM20G_CTRL_SET_WATERMARK:
+        if((rt_ubase_t)arg < 1 || (rt_ubase_t)arg > sensor->info.fifo_max)
+            return -RT_EINVAL;
+        sen->watermark = (rt_ubase_t)arg;
+        return RT_EOK;
+    default:
+        return -RT_EINVAL;
+    }
+}
+
+static const struct rt_sensor_ops hsm20g_ops = {
+    hsm20g_fetch_data,
+    hsm20g_control,
+};
+
+static int hsm20g_register(struct hsm20g_sensor *sen, const char *name, struct rt_sensor_module *module,
+                           rt_uint8_t type, rt_uint8_t unit, rt_sensor_float_t range_min, rt_sensor_float_t range_max){
+    rt_sensor_t sensor = &sen->parent;
+
+    sensor->info.type = type;
+    sensor->info.vendor = RT_SENSOR_VENDOR_UNKNOWN;
+    sensor->info.name = "hsm20g";
+    sensor->info.unit = unit;
+    sensor->info.intf_type = 0;         // analog, read through the ADC
+    sensor->info.fifo_max = HSM20G_FIFO_MAX;
+    sensor->info.acquire_min = HSM20G_PERIOD_MS;
+    sensor->info.accuracy.resolution = 0.01f;
+    sensor->info.scale.range_min = range_min;
+    sensor->info.scale.range_max = range_max;
+    sensor->config.irq_pin.pin = PIN_IRQ_PIN_NONE;
+    sensor->ops = &hsm20g_ops;
+    sensor->module = module;
+    sen->watermark = 1;
+
+    return rt_hw_sensor_register(sensor, name,
+                                 RT_DEVICE_FLAG_RDONLY | RT_DEVICE_FLAG_FIFO_RX, RT_NULL);
+}
+
+const struct hsm20g_stat *hsm20g_get_stat(void){
+    return &hsm20g_stat;
+}
+
+int hsm20g_init(void){
+    rt_thread_t tid;
+
+    ADC_init();
+
+    hsm20g_module.sen[0] = &hsm20g_temp_sensor.parent;
+    hsm20g_module.sen[1] = &hsm20g_humid_sensor.parent;
+    hsm20g_module.sen_num = 2;
+
+    // temperature accuracy +-1 degC, humidity +-5 %RH per the datasheet
+    hsm20g_temp_sensor.parent.info.accuracy.error = 1.0f;
+    hsm20g_humid_sensor.parent.info.accuracy.error = 5.0f;
+    if(hsm20g_register(&hsm20g_temp_sensor, HSM20G_SENSOR_NAME, &hsm20g_module, RT_SENSOR_TYPE_TEMP,
+                       RT_SENSOR_UNIT_CELSIUS, HSM20G_TEMP_POLY(0.0), HSM20G_TEMP_POLY(3.3)) != RT_EOK ||
+       hsm20g_register(&hsm20g_humid_sensor, HSM20G_SENSOR_NAME, &hsm20g_module, RT_SENSOR_TYPE_HUMI,
+                       RT_SENSOR_UNIT_PERCENTAGE, 0, 100) != RT_EOK)
+        return -RT_ERROR;
+
+    tid = rt_thread_create("hsm20g", hsm20g_entry, RT_NULL, 768, 1, 20);
+    if(tid == RT_NULL)
+        return -RT_ENOMEM;
+    return rt_thread_startup(tid);
+}
+
+#ifdef RT_USING_FINSH
+static void hsm20g_cmd(int argc, char **argv){
+    struct hsm20g_stat *st = &hsm20g_stat;
+
+    rt_kprintf("%d readings, one per %d ms, %d dropped from full FIFOs\n",
+               st->readings, HSM20G_PERIOD_MS, st->dropped);
+    rt_kprintf("FIFO depth: %d (devices: temperature %d, humidity %d), max %d of %d\n", hsm20g_fifo_len,
+               hsm20g_temp_sensor.parent.data_len / sizeof(struct rt_sensor_data),
+               hsm20g_humid_sensor.parent.data_len / sizeof(struct rt_sensor_data),
+               st->max_depth, HSM20G_FIFO_MAX);
+    rt_kprintf("newest: %d centi-degC, %d centi-%%RH at tick %d\n",
+               hsm20g_newest.temperature, hsm20g_newest.humidity, hsm20g_newest.tick);
+}
+MSH_CMD_EXPORT_ALIAS(hsm20g_cmd, hsm20g, show the HSM-20G sensor state);
+#endif /* RT_USING_FINSH */
+
+#if defined(RT_USING_FINSH) && defined(HSM20G_USING_SENSOR_BENCH)
+/*
+ * msh>sensor_bench [num=1000]
+ *
+ * read_th keeps "tm-hsm" and "hm-hsm" open, and they are standalone
+ * devices, so the bench registers a device of its own, "tm-hsmb", on the
+ * same driver ops and in a module of its own, and feeds it itself. It
+ * times `num` polling reads, then `num` readings taken in FIFO mode a full
+ * FIFO per rt_device_read(): the framework's cost per reading either way.
+ */
+#include "hardware/clocks.h"
+
+static struct hsm20g_sensor hsm20g_bench_sensor;
+static struct rt_sensor_module hsm20g_bench_module;
+static rt_uint32_t hsm20g_bench_ind;
+
+static rt_err_t hsm20g_bench_rx_ind(rt_device_t dev, rt_size_t size){
+    hsm20g_bench_ind++;
+    return RT_EOK;
+}
+
+static void sensor_bench(int argc, char **argv){
+    static struct rt_sensor_data data[HSM20G_FIFO_MAX];
+    rt_device_t dev = &hsm20g_bench_sensor.parent.parent;
+    rt_uint32_t num = argc > 1 ? atoi(argv[1]) : 1000;
+    rt_uint32_t i, k, got, reads, t0, t_poll, t_fifo, mhz;
+    rt_size_t n;
+    rt_ssize_t res;
+
+    if(num == 0){
+        rt_kprintf("Usage: sensor_bench [num]\n");
+        return;
+    }
+    if(hsm20g_bench_module.sen_num == 0){
+        hsm20g_bench_module.sen[0] = &hsm20g_bench_sensor.parent;
+        hsm20g_bench_module.sen_num = 1;
+        hsm20g_bench_sensor.parent.info.accuracy.error = 1.0f;
+        if(hsm20g_register(&hsm20g_bench_sensor, HSM20G_SENSOR_NAME "b", &hsm20g_bench_module, RT_SENSOR_TYPE_TEMP,
+                           RT_SENSOR_UNIT_CELSIUS, HSM20G_TEMP_POLY(0.0), HSM20G_TEMP_POLY(3.3)) != RT_EOK){
+            hsm20g_bench_module.sen_num = 0;
+            return;
+        }
+    }
+
+    if(rt_device_open(dev, RT_DEVICE_FLAG_RDONLY) != RT_EOK){
+        rt_kprintf("tm-hsmb is busy\n");
+        return;
+    }
+    rt_mutex_take(hsm20g_bench_module.lock, RT_WAITING_FOREVER);
+    hsm20g_push(&hsm20g_bench_sensor, 25.0f, rt_tick_get());
+    rt_mutex_release(hsm20g_bench_module.lock);
+    got = 0;
+    t0 = time_us_32();
+    for(i = 0; i < num; i++)
+        got += rt_device_read(dev, 0, data, 1) == 1;
+    t_poll = time_us_32() - t0;
+    rt_device_close(dev);
+
+    hsm20g_bench_ind = 0;
+    rt_device_set_rx_indicate(dev, hsm20g_bench_rx_ind);
+    if(rt_device_open(dev, RT_DEVICE_FLAG_FIFO_RX) != RT_EOK)
+        goto __exit;
+    rt_device_control(dev, HSM20G_CTRL_SET_WATERMARK, (void *)HSM20G_FIFO_MAX);
+    t_fifo = 0;
+    reads = 0;
+    for(i = 0; i < num; i += res){
+        rt_mutex_take(hsm20g_bench_module.lock, RT_WAITING_FOREVER);
+        for(k = 0; k < HSM20G_FIFO_MAX && i + k < num; k++){
+            n = hsm20g_push(&hsm20g_bench_sensor, 25.0f + k / 100.0f, rt_tick_get());
+            if(n)
+                dev->rx_indicate(dev, n);
+        }
+        rt_mutex_release(hsm20g_bench_module.lock);
+
+        t0 = time_us_32();
+        res = rt_device_read(dev, 0, data, HSM20G_FIFO_MAX);
+        t_fifo += time_us_32() - t0;
+        if(res <= 0)
+            break;
+        reads++;
+    }
+    rt_device_close(dev);
+
+    mhz = clock_get_hz(clk_sys) / 1000000;
+    rt_kprintf("polling: %d reads, %d with data, %d us, %d cycles per reading\n", num, got, t_poll,
+               (rt_uint32_t)((rt_uint64_t)t_poll * mhz / num));
+    if(i > 0)
+        rt_kprintf("fifo: %d readings in %d reads, %d rx_indicate, %d us, %d cycles per reading\n", i, reads,
+                   hsm20g_bench_ind, t_fifo, (rt_uint32_t)((rt_uint64_t)t_fifo * mhz / i));
+__exit:
+    rt_device_set_rx_indicate(dev, RT_NULL);
+}
+MSH_CMD_EXPORT(sensor_bench, time polling and FIFO reads through the sensor framework);
+#endif /* RT_USING_FINSH && HSM20G_USING_SENSOR_BENCH */
+
+#else
+int hsm20g_init(void){
+    ADC_init();
+    return RT_EOK;
+}
+#endif /* HSM20G_USING_SENSOR */
+
+#if defined(RT_USING_FINSH) && defined(HSM20G_USING_BENCH)
+/*
+ * msh>hsm20g_bench
+ *
+ * Times the old float/pow() conversion against the table, in cycles of the
+ * M0+, which does its floating point in software. tests/host/hsm20g_test
+ * checks the tables against the polynomials.
+ */
+#include <math.h>
+#include "hardware/clocks.h"
+
+static volatile float hsm20g_bench_sink_f;
+static volatile int32_t hsm20g_bench_sink_i;
+
+// the conversion read_from_sensor() used to do, for reference
+static void hsm20g_float_convert(uint temp_raw, uint humid_raw, float *temperature, float *humidity){
     const float conversion_factor = 3.3f / (1 << 12);
 
     float temp_voltage = temp_raw * conversion_factor;
     float humid_voltage = humid_raw * conversion_factor;
 
-    //int temperature=(5.26*pow(voltage_temp,3))-(27.34*pow(voltage_temp,2))+(68.87*voltage_temp)-17.81;
-    result->temperature = (5.26*temp_voltage*temp_voltage*temp_voltage)-(27.34*temp_voltage*temp_voltage)+(68.87*temp_voltage)-7.81;
-    //printf("Temp = %f\t\n", result->temperature);
+    *temperature = (5.26*temp_voltage*temp_voltage*temp_voltage)-(27.34*temp_voltage*temp_voltage)+(68.87*temp_voltage)-7.81;
+    *humidity = (3.71*pow(humid_voltage,3))-(20.65*pow(humid_voltage,2))+(64.81*humid_voltage)-27.44;
+}
 
-    result->humidity = (3.71*pow(humid_voltage,3))-(20.65*pow(humid_voltage,2))+(64.81*humid_voltage)-27.44;
-    //printf("Humidity = %.2f", result->humidity);
+static void hsm20g_bench(int argc, char **argv){
+    uint32_t code, t0, t_float, t_table, mhz;
+    float t, h;
 
-}
+    t0 = time_us_32();
+    for(code = 0; code < 4096; code++){
+        hsm20g_float_convert(code, code, &t, &h);
+        hsm20g_bench_sink_f = t + h;
+    }
+    t_float = time_us_32() - t0;
 
-void ADC_init(void){
-    adc_init();
-    adc_gpio_init(TEMP_PIN);
-    adc_gpio_init(HUMID_PIN);
+    t0 = time_us_32();
+    for(code = 0; code < 4096; code++)
+        hsm20g_bench_sink_i = hsm20g_temperature(code << PICO_ADC_FRAC_BITS) + hsm20g_humidity(code << PICO_ADC_FRAC_BITS);
+    t_table = time_us_32() - t0;
+
+    mhz = clock_get_hz(clk_sys) / 1000000;
+    rt_kprintf("cycles per sample (both channels): float/pow %d, table %d\n",
+               t_float * mhz / 4096, t_table * mhz / 4096);
 }
+MSH_CMD_EXPORT(hsm20g_bench, time the HSM-20G conversion);
+#endif /* RT_USING_FINSH && HSM20G_USING_BENCH */
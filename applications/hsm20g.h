@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        HSM-20G as sensor framework devices
+ * 2026-10-17     khair        hsm20g_read() for paired integer readings
+ */
+#ifndef APPLICATIONS_HSM20G_H_
+#define APPLICATIONS_HSM20G_H_
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+/* registered as "tm-hsm" (temperature) and "hm-hsm" (humidity) */
+#define HSM20G_SENSOR_NAME          "hsm"
+#define HSM20G_TEMP_DEVICE          "tm-" HSM20G_SENSOR_NAME
+#define HSM20G_HUMID_DEVICE         "hm-" HSM20G_SENSOR_NAME
+
+#ifndef HSM20G_FIFO_MAX
+#define HSM20G_FIFO_MAX             16
+#endif
+
+/* readings per rx_indicate in FIFO mode, arg is the count (default 1) */
+#define HSM20G_CTRL_SET_WATERMARK   (RT_SENSOR_CTRL_USER_CMD_START + 1)
+
+typedef struct{
+    int32_t humidity;       // 0.01 %RH
+    int32_t temperature;    // 0.01 degC
+    rt_tick_t tick;         // when the reading was taken
+}sensor_reading;
+
+struct hsm20g_stat
+{
+    rt_uint32_t readings;           /* readings taken */
+    rt_uint32_t dropped;            /* readings pushed out of a full FIFO */
+    rt_uint32_t max_depth;          /* most readings ever waiting in a FIFO */
+};
+
+int hsm20g_init(void);
+int read_from_sensor(sensor_reading *result);
+int32_t hsm20g_temperature(uint32_t code);
+int32_t hsm20g_humidity(uint32_t code);
+const struct hsm20g_stat *hsm20g_get_stat(void);
+
+#ifdef HSM20G_USING_SENSOR
+rt_size_t hsm20g_read(sensor_reading *buf, rt_size_t max);
+#endif
+
+#endif /* APPLICATIONS_HSM20G_H_ */
@@ -22,9 +22,17 @@
 #include "hardware/gpio.h"
 #include "hardware/i2c.h"
 
+#include "mkt.h"
+#include "alarm.h"
+#include "reading.h"
 #include "ssd1306_lcd.c"
+#include "display_ui.h"
 #include "sim800.c"
-#include "hsm20g.c"
+#include "hsm20g.h"
+#include "sample_batch.h"
+#include "sample_log.h"
+#include "uplink.h"
+#include "core1.h"
 
 
 #define LCD_I2C i2c0
@@ -33,18 +41,13 @@
 #define PICO_DEFAULT_I2C_SCL_PIN 17
 
 ssd1306_t disp;
-float temprature_in_c;
-float relative_humidity;
-int temp_state = 0;
-int humid_state = 0;
-
-uint8_t api_key[] = "api_key=B3FPE7GTVY1ISGQS&field1=";
+// written by read_th only, read lock-free by everyone else
+struct reading_snapshot latest_reading;
 
 // Thread control block declaration //
 rt_thread_t read_th_thread  = RT_NULL;
 rt_thread_t display_th_thread  = RT_NULL;
 rt_thread_t data_to_cloud_thread  = RT_NULL;
-rt_thread_t notification_thread  = RT_NULL;
 
 
 void I2C_init(void){
@@ -57,20 +60,107 @@ void I2C_init(void){
 }
 
 void SSD1306_init(void){
+#ifdef BSP_USING_I2C0
+    // i2c0 is set up by drv_i2c, frames go out by DMA
+    disp.bus = rt_i2c_bus_device_find("i2c0");
+#else
     I2C_init();
+#endif
     disp.external_vcc=false;
     ssd1306_init(&disp, 128, 64, 0x3C, LCD_I2C);
     ssd1306_clear(&disp);
 }
 
+#ifdef CORE1_USING_WORKER
+// the display belongs to core1, display_th only queues commands for it
+static void core1_display_set(rt_uint32_t id, rt_int32_t value){
+    ui_set((enum ui_widget_id)id, value);
+}
+
+static void core1_display_refresh(void){
+    ui_refresh(&disp);
+}
+
+static const struct core1_display_ops core1_display = {
+    .set = core1_display_set,
+    .refresh = core1_display_refresh,
+};
+
+#define display_set(id, value)  core1_ui_set(id, value)
+#define display_refresh()       core1_ui_refresh()
+#else
+#define display_set(id, value)  ui_set(id, value)
+#define display_refresh()       ui_refresh(&disp)
+#endif
+
 void system_init(void){
     stdio_init_all();
-    uart1_init();
+    sim800_init();
+    sample_batch_init();
+    sample_log_init();
+#ifdef APP_USING_UPLINK
+    uplink_init();
+#endif
     SSD1306_init();
-    ADC_init();
+    reading_snapshot_init(&latest_reading);
+    mkt_init();
+    alarm_init(send_sms);   // before the sensor, its readings feed the alarms
+#ifdef CORE1_USING_WORKER
+    core1_init(&core1_display);     // takes over the ADC and the display
+#endif
+    hsm20g_init();
+}
+
+
+#ifdef HSM20G_USING_SENSOR
+static struct rt_semaphore sensor_rx_sem;
+static sensor_reading sensor_batch[HSM20G_FIFO_MAX];
+
+static rt_err_t sensor_rx_ind(rt_device_t dev, rt_size_t size)
+{
+    return rt_sem_release(&sensor_rx_sem);
 }
 
+void read_th(void* parameter)
+{
+    rt_device_t temp_dev = rt_device_find(HSM20G_TEMP_DEVICE);
+    rt_device_t humid_dev = rt_device_find(HSM20G_HUMID_DEVICE);
+    struct reading latest;
+    rt_size_t n, i;
+
+    if(temp_dev == RT_NULL || humid_dev == RT_NULL)
+        return;
 
+    // both devices fill together, so waking on the humidity one is enough
+    rt_sem_init(&sensor_rx_sem, "sen_rx", 0, RT_IPC_FLAG_FIFO);
+    rt_device_set_rx_indicate(humid_dev, sensor_rx_ind);
+    if(rt_device_open(temp_dev, RT_DEVICE_FLAG_FIFO_RX) != RT_EOK ||
+       rt_device_open(humid_dev, RT_DEVICE_FLAG_FIFO_RX) != RT_EOK)
+        return;
+
+    while(1)
+    {
+        rt_sem_take(&sensor_rx_sem, RT_WAITING_FOREVER);
+
+        // everything queued since the last wakeup, oldest first, both values of each reading together
+        n = hsm20g_read(sensor_batch, HSM20G_FIFO_MAX);
+        for(i = 0; i < n; i++){
+            sample_log_add(sensor_batch[i].temperature, sensor_batch[i].humidity, sensor_batch[i].tick);
+            mkt_add(sensor_batch[i].temperature, sensor_batch[i].tick);
+            alarm_feed(ALARM_TEMP, sensor_batch[i].temperature, sensor_batch[i].tick);
+            alarm_feed(ALARM_HUMID, sensor_batch[i].humidity, sensor_batch[i].tick);
+        }
+        if(n == 0)
+            continue;
+
+        latest.temperature = sensor_batch[n - 1].temperature;
+        latest.humidity = sensor_batch[n - 1].humidity;
+        latest.tick = sensor_batch[n - 1].tick;
+        latest.flags = READING_TEMP_VALID | READING_HUMID_VALID;
+        reading_publish(&latest_reading, &latest);
+    }
+}
+#else
 void read_th(void* parameter)
 {
 
@@ -78,98 +168,76 @@ void read_th(void* parameter)
     {
         //rt_kprintf("Reading the sensor!\n");
         sensor_reading reading;
-        read_from_sensor(&reading);
-        temprature_in_c = reading.temperature;
-        relative_humidity = reading.humidity;
-
+        struct reading latest;
+        // with BSP_USING_ADC this blocks until the capture has a new reading,
+        // one every BSP_ADC_DECIMATION / BSP_ADC_SAMPLE_RATE s (2 s by default)
+        if(read_from_sensor(&reading) == RT_EOK){
+            latest.temperature = reading.temperature;
+            latest.humidity = reading.humidity;
+            latest.tick = reading.tick;
+            latest.flags = READING_TEMP_VALID | READING_HUMID_VALID;
+            reading_publish(&latest_reading, &latest);
+            sample_log_add(reading.temperature, reading.humidity, reading.tick);
+            mkt_add(reading.temperature, reading.tick);
+            alarm_feed(ALARM_TEMP, reading.temperature, reading.tick);
+            alarm_feed(ALARM_HUMID, reading.humidity, reading.tick);
+        }
+#ifndef BSP_USING_ADC
         rt_thread_mdelay(2000);
+#endif
 
     }
 }
+#endif /* HSM20G_USING_SENSOR */
 
 void display_th(void* parameter)
 {
+    struct mkt_report mkt;
+    struct reading now;
 
     while(1)
     {
        //rt_kprintf("Displaying data!\n");
-       char pre_temp[20] = "T: ";
-       char temp[20];
-       char post_temp[20] = " C";
-
-       int int_temp = (int)temprature_in_c;
-       float float_part = (abs(temprature_in_c) - abs(int_temp)) * 100;
-       int float_temp = (int)float_part;
-
-       rt_sprintf(temp, "%d.%d", int_temp, float_temp);
-       strcat(pre_temp, temp);
-       strcat(pre_temp, post_temp);
-
-       ssd1306_draw_string(&disp, 8, 24, 2, pre_temp);
-       ssd1306_show(&disp);
-
-       char pre_humid[20] = "H: ";
-       char humid[20];
-       char post_humid[20] = " %";
-
-       int int_humid = (int)relative_humidity;
-       float float_hpart = (abs(relative_humidity) - abs(int_humid)) * 100;
-       int float_humid = (int)float_hpart;
-
-       rt_sprintf(humid, "%d.%d", int_humid, float_humid);
-       strcat(pre_humid, humid);
-       strcat(pre_humid, post_humid);
-
-       ssd1306_draw_string(&disp, 8, 44, 2, pre_humid);
-       ssd1306_show(&disp);
-
-       rt_thread_mdelay(15000);
-       ssd1306_clear(&disp);
+       reading_get(&latest_reading, &now);
+       mkt_get(MKT_WINDOW_24H, &mkt);
+       display_set(UI_TEMPERATURE, now.temperature);
+       display_set(UI_HUMIDITY, now.humidity);
+       display_set(UI_ALARM, alarm_active_mask());
+       display_set(UI_LINK, sim800_http_conn_state());
+       display_set(UI_MKT, mkt.mkt);
+       display_set(UI_EXCURSION, mkt.excursion_total_min);
+
+       // only the widgets whose value changed are redrawn and sent
+       display_refresh();
+
+       rt_thread_mdelay(UI_REFRESH_MS);
     }
 }
 
+#ifdef APP_USING_UPLINK
 void data_to_cloud(void* parameter)
 {
-
-    while(1)
-    {
-        //rt_kprintf("Sending to cloud!\n");
-        send_data(api_key, (int)temprature_in_c, (int)relative_humidity);
-        //send data to cloud every 10 seconds
-        rt_thread_mdelay(20000);
-    }
+    // uploads come out of the flash log, a backlog drains once the link is back
+    uplink_run();
 }
-
-void send_notification(void* parameter)
+#else
+void data_to_cloud(void* parameter)
 {
+    struct reading now;
 
     while(1)
     {
-        //rt_kprintf("Sending notification!\n");
-        if(temprature_in_c>4){
-            if(temp_state==0){
-                temperature_high_alart();
-                temp_state = 1;
-            }
-        }
-        else{
-            if(temp_state==1)
-                temp_state = 0;
-        }
-        if(relative_humidity>50){
-            if(humid_state==0){
-                humidity_high_alart();
-                humid_state = 1;
-            }
-        }
-        else{
-            if(humid_state==1)
-                humid_state = 0;
-        }
-        rt_thread_mdelay(3000);
+        //rt_kprintf("Sending to cloud!\n");
+        // temperature and humidity from the same reading, none before the first
+        if(reading_get(&latest_reading, &now) != 0)
+            sample_batch_add(now.temperature, now.humidity);
+        //one sample every 20 seconds, sent in bulk once a batch is full or old enough
+        while(sample_batch_due() && sample_batch_flush() == RT_EOK)
+            ;
+        rt_thread_mdelay(20000);
     }
 }
-
+#endif /* APP_USING_UPLINK */
 
 void Run(void)
 {
@@ -188,14 +256,10 @@ void Run(void)
     if (display_th_thread != RT_NULL)
         rt_thread_startup(display_th_thread);
 
-    data_to_cloud_thread = rt_thread_create( "DataToCloud", data_to_cloud, RT_NULL, 512, 2, 20);
+    data_to_cloud_thread = rt_thread_create( "DataToCloud", data_to_cloud, RT_NULL, 1024, 2, 20);
     if (data_to_cloud_thread != RT_NULL)
         rt_thread_startup(data_to_cloud_thread);
 
-    notification_thread = rt_thread_create( "SendNotification", send_notification, RT_NULL, 512, 2, 20);
-    if (notification_thread != RT_NULL)
-        rt_thread_startup(notification_thread);
-
 }
 
 
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        streaming MKT and excursion budget
+ * 2026-10-17     khair        count hours across the tick wrap
+ */
+/*
+ * Mean Kinetic Temperature and time out of range, kept up to date one
+ * sample at a time:
+ *
+ *   MKT = (Ea/R) / -ln( sum(exp(-Ea/(R*Ti))) / n )
+ *
+ * Each sample adds its Arrhenius weight to running sums; no exp() runs per
+ * sample. The weights come from a table built once at init, every 0.5 degC
+ * from -40 to +85 degC, scaled so the weight at +85 degC is 1.0 in Q31, and
+ * are interpolated linearly in between (readings outside that range weigh
+ * as its ends). Interpolating the convex curve overestimates a weight by
+ * at most 0.14 %, at -40 degC, which moves MKT by less than 0.01 degC.
+ * The sums are integers, so windows can drop old hours exactly. The one
+ * log() runs when a report is asked for.
+ *
+ * Samples go into hourly buckets, 168 of them, and into running 24 h and
+ * 7 d totals. When a new hour starts, the hour leaving each window is
+ * subtracted, so a sample costs O(1) and the windows move with hour
+ * granularity. Hours are counted from the ticks elapsed since the current
+ * one began, not from the tick itself, so the windows keep moving when the
+ * tick wraps around. Excursion time is counted per band: the time since the
+ * previous sample is charged to the band of the new one.
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <rtthread.h>
+
+#include "mkt.h"
+
+#define DBG_TAG "mkt"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#define MKT_GAS_CONSTANT    8.3144626
+#define MKT_E_OVER_R        (MKT_ACTIVATION_ENERGY / MKT_GAS_CONSTANT)     /* K */
+#define MKT_KELVIN          27315                                           /* 0.01 K */
+
+#define MKT_TABLE_MIN       (-4000)                                         /* 0.01 degC */
+#define MKT_TABLE_MAX       8500
+#define MKT_TABLE_STEP      50
+#define MKT_TABLE_LEN       ((MKT_TABLE_MAX - MKT_TABLE_MIN) / MKT_TABLE_STEP + 1)
+#define MKT_T_TOP           ((MKT_TABLE_MAX + MKT_KELVIN) / 100.0)          /* K */
+#define MKT_WEIGHT_ONE      2147483648.0                                    /* Q31 */
+
+#define MKT_HOURS           (7 * 24)
+#define MKT_HOUR_TICKS      (3600 * RT_TICK_PER_SECOND)
+#define MKT_MAX_GAP_TICKS   (MKT_MAX_GAP_MS * RT_TICK_PER_SECOND / 1000)
+
+struct mkt_acc
+{
+    rt_uint64_t sum;                        /* Q31 weights */
+    rt_uint32_t count;
+    rt_uint32_t band_ms[MKT_BAND_MAX];
+};
+
+struct mkt
+{
+    struct mkt_acc hour[MKT_HOURS];         /* slot = hour number % MKT_HOURS */
+    struct mkt_acc window[2];               /* 24 h, 7 d */
+    rt_uint32_t cur_hour;                   /* hour number of the newest sample */
+    rt_tick_t hour_start;                   /* tick the current hour began at */
+    rt_tick_t last_tick;
+    rt_bool_t started;
+
+    rt_uint64_t all_sum;
+    rt_uint32_t all_count;
+    rt_uint64_t all_band_ms[MKT_BAND_MAX];
+};
+
+static rt_uint32_t mkt_table[MKT_TABLE_LEN];
+static struct mkt mkt;
+static struct rt_mutex mkt_lock;
+
+static const char *const mkt_band_names[MKT_BAND_MAX] = {"freeze", "cold", "warm", "hot"};
+
+const char *mkt_band_name(enum mkt_band band)
+{
+    return band < MKT_BAND_MAX ? mkt_band_names[band] : "?";
+}
+
+/* Arrhenius weight of a temperature in 0.01 degC, Q31 */
+static rt_uint32_t mkt_weight(rt_int32_t temperature)
+{
+    rt_uint32_t k, f, t;
+
+    if (temperature <= MKT_TABLE_MIN)
+        return mkt_table[0];
+    if (temperature >= MKT_TABLE_MAX)
+        return mkt_table[MKT_TABLE_LEN - 1];
+
+    t = temperature - MKT_TABLE_MIN;
+    k = t / MKT_TABLE_STEP;
+    f = t % MKT_TABLE_STEP;
+
+    return mkt_table[k] + (rt_uint32_t)(((rt_uint64_t)(mkt_table[k + 1] - mkt_table[k]) * f
+                                         + MKT_TABLE_STEP / 2) / MKT_TABLE_STEP);
+}
+
+static int mkt_band_of(rt_int32_t temperature)
+{
+    if (temperature < MKT_FREEZE_LIMIT)
+        return MKT_BAND_FREEZE;
+    if (temperature < MKT_LOW_LIMIT)
+        return MKT_BAND_COLD;
+    if (temperature > MKT_HOT_LIMIT)
+        return MKT_BAND_HOT;
+    if (temperature > MKT_HIGH_LIMIT)
+        return MKT_BAND_WARM;
+    return -1;
+}
+
+/* MKT in 0.01 degC from a sum of Q31 weights */
+static rt_int32_t mkt_from_sum(rt_uint64_t sum, rt_uint32_t count)
+{
+    double mean, kelvin;
+
+    if (count == 0 || sum == 0)
+        return MKT_NONE;
+
+    mean = (double)sum / count / MKT_WEIGHT_ONE;
+    kelvin = MKT_E_OVER_R / (MKT_E_OVER_R / MKT_T_TOP - log(mean));
+
+    return (rt_int32_t)floor(kelvin * 100 - MKT_KELVIN + 0.5);
+}
+
+static void mkt_acc_sub(struct mkt_acc *acc, const struct mkt_acc *old)
+{
+    int b;
+
+    acc->sum -= old->sum;
+    acc->count -= old->count;
+    for (b = 0; b < MKT_BAND_MAX; b++)
+        acc->band_ms[b] -= old->band_ms[b];
+}
+
+/* start hour `hour`, dropping the hours that leave each window on the way */
+static void mkt_advance(struct mkt *m, rt_uint32_t hour)
+{
+    rt_uint32_t h;
+
+    if (hour - m->cur_hour >= MKT_HOURS)
+    {
+        /* nothing recent enough is left */
+        rt_memset(m->hour, 0, sizeof(m->hour));
+        rt_memset(m->window, 0, sizeof(m->window));
+        m->cur_hour = hour;
+        return;
+    }
+
+    for (h = m->cur_hour + 1; h != hour + 1; h++)
+    {
+        mkt_acc_sub(&m->window[0], &m->hour[(h + MKT_HOURS - 24) % MKT_HOURS]);
+        mkt_acc_sub(&m->window[1], &m->hour[h % MKT_HOURS]);
+        rt_memset(&m->hour[h % MKT_HOURS], 0, sizeof(m->hour[0]));
+    }
+    m->cur_hour = hour;
+}
+
+static void mkt_engine_add(struct mkt *m, rt_int32_t temperature, rt_tick_t tick)
+{
+    struct mkt_acc *acc[3];
+    rt_uint32_t weight = mkt_weight(temperature);
+    rt_uint32_t dt = 0, hours;
+    int band = mkt_band_of(temperature);
+    int i;
+
+    if (!m->started)
+    {
+        m->started = RT_TRUE;
+        m->cur_hour = tick / MKT_HOUR_TICKS;
+        m->hour_start = tick - tick % MKT_HOUR_TICKS;
+    }
+    else
+    {
+        if (tick - m->last_tick <= MKT_MAX_GAP_TICKS)
+            dt = (tick - m->last_tick) * 1000 / RT_TICK_PER_SECOND;
+        if ((rt_int32_t)(tick - m->hour_start) >= MKT_HOUR_TICKS)
+        {
+            hours = (tick - m->hour_start) / MKT_HOUR_TICKS;
+            m->hour_start += hours * MKT_HOUR_TICKS;
+            mkt_advance(m, m->cur_hour + hours);
+        }
+    }
+    m->last_tick = tick;
+
+    acc[0] = &m->hour[m->cur_hour % MKT_HOURS];
+    acc[1] = &m->window[0];
+    acc[2] = &m->window[1];
+    for (i = 0; i < 3; i++)
+    {
+        acc[i]->sum += weight;
+        acc[i]->count++;
+        if (band >= 0)
+            acc[i]->band_ms[band] += dt;
+    }
+
+    m->all_sum += weight;
+    m->all_count++;
+    if (band >= 0)
+        m->all_band_ms[band] += dt;
+}
+
+static rt_err_t mkt_engine_get(struct mkt *m, enum mkt_window window, struct mkt_report *report)
+{
+    rt_uint64_t ms, total_ms = 0;
+    int b;
+
+    if (window >= MKT_WINDOW_MAX)
+        return -RT_EINVAL;
+
+    if (window == MKT_WINDOW_ALL)
+    {
+        report->mkt = mkt_from_sum(m->all_sum, m->all_count);
+        report->samples = m->all_count;
+    }
+    else
+    {
+        report->mkt = mkt_from_sum(m->window[window].sum, m->window[window].count);
+        report->samples = m->window[window].count;
+    }
+
+    for (b = 0; b < MKT_BAND_MAX; b++)
+    {
+        ms = window == MKT_WINDOW_ALL ? m->all_band_ms[b] : m->window[window].band_ms[b];
+        report->excursion_min[b] = ms / 60000;
+        total_ms += ms;
+    }
+    report->excursion_total_min = total_ms / 60000;
+
+    return report->samples ? RT_EOK : -RT_EEMPTY;
+}
+
+int mkt_init(void)
+{
+    double kelvin;
+    int i;
+
+    for (i = 0; i < MKT_TABLE_LEN; i++)
+    {
+        kelvin = (MKT_TABLE_MIN + i * MKT_TABLE_STEP + MKT_KELVIN) / 100.0;
+        mkt_table[i] = (rt_uint32_t)(exp(MKT_E_OVER_R * (1 / MKT_T_TOP - 1 / kelvin)) * MKT_WEIGHT_ONE + 0.5);
+    }
+
+    return rt_mutex_init(&mkt_lock, "mkt", RT_IPC_FLAG_PRIO);
+}
+
+/**
+ * Add one temperature sample, in 0.01 degC, taken at `tick`. Samples must
+ * come in time order.
+ */
+void mkt_add(rt_int32_t temperature, rt_tick_t tick)
+{
+    rt_mutex_take(&mkt_lock, RT_WAITING_FOREVER);
+    mkt_engine_add(&mkt, temperature, tick);
+    rt_mutex_release(&mkt_lock);
+}
+
+/**
+ * Report MKT and excursion minutes over a window.
+ *
+ * @return RT_EOK, or -RT_EEMPTY when the window holds no samples (the
+ *         report then has mkt = MKT_NONE).
+ */
+rt_err_t mkt_get(enum mkt_window window, struct mkt_report *report)
+{
+    rt_err_t result;
+
+    rt_mutex_take(&mkt_lock, RT_WAITING_FOREVER);
+    result = mkt_engine_get(&mkt, window, report);
+    rt_mutex_release(&mkt_lock);
+
+    return result;
+}
+
+#ifdef RT_USING_FINSH
+static void mkt_print_centi(const char *label, rt_int32_t value)
+{
+    rt_uint32_t mag = value < 0 ? -(rt_uint32_t)value : (rt_uint32_t)value;
+
+    if (value == MKT_NONE)
+        rt_kprintf("%s --", label);
+    else
+        rt_kprintf("%s %s%u.%02u C", label, value < 0 ? "-" : "", mag / 100, mag % 100);
+}
+
+static void mkt_cmd(int argc, char **argv)
+{
+    static const char *const names[MKT_WINDOW_MAX] = {"24 h", "7 d", "boot"};
+    struct mkt_report report;
+    int w, b;
+
+    if (argc == 3 && !rt_strcmp(argv[1], "add"))
+        mkt_add(atoi(argv[2]), rt_tick_get());
+
+    rt_kprintf("range %d..%d, freeze below %d, hot above %d (0.01 degC), Ea %d J/mol\n",
+               MKT_LOW_LIMIT, MKT_HIGH_LIMIT, MKT_FREEZE_LIMIT, MKT_HOT_LIMIT, MKT_ACTIVATION_ENERGY);
+    for (w = 0; w < MKT_WINDOW_MAX; w++)
+    {
+        mkt_get(w, &report);
+        mkt_print_centi(names[w], report.mkt);
+        rt_kprintf(", %d samples, out of range %d min (", report.samples, report.excursion_total_min);
+        for (b = 0; b < MKT_BAND_MAX; b++)
+            rt_kprintf("%s%s %d", b ? ", " : "", mkt_band_name(b), report.excursion_min[b]);
+        rt_kprintf(")\n");
+    }
+}
+MSH_CMD_EXPORT_ALIAS(mkt_cmd, mkt, mean kinetic temperature and excursions);
+#endif /* RT_USING_FINSH */
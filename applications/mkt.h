@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        streaming MKT and excursion budget
+ */
+#ifndef APPLICATIONS_MKT_H_
+#define APPLICATIONS_MKT_H_
+
+#include <rtthread.h>
+
+#ifndef MKT_ACTIVATION_ENERGY
+#define MKT_ACTIVATION_ENERGY       83144   /* J/mol, the USP default */
+#endif
+#ifndef MKT_LOW_LIMIT
+#define MKT_LOW_LIMIT               200     /* 0.01 degC */
+#endif
+#ifndef MKT_HIGH_LIMIT
+#define MKT_HIGH_LIMIT              800
+#endif
+#ifndef MKT_FREEZE_LIMIT
+#define MKT_FREEZE_LIMIT            0
+#endif
+#ifndef MKT_HOT_LIMIT
+#define MKT_HOT_LIMIT               2500
+#endif
+
+/* a gap longer than this between samples is not counted as excursion time */
+#define MKT_MAX_GAP_MS              60000
+
+#define MKT_NONE                    ((rt_int32_t)0x80000000)
+
+/* out-of-range bands, exclusive: a freezing sample is not also "cold" */
+enum mkt_band
+{
+    MKT_BAND_FREEZE = 0,            /* below MKT_FREEZE_LIMIT */
+    MKT_BAND_COLD,                  /* MKT_FREEZE_LIMIT .. MKT_LOW_LIMIT */
+    MKT_BAND_WARM,                  /* MKT_HIGH_LIMIT .. MKT_HOT_LIMIT */
+    MKT_BAND_HOT,                   /* above MKT_HOT_LIMIT */
+
+    MKT_BAND_MAX
+};
+
+enum mkt_window
+{
+    MKT_WINDOW_24H = 0,             /* the current hour and the 23 before it */
+    MKT_WINDOW_7D,                  /* the current hour and the 167 before it */
+    MKT_WINDOW_ALL,                 /* since boot */
+
+    MKT_WINDOW_MAX
+};
+
+struct mkt_report
+{
+    rt_int32_t mkt;                 /* 0.01 degC, MKT_NONE without samples */
+    rt_uint32_t samples;
+    rt_uint32_t excursion_min[MKT_BAND_MAX];
+    rt_uint32_t excursion_total_min;
+};
+
+int mkt_init(void);
+void mkt_add(rt_int32_t temperature, rt_tick_t tick);
+rt_err_t mkt_get(enum mkt_window window, struct mkt_report *report);
+const char *mkt_band_name(enum mkt_band band);
+
+#endif /* APPLICATIONS_MKT_H_ */
@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        per-thread cpu time and wakeup latency
+ */
+/*
+ * msh>top [seconds]
+ * msh>prof reset|dump
+ *
+ * Profiles the scheduler from the kernel hooks, timed with the cputime
+ * clock (the microsecond timer on this board):
+ *
+ *   thread   run time of every thread, the idle thread included, with the
+ *            time spent in interrupts taken out; the switches into it; and
+ *            its wakeup latency, from rt_thread_resume() making it ready
+ *            to the scheduler switching to it
+ *   irq      time, count and longest run of each interrupt that goes
+ *            through rt_interrupt_enter/leave, nested ones taken out of
+ *            the one they interrupted
+ *   latency  a histogram of every wakeup latency, in powers of two
+ *   crit     the longest the tick interrupt waited to be taken, in CPU
+ *            cycles from the SysTick count; the tick is masked by every
+ *            interrupt-off section and by the interrupts in front of it,
+ *            so over a long run this is the worst of them
+ *
+ * "top" shows the share of the CPU over the next few seconds (one by
+ * default); the rest since the last reset. "prof dump" prints everything
+ * since the reset as hex lines starting "PROF ", one binary image for
+ * offline analysis, all fields little-endian:
+ *
+ *   head     "RTPF", u16 version 1, u16 threads, u16 irqs, u16 buckets,
+ *            u32 ns per cputime tick, u64 now, u64 reset time, u64 time in
+ *            interrupts, u32 crit cycles, u32 clk_sys Hz, u32 threads not
+ *            followed
+ *   thread   char name[RT_NAME_MAX], u64 run, u32 switches, u32 wakeups,
+ *            u64 wakeup latency sum, u32 wakeup latency max
+ *   irq      u8 exception number (IRQ n is 16 + n), u32 count, u64 time,
+ *            u32 longest
+ *   bucket   u32 wakeups with latency below 2^i ticks, the last one all above
+ *
+ * Times are in cputime ticks. Interrupts that never call
+ * rt_interrupt_enter() are counted in the thread they interrupted.
+ */
+#include <stdlib.h>
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+
+#ifdef APP_USING_PROFILER
+
+#define PROF_IRQ_MAX            48      /* the 16 exceptions and 32 IRQs */
+#define PROF_NEST_MAX           8
+#define PROF_BUCKETS            16
+#define PROF_ISR_SYSTICK        15      /* SysTick exception number */
+#define PROF_DUMP_LINE          32
+
+struct prof_thread
+{
+    rt_thread_t thread;                 /* RT_NULL for a free entry */
+    char name[RT_NAME_MAX];
+    rt_uint64_t run;
+    rt_uint32_t switches;
+    rt_uint32_t wakeups;
+    rt_uint64_t wake_total;
+    rt_uint32_t wake_max;
+    rt_uint64_t ready_at;               /* when it was made ready, 0 once running */
+};
+
+struct prof_irq
+{
+    rt_uint64_t time;
+    rt_uint32_t count;
+    rt_uint32_t max;
+};
+
+struct prof_nest
+{
+    rt_uint64_t start;
+    rt_uint64_t inner;                  /* time in the interrupts nested in it */
+    rt_uint8_t irq;
+};
+
+static struct
+{
+    rt_uint64_t since;
+    rt_uint64_t switched_at;            /* start of the current thread's run */
+    rt_uint64_t irq_at_switch;          /* irq_total at the time */
+    rt_uint64_t irq_total;              /* time in interrupts, outermost only */
+    struct prof_thread *current;
+    int nest;
+    struct prof_nest stack[PROF_NEST_MAX];
+    struct prof_irq irq[PROF_IRQ_MAX];
+    rt_uint32_t buckets[PROF_BUCKETS];
+    rt_uint32_t crit_max;
+    rt_uint32_t lost;
+    struct prof_thread threads[PROFILER_THREAD_MAX];
+} prof;
+
+rt_inline rt_uint64_t prof_now(void)
+{
+    return clock_cpu_gettime();
+}
+
+rt_inline rt_uint32_t prof_ipsr(void)
+{
+    rt_uint32_t ipsr;
+
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return ipsr & 0x3f;
+}
+
+static int prof_bucket(rt_uint64_t ticks)
+{
+    int i;
+
+    for (i = 0; i < PROF_BUCKETS - 1 && ticks >= (1ULL << i); i++);
+    return i;
+}
+
+/* the entry of a thread, taken over if its thread has gone and another
+ * one has the same control block now; called with interrupts off */
+static struct prof_thread *prof_thread_get(rt_thread_t thread)
+{
+    struct prof_thread *free = RT_NULL, *t;
+
+    for (t = prof.threads; t < prof.threads + PROFILER_THREAD_MAX; t++)
+    {
+        if (t->thread == thread)
+        {
+            if (rt_strncmp(t->name, thread->parent.name, RT_NAME_MAX) == 0)
+                return t;
+            free = t;
+            break;
+        }
+        if (t->thread == RT_NULL && free == RT_NULL)
+            free = t;
+    }
+    if (free == RT_NULL)
+    {
+        prof.lost++;
+        return RT_NULL;
+    }
+
+    rt_memset(free, 0, sizeof(*free));
+    free->thread = thread;
+    rt_strncpy(free->name, thread->parent.name, RT_NAME_MAX);
+
+    return free;
+}
+
+/* the interrupt time so far, the one running now included */
+rt_inline rt_uint64_t prof_irq_time(rt_uint64_t now)
+{
+    return prof.irq_total + (prof.nest > 0 ? now - prof.stack[0].start : 0);
+}
+
+/* charge the running thread up to now; interrupts off */
+static void prof_charge(rt_uint64_t now)
+{
+    rt_uint64_t irq = prof_irq_time(now);
+
+    if (prof.current != RT_NULL)
+        prof.current->run += (now - prof.switched_at) - (irq - prof.irq_at_switch);
+    prof.switched_at = now;
+    prof.irq_at_switch = irq;
+}
+
+/* with interrupts off, from rt_schedule() in a thread or an interrupt */
+static void prof_scheduler_hook(struct rt_thread *from, struct rt_thread *to)
+{
+    rt_uint64_t now = prof_now(), latency;
+    struct prof_thread *t;
+
+    prof_charge(now);
+
+    t = prof.current = prof_thread_get(to);
+    if (t == RT_NULL)
+        return;
+    t->switches++;
+    if (t->ready_at != 0)
+    {
+        latency = now - t->ready_at;
+        t->ready_at = 0;
+        t->wakeups++;
+        t->wake_total += latency;
+        if (latency > t->wake_max)
+            t->wake_max = latency;
+        prof.buckets[prof_bucket(latency)]++;
+    }
+}
+
+static void prof_resume_hook(struct rt_thread *thread)
+{
+    struct prof_thread *t;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    t = prof_thread_get(thread);
+    if (t != RT_NULL)
+        t->ready_at = prof_now();
+    rt_hw_interrupt_enable(level);
+}
+
+/* both with interrupts off, inside the interrupt */
+static void prof_irq_enter(void)
+{
+    rt_uint32_t ipsr = prof_ipsr(), late;
+    struct prof_nest *n;
+
+    if (ipsr == PROF_ISR_SYSTICK)
+    {
+        /* SysTick counts down from the reload value since it fired */
+        late = mpu_hw->rvr - mpu_hw->cvr;
+        if (late > prof.crit_max)
+            prof.crit_max = late;
+    }
+
+    if (prof.nest < PROF_NEST_MAX)
+    {
+        n = &prof.stack[prof.nest];
+        n->start = prof_now();
+        n->inner = 0;
+        n->irq = ipsr;
+    }
+    prof.nest++;
+}
+
+static void prof_irq_leave(void)
+{
+    struct prof_irq *irq;
+    struct prof_nest *n;
+    rt_uint64_t time;
+
+    if (prof.nest == 0)
+        return;
+    prof.nest--;
+    if (prof.nest >= PROF_NEST_MAX)
+        return;
+
+    n = &prof.stack[prof.nest];
+    time = prof_now() - n->start;
+    irq = &prof.irq[n->irq];
+    irq->time += time - n->inner;
+    irq->count++;
+    if (time - n->inner > irq->max)
+        irq->max = time - n->inner;
+
+    if (prof.nest > 0)
+        prof.stack[prof.nest - 1].inner += time;
+    else
+        prof.irq_total += time;
+}
+
+static void prof_reset(void)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rt_memset(prof.irq, 0, sizeof(prof.irq));
+    rt_memset(prof.buckets, 0, sizeof(prof.buckets));
+    rt_memset(prof.threads, 0, sizeof(prof.threads));
+    prof.crit_max = prof.lost = 0;
+    prof.irq_total = 0;
+    prof.nest = 0;
+    prof.since = prof.switched_at = prof_now();
+    prof.irq_at_switch = 0;
+    prof.current = prof_thread_get(rt_thread_self());
+    rt_hw_interrupt_enable(level);
+}
+
+static int prof_init(void)
+{
+    prof_reset();
+    rt_scheduler_sethook(prof_scheduler_hook);
+    rt_thread_resume_sethook(prof_resume_hook);
+    rt_interrupt_enter_sethook(prof_irq_enter);
+    rt_interrupt_leave_sethook(prof_irq_leave);
+
+    return RT_EOK;
+}
+INIT_APP_EXPORT(prof_init);
+
+#ifdef RT_USING_FINSH
+/* tenths of a percent */
+rt_inline int prof_permille(rt_uint64_t part, rt_uint64_t whole)
+{
+    return whole ? (int)(part * 1000 / whole) : 0;
+}
+
+static void top(int argc, char **argv)
+{
+    static rt_uint64_t run[PROFILER_THREAD_MAX], irq[PROF_IRQ_MAX];
+    static rt_thread_t thread[PROFILER_THREAD_MAX];
+    rt_uint64_t start, window, total;
+    struct prof_thread *t;
+    rt_base_t level;
+    int i, seconds, p;
+
+    seconds = argc > 1 ? atoi(argv[1]) : 1;
+    if (seconds <= 0)
+    {
+        rt_kprintf("usage: top [seconds]\n");
+        return;
+    }
+
+    level = rt_hw_interrupt_disable();
+    start = prof_now();
+    prof_charge(start);
+    for (i = 0; i < PROFILER_THREAD_MAX; i++)
+    {
+        thread[i] = prof.threads[i].thread;
+        run[i] = prof.threads[i].run;
+    }
+    for (i = 0; i < PROF_IRQ_MAX; i++)
+        irq[i] = prof.irq[i].time;
+    rt_hw_interrupt_enable(level);
+
+    rt_thread_mdelay(seconds * 1000);
+
+    level = rt_hw_interrupt_disable();
+    window = prof_now();
+    prof_charge(window);
+    window -= start;
+    rt_hw_interrupt_enable(level);
+
+    total = prof_now() - prof.since;
+    rt_kprintf("%d ms, %d s since reset, crit %d cycles at %d MHz\n",
+               (int)clock_cpu_millisecond(window), (int)(clock_cpu_millisecond(total) / 1000),
+               prof.crit_max, clock_get_hz(clk_sys) / 1000000);
+    rt_kprintf("%-*.*s  cpu%%   switch  wakeup  wait avg/max us\n", RT_NAME_MAX, RT_NAME_MAX, "thread");
+    for (i = 0; i < PROFILER_THREAD_MAX; i++)
+    {
+        t = &prof.threads[i];
+        if (t->thread == RT_NULL)
+            continue;
+        p = prof_permille(t->run - (t->thread == thread[i] ? run[i] : 0), window);
+        rt_kprintf("%-*.*s %3d.%d %8d %7d  %d/%d\n", RT_NAME_MAX, RT_NAME_MAX, t->name,
+                   p / 10, p % 10, t->switches, t->wakeups,
+                   t->wakeups ? (int)clock_cpu_microsecond(t->wake_total / t->wakeups) : 0,
+                   (int)clock_cpu_microsecond(t->wake_max));
+    }
+    rt_kprintf("irq       cpu%%    count  avg/max us\n");
+    for (i = 0; i < PROF_IRQ_MAX; i++)
+    {
+        if (prof.irq[i].count == 0)
+            continue;
+        p = prof_permille(prof.irq[i].time - irq[i], window);
+        if (i < 16)
+            rt_kprintf("exc %-3d %3d.%d %8d  %d/%d\n", i, p / 10, p % 10, prof.irq[i].count,
+                       (int)clock_cpu_microsecond(prof.irq[i].time / prof.irq[i].count),
+                       (int)clock_cpu_microsecond(prof.irq[i].max));
+        else
+            rt_kprintf("irq %-3d %3d.%d %8d  %d/%d\n", i - 16, p / 10, p % 10, prof.irq[i].count,
+                       (int)clock_cpu_microsecond(prof.irq[i].time / prof.irq[i].count),
+                       (int)clock_cpu_microsecond(prof.irq[i].max));
+    }
+    rt_kprintf("wakeup latency, us:");
+    for (i = 0; i < PROF_BUCKETS; i++)
+    {
+        if (prof.buckets[i] == 0)
+            continue;
+        if (i < PROF_BUCKETS - 1)
+            rt_kprintf(" <%d:%d", (int)clock_cpu_microsecond(1ULL << i), prof.buckets[i]);
+        else
+            rt_kprintf(" more:%d", prof.buckets[i]);
+    }
+    rt_kprintf("\n");
+    if (prof.lost)
+        rt_kprintf("%d switches to threads past PROFILER_THREAD_MAX\n", prof.lost);
+}
+MSH_CMD_EXPORT(top, cpu use of threads and interrupts: top [seconds]);
+
+static struct
+{
+    rt_uint8_t line[PROF_DUMP_LINE];
+    int len;
+} prof_dump_out;
+
+static void prof_dump_flush(void)
+{
+    int i;
+
+    if (prof_dump_out.len == 0)
+        return;
+    rt_kprintf("PROF ");
+    for (i = 0; i < prof_dump_out.len; i++)
+        rt_kprintf("%02x", prof_dump_out.line[i]);
+    rt_kprintf("\n");
+    prof_dump_out.len = 0;
+}
+
+/* little-endian, whatever the width */
+static void prof_dump_put(rt_uint64_t value, int size)
+{
+    while (size--)
+    {
+        prof_dump_out.line[prof_dump_out.len++] = (rt_uint8_t)value;
+        value >>= 8;
+        if (prof_dump_out.len == PROF_DUMP_LINE)
+            prof_dump_flush();
+    }
+}
+
+static void prof_dump(void)
+{
+    struct prof_thread *t;
+    rt_base_t level;
+    int i, n = 0;
+
+    level = rt_hw_interrupt_disable();
+    prof_charge(prof_now());
+    rt_hw_interrupt_enable(level);
+
+    for (i = 0; i < PROFILER_THREAD_MAX; i++)
+        n += prof.threads[i].thread != RT_NULL;
+
+    prof_dump_out.len = 0;
+    prof_dump_put('R' | 'T' << 8 | 'P' << 16 | (rt_uint32_t)'F' << 24, 4);
+    prof_dump_put(1, 2);
+    prof_dump_put(n, 2);
+    prof_dump_put(PROF_IRQ_MAX, 2);
+    prof_dump_put(PROF_BUCKETS, 2);
+    prof_dump_put(clock_cpu_getres() / (1000UL * 1000), 4);
+    prof_dump_put(prof_now(), 8);
+    prof_dump_put(prof.since, 8);
+    prof_dump_put(prof.irq_total, 8);
+    prof_dump_put(prof.crit_max, 4);
+    prof_dump_put(clock_get_hz(clk_sys), 4);
+    prof_dump_put(prof.lost, 4);
+    for (i = 0; i < PROFILER_THREAD_MAX; i++)
+    {
+        t = &prof.threads[i];
+        if (t->thread == RT_NULL)
+            continue;
+        for (n = 0; n < RT_NAME_MAX; n++)
+            prof_dump_put(t->name[n], 1);
+        prof_dump_put(t->run, 8);
+        prof_dump_put(t->switches, 4);
+        prof_dump_put(t->wakeups, 4);
+        prof_dump_put(t->wake_total, 8);
+        prof_dump_put(t->wake_max, 4);
+    }
+    for (i = 0; i < PROF_IRQ_MAX; i++)
+    {
+        prof_dump_put(i, 1);
+        prof_dump_put(prof.irq[i].count, 4);
+        prof_dump_put(prof.irq[i].time, 8);
+        prof_dump_put(prof.irq[i].max, 4);
+    }
+    for (i = 0; i < PROF_BUCKETS; i++)
+        prof_dump_put(prof.buckets[i], 4);
+    prof_dump_flush();
+}
+
+static void prof_cmd(int argc, char **argv)
+{
+    if (argc == 2 && !rt_strcmp(argv[1], "reset"))
+        prof_reset();
+    else if (argc == 2 && !rt_strcmp(argv[1], "dump"))
+        prof_dump();
+    else
+        rt_kprintf("usage: prof reset|dump\n");
+}
+MSH_CMD_EXPORT_ALIAS(prof_cmd, prof, reset or dump the profile: prof reset|dump);
+#endif /* RT_USING_FINSH */
+
+#endif /* APP_USING_PROFILER */
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        lock-free snapshot of the latest reading
+ * 2026-10-17     khair        fence before a slot is refilled
+ * 2026-10-17     khair        stress test left to tests/host
+ */
+/*
+ * A generation-counted double buffer. The writer fills the slot that is
+ * not published, then bumps the generation to publish it. A reader loads
+ * the generation, copies the slot it names and loads the generation again;
+ * if it moved, the writer may have started on that slot, so the copy is
+ * thrown away and taken again.
+ *
+ * Unlike a seqlock there is no "write in progress" state: the published
+ * slot is always complete. A reader that preempts the writer mid-update
+ * copies the previous reading and is done, instead of spinning on a
+ * thread that cannot run. A reader retries only when a newer reading was
+ * published during its copy. Neither side takes a lock or disables
+ * interrupts.
+ *
+ * The fields are copied with relaxed atomic accesses and ordered by
+ * fences. The writer needs two: one before it refills a slot, pairing with
+ * the reader's fence before its re-check, and the release that publishes
+ * the generation. tests/host/reading_stress.c runs them on host threads.
+ */
+#include <rtthread.h>
+
+#include "reading.h"
+
+#define DBG_TAG "reading"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#define READING_LOAD(x)         __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define READING_STORE(x, v)     __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+
+void reading_snapshot_init(struct reading_snapshot *snap)
+{
+    rt_memset(snap, 0, sizeof(*snap));
+}
+
+/**
+ * Publish a new reading. Single writer only; never waits for readers.
+ */
+void reading_publish(struct reading_snapshot *snap, const struct reading *reading)
+{
+    rt_uint32_t gen = READING_LOAD(snap->gen);
+    struct reading *slot = &snap->slot[(gen + 1) & 1];
+
+    /* a reader that sees any of the stores below also sees the generation
+     * that retired the slot, so its re-check fails and it copies again */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    READING_STORE(slot->temperature, reading->temperature);
+    READING_STORE(slot->humidity, reading->humidity);
+    READING_STORE(slot->tick, reading->tick);
+    READING_STORE(slot->flags, reading->flags);
+
+    /* the slot is complete before the new generation names it */
+    __atomic_store_n(&snap->gen, gen + 1, __ATOMIC_RELEASE);
+}
+
+static rt_uint32_t reading_copy(struct reading_snapshot *snap, struct reading *reading, rt_uint32_t *retries)
+{
+    const struct reading *slot;
+    rt_uint32_t gen;
+
+    while (1)
+    {
+        gen = __atomic_load_n(&snap->gen, __ATOMIC_ACQUIRE);
+        slot = &snap->slot[gen & 1];
+
+        reading->temperature = READING_LOAD(slot->temperature);
+        reading->humidity = READING_LOAD(slot->humidity);
+        reading->tick = READING_LOAD(slot->tick);
+        reading->flags = READING_LOAD(slot->flags);
+
+        /* the copy is done before the generation is checked again */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (READING_LOAD(snap->gen) == gen)
+            return gen;
+        (*retries)++;
+    }
+}
+
+/**
+ * Copy the latest reading.
+ *
+ * @return the number of readings published so far, 0 when there is none
+ *         yet (the copy is then all zero); a reader can compare it with the
+ *         last value it saw to tell whether the reading is new.
+ */
+rt_uint32_t reading_get(struct reading_snapshot *snap, struct reading *reading)
+{
+    rt_uint32_t retries = 0;
+
+    return reading_copy(snap, reading, &retries);
+}
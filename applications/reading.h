@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        lock-free snapshot of the latest reading
+ */
+#ifndef APPLICATIONS_READING_H_
+#define APPLICATIONS_READING_H_
+
+#include <rtthread.h>
+
+/* reading flags */
+#define READING_TEMP_VALID          0x01
+#define READING_HUMID_VALID         0x02
+
+struct reading
+{
+    rt_int32_t temperature;         /* 0.01 degC */
+    rt_int32_t humidity;            /* 0.01 %RH */
+    rt_tick_t tick;                 /* when it was taken */
+    rt_uint32_t flags;              /* READING_* */
+};
+
+/*
+ * The latest reading, published by one writer and read by any number of
+ * readers without locks. Only the writer may call reading_publish().
+ */
+struct reading_snapshot
+{
+    rt_uint32_t gen;                /* readings published, the newest is in slot[gen & 1] */
+    struct reading slot[2];
+};
+
+void reading_snapshot_init(struct reading_snapshot *snap);
+void reading_publish(struct reading_snapshot *snap, const struct reading *reading);
+rt_uint32_t reading_get(struct reading_snapshot *snap, struct reading *reading);
+
+#endif /* APPLICATIONS_READING_H_ */
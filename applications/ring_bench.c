@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        rt_spscring against rt_ringbuffer
+ */
+/*
+ * msh>ring_bench [kbytes]
+ * msh>ring_bench stress [seconds]
+ *
+ * The first form pushes kbytes (64 by default) through a ring in chunks
+ * of 1, 16 and 128 bytes; each chunk comes from a source buffer, as from a
+ * DMA block or a FIFO, and is summed on the way out, as by a parser:
+ *
+ *   rb+irq    rt_ringbuffer with interrupts off around every call, which
+ *             an interrupt on the other side needs
+ *   rb        rt_ringbuffer with no lock
+ *   spsc      rt_spscring_put/get, no lock needed
+ *   inplace   rt_spscring_reserve/commit and peek_span/consume, the sum
+ *             taken in the ring without the copy out
+ *
+ * and prints the CPU cycles per chunk, from the microsecond timer.
+ *
+ * "stress" checks the ordering contract for some seconds (5 by default):
+ * a producer in the tick interrupt writes a byte sequence in bursts of
+ * random size through reserve/commit, and this thread checks every byte it
+ * peeks. It prints the bytes checked, the bad ones, and the most the ring
+ * held. Sleep modes are held off meanwhile. Thread against thread, and
+ * the throughput between two threads, are tests/host/spscring_stress and
+ * tests/host/ring_bench.
+ */
+#include <stdlib.h>
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "hardware/clocks.h"
+#include "hardware/timer.h"
+
+#if defined(RT_USING_FINSH) && defined(RING_USING_BENCH)
+
+#define RING_BENCH_SIZE         1024    /* bytes in the ring */
+#define RING_BENCH_CHUNK_MAX    128
+#define RING_BENCH_BURST        (RING_BENCH_SIZE / 4)
+
+enum ring_bench_kind
+{
+    RING_BENCH_RB_IRQ,
+    RING_BENCH_RB,
+    RING_BENCH_SPSC,
+    RING_BENCH_INPLACE,
+};
+
+static const char *const ring_bench_name[] = {"rb+irq", "rb", "spsc", "inplace"};
+
+static rt_uint8_t ring_bench_pool[RING_BENCH_SIZE];
+static rt_uint8_t ring_bench_src[RING_BENCH_CHUNK_MAX];
+static rt_uint8_t ring_bench_dst[RING_BENCH_CHUNK_MAX];
+static volatile rt_uint32_t ring_bench_sink;
+
+static struct
+{
+    struct rt_spscring ring;
+    rt_uint32_t written;                /* next byte of the sequence */
+    rt_uint32_t seed;
+} ring_bench_stress;
+
+static rt_uint32_t ring_bench_sum(const rt_uint8_t *p, rt_size_t n)
+{
+    rt_uint32_t sum = 0;
+
+    while (n--)
+        sum += *p++;
+    return sum;
+}
+
+/* microseconds to move total bytes through the ring in chunks */
+static rt_uint32_t ring_bench_run(enum ring_bench_kind kind, rt_uint32_t total, rt_size_t chunk)
+{
+    struct rt_ringbuffer rb;
+    struct rt_spscring spsc;
+    rt_uint32_t start, moved, sum = 0;
+    rt_uint8_t *span;
+    rt_base_t level;
+    rt_size_t n;
+
+    rt_ringbuffer_init(&rb, ring_bench_pool, sizeof(ring_bench_pool));
+    rt_spscring_init(&spsc, ring_bench_pool, sizeof(ring_bench_pool));
+
+    start = time_us_32();
+    for (moved = 0; moved < total; moved += chunk)
+    {
+        switch (kind)
+        {
+        case RING_BENCH_RB_IRQ:
+            level = rt_hw_interrupt_disable();
+            rt_ringbuffer_put(&rb, ring_bench_src, chunk);
+            rt_hw_interrupt_enable(level);
+            level = rt_hw_interrupt_disable();
+            n = rt_ringbuffer_get(&rb, ring_bench_dst, chunk);
+            rt_hw_interrupt_enable(level);
+            sum += ring_bench_sum(ring_bench_dst, n);
+            break;
+
+        case RING_BENCH_RB:
+            rt_ringbuffer_put(&rb, ring_bench_src, chunk);
+            n = rt_ringbuffer_get(&rb, ring_bench_dst, chunk);
+            sum += ring_bench_sum(ring_bench_dst, n);
+            break;
+
+        case RING_BENCH_SPSC:
+            rt_spscring_put(&spsc, ring_bench_src, chunk);
+            n = rt_spscring_get(&spsc, ring_bench_dst, chunk);
+            sum += ring_bench_sum(ring_bench_dst, n);
+            break;
+
+        case RING_BENCH_INPLACE:
+            /* the chunk size divides the ring, so a span never wraps */
+            n = rt_spscring_reserve(&spsc, &span, chunk);
+            rt_memcpy(span, ring_bench_src, n);
+            rt_spscring_commit(&spsc, n);
+            n = rt_spscring_peek_span(&spsc, &span);
+            sum += ring_bench_sum(span, n);
+            rt_spscring_consume(&spsc, n);
+            break;
+        }
+    }
+    ring_bench_sink = sum;
+
+    return time_us_32() - start;
+}
+
+static void ring_bench_throughput(rt_uint32_t total)
+{
+    static const rt_size_t chunks[] = {1, 16, RING_BENCH_CHUNK_MAX};
+    rt_uint32_t mhz = clock_get_hz(clk_sys) / 1000000, us;
+    int i, kind;
+
+    for (i = 0; i < sizeof(ring_bench_src); i++)
+        ring_bench_src[i] = i;
+
+    rt_kprintf("%d KB through a %d byte ring, cycles per chunk at %d MHz\n",
+               total / 1024, RING_BENCH_SIZE, mhz);
+    for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++)
+    {
+        rt_kprintf("chunk %3d:", chunks[i]);
+        for (kind = RING_BENCH_RB_IRQ; kind <= RING_BENCH_INPLACE; kind++)
+        {
+            us = ring_bench_run((enum ring_bench_kind)kind, total, chunks[i]);
+            rt_kprintf(" %s %d", ring_bench_name[kind],
+                       (int)((rt_uint64_t)us * mhz * chunks[i] / total));
+        }
+        rt_kprintf("\n");
+    }
+}
+
+/* one burst of the sequence, whatever fits of it; returns the bytes written */
+static rt_size_t ring_bench_produce(void)
+{
+    rt_uint32_t want, start = ring_bench_stress.written;
+    rt_uint8_t *span;
+    rt_size_t n, i;
+
+    ring_bench_stress.seed = ring_bench_stress.seed * 1103515245 + 12345;
+    want = 1 + (ring_bench_stress.seed >> 8) % RING_BENCH_BURST;
+    while (want > 0 && (n = rt_spscring_reserve(&ring_bench_stress.ring, &span, want)) > 0)
+    {
+        for (i = 0; i < n; i++)
+            span[i] = (rt_uint8_t)(ring_bench_stress.written + i);
+        rt_spscring_commit(&ring_bench_stress.ring, n);
+        ring_bench_stress.written += n;
+        want -= n;
+    }
+
+    return ring_bench_stress.written - start;
+}
+
+static void ring_bench_timeout(void *parameter)
+{
+    (void)ring_bench_produce();
+}
+
+/* check what the producer writes until the time is up */
+static void ring_bench_check(const char *name, rt_tick_t ticks)
+{
+    rt_uint32_t read = 0, bad = 0, fill = 0, seed = 1;
+    rt_tick_t end = rt_tick_get() + ticks;
+    rt_uint8_t *span;
+    rt_size_t n, i;
+
+    while ((rt_int32_t)(rt_tick_get() - end) < 0)
+    {
+        if (rt_spscring_data_len(&ring_bench_stress.ring) > fill)
+            fill = rt_spscring_data_len(&ring_bench_stress.ring);
+
+        n = rt_spscring_peek_span(&ring_bench_stress.ring, &span);
+        if (n == 0)
+        {
+            rt_thread_delay(1);
+            continue;
+        }
+
+        /* random steps, so spans split at every offset */
+        seed = seed * 1103515245 + 12345;
+        if (n > 1 + (seed >> 8) % RING_BENCH_BURST)
+            n = 1 + (seed >> 8) % RING_BENCH_BURST;
+        for (i = 0; i < n; i++)
+        {
+            if (span[i] != (rt_uint8_t)(read + i))
+                bad++;
+        }
+        rt_spscring_consume(&ring_bench_stress.ring, n);
+        read += n;
+    }
+
+    rt_kprintf("%-14s %u bytes checked, %u bad, ring held up to %u of %d\n",
+               name, read, bad, fill, RING_BENCH_SIZE);
+}
+
+static void ring_bench_stress_run(int seconds)
+{
+    rt_tick_t ticks = rt_tick_from_millisecond(seconds * 1000);
+    struct rt_timer timer;
+
+    rt_spscring_init(&ring_bench_stress.ring, ring_bench_pool, sizeof(ring_bench_pool));
+    ring_bench_stress.written = 0;
+    ring_bench_stress.seed = 7;
+    rt_timer_init(&timer, "rbench", ring_bench_timeout, RT_NULL, 1,
+                  RT_TIMER_FLAG_PERIODIC | RT_TIMER_FLAG_HARD_TIMER);
+    rt_timer_start(&timer);
+    ring_bench_check("tick -> thread", ticks);
+    rt_timer_stop(&timer);
+    rt_timer_detach(&timer);
+}
+
+static void ring_bench(int argc, char **argv)
+{
+    int n;
+
+#ifdef RT_USING_PM
+    rt_pm_request(PM_SLEEP_MODE_NONE);
+#endif
+    if (argc > 1 && !rt_strcmp(argv[1], "stress"))
+    {
+        n = argc > 2 ? atoi(argv[2]) : 5;
+        ring_bench_stress_run(n > 0 ? n : 5);
+    }
+    else if (argc < 2 || atoi(argv[1]) > 0)
+    {
+        n = argc > 1 ? atoi(argv[1]) : 64;
+        ring_bench_throughput(n * 1024);
+    }
+    else
+    {
+        rt_kprintf("usage: ring_bench [kbytes] | stress [seconds]\n");
+    }
+#ifdef RT_USING_PM
+    rt_pm_release(PM_SLEEP_MODE_NONE);
+#endif
+}
+MSH_CMD_EXPORT(ring_bench, time rt_spscring against rt_ringbuffer: ring_bench [kbytes] | stress [seconds]);
+
+#endif /* RT_USING_FINSH && RING_USING_BENCH */
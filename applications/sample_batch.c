@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        batch samples into ThingSpeak bulk updates
+ * 2026-10-17     khair        refuse to post without a channel id
+ * 2026-10-17     khair        fall back to /update without a channel id
+ */
+/*
+ * Readings are queued in RAM with the time they were taken and sent in
+ * groups through the ThingSpeak bulk-update endpoint, one POST for up to
+ * SAMPLE_BATCH_SIZE samples instead of one POST per sample:
+ *
+ *   POST api.thingspeak.com/channels/<id>/bulk_update.json
+ *   {"write_api_key":"...","updates":[{"delta_t":20,"field1":23.45,"field2":61.20},...]}
+ *
+ * The newest entry also carries the cold-chain summary at send time:
+ * field3 and field4 the 24 h and 7 d MKT, field5 the minutes out of range
+ * in the last 24 h.
+ *
+ * delta_t is the number of seconds since the previous entry, so the board
+ * needs no wall clock. A batch is sent when SAMPLE_BATCH_SIZE samples are
+ * queued or the oldest one is SAMPLE_BATCH_MAX_AGE seconds old. Samples
+ * stay queued until the server accepts them.
+ *
+ * The bulk URL names the channel. While THINGSPEAK_CHANNEL_ID is unset
+ * ("0", the Kconfig default) samples go one per post to the plain update
+ * endpoint instead, which only needs the write key:
+ *
+ *   POST api.thingspeak.com/update
+ *   api_key=...&field1=23.45&field2=61.20&field3=...&field4=...&field5=...
+ *
+ * The server stamps those with the time they arrive and takes at most one
+ * every UPDATE_INTERVAL seconds, so a backlog goes out slowly and bunched.
+ *
+ * With SAMPLE_BATCH_USING_PACKED the batch goes instead to an ingest
+ * server of our own as application/octet-stream: a struct
+ * sample_batch_packed header and then the samples as one sample_codec
+ * stream, about 60 bytes for 30 samples against some 1.5 KB of JSON.
+ * ThingSpeak only takes JSON and forms, so that needs a server that
+ * decodes the stream and forwards it.
+ */
+#include <stdlib.h>
+#include <rtthread.h>
+
+#include "sim800_http.h"
+#include "sample_batch.h"
+#include "mkt.h"
+#include "sample_codec.h"
+#include "sample_log.h"
+
+#define DBG_TAG "batch"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#define BULK_UPDATE_URL     "api.thingspeak.com/channels/" THINGSPEAK_CHANNEL_ID "/bulk_update.json"
+#define UPDATE_URL          "api.thingspeak.com/update"
+#define UPDATE_INTERVAL     15      /* seconds between updates the server takes */
+
+/* {"delta_t":4294967295,"field1":-21474836.48,"field2":-21474836.48}, */
+#define BULK_ENTRY_MAX      72
+#define BULK_HEAD_MAX       (48 + sizeof(THINGSPEAK_WRITE_KEY))
+/* ,"field3":-21474836.48,"field4":-21474836.48,"field5":4294967295 */
+#define BULK_MKT_MAX        68
+#define BULK_BODY_MAX       (BULK_HEAD_MAX + SAMPLE_BATCH_SIZE * BULK_ENTRY_MAX + BULK_MKT_MAX + 4)
+
+#define SAMPLE_BATCH_PACKED_MAGIC   0x31504253  /* "SBP1" */
+
+/* head of a packed upload, little-endian */
+struct sample_batch_packed
+{
+    rt_uint32_t magic;
+    rt_uint16_t count;              /* samples in the stream that follows */
+    rt_uint16_t boot;               /* sample_log_boot(), 0 without the log */
+    rt_int32_t mkt_24h;             /* 0.01 degC, MKT_NONE without samples */
+    rt_int32_t mkt_7d;
+    rt_uint32_t excursion_min;      /* minutes out of range in the last 24 h */
+};
+
+#ifdef SAMPLE_BATCH_USING_PACKED
+#define BATCH_URL           SAMPLE_BATCH_PACKED_URL "?api_key=" THINGSPEAK_WRITE_KEY
+#define BATCH_CONTENT       SIM800_CONTENT_BINARY
+#else
+#define BATCH_URL           BULK_UPDATE_URL
+#define BATCH_CONTENT       SIM800_CONTENT_JSON
+#endif
+
+/* the bulk-update URL names the channel; "0", the Kconfig default, is none */
+#ifdef SAMPLE_BATCH_USING_PACKED
+#define BATCH_CONFIGURED()  RT_TRUE
+#else
+#define BATCH_CONFIGURED()  (THINGSPEAK_CHANNEL_ID[0] != '\0' && rt_strcmp(THINGSPEAK_CHANNEL_ID, "0") != 0)
+#endif
+
+struct sample_batch
+{
+    struct rt_mutex lock;           /* queue */
+    struct rt_mutex flush_lock;     /* body and the post in flight */
+    struct sample ring[SAMPLE_BATCH_CAPACITY];
+    rt_uint32_t head;               /* sequence number of the oldest sample */
+    rt_uint32_t count;
+    rt_uint32_t last_sent_time;     /* time of the newest sample the server has */
+    rt_tick_t last_post;            /* of the last /update */
+
+    struct sample out[SAMPLE_BATCH_SIZE];   /* the samples being sent, oldest first */
+    char body[BULK_BODY_MAX];
+    struct sample_batch_stat stat;
+};
+
+static struct sample_batch batch;
+
+static struct sample *sample_at(struct sample_batch *b, rt_uint32_t seq)
+{
+    return &b->ring[seq % SAMPLE_BATCH_CAPACITY];
+}
+
+/**
+ * Set up the queue.
+ *
+ * @return RT_EOK
+ */
+int sample_batch_init(void)
+{
+    rt_mutex_init(&batch.flush_lock, "bflush", RT_IPC_FLAG_PRIO);
+    rt_mutex_init(&batch.lock, "batch", RT_IPC_FLAG_PRIO);
+    if (!BATCH_CONFIGURED())
+        LOG_W("THINGSPEAK_CHANNEL_ID is not set, sending one sample per update");
+
+    return RT_EOK;
+}
+
+/**
+ * The most samples one post takes: SAMPLE_BATCH_SIZE, or 1 while
+ * THINGSPEAK_CHANNEL_ID is unset.
+ */
+rt_uint32_t sample_batch_limit(void)
+{
+    return BATCH_CONFIGURED() ? SAMPLE_BATCH_SIZE : 1;
+}
+
+void sample_batch_add(rt_int32_t temperature, rt_int32_t humidity)
+{
+    struct sample *s;
+
+    rt_mutex_take(&batch.lock, RT_WAITING_FOREVER);
+    if (batch.count == SAMPLE_BATCH_CAPACITY)
+    {
+        batch.head++;
+        batch.count--;
+        batch.stat.dropped++;
+    }
+    s = sample_at(&batch, batch.head + batch.count);
+    s->time = rt_tick_get() / RT_TICK_PER_SECOND;
+    s->temperature = temperature;
+    s->humidity = humidity;
+    batch.count++;
+    batch.stat.queued++;
+    rt_mutex_release(&batch.lock);
+}
+
+rt_bool_t sample_batch_due(void)
+{
+    rt_bool_t due;
+
+    rt_mutex_take(&batch.lock, RT_WAITING_FOREVER);
+    due = batch.count >= sample_batch_limit()
+          || (batch.count && rt_tick_get() / RT_TICK_PER_SECOND - sample_at(&batch, batch.head)->time >= SAMPLE_BATCH_MAX_AGE);
+    rt_mutex_release(&batch.lock);
+
+    return due;
+}
+
+rt_size_t sample_batch_count(void)
+{
+    return batch.count;
+}
+
+const struct sample_batch_stat *sample_batch_get_stat(void)
+{
+    return &batch.stat;
+}
+
+#ifdef SAMPLE_BATCH_USING_PACKED
+/* write `n` samples of boot `boot` as a packed body, returns its length */
+static int sample_batch_build(struct sample_batch *b, const struct sample *s, rt_uint32_t n, rt_uint32_t prev,
+                              rt_uint16_t boot)
+{
+    struct sample_batch_packed head;
+    struct sample_codec_enc enc;
+    struct mkt_report day, week;
+    rt_uint32_t i;
+
+    mkt_get(MKT_WINDOW_24H, &day);
+    mkt_get(MKT_WINDOW_7D, &week);
+
+    head.magic = SAMPLE_BATCH_PACKED_MAGIC;
+    head.count = n;
+    head.boot = boot;
+    head.mkt_24h = day.mkt;
+    head.mkt_7d = week.mkt;
+    head.excursion_min = day.excursion_total_min;
+    rt_memcpy(b->body, &head, sizeof(head));
+
+    /* at most 14 bytes a sample, BULK_ENTRY_MAX leaves plenty of room */
+    sample_codec_enc_init(&enc, b->body + sizeof(head), sizeof(b->body) - sizeof(head));
+    for (i = 0; i < n; i++)
+        sample_codec_put(&enc, &s[i]);
+
+    return sizeof(head) + sample_codec_len(&enc);
+}
+#else
+/* print a value in hundredths as a JSON number */
+static int format_centi(char *buf, rt_size_t size, rt_int32_t value)
+{
+    rt_uint32_t mag = value < 0 ? -(rt_uint32_t)value : (rt_uint32_t)value;
+
+    return rt_snprintf(buf, size, "%s%u.%02u", value < 0 ? "-" : "", mag / 100, mag % 100);
+}
+
+/* write `n` samples as a bulk-update body, `prev` the time of the sample
+ * before them or 0; returns its length */
+static int sample_batch_build(struct sample_batch *b, const struct sample *s, rt_uint32_t n, rt_uint32_t prev,
+                              rt_uint16_t boot)
+{
+    char *p = b->body, *end = b->body + sizeof(b->body);
+    struct mkt_report day, week;
+    rt_uint32_t i;
+
+    mkt_get(MKT_WINDOW_24H, &day);
+    mkt_get(MKT_WINDOW_7D, &week);
+
+    p += rt_snprintf(p, end - p, "{\"write_api_key\":\"%s\",\"updates\":[", THINGSPEAK_WRITE_KEY);
+    for (i = 0; i < n; i++, s++)
+    {
+        p += rt_snprintf(p, end - p, "%s{\"delta_t\":%u,\"field1\":", i ? "," : "",
+                         prev ? s->time - prev : 0);
+        p += format_centi(p, end - p, s->temperature);
+        p += rt_snprintf(p, end - p, ",\"field2\":");
+        p += format_centi(p, end - p, s->humidity);
+        if (i == n - 1 && day.mkt != MKT_NONE)
+        {
+            p += rt_snprintf(p, end - p, ",\"field3\":");
+            p += format_centi(p, end - p, day.mkt);
+            p += rt_snprintf(p, end - p, ",\"field4\":");
+            p += format_centi(p, end - p, week.mkt);
+            p += rt_snprintf(p, end - p, ",\"field5\":%u", day.excursion_total_min);
+        }
+        p += rt_snprintf(p, end - p, "}");
+        prev = s->time;
+    }
+    p += rt_snprintf(p, end - p, "]}");
+
+    return p - b->body;
+}
+
+/* write one sample as an /update form, returns its length */
+static int sample_batch_build_update(struct sample_batch *b, const struct sample *s)
+{
+    char *p = b->body, *end = b->body + sizeof(b->body);
+    struct mkt_report day, week;
+
+    mkt_get(MKT_WINDOW_24H, &day);
+    mkt_get(MKT_WINDOW_7D, &week);
+
+    p += rt_snprintf(p, end - p, "api_key=%s&field1=", THINGSPEAK_WRITE_KEY);
+    p += format_centi(p, end - p, s->temperature);
+    p += rt_snprintf(p, end - p, "&field2=");
+    p += format_centi(p, end - p, s->humidity);
+    if (day.mkt != MKT_NONE)
+    {
+        p += rt_snprintf(p, end - p, "&field3=");
+        p += format_centi(p, end - p, day.mkt);
+        p += rt_snprintf(p, end - p, "&field4=");
+        p += format_centi(p, end - p, week.mkt);
+        p += rt_snprintf(p, end - p, "&field5=%u", day.excursion_total_min);
+    }
+
+    return p - b->body;
+}
+#endif /* SAMPLE_BATCH_USING_PACKED */
+
+/* builds and posts a body; needs `flush_lock` */
+static int sample_batch_send(struct sample_batch *b, const struct sample *s, rt_uint32_t n, rt_uint32_t prev,
+                             rt_uint16_t boot)
+{
+    const char *url = BATCH_URL, *content = BATCH_CONTENT;
+    int len, result;
+
+#ifndef SAMPLE_BATCH_USING_PACKED
+    if (!BATCH_CONFIGURED())
+    {
+        rt_int32_t wait;
+
+        /* updates sooner than that are answered "0" and dropped */
+        wait = (rt_int32_t)(b->last_post + UPDATE_INTERVAL * RT_TICK_PER_SECOND - rt_tick_get());
+        if (b->stat.flushes > 0 && wait > 0)
+            rt_thread_delay(wait);
+        b->last_post = rt_tick_get();
+        len = sample_batch_build_update(b, s);
+        url = UPDATE_URL;
+        content = SIM800_CONTENT_FORM;
+    }
+    else
+#endif
+    {
+        len = sample_batch_build(b, s, n, prev, boot);
+    }
+    b->stat.flushes++;
+    b->stat.last_len = len;
+    result = sim800_http_post(url, content, b->body, len);
+    if (result != RT_EOK)
+        b->stat.failures++;
+
+    return result;
+}
+
+/**
+ * Send `n` samples of boot `boot` (at most sample_batch_limit(), oldest
+ * first) as one bulk update, bypassing the queue. `prev` is the time of
+ * the sample sent before them in the same boot, or 0.
+ *
+ * @return RT_EOK when the server accepted them, the sim800_http_post()
+ *         error otherwise.
+ */
+int sample_batch_post(const struct sample *s, rt_uint32_t n, rt_uint16_t boot, rt_uint32_t prev)
+{
+    int result;
+
+    if (n == 0 || n > sample_batch_limit())
+        return -RT_EINVAL;
+
+    rt_mutex_take(&batch.flush_lock, RT_WAITING_FOREVER);
+    result = sample_batch_send(&batch, s, n, prev, boot);
+    if (result == RT_EOK)
+        batch.stat.sent += n;
+    rt_mutex_release(&batch.flush_lock);
+
+    return result;
+}
+
+/**
+ * Send the oldest queued samples (up to sample_batch_limit()) as one bulk
+ * update. They are removed from the queue only when the server accepted
+ * them.
+ *
+ * @return RT_EOK on success or when nothing is queued, an error otherwise.
+ */
+int sample_batch_flush(void)
+{
+    rt_uint32_t first, n, left, i;
+    int result;
+
+    rt_mutex_take(&batch.flush_lock, RT_WAITING_FOREVER);
+    rt_mutex_take(&batch.lock, RT_WAITING_FOREVER);
+    n = batch.count < sample_batch_limit() ? batch.count : sample_batch_limit();
+    if (n == 0)
+    {
+        rt_mutex_release(&batch.lock);
+        rt_mutex_release(&batch.flush_lock);
+        return RT_EOK;
+    }
+    first = batch.head;
+    for (i = 0; i < n; i++)
+        batch.out[i] = *sample_at(&batch, first + i);
+    rt_mutex_release(&batch.lock);
+
+    result = sample_batch_send(&batch, batch.out, n, batch.last_sent_time, sample_log_boot());
+    if (result != RT_EOK)
+    {
+        LOG_W("bulk update of %d samples failed (%d), %d queued", n, result, batch.count);
+        rt_mutex_release(&batch.flush_lock);
+        return result;
+    }
+
+    rt_mutex_take(&batch.lock, RT_WAITING_FOREVER);
+    /* some of the sent samples may have been dropped meanwhile */
+    left = first + n - batch.head;
+    if ((rt_int32_t)left > 0)
+    {
+        batch.head += left;
+        batch.count -= left;
+    }
+    batch.last_sent_time = batch.out[n - 1].time;
+    batch.stat.sent += n;
+    rt_mutex_release(&batch.lock);
+    rt_mutex_release(&batch.flush_lock);
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_FINSH
+static void batch_cmd(int argc, char **argv)
+{
+    const struct sample_batch_stat *stat = &batch.stat;
+
+    if (argc == 4 && !rt_strcmp(argv[1], "add"))
+    {
+        sample_batch_add(atoi(argv[2]), atoi(argv[3]));
+    }
+    else if (argc == 2 && !rt_strcmp(argv[1], "flush"))
+    {
+        rt_kprintf("flush: %d\n", sample_batch_flush());
+    }
+    else if (argc != 1)
+    {
+        rt_kprintf("Usage: batch [add <temp_centi> <humid_centi> | flush]\n");
+        return;
+    }
+
+    rt_kprintf("%d of %d queued, batch %d, max age %d s\n",
+               batch.count, SAMPLE_BATCH_CAPACITY, sample_batch_limit(), SAMPLE_BATCH_MAX_AGE);
+    rt_kprintf("queued %d, sent %d, dropped %d\n", stat->queued, stat->sent, stat->dropped);
+    rt_kprintf("flushes %d, failed %d, last body %d bytes\n", stat->flushes, stat->failures, stat->last_len);
+}
+MSH_CMD_EXPORT_ALIAS(batch_cmd, batch, ThingSpeak sample batching);
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        batch samples into ThingSpeak bulk updates
+ * 2026-10-17     khair        one sample per update without a channel id
+ */
+#ifndef APPLICATIONS_SAMPLE_BATCH_H_
+#define APPLICATIONS_SAMPLE_BATCH_H_
+
+#include <rtthread.h>
+
+#ifndef SAMPLE_BATCH_SIZE
+#define SAMPLE_BATCH_SIZE           30
+#endif
+
+#ifndef SAMPLE_BATCH_MAX_AGE
+#define SAMPLE_BATCH_MAX_AGE        900     /* seconds */
+#endif
+
+#ifndef THINGSPEAK_CHANNEL_ID
+#define THINGSPEAK_CHANNEL_ID       "0"
+#endif
+
+#ifndef THINGSPEAK_WRITE_KEY
+#define THINGSPEAK_WRITE_KEY        ""
+#endif
+
+/* samples kept while uploads fail, the oldest are dropped beyond this */
+#define SAMPLE_BATCH_CAPACITY       (2 * SAMPLE_BATCH_SIZE)
+
+struct sample
+{
+    rt_uint32_t time;               /* seconds since boot */
+    rt_int32_t temperature;         /* 0.01 degC */
+    rt_int32_t humidity;            /* 0.01 %RH */
+};
+
+struct sample_batch_stat
+{
+    rt_uint32_t queued;             /* samples added */
+    rt_uint32_t sent;               /* samples accepted by the server */
+    rt_uint32_t dropped;            /* samples lost to a full queue */
+    rt_uint32_t flushes;            /* bulk posts attempted */
+    rt_uint32_t failures;           /* bulk posts that failed */
+    rt_uint32_t last_len;           /* body length of the last bulk post */
+};
+
+int sample_batch_init(void);
+void sample_batch_add(rt_int32_t temperature, rt_int32_t humidity);
+rt_bool_t sample_batch_due(void);
+int sample_batch_flush(void);
+int sample_batch_post(const struct sample *s, rt_uint32_t n, rt_uint16_t boot, rt_uint32_t prev);
+rt_uint32_t sample_batch_limit(void);
+rt_size_t sample_batch_count(void);
+const struct sample_batch_stat *sample_batch_get_stat(void);
+
+#endif /* APPLICATIONS_SAMPLE_BATCH_H_ */
@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        delta-of-delta sample codec
+ */
+/*
+ * A bit stream for samples in the style of Gorilla (Pelkonen et al.,
+ * VLDB 2015), adapted to integer fixed-point values.
+ *
+ * The first sample is stored whole. For every later one the time is
+ * stored as the change of its step from the step before (delta of delta),
+ * and each value as the zig-zag folded change from the value before, so
+ * small changes of either sign become small numbers. Each of the three
+ * goes into the smallest of five buckets it fits, led by a unary prefix:
+ *
+ *   prefix   time (dod)    value (delta)
+ *   0        0             0
+ *   10       7 bits        4 bits  (within +-8)
+ *   110      12 bits       8 bits
+ *   1110     20 bits       16 bits
+ *   1111     32 bits       32 bits (anything)
+ *
+ * Samples every 2 s make the time cost one bit, and a fridge that holds
+ * its temperature within a few hundredths changes by 0 or a 4-bit delta,
+ * so a sample typically takes 3 to 13 bits. Any input round-trips
+ * exactly, including time going backwards after a reboot.
+ */
+#include <stdlib.h>
+#include <rtthread.h>
+
+#include "sample_codec.h"
+
+#define DBG_TAG "codec"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#define SAMPLE_CODEC_BUCKETS    5
+
+/* payload bits of buckets 1..4 of each field; bucket 0 only holds zero */
+static const rt_uint8_t sample_codec_time_bits[SAMPLE_CODEC_BUCKETS] = {0, 7, 12, 20, 32};
+static const rt_uint8_t sample_codec_value_bits[SAMPLE_CODEC_BUCKETS] = {0, 4, 8, 16, 32};
+
+rt_inline rt_uint32_t sample_codec_zigzag(rt_int32_t v)
+{
+    return ((rt_uint32_t)v << 1) ^ (rt_uint32_t)(v >> 31);
+}
+
+rt_inline rt_int32_t sample_codec_unzigzag(rt_uint32_t z)
+{
+    return (rt_int32_t)(z >> 1) ^ -(rt_int32_t)(z & 1);
+}
+
+/* the smallest bucket `z` fits in */
+static int sample_codec_bucket(const rt_uint8_t *bits, rt_uint32_t z)
+{
+    int k;
+
+    if (z == 0)
+        return 0;
+    for (k = 1; k < SAMPLE_CODEC_BUCKETS - 1; k++)
+    {
+        if (z >> bits[k] == 0)
+            break;
+    }
+    return k;
+}
+
+/* prefix plus payload bits of `z` in its bucket */
+static rt_uint32_t sample_codec_field_bits(const rt_uint8_t *bits, rt_uint32_t z)
+{
+    int k = sample_codec_bucket(bits, z);
+
+    return (k < SAMPLE_CODEC_BUCKETS - 1 ? k + 1 : k) + bits[k];
+}
+
+/* MSB first; the caller has checked that `n` more bits fit */
+static void sample_codec_write(struct sample_codec_enc *enc, rt_uint32_t value, rt_uint32_t n)
+{
+    rt_uint32_t used, take, chunk;
+    rt_uint8_t *byte;
+
+    while (n)
+    {
+        byte = &enc->buf[enc->bits >> 3];
+        used = enc->bits & 7;
+        if (used == 0)
+            *byte = 0;
+        take = 8 - used < n ? 8 - used : n;
+        chunk = (value >> (n - take)) & ((1u << take) - 1);
+        *byte |= chunk << (8 - used - take);
+        enc->bits += take;
+        n -= take;
+    }
+}
+
+static void sample_codec_write_field(struct sample_codec_enc *enc, const rt_uint8_t *bits, rt_uint32_t z)
+{
+    int k = sample_codec_bucket(bits, z);
+
+    if (k < SAMPLE_CODEC_BUCKETS - 1)
+        sample_codec_write(enc, ((1u << k) - 1) << 1, k + 1);
+    else
+        sample_codec_write(enc, (1u << k) - 1, k);
+    if (bits[k])
+        sample_codec_write(enc, z, bits[k]);
+}
+
+void sample_codec_enc_init(struct sample_codec_enc *enc, void *buf, rt_size_t size)
+{
+    rt_memset(enc, 0, sizeof(*enc));
+    enc->buf = buf;
+    enc->size = size;
+}
+
+/**
+ * Append a sample.
+ *
+ * @return RT_FALSE if it does not fit in the buffer; the stream is then
+ *         unchanged and still complete.
+ */
+rt_bool_t sample_codec_put(struct sample_codec_enc *enc, const struct sample *s)
+{
+    rt_int32_t delta = (rt_int32_t)(s->time - enc->prev.time);
+    rt_uint32_t zt, zh, zd, need;
+
+    if (enc->count == 0)
+    {
+        if (enc->bits + SAMPLE_CODEC_FIRST_BITS > enc->size * 8)
+            return RT_FALSE;
+        sample_codec_write(enc, s->time, 32);
+        sample_codec_write(enc, (rt_uint32_t)s->temperature, 32);
+        sample_codec_write(enc, (rt_uint32_t)s->humidity, 32);
+        delta = 0;
+    }
+    else
+    {
+        zd = sample_codec_zigzag((rt_int32_t)((rt_uint32_t)delta - (rt_uint32_t)enc->prev_delta));
+        zt = sample_codec_zigzag((rt_int32_t)((rt_uint32_t)s->temperature - (rt_uint32_t)enc->prev.temperature));
+        zh = sample_codec_zigzag((rt_int32_t)((rt_uint32_t)s->humidity - (rt_uint32_t)enc->prev.humidity));
+        need = sample_codec_field_bits(sample_codec_time_bits, zd) + sample_codec_field_bits(sample_codec_value_bits, zt)
+               + sample_codec_field_bits(sample_codec_value_bits, zh);
+        if (enc->bits + need > enc->size * 8)
+            return RT_FALSE;
+        sample_codec_write_field(enc, sample_codec_time_bits, zd);
+        sample_codec_write_field(enc, sample_codec_value_bits, zt);
+        sample_codec_write_field(enc, sample_codec_value_bits, zh);
+    }
+
+    enc->prev = *s;
+    enc->prev_delta = delta;
+    enc->count++;
+    return RT_TRUE;
+}
+
+static rt_bool_t sample_codec_read(struct sample_codec_dec *dec, rt_uint32_t n, rt_uint32_t *value)
+{
+    rt_uint32_t v = 0, used, take;
+
+    if (dec->bits + n > dec->size * 8)
+        return RT_FALSE;
+
+    while (n)
+    {
+        used = dec->bits & 7;
+        take = 8 - used < n ? 8 - used : n;
+        v = (v << take) | ((dec->buf[dec->bits >> 3] >> (8 - used - take)) & ((1u << take) - 1));
+        dec->bits += take;
+        n -= take;
+    }
+    *value = v;
+    return RT_TRUE;
+}
+
+static rt_bool_t sample_codec_read_field(struct sample_codec_dec *dec, const rt_uint8_t *bits, rt_uint32_t *z)
+{
+    rt_uint32_t bit;
+    int k;
+
+    for (k = 0; k < SAMPLE_CODEC_BUCKETS - 1; k++)
+    {
+        if (!sample_codec_read(dec, 1, &bit))
+            return RT_FALSE;
+        if (bit == 0)
+            break;
+    }
+    *z = 0;
+    return bits[k] == 0 || sample_codec_read(dec, bits[k], z);
+}
+
+/**
+ * Start decoding `count` samples from a stream of `len` bytes.
+ */
+void sample_codec_dec_init(struct sample_codec_dec *dec, const void *buf, rt_size_t len, rt_uint32_t count)
+{
+    rt_memset(dec, 0, sizeof(*dec));
+    dec->buf = buf;
+    dec->size = len;
+    dec->total = count;
+}
+
+/**
+ * Take the next sample.
+ *
+ * @return RT_FALSE after the last one, or if the stream is cut short.
+ */
+rt_bool_t sample_codec_get(struct sample_codec_dec *dec, struct sample *s)
+{
+    rt_uint32_t t, v, h;
+    rt_int32_t delta;
+
+    if (dec->count >= dec->total)
+        return RT_FALSE;
+
+    if (dec->count == 0)
+    {
+        if (!sample_codec_read(dec, 32, &t) || !sample_codec_read(dec, 32, &v) || !sample_codec_read(dec, 32, &h))
+            return RT_FALSE;
+        s->time = t;
+        s->temperature = (rt_int32_t)v;
+        s->humidity = (rt_int32_t)h;
+        delta = 0;
+    }
+    else
+    {
+        if (!sample_codec_read_field(dec, sample_codec_time_bits, &t)
+            || !sample_codec_read_field(dec, sample_codec_value_bits, &v)
+            || !sample_codec_read_field(dec, sample_codec_value_bits, &h))
+            return RT_FALSE;
+        delta = (rt_int32_t)((rt_uint32_t)dec->prev_delta + (rt_uint32_t)sample_codec_unzigzag(t));
+        s->time = dec->prev.time + (rt_uint32_t)delta;
+        s->temperature = (rt_int32_t)((rt_uint32_t)dec->prev.temperature + (rt_uint32_t)sample_codec_unzigzag(v));
+        s->humidity = (rt_int32_t)((rt_uint32_t)dec->prev.humidity + (rt_uint32_t)sample_codec_unzigzag(h));
+    }
+
+    dec->prev = *s;
+    dec->prev_delta = delta;
+    dec->count++;
+    return RT_TRUE;
+}
+
+#if defined(RT_USING_FINSH) && defined(SAMPLE_CODEC_USING_BENCH)
+#include "hardware/timer.h"
+
+/*
+ * msh>sample_codec_bench [rounds]
+ *
+ * Encodes synthetic traces and reports bytes per sample and the time per
+ * sample both ways, then round-trips `rounds` random streams of random
+ * kinds into buffers of random size and checks every sample comes back.
+ * tests/host/sample_codec_fuzz.c runs it on a PC.
+ */
+#define CODEC_BENCH_SAMPLES     1024
+#define CODEC_BENCH_BUF         (CODEC_BENCH_SAMPLES * 14 + 16)
+
+enum codec_trace
+{
+    CODEC_TRACE_FRIDGE = 0,         /* 2 s, slow compressor cycle, a little noise */
+    CODEC_TRACE_STEADY,             /* 2 s, value held exactly */
+    CODEC_TRACE_NOISY,              /* 2 s, +-0.5 of noise */
+    CODEC_TRACE_JITTER,             /* 1..3 s steps, reboots that restart the time */
+    CODEC_TRACE_RANDOM,             /* anything at all */
+    CODEC_TRACE_MAX
+};
+
+static const char *const codec_trace_names[CODEC_TRACE_MAX] = {"fridge", "steady", "noisy", "jitter", "random"};
+
+struct codec_bench
+{
+    struct sample in[CODEC_BENCH_SAMPLES];
+    struct sample out;
+    rt_uint8_t buf[CODEC_BENCH_BUF];
+    rt_uint32_t rng;
+};
+
+static rt_uint32_t codec_rand(struct codec_bench *b)
+{
+    b->rng ^= b->rng << 13;
+    b->rng ^= b->rng >> 17;
+    b->rng ^= b->rng << 5;
+    return b->rng;
+}
+
+static void codec_trace(struct codec_bench *b, enum codec_trace kind, rt_uint32_t n)
+{
+    struct sample *s = b->in;
+    rt_uint32_t i, t = codec_rand(b) % 100000;
+    rt_int32_t temp = 400, humid = 6000, drift = 1;
+
+    for (i = 0; i < n; i++, s++)
+    {
+        switch (kind)
+        {
+        case CODEC_TRACE_FRIDGE:
+            /* the compressor pulls 2..8 degC up and down over ~20 minutes */
+            if (temp >= 800 || temp <= 200)
+                drift = -drift;
+            if (codec_rand(b) % 3 == 0)
+                temp += drift;
+            t += 2;
+            s->temperature = temp + (rt_int32_t)(codec_rand(b) % 5) - 2;
+            s->humidity = humid + (rt_int32_t)(codec_rand(b) % 9) - 4;
+            break;
+        case CODEC_TRACE_STEADY:
+            t += 2;
+            s->temperature = temp;
+            s->humidity = humid;
+            break;
+        case CODEC_TRACE_NOISY:
+            t += 2;
+            s->temperature = temp + (rt_int32_t)(codec_rand(b) % 101) - 50;
+            s->humidity = humid + (rt_int32_t)(codec_rand(b) % 101) - 50;
+            break;
+        case CODEC_TRACE_JITTER:
+            t = codec_rand(b) % 200 ? t + 1 + codec_rand(b) % 3 : codec_rand(b) % 10;
+            temp += (rt_int32_t)(codec_rand(b) % 41) - 20;
+            humid += (rt_int32_t)(codec_rand(b) % 401) - 200;
+            s->temperature = temp;
+            s->humidity = humid;
+            break;
+        default:
+            t = codec_rand(b);
+            s->temperature = (rt_int32_t)codec_rand(b);
+            s->humidity = (rt_int32_t)codec_rand(b);
+            break;
+        }
+        s->time = t;
+    }
+}
+
+static rt_bool_t codec_same(const struct sample *a, const struct sample *b)
+{
+    return a->time == b->time && a->temperature == b->temperature && a->humidity == b->humidity;
+}
+
+static int sample_codec_bench(int argc, char **argv)
+{
+    struct codec_bench *b;
+    struct sample_codec_enc enc;
+    struct sample_codec_dec dec;
+    rt_uint32_t rounds = argc > 1 ? atoi(argv[1]) : 2000;
+    rt_uint32_t i, r, n, size, put, start, enc_us, dec_us, failures = 0, samples = 0;
+    enum codec_trace kind;
+    rt_size_t len;
+
+    b = rt_malloc(sizeof(*b));
+    if (b == RT_NULL)
+        return -RT_ENOMEM;
+    b->rng = 0x2545f491;
+
+    /* 28 bytes is a sample as three decimal fields in the bulk JSON */
+    rt_kprintf("trace    bytes/sample  vs JSON  enc us/sample  dec us/sample\n");
+    for (kind = 0; kind < CODEC_TRACE_MAX; kind++)
+    {
+        codec_trace(b, kind, CODEC_BENCH_SAMPLES);
+
+        start = time_us_32();
+        sample_codec_enc_init(&enc, b->buf, sizeof(b->buf));
+        for (i = 0; i < CODEC_BENCH_SAMPLES; i++)
+            sample_codec_put(&enc, &b->in[i]);
+        enc_us = time_us_32() - start;
+        len = sample_codec_len(&enc);
+
+        start = time_us_32();
+        sample_codec_dec_init(&dec, b->buf, len, enc.count);
+        for (i = 0; sample_codec_get(&dec, &b->out); i++)
+        {
+            if (!codec_same(&b->out, &b->in[i]))
+                break;
+        }
+        dec_us = time_us_32() - start;
+        if (i != CODEC_BENCH_SAMPLES)
+            failures++;
+
+        rt_kprintf("%-8s %5d.%02d        %3dx     %4d.%02d        %4d.%02d\n", codec_trace_names[kind],
+                   len / CODEC_BENCH_SAMPLES, len * 100 / CODEC_BENCH_SAMPLES % 100,
+                   28 * CODEC_BENCH_SAMPLES / (len ? len : 1), enc_us / CODEC_BENCH_SAMPLES,
+                   enc_us * 100 / CODEC_BENCH_SAMPLES % 100, dec_us / CODEC_BENCH_SAMPLES,
+                   dec_us * 100 / CODEC_BENCH_SAMPLES % 100);
+    }
+
+    for (r = 0; r < rounds; r++)
+    {
+        kind = codec_rand(b) % CODEC_TRACE_MAX;
+        n = 1 + codec_rand(b) % CODEC_BENCH_SAMPLES;
+        size = codec_rand(b) % (sizeof(b->buf) + 1);
+        codec_trace(b, kind, n);
+
+        /* fill the buffer as far as it goes */
+        sample_codec_enc_init(&enc, b->buf, size);
+        for (put = 0; put < n && sample_codec_put(&enc, &b->in[put]); put++)
+            ;
+        if (put != enc.count || sample_codec_len(&enc) > size)
+            failures++;
+        samples += put;
+
+        sample_codec_dec_init(&dec, b->buf, sample_codec_len(&enc), enc.count);
+        for (i = 0; sample_codec_get(&dec, &b->out); i++)
+        {
+            if (!codec_same(&b->out, &b->in[i]))
+                break;
+        }
+        if (i != put)
+            failures++;
+
+        /* a cut stream ends early instead of running past its end */
+        if (put > 1)
+        {
+            sample_codec_dec_init(&dec, b->buf, sample_codec_len(&enc) / 2, enc.count);
+            for (i = 0; sample_codec_get(&dec, &b->out); i++)
+                ;
+            if (i >= put || dec.bits > dec.size * 8)
+                failures++;
+        }
+    }
+    rt_kprintf("%d random streams, %d samples round-tripped, %d failures: %s\n", rounds, samples, failures,
+               failures ? "FAIL" : "pass");
+
+    rt_free(b);
+
+    return failures ? -RT_ERROR : RT_EOK;
+}
+MSH_CMD_EXPORT(sample_codec_bench, measure and fuzz the sample codec);
+#endif /* RT_USING_FINSH && SAMPLE_CODEC_USING_BENCH */
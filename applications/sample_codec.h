@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        delta-of-delta sample codec
+ */
+#ifndef APPLICATIONS_SAMPLE_CODEC_H_
+#define APPLICATIONS_SAMPLE_CODEC_H_
+
+#include <rtthread.h>
+
+#include "sample_batch.h"
+
+/* the first sample of a stream: 32-bit time, two 32-bit values */
+#define SAMPLE_CODEC_FIRST_BITS     96
+/* the most any later sample takes */
+#define SAMPLE_CODEC_SAMPLE_MAX_BITS (3 * 36)
+
+/*
+ * Encoder state. The stream goes into a buffer the caller owns; nothing is
+ * allocated. A stream has no end marker, so whoever stores it keeps the
+ * sample count too, and it can only be decoded from its start.
+ */
+struct sample_codec_enc
+{
+    rt_uint8_t *buf;
+    rt_uint32_t size;               /* bytes in buf */
+    rt_uint32_t bits;               /* bits written */
+    rt_uint32_t count;              /* samples written */
+    struct sample prev;
+    rt_int32_t prev_delta;          /* time step before the last one */
+};
+
+struct sample_codec_dec
+{
+    const rt_uint8_t *buf;
+    rt_uint32_t size;               /* bytes in buf */
+    rt_uint32_t bits;               /* bits read */
+    rt_uint32_t count;              /* samples read */
+    rt_uint32_t total;              /* samples in the stream */
+    struct sample prev;
+    rt_int32_t prev_delta;
+};
+
+void sample_codec_enc_init(struct sample_codec_enc *enc, void *buf, rt_size_t size);
+rt_bool_t sample_codec_put(struct sample_codec_enc *enc, const struct sample *s);
+
+/* bytes of the stream so far, the last one padded with zero bits */
+rt_inline rt_size_t sample_codec_len(const struct sample_codec_enc *enc)
+{
+    return (enc->bits + 7) / 8;
+}
+
+void sample_codec_dec_init(struct sample_codec_dec *dec, const void *buf, rt_size_t len, rt_uint32_t count);
+rt_bool_t sample_codec_get(struct sample_codec_dec *dec, struct sample *s);
+
+#endif /* APPLICATIONS_SAMPLE_CODEC_H_ */
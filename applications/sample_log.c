@@ -0,0 +1,914 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        log-structured sample store in flash
+ * 2026-10-17     khair        writer below the application threads
+ * 2026-10-17     khair        retry an erase the flash driver puts off
+ */
+/*
+ * Every sample goes into an append-only log on a FAL partition, so a
+ * modem outage or a reboot loses nothing that reached flash.
+ *
+ * Samples are packed by sample_codec into a RAM page, usually at under two
+ * bytes each, and programmed one full 256-byte page at a time, every few
+ * minutes at one sample every 2 s. Each page is a stream of its own, so
+ * it can be decoded without the pages around it. A page
+ * carries its sequence number and a CRC-32 and always sits at page
+ * seq % pages of the partition, so the log walks the partition as a ring
+ * and wears every sector the same. A sector is erased just before the
+ * first page of a new lap goes into it, which drops the oldest 16 pages.
+ * The page buffer is doubled and a writer thread does the programming, so
+ * adding a sample never waits for flash. The writer runs below every
+ * other thread of the application: an erase shuts interrupts off for
+ * about 45 ms (see drv_flash.c), and it should only ever delay idle time.
+ * The driver may also put an erase off, while the modem is busy: the page
+ * then stays where it is and the writer tries again SAMPLE_LOG_RETRY_MS
+ * later, with the other buffer taking samples meanwhile.
+ *
+ * Nothing but the pages is stored. At boot the head is found by binary
+ * search over the sectors: sectors written in the current lap hold
+ * sequence numbers that follow on from sector 0, the others do not. Pages
+ * torn by a power cut fail their CRC and are passed over, and a page that
+ * is not blank is never programmed again. Samples still in RAM when power
+ * goes are lost; sample_log_sync() writes them out early.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <rtthread.h>
+
+#include "hardware/timer.h"
+
+#include "sample_log.h"
+#include "sample_codec.h"
+
+#ifdef APP_USING_SAMPLE_LOG
+
+#include <fal.h>
+
+#define DBG_TAG "slog"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#define SAMPLE_LOG_NONE         0xffffffffu
+#define SAMPLE_LOG_RETRY_MS     1000
+
+struct sample_log_page
+{
+    struct sample_log_page_hdr hdr;
+    rt_uint8_t payload[SAMPLE_LOG_PAYLOAD_MAX];
+};
+
+struct sample_log
+{
+    const struct fal_partition *part;
+    rt_uint32_t pages;              /* pages in the partition */
+    rt_uint32_t head;               /* seq of the next page to program */
+    rt_uint32_t tail;               /* seq of the oldest page still stored */
+    rt_uint16_t boot;
+
+    struct rt_mutex lock;           /* the page buffers */
+    struct rt_mutex flash_lock;     /* flash, head, tail and scratch */
+    struct rt_semaphore ready;      /* a full page waits for the writer */
+    struct sample_log_page buf[2];
+    struct sample_codec_enc enc[2]; /* packs into buf[i].payload */
+    rt_uint8_t fill;                /* buffer samples go into */
+    rt_uint8_t waiting;             /* the other buffer is full */
+    struct sample_log_page scratch;
+
+    struct sample_log_stat stat;
+};
+
+static struct sample_log sample_log;
+
+/* CRC-32 (IEEE 802.3), `crc` 0 to start or the CRC of the data before */
+rt_uint32_t sample_log_crc(rt_uint32_t crc, const void *buf, rt_size_t len)
+{
+    static const rt_uint32_t table[16] =
+    {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+    const rt_uint8_t *data = buf;
+
+    crc = ~crc;
+    while (len--)
+    {
+        crc = (crc >> 4) ^ table[(crc ^ *data) & 0xf];
+        crc = (crc >> 4) ^ table[(crc ^ (*data >> 4)) & 0xf];
+        data++;
+    }
+    return ~crc;
+}
+
+static rt_uint32_t sample_log_page_crc(const struct sample_log_page *page)
+{
+    rt_uint32_t crc;
+
+    crc = sample_log_crc(0, &page->hdr, offsetof(struct sample_log_page_hdr, crc));
+    return sample_log_crc(crc, page->payload, page->hdr.len);
+}
+
+/* reads the page stored at position `pos`; true if it is intact */
+static rt_bool_t sample_log_load_at(struct sample_log *log, rt_uint32_t pos, struct sample_log_page *page)
+{
+    const struct sample_log_page_hdr *hdr = &page->hdr;
+
+    if (fal_partition_read(log->part, pos * SAMPLE_LOG_PAGE_SIZE, (rt_uint8_t *)page, sizeof(*page)) < 0)
+        return RT_FALSE;
+
+    return hdr->magic == SAMPLE_LOG_MAGIC && hdr->seq % log->pages == pos && hdr->len <= SAMPLE_LOG_PAYLOAD_MAX
+           && hdr->crc == sample_log_page_crc(page);
+}
+
+static rt_bool_t sample_log_load(struct sample_log *log, rt_uint32_t seq, struct sample_log_page *page)
+{
+    return sample_log_load_at(log, seq % log->pages, page) && page->hdr.seq == seq;
+}
+
+static rt_bool_t sample_log_blank(const struct sample_log_page *page)
+{
+    const rt_uint32_t *word = (const rt_uint32_t *)page;
+    rt_size_t i;
+
+    for (i = 0; i < sizeof(*page) / sizeof(*word); i++)
+    {
+        if (word[i] != 0xffffffff)
+            return RT_FALSE;
+    }
+    return RT_TRUE;
+}
+
+/* seq of the first page of sector `k` from any intact page in it, or SAMPLE_LOG_NONE */
+static rt_uint32_t sample_log_sector_base(struct sample_log *log, rt_uint32_t k)
+{
+    rt_uint32_t j;
+
+    for (j = 0; j < SAMPLE_LOG_SECTOR_PAGES; j++)
+    {
+        if (sample_log_load_at(log, k * SAMPLE_LOG_SECTOR_PAGES + j, &log->scratch))
+            return log->scratch.hdr.seq - j;
+    }
+    return SAMPLE_LOG_NONE;
+}
+
+/*
+ * Finds head, tail and the boot count from what is in flash, reading a
+ * few pages per sector visited and O(log sectors) sectors.
+ */
+static void sample_log_recover(struct sample_log *log)
+{
+    rt_uint32_t sectors = log->pages / SAMPLE_LOG_SECTOR_PAGES;
+    rt_uint32_t base0, base, h, lo, hi, mid, t, i;
+    int j;
+
+    log->boot = 1;
+    base0 = sample_log_sector_base(log, 0);
+    if (base0 == SAMPLE_LOG_NONE)
+    {
+        /* empty, or sector 0 was erased for a new lap and power went */
+        if (sample_log_sector_base(log, sectors - 1) == SAMPLE_LOG_NONE)
+        {
+            log->head = log->tail = 0;
+            return;
+        }
+        h = sectors - 1;
+    }
+    else
+    {
+        /* the largest sector written in the same lap as sector 0 */
+        lo = 0;
+        hi = sectors - 1;
+        while (lo < hi)
+        {
+            mid = (lo + hi + 1) / 2;
+            if (sample_log_sector_base(log, mid) == base0 + mid * SAMPLE_LOG_SECTOR_PAGES)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        h = lo;
+    }
+    base = sample_log_sector_base(log, h);
+
+    /* the next page goes after the last one touched, torn or not */
+    for (j = SAMPLE_LOG_SECTOR_PAGES - 1; j > 0; j--)
+    {
+        fal_partition_read(log->part, (h * SAMPLE_LOG_SECTOR_PAGES + j) * SAMPLE_LOG_PAGE_SIZE,
+                           (rt_uint8_t *)&log->scratch, sizeof(log->scratch));
+        if (!sample_log_blank(&log->scratch))
+            break;
+    }
+    log->head = base + j + 1;
+
+    for (; j >= 0; j--)
+    {
+        if (sample_log_load(log, base + j, &log->scratch))
+        {
+            log->boot = log->scratch.hdr.boot + 1;
+            break;
+        }
+    }
+
+    /* the oldest data is in the next sector from the last lap, unless
+     * that one is erased; in the first lap it starts at sector 0 */
+    log->tail = base >= h * SAMPLE_LOG_SECTOR_PAGES ? base - h * SAMPLE_LOG_SECTOR_PAGES : 0;
+    for (i = 1; i <= 2 && i < sectors; i++)
+    {
+        t = sample_log_sector_base(log, (h + i) % sectors);
+        if (t != SAMPLE_LOG_NONE && t < base)
+        {
+            log->tail = t;
+            break;
+        }
+    }
+}
+
+static void sample_log_page_reset(struct sample_log *log, int i)
+{
+    struct sample_log_page *page = &log->buf[i];
+
+    page->hdr.format = SAMPLE_LOG_FORMAT_PACKED;
+    page->hdr.count = 0;
+    page->hdr.len = 0;
+    sample_codec_enc_init(&log->enc[i], page->payload, sizeof(page->payload));
+}
+
+static rt_err_t sample_log_open(struct sample_log *log, const char *name)
+{
+    log->part = fal_partition_find(name);
+    if (log->part == RT_NULL)
+        return -RT_ERROR;
+
+    log->pages = log->part->len / SAMPLE_LOG_SECTOR_SIZE * SAMPLE_LOG_SECTOR_PAGES;
+    if (log->pages < 3 * SAMPLE_LOG_SECTOR_PAGES)
+        return -RT_EINVAL;
+
+    log->fill = 0;
+    log->waiting = 0;
+    sample_log_page_reset(log, 0);
+    rt_mutex_take(&log->flash_lock, RT_WAITING_FOREVER);
+    sample_log_recover(log);
+    rt_mutex_release(&log->flash_lock);
+
+    return RT_EOK;
+}
+
+/*
+ * Programs one sealed page at the head, erasing its sector first on a new
+ * lap. -RT_EBUSY when the driver put the erase off: nothing has changed.
+ */
+static rt_err_t sample_log_program(struct sample_log *log, struct sample_log_page *page)
+{
+    rt_uint32_t pos, start, us, old;
+    rt_err_t err = RT_EOK;
+    int ret;
+
+    start = time_us_32();
+    pos = log->head % log->pages;
+    if (pos % SAMPLE_LOG_SECTOR_PAGES == 0)
+    {
+        ret = fal_partition_erase(log->part, pos * SAMPLE_LOG_PAGE_SIZE, SAMPLE_LOG_SECTOR_SIZE);
+        if (ret == -RT_EBUSY)
+        {
+            log->stat.deferred++;
+            return -RT_EBUSY;
+        }
+        if (ret < 0)
+            err = -RT_EIO;
+        log->stat.erases++;
+
+        /* the sector held the oldest pages of the last lap */
+        old = log->head + SAMPLE_LOG_SECTOR_PAGES;
+        if (old >= log->pages && log->tail < old - log->pages)
+            log->tail = old - log->pages;
+    }
+
+    page->hdr.magic = SAMPLE_LOG_MAGIC;
+    page->hdr.seq = log->head;
+    page->hdr.boot = log->boot;
+    page->hdr.reserved = 0xffff;
+    page->hdr.crc = sample_log_page_crc(page);
+    if (err == RT_EOK && fal_partition_write(log->part, pos * SAMPLE_LOG_PAGE_SIZE, (rt_uint8_t *)page, sizeof(*page)) < 0)
+        err = -RT_EIO;
+
+    /* a failed page is left behind, readers pass over it */
+    log->head++;
+    if (err == RT_EOK)
+        log->stat.pages++;
+    else
+        log->stat.errors++;
+
+    us = time_us_32() - start;
+    if (us > log->stat.max_write_us)
+        log->stat.max_write_us = us;
+
+    return err;
+}
+
+/* hands the fill page over to the writer; needs `lock` */
+static rt_bool_t sample_log_seal(struct sample_log *log)
+{
+    if (log->waiting)
+        return RT_FALSE;
+
+    log->waiting = 1;
+    log->fill ^= 1;
+    sample_log_page_reset(log, log->fill);
+    return RT_TRUE;
+}
+
+/* packs a sample into the fill page if it fits; needs `lock` */
+static rt_bool_t sample_log_put(struct sample_log *log, const struct sample *s)
+{
+    struct sample_log_page *page = &log->buf[log->fill];
+    struct sample_codec_enc *enc = &log->enc[log->fill];
+
+    if (page->hdr.count >= SAMPLE_LOG_PACKED_MAX || !sample_codec_put(enc, s))
+        return RT_FALSE;
+
+    page->hdr.count = enc->count;
+    page->hdr.len = sample_codec_len(enc);
+    return RT_TRUE;
+}
+
+static void sample_log_append(struct sample_log *log, const struct sample *s)
+{
+    rt_bool_t sealed = RT_FALSE;
+
+    rt_mutex_take(&log->lock, RT_WAITING_FOREVER);
+    if (sample_log_put(log, s))
+    {
+        log->stat.added++;
+    }
+    else if (sample_log_seal(log))
+    {
+        /* the page is full, and an empty one always takes a sample */
+        sample_log_put(log, s);
+        log->stat.added++;
+        sealed = RT_TRUE;
+    }
+    else
+    {
+        /* both pages wait for flash */
+        log->stat.dropped++;
+    }
+    rt_mutex_release(&log->lock);
+
+    if (sealed)
+        rt_sem_release(&log->ready);
+}
+
+/*
+ * Programs the page waiting for flash, and with `partial` the fill page
+ * too. On -RT_EBUSY a page still waits, to be written by a later call.
+ */
+static rt_err_t sample_log_write(struct sample_log *log, rt_bool_t partial)
+{
+    rt_err_t err = RT_EOK, ret;
+    int pass;
+
+    rt_mutex_take(&log->flash_lock, RT_WAITING_FOREVER);
+    for (pass = 0; pass < 2; pass++)
+    {
+        rt_mutex_take(&log->lock, RT_WAITING_FOREVER);
+        if (!log->waiting && partial && log->buf[log->fill].hdr.count > 0)
+            sample_log_seal(log);
+        rt_mutex_release(&log->lock);
+
+        /* only this function clears `waiting`, so the page stays put */
+        if (!log->waiting)
+            break;
+        ret = sample_log_program(log, &log->buf[log->fill ^ 1]);
+        if (ret == -RT_EBUSY)
+        {
+            err = ret;
+            break;
+        }
+        if (ret != RT_EOK)
+            err = -RT_EIO;
+
+        rt_mutex_take(&log->lock, RT_WAITING_FOREVER);
+        log->waiting = 0;
+        rt_mutex_release(&log->lock);
+    }
+    rt_mutex_release(&log->flash_lock);
+
+    return err;
+}
+
+/* unpacks the samples of an intact page from `from` on, returns how many */
+static rt_size_t sample_log_unpack(const struct sample_log_page *page, rt_uint32_t from, struct sample *buf,
+                                   rt_size_t max)
+{
+    const struct sample_log_record *rec = (const struct sample_log_record *)page->payload;
+    struct sample_codec_dec dec;
+    struct sample s;
+    rt_uint32_t i;
+    rt_size_t n = 0;
+
+    if (page->hdr.format == SAMPLE_LOG_FORMAT_RAW)
+    {
+        for (i = from; i < page->hdr.count && i < page->hdr.len / sizeof(*rec) && n < max; i++, n++)
+        {
+            buf[n].time = rec[i].time;
+            buf[n].temperature = rec[i].temperature;
+            buf[n].humidity = rec[i].humidity;
+        }
+        return n;
+    }
+
+    /* a stream only decodes from its start */
+    sample_codec_dec_init(&dec, page->payload, page->hdr.len, page->hdr.count);
+    for (i = 0; n < max && sample_codec_get(&dec, &s); i++)
+    {
+        if (i >= from)
+            buf[n++] = s;
+    }
+    return n;
+}
+
+/*
+ * Copies up to `max` samples from `cur` on, oldest first, and moves the
+ * cursor past them. One call returns samples of one boot only, given in
+ * cur->boot. A cursor on data that has been overwritten moves up to the
+ * oldest page still stored.
+ */
+static rt_ssize_t sample_log_read_from(struct sample_log *log, struct sample_log_cursor *cur, struct sample *buf,
+                                       rt_size_t max)
+{
+    const struct sample_log_page *page = &log->scratch;
+    rt_size_t n = 0, got;
+
+    rt_mutex_take(&log->flash_lock, RT_WAITING_FOREVER);
+    if (cur->seq < log->tail)
+    {
+        cur->seq = log->tail;
+        cur->index = 0;
+    }
+
+    while (n < max && cur->seq < log->head)
+    {
+        if (!sample_log_load(log, cur->seq, &log->scratch)
+            || (page->hdr.format != SAMPLE_LOG_FORMAT_RAW && page->hdr.format != SAMPLE_LOG_FORMAT_PACKED))
+        {
+            log->stat.skipped++;
+            cur->seq++;
+            cur->index = 0;
+            continue;
+        }
+        if (n > 0 && page->hdr.boot != cur->boot)
+            break;
+        cur->boot = page->hdr.boot;
+
+        got = sample_log_unpack(page, cur->index, buf + n, max - n);
+        n += got;
+        cur->index += got;
+        /* room left over means the page ran out */
+        if (n < max || cur->index >= page->hdr.count)
+        {
+            cur->seq++;
+            cur->index = 0;
+        }
+    }
+    rt_mutex_release(&log->flash_lock);
+
+    return n;
+}
+
+static void sample_log_setup(struct sample_log *log, const char *name)
+{
+    rt_memset(log, 0, sizeof(*log));
+    rt_mutex_init(&log->lock, name, RT_IPC_FLAG_PRIO);
+    rt_mutex_init(&log->flash_lock, name, RT_IPC_FLAG_PRIO);
+    rt_sem_init(&log->ready, name, 0, RT_IPC_FLAG_FIFO);
+    sample_log_page_reset(log, 0);
+}
+
+static void sample_log_thread_entry(void *parameter)
+{
+    struct sample_log *log = parameter;
+    rt_err_t err;
+
+    while (1)
+    {
+        rt_sem_take(&log->ready, RT_WAITING_FOREVER);
+        while ((err = sample_log_write(log, RT_FALSE)) == -RT_EBUSY)
+            rt_thread_mdelay(SAMPLE_LOG_RETRY_MS);
+        if (err != RT_EOK)
+            LOG_W("page %d not written", log->head - 1);
+    }
+}
+
+/**
+ * Open the log partition and start the writer thread. Samples added before
+ * this are not logged.
+ */
+int sample_log_init(void)
+{
+    struct sample_log *log = &sample_log;
+    rt_thread_t tid;
+    rt_err_t err;
+
+    sample_log_setup(log, "slog");
+    err = sample_log_open(log, SAMPLE_LOG_PARTITION);
+    if (err != RT_EOK)
+    {
+        LOG_E("no usable partition \"%s\"", SAMPLE_LOG_PARTITION);
+        log->part = RT_NULL;
+        return err;
+    }
+    LOG_I("boot %d, pages %d..%d of %d", log->boot, log->tail, log->head, log->pages);
+
+    tid = rt_thread_create("slog", sample_log_thread_entry, log, 1024, RT_THREAD_PRIORITY_MAX - 8, 20);
+    if (tid == RT_NULL)
+        return -RT_ENOMEM;
+
+    return rt_thread_startup(tid);
+}
+
+/**
+ * Log a sample taken at `tick`. Never waits for flash.
+ */
+void sample_log_add(rt_int32_t temperature, rt_int32_t humidity, rt_tick_t tick)
+{
+    struct sample s;
+
+    if (sample_log.part == RT_NULL)
+        return;
+
+    s.time = tick / RT_TICK_PER_SECOND;
+    s.temperature = temperature;
+    s.humidity = humidity;
+    sample_log_append(&sample_log, &s);
+}
+
+/**
+ * Write out every sample added so far, the last page partly filled. Costs
+ * a page, so for shutdowns and tests rather than routine use. -RT_EBUSY
+ * when an erase was put off; the writer thread finishes the job.
+ */
+rt_err_t sample_log_sync(void)
+{
+    rt_err_t err;
+
+    if (sample_log.part == RT_NULL)
+        return -RT_ERROR;
+
+    err = sample_log_write(&sample_log, RT_TRUE);
+    if (err == -RT_EBUSY)
+        rt_sem_release(&sample_log.ready);
+    return err;
+}
+
+void sample_log_oldest(struct sample_log_cursor *cur)
+{
+    rt_mutex_take(&sample_log.flash_lock, RT_WAITING_FOREVER);
+    cur->seq = sample_log.tail;
+    cur->index = 0;
+    cur->boot = 0;
+    rt_mutex_release(&sample_log.flash_lock);
+}
+
+/* the position the next page will be written at */
+void sample_log_newest(struct sample_log_cursor *cur)
+{
+    rt_mutex_take(&sample_log.flash_lock, RT_WAITING_FOREVER);
+    cur->seq = sample_log.head;
+    cur->index = 0;
+    cur->boot = sample_log.boot;
+    rt_mutex_release(&sample_log.flash_lock);
+}
+
+rt_ssize_t sample_log_read(struct sample_log_cursor *cur, struct sample *buf, rt_size_t max)
+{
+    if (sample_log.part == RT_NULL)
+        return -RT_ERROR;
+
+    return sample_log_read_from(&sample_log, cur, buf, max);
+}
+
+/* pages the log holds; the oldest are overwritten beyond this */
+rt_uint32_t sample_log_capacity(void)
+{
+    return sample_log.pages;
+}
+
+/* numbers the boots, so sample times (seconds since boot) can be told apart */
+rt_uint16_t sample_log_boot(void)
+{
+    return sample_log.boot;
+}
+
+const struct sample_log_stat *sample_log_get_stat(void)
+{
+    return &sample_log.stat;
+}
+
+#if defined(RT_USING_FINSH) && defined(SAMPLE_LOG_USING_SELFTEST)
+/*
+ * msh>sample_log_selftest
+ *
+ * Runs the log on "logsim", a 16 KB partition in RAM that behaves like NOR
+ * flash: programming only clears bits and erase sets a sector to 0xff.
+ * Between rounds of writing the log is reopened, as at a reboot, and must
+ * find the same head and tail; power cuts are faked by tearing a page and
+ * half-erasing a sector, and an erase put off as by a busy modem must
+ * lose nothing. All samples read back must be in order, with only the torn
+ * page missing. tests/host/sample_log_sim.c runs it on a PC.
+ */
+#define SAMPLE_LOG_SIM_SIZE     (16 * 1024)
+
+static rt_uint8_t sample_log_sim[SAMPLE_LOG_SIM_SIZE];
+static rt_bool_t sample_log_sim_busy;   /* erases are put off, as drv_flash.c may */
+
+static int sample_log_sim_init(void)
+{
+    return 0;
+}
+
+static int sample_log_sim_read(long offset, rt_uint8_t *buf, size_t size)
+{
+    rt_memcpy(buf, sample_log_sim + offset, size);
+    return size;
+}
+
+static int sample_log_sim_write(long offset, const rt_uint8_t *buf, size_t size)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++)
+        sample_log_sim[offset + i] &= buf[i];
+    return size;
+}
+
+static int sample_log_sim_erase(long offset, size_t size)
+{
+    rt_uint32_t start = offset & ~(SAMPLE_LOG_SECTOR_SIZE - 1);
+
+    if (sample_log_sim_busy)
+        return -RT_EBUSY;
+    rt_memset(sample_log_sim + start, 0xff, RT_ALIGN(offset + size, SAMPLE_LOG_SECTOR_SIZE) - start);
+    return size;
+}
+
+const struct fal_flash_dev sample_log_sim_flash =
+{
+    .name = "logsim",
+    .addr = 0,
+    .len = SAMPLE_LOG_SIM_SIZE,
+    .blk_size = SAMPLE_LOG_SECTOR_SIZE,
+    .ops = {sample_log_sim_init, sample_log_sim_read, sample_log_sim_write, sample_log_sim_erase},
+    .write_gran = 1,
+};
+
+struct sample_log_check
+{
+    struct sample_log log;
+    rt_uint32_t added;              /* samples appended so far */
+    rt_uint32_t pages;              /* pages programmed before the last reopen */
+    rt_uint16_t boot;               /* boot of the newest page */
+    rt_uint32_t failures;
+};
+
+/* the sample at time `t`: runs of steady values, so some pages fill up
+ * on count and others on bytes */
+static void sample_log_check_sample(rt_uint32_t t, struct sample *s)
+{
+    s->time = t;
+    s->temperature = (rt_int32_t)(t / 8 * 7 % 12000) - 4000;
+    s->humidity = t / 3 * 13 % 10000;
+}
+
+static void sample_log_check_add(struct sample_log_check *c, rt_uint32_t n)
+{
+    struct sample s;
+
+    while (n--)
+    {
+        sample_log_check_sample(c->added++, &s);
+        sample_log_append(&c->log, &s);
+        sample_log_write(&c->log, RT_FALSE);
+    }
+}
+
+/* adds samples until `n` more pages have gone to flash */
+static void sample_log_check_pages(struct sample_log_check *c, rt_uint32_t n)
+{
+    rt_uint32_t head = c->log.head + n;
+
+    while (c->log.head < head)
+        sample_log_check_add(c, 1);
+}
+
+/* reopens the log as after a power cut and checks what it recovers */
+static void sample_log_check_reopen(struct sample_log_check *c, const char *what, rt_uint32_t head, rt_uint32_t tail)
+{
+    struct sample_log *log = &c->log;
+    struct sample_log_cursor cur = {0};
+    struct sample s[8], want;
+    rt_uint32_t expect = SAMPLE_LOG_NONE, read = 0, skipped;
+    rt_ssize_t n, i;
+    rt_bool_t ok = RT_TRUE;
+
+    if (log->stat.pages != c->pages)
+        c->boot = log->boot;
+    c->pages = log->stat.pages;
+    /* samples still in RAM go with the power */
+    c->added -= log->buf[log->fill].hdr.count + (log->waiting ? log->buf[log->fill ^ 1].hdr.count : 0);
+
+    sample_log_open(log, "logsim");
+    if (log->head != head || log->tail != tail || log->boot != c->boot + 1)
+        ok = RT_FALSE;
+
+    skipped = log->stat.skipped;
+    cur.seq = log->tail;
+    while ((n = sample_log_read_from(log, &cur, s, 8)) > 0)
+    {
+        for (i = 0; i < n; i++, read++)
+        {
+            if (expect != SAMPLE_LOG_NONE && s[i].time != expect)
+            {
+                /* only a torn page may leave a gap */
+                if (log->stat.skipped == skipped || s[i].time < expect)
+                    ok = RT_FALSE;
+            }
+            sample_log_check_sample(s[i].time, &want);
+            if (s[i].temperature != want.temperature || s[i].humidity != want.humidity)
+                ok = RT_FALSE;
+            expect = s[i].time + 1;
+        }
+    }
+    /* everything written made it, the last page partly filled */
+    if (head != tail && expect != c->added)
+        ok = RT_FALSE;
+
+    rt_kprintf("%-26s head %4d tail %4d boot %d, %4d samples, %d skipped: %s\n", what, log->head, log->tail,
+               log->boot, read, log->stat.skipped - skipped, ok ? "pass" : "FAIL");
+    if (!ok)
+        c->failures++;
+}
+
+static int sample_log_selftest(int argc, char **argv)
+{
+    struct sample_log_check *c;
+    struct sample_log *log;
+    rt_uint32_t pages, pos, head, tail;
+    rt_uint8_t junk[SAMPLE_LOG_PAGE_SIZE / 2];
+    int err;
+
+    c = rt_calloc(1, sizeof(*c));
+    if (c == RT_NULL)
+        return -RT_ENOMEM;
+    log = &c->log;
+    sample_log_setup(log, "slogt");
+    rt_memset(sample_log_sim, 0xff, sizeof(sample_log_sim));
+    if (sample_log_open(log, "logsim") != RT_EOK)
+    {
+        rt_kprintf("no \"logsim\" partition\n");
+        c->failures++;
+        goto out;
+    }
+    pages = log->pages;
+    sample_log_check_reopen(c, "empty", 0, 0);
+
+    /* part of the first lap; the partial page is written before "power off" */
+    sample_log_check_add(c, 100);
+    sample_log_write(log, RT_TRUE);
+    sample_log_check_reopen(c, "first lap", log->head, 0);
+
+    /* a little over two laps */
+    sample_log_check_pages(c, 2 * pages + 5);
+    sample_log_write(log, RT_TRUE);
+    head = log->head;
+    /* the sector after the head one still holds the last lap */
+    tail = ((head - 1) / SAMPLE_LOG_SECTOR_PAGES + 1) * SAMPLE_LOG_SECTOR_PAGES - pages;
+    sample_log_check_reopen(c, "wrapped", head, tail);
+
+    /* power cut while a page was being programmed */
+    pos = log->head % pages;
+    rt_memset(junk, 0x5a, sizeof(junk));
+    sample_log_sim_write(pos * SAMPLE_LOG_PAGE_SIZE, junk, sizeof(junk));
+    tail = log->tail;
+    sample_log_check_reopen(c, "torn page", log->head + 1, tail);
+    sample_log_check_pages(c, 3);
+    sample_log_write(log, RT_TRUE);
+    sample_log_check_reopen(c, "after torn page", log->head, log->tail);
+
+    /* fill up to the end of the sector, then cut power half way through
+     * erasing the next one */
+    while (log->head % SAMPLE_LOG_SECTOR_PAGES)
+        sample_log_check_add(c, 1);
+    head = log->head;
+    pos = head % pages;
+    rt_memset(sample_log_sim + pos * SAMPLE_LOG_PAGE_SIZE, 0xff, SAMPLE_LOG_SECTOR_SIZE / 2);
+    sample_log_check_reopen(c, "half-erased sector", head, head - pages);
+    sample_log_check_pages(c, 2);
+    sample_log_write(log, RT_TRUE);
+    sample_log_check_reopen(c, "after half erase", log->head, log->tail);
+
+    /* the erase at the next sector is put off: the page waits, the other
+     * one takes samples, and both go out once the erase goes through */
+    while (log->head % SAMPLE_LOG_SECTOR_PAGES)
+        sample_log_check_add(c, 1);
+    head = log->head;
+    sample_log_sim_busy = RT_TRUE;
+    while (!log->waiting && log->head == head)
+        sample_log_check_add(c, 1);
+    sample_log_check_add(c, 5);
+    sample_log_sim_busy = RT_FALSE;
+    if (log->head != head || log->stat.deferred == 0 || log->stat.dropped != 0)
+    {
+        rt_kprintf("erase put off: head %d, %d put off, %d dropped: FAIL\n", log->head, log->stat.deferred,
+                   log->stat.dropped);
+        c->failures++;
+    }
+    sample_log_write(log, RT_TRUE);
+    sample_log_check_reopen(c, "after erase put off", log->head, log->tail);
+
+    /* wrap onto sector 0 and lose power right after erasing it */
+    while (log->head % pages)
+        sample_log_check_add(c, 1);
+    head = log->head;
+    sample_log_sim_erase(0, SAMPLE_LOG_SECTOR_SIZE);
+    sample_log_check_reopen(c, "sector 0 erased", head, head + SAMPLE_LOG_SECTOR_PAGES - pages);
+    sample_log_check_pages(c, 1);
+    sample_log_check_add(c, 3);
+    sample_log_write(log, RT_TRUE);
+    sample_log_check_reopen(c, "after sector 0", log->head, log->tail);
+
+    rt_kprintf("%d pages, %d erases (%d put off), %d samples: %s\n", log->stat.pages, log->stat.erases,
+               log->stat.deferred, c->added, c->failures ? "FAIL" : "pass");
+out:
+    rt_mutex_detach(&log->lock);
+    rt_mutex_detach(&log->flash_lock);
+    rt_sem_detach(&log->ready);
+    err = c->failures ? -RT_ERROR : RT_EOK;
+    rt_free(c);
+
+    return err;
+}
+MSH_CMD_EXPORT(sample_log_selftest, check the sample log against simulated flash);
+#endif /* RT_USING_FINSH && SAMPLE_LOG_USING_SELFTEST */
+
+#ifdef RT_USING_FINSH
+static void sample_log_cmd(int argc, char **argv)
+{
+    struct sample_log *log = &sample_log;
+    struct sample_log_stat *st = &log->stat;
+    struct sample_log_cursor cur;
+    struct sample s[4];
+    rt_ssize_t n, i;
+    rt_uint32_t count, stored;
+
+    if (log->part == RT_NULL)
+    {
+        rt_kprintf("sample log not open\n");
+        return;
+    }
+
+    if (argc > 1 && !rt_strcmp(argv[1], "sync"))
+    {
+        rt_kprintf("sync: %s\n", sample_log_sync() == RT_EOK ? "ok" : "failed");
+        return;
+    }
+
+    if (argc > 1 && !rt_strcmp(argv[1], "tail"))
+    {
+        /* the last `count` samples in flash, pages hold different numbers */
+        count = argc > 2 ? atoi(argv[2]) : 10;
+        sample_log_newest(&cur);
+        rt_mutex_take(&log->flash_lock, RT_WAITING_FOREVER);
+        for (stored = 0; stored < count && cur.seq > log->tail; )
+        {
+            cur.seq--;
+            if (sample_log_load(log, cur.seq, &log->scratch))
+                stored += log->scratch.hdr.count;
+        }
+        cur.index = stored > count ? stored - count : 0;
+        rt_mutex_release(&log->flash_lock);
+        while ((n = sample_log_read(&cur, s, 4)) > 0)
+        {
+            for (i = 0; i < n; i++)
+                rt_kprintf("boot %d  %6ds  %5d  %5d\n", cur.boot, s[i].time, s[i].temperature, s[i].humidity);
+        }
+        return;
+    }
+
+    rt_kprintf("partition %s: %d pages, boot %d, pages %d..%d stored\n", log->part->name, log->pages, log->boot,
+               log->tail, log->head);
+    rt_kprintf("samples %d (dropped %d), in RAM %d, pages %d, erases %d (%d put off), errors %d, skipped %d\n",
+               st->added, st->dropped,
+               log->buf[log->fill].hdr.count + (log->waiting ? log->buf[log->fill ^ 1].hdr.count : 0), st->pages,
+               st->erases, st->deferred, st->errors, st->skipped);
+    rt_kprintf("fill page %d bits a sample, longest page write %d us\n",
+               log->buf[log->fill].hdr.count ? log->enc[log->fill].bits / log->buf[log->fill].hdr.count : 0,
+               st->max_write_us);
+}
+MSH_CMD_EXPORT_ALIAS(sample_log_cmd, slog, show the sample log: slog [sync | tail [n]]);
+#endif /* RT_USING_FINSH */
+
+#endif /* APP_USING_SAMPLE_LOG */
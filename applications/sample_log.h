@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        log-structured sample store in flash
+ */
+#ifndef APPLICATIONS_SAMPLE_LOG_H_
+#define APPLICATIONS_SAMPLE_LOG_H_
+
+#include <rtthread.h>
+
+#include "sample_batch.h"
+
+#ifndef SAMPLE_LOG_PARTITION
+#define SAMPLE_LOG_PARTITION        "log"
+#endif
+
+#define SAMPLE_LOG_PAGE_SIZE        256     /* flash program unit */
+#define SAMPLE_LOG_SECTOR_SIZE      4096    /* flash erase unit */
+#define SAMPLE_LOG_SECTOR_PAGES     (SAMPLE_LOG_SECTOR_SIZE / SAMPLE_LOG_PAGE_SIZE)
+
+#define SAMPLE_LOG_MAGIC            0x474f4c53  /* "SLOG" */
+#define SAMPLE_LOG_FORMAT_RAW       1   /* struct sample_log_record array, read only */
+#define SAMPLE_LOG_FORMAT_PACKED    2   /* a sample_codec stream */
+
+/*
+ * Every page starts with this header. Page `seq` is always stored at page
+ * seq % pages of the partition, so the sequence number gives the place
+ * and the place plus the partition's lap gives the sequence number.
+ */
+struct sample_log_page_hdr
+{
+    rt_uint32_t magic;
+    rt_uint32_t seq;                /* pages written before this one */
+    rt_uint16_t boot;               /* boot the sample times count from */
+    rt_uint8_t format;              /* SAMPLE_LOG_FORMAT_* */
+    rt_uint8_t count;               /* samples in the page */
+    rt_uint16_t len;                /* payload bytes after the header */
+    rt_uint16_t reserved;
+    rt_uint32_t crc;                /* CRC-32 of the header up to here and the payload */
+};
+
+#define SAMPLE_LOG_PAYLOAD_MAX      (SAMPLE_LOG_PAGE_SIZE - sizeof(struct sample_log_page_hdr))
+
+/* one sample as stored by SAMPLE_LOG_FORMAT_RAW */
+struct sample_log_record
+{
+    rt_uint32_t time;               /* seconds since boot */
+    rt_int16_t temperature;         /* 0.01 degC */
+    rt_uint16_t humidity;           /* 0.01 %RH */
+};
+
+#define SAMPLE_LOG_RAW_MAX          (SAMPLE_LOG_PAYLOAD_MAX / sizeof(struct sample_log_record))
+/* hdr.count is 8 bits; steady readings pack tighter than this */
+#define SAMPLE_LOG_PACKED_MAX       255
+
+/* a position in the log: the sample `index` of page `seq` */
+struct sample_log_cursor
+{
+    rt_uint32_t seq;
+    rt_uint32_t index;
+    rt_uint16_t boot;               /* boot of the samples last read */
+};
+
+struct sample_log_stat
+{
+    rt_uint32_t added;              /* samples handed to the log */
+    rt_uint32_t dropped;            /* samples lost while both pages waited for flash */
+    rt_uint32_t pages;              /* pages programmed */
+    rt_uint32_t erases;             /* sectors erased */
+    rt_uint32_t deferred;           /* erases put off by the flash driver, and retried */
+    rt_uint32_t errors;             /* failed flash operations */
+    rt_uint32_t skipped;            /* unreadable pages passed over by readers */
+    rt_uint32_t max_write_us;       /* longest page program, erase included */
+};
+
+#ifdef APP_USING_SAMPLE_LOG
+rt_uint32_t sample_log_crc(rt_uint32_t crc, const void *buf, rt_size_t len);
+int sample_log_init(void);
+void sample_log_add(rt_int32_t temperature, rt_int32_t humidity, rt_tick_t tick);
+rt_err_t sample_log_sync(void);
+void sample_log_oldest(struct sample_log_cursor *cur);
+void sample_log_newest(struct sample_log_cursor *cur);
+rt_ssize_t sample_log_read(struct sample_log_cursor *cur, struct sample *buf, rt_size_t max);
+rt_uint16_t sample_log_boot(void);
+rt_uint32_t sample_log_capacity(void);
+const struct sample_log_stat *sample_log_get_stat(void);
+#else
+rt_inline int sample_log_init(void) { return -RT_ENOSYS; }
+rt_inline void sample_log_add(rt_int32_t temperature, rt_int32_t humidity, rt_tick_t tick) {}
+rt_inline rt_uint16_t sample_log_boot(void) { return 0; }
+#endif /* APP_USING_SAMPLE_LOG */
+
+#endif /* APPLICATIONS_SAMPLE_LOG_H_ */
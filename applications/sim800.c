@@ -6,6 +6,9 @@
  * Change Logs:
  * Date           Author       Notes
  * 2023-05-13     khair       the first version
+ * 2026-10-17     khair       write to the modem through the serial device
+ * 2026-10-17     khair       one SMS sender for all alarm texts
+ * 2026-10-17     khair       SMS and calls through the AT client
  */
 /*
  * gprs.c
@@ -19,188 +22,74 @@
 #include <ctype.h>
 #include <rtthread.h>
 #include <rthw.h>
+#include <rtdevice.h>
+#include <at.h>
 #include "pico/stdlib.h"
-#include "hardware/uart.h"
+
+#include "sim800_http.h"
 
 //#include "sim800.h"
 
-#define UART_ID uart1
-#define BAUD_RATE 9600
-#define DATA_BITS 8
-#define STOP_BITS 1
-#define PARITY    UART_PARITY_NONE
-#define UART_TX_PIN 8
-#define UART_RX_PIN 9
-
-void send_data(char *msg, int first_val, int second_val);
-void send_apikey(char *msg, int temp, int humid);
-void send_command(uint8_t *buf);
+#define THINGSPEAK_UPDATE_URL "api.thingspeak.com/update"
+
+int send_data(char *msg, int first_val, int second_val);
 void send_test_sms(void);
 void make_test_call(void);
-void temperature_high_alart(void);
-void humidity_high_alart(void);
-void uart1_init(void);
-
-void send_data(char *msg, int first_val, int second_val){
-    rt_thread_mdelay(1000);
-    send_command("AT\r\n");                                             // Check Communication
-    rt_thread_mdelay(500);
-    send_command("AT+SAPBR=3,1,\"CONTYPE\",\"GPRS\"\r\n");              // Connection type GPRS
-    rt_thread_mdelay(500);
-    send_command("AT+SAPBR=3,1,\"APN\",\"gpinternet\"\r\n");            // APN of the provider
-    rt_thread_mdelay(500);
-    send_command("AT+SAPBR=1,1\r\n");                                   // Open GPRS context
-    rt_thread_mdelay(4000);
-    send_command("AT+SAPBR=2,1\r\n");                                   // Query the GPRS context
-    rt_thread_mdelay(3000);
-    send_command("AT+HTTPINIT\r\n");                                    // Initialize HTTP service
-    rt_thread_mdelay(3000);
-    send_command("AT+HTTPPARA=\"CID\",1\r\n");                          // Set parameters for HTTP session
-    rt_thread_mdelay(3000);
-    send_command("AT+HTTPPARA=\"URL\",\"api.thingspeak.com/update\"\r\n"); // Set parameters for HTTP session
-    rt_thread_mdelay(5000);
-    send_command("AT+HTTPDATA=33,10000\r\n");                           // POST data of size 33 Bytes with maximum latency time of 10seconds for inputting the data
-    rt_thread_mdelay(2000);
-
-    send_apikey(msg, first_val, second_val);
-    rt_thread_mdelay(5000);
-
-    send_command("AT+HTTPACTION=1\r\n");                                 // Start POST session
-    rt_thread_mdelay(4000);
-    send_command("AT+HTTPTERM\r\n");                                     // Terminate HTTP service
-    rt_thread_mdelay(3000);
-    send_command("AT+SAPBR=0,1\r\n");                                    // Close GPRS context
-    rt_thread_mdelay(2000);
-}
+void send_sms(const char *text);
+int sim800_init(void);
 
-void send_apikey(char *msg, int temp, int humid){
-    uint8_t count = 0;
-    uint8_t *api_key;
-    char temp_str[20];
-    char humid_str[20];
-    char tmp1[60];
-    char key_final[60];
-
-    rt_sprintf(temp_str, "%d", temp);
-    rt_sprintf(humid_str, "%d", humid);
-    rt_strcpy(tmp1, msg);
-    strcat(tmp1, temp_str);
-    strcat(tmp1, "&field2=");
-    strcat(tmp1, humid_str);
-    rt_strcpy(key_final, tmp1);
-    strcat(key_final, "\r\n");
-
-    while(count < strlen(key_final))
-        {
-        uart_putc_raw(uart1, key_final[count++]);
-        }
+int send_data(char *msg, int first_val, int second_val){
+    char body[80];
+    int len;
 
-}
+    // api_key=...&field1=<temp>&field2=<humid>, the length goes into AT+HTTPDATA
+    len = rt_snprintf(body, sizeof(body), "%s%d&field2=%d", msg, first_val, second_val);
 
-void send_command(uint8_t *buf){
-    uint8_t *command, count = 0;
-    command = buf;
-    while(count < strlen(command))
-        {
-        uart_putc_raw(uart1, command[count++]);
-        }
+    return sim800_http_post(THINGSPEAK_UPDATE_URL, SIM800_CONTENT_FORM, body, len);
 }
 
+#define SMS_NUMBER "+8801719xxxxxx"   // set your number
 
 void send_test_sms(void)
 {
-   send_command("AT\r\n");                         /* Check Communication */
-   rt_thread_mdelay(500);
-   send_command("AT+CMGF=1\r\n");                  // Configuring TEXT mode
-   rt_thread_mdelay(200);
-   send_command("AT+CMGS=\"+8801719xxxxxx\"\r\n"); // Configuring TEXT mode, set you number
-   rt_thread_mdelay(200);
-   send_command("RISC-V WCH Test Message.\r\n");   // Configuring TEXT mode
-   rt_thread_mdelay(200);
-   uart_putc_raw(uart1, 26);
-   rt_kprintf("SMS Sent");
-   rt_thread_mdelay(500);
+   if (sim800_sms_send(SMS_NUMBER, "RISC-V WCH Test Message.") == RT_EOK)
+      rt_kprintf("SMS Sent\n");
 }
 
 void make_test_call(void)
 {
-   send_command("AT\r\n");               /* Check Communication */
-   rt_thread_mdelay(2500);
-   send_command("ATD+01719xxxxxx;\r\n"); // Configuring TEXT mode
-   rt_thread_mdelay(10000);
-   rt_thread_mdelay(10000);
-   send_command("ATH\r\n");
-   rt_kprintf("\r\nCall Sent");
-   rt_thread_mdelay(500);
+   at_client_t client = at_client_get(SIM800_AT_DEVICE);
+   at_response_t resp;
+
+   resp = at_create_resp(64, 0, rt_tick_from_millisecond(5000));
+   if (resp == RT_NULL)
+      return;
+   // through the client's own buffer and lock, waiting for each "OK"
+   if (at_obj_exec_cmd(client, resp, "ATD+01719xxxxxx;") == RT_EOK)
+   {
+      rt_thread_mdelay(20000);
+      at_obj_exec_cmd(client, resp, "ATH");
+      rt_kprintf("\r\nCall Sent");
+   }
+   at_delete_resp(resp);
 }
 
 
-void temperature_high_alart(void)
+void send_sms(const char *text)
 {
-   send_command("AT\r\n");                         /* Check Communication */
-   rt_thread_mdelay(500);
-   send_command("AT+CMGF=1\r\n");                  // Configuring TEXT mode
-   rt_thread_mdelay(200);
-   send_command("AT+CMGS=\"+8801719xxxxxx\"\r\n"); // Configuring TEXT mode, set your number
-   rt_thread_mdelay(200);
-   send_command("Temperature is higher than normal.\r\n");   // Configuring TEXT mode
-   rt_thread_mdelay(200);
-   uart_putc_raw(uart1, 26);
-   rt_kprintf("SMS Sent\n");
-   rt_thread_mdelay(500);
+   // copied by the HTTP engine, sent between its posts
+   if (sim800_sms_send(SMS_NUMBER, text) == RT_EOK)
+      rt_kprintf("SMS Sent\n");
 }
 
-void humidity_high_alart(void)
-{
-   send_command("AT\r\n");                         /* Check Communication */
-   rt_thread_mdelay(500);
-   send_command("AT+CMGF=1\r\n");                  // Configuring TEXT mode
-   rt_thread_mdelay(200);
-   send_command("AT+CMGS=\"+8801719xxxxxx\"\r\n"); // Configuring TEXT mode
-   rt_thread_mdelay(200);
-   send_command("Humidity is higher than normal.\r\n");   // Configuring TEXT mode
-   rt_thread_mdelay(200);
-   uart_putc_raw(uart1, 26);
-   rt_kprintf("SMS Sent\n");
-   rt_thread_mdelay(500);
-}
 
-
-void uart1_init(void)
+int sim800_init(void)
 {
-   // Set up our UART with a basic baud rate.
-   uart_init(UART_ID, 9600);
-
-   // Set the TX and RX pins by using the function select on the GPIO
-   // Set datasheet for more information on function select
-   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
-   gpio_set_function(UART_RX_PIN, GPIO_FUNC_UART);
-
-   // Actually, we want a different speed
-   // The call will return the actual baud rate selected, which will be as close as
-   // possible to that requested
-   uart_set_baudrate(UART_ID, BAUD_RATE);
-
-   // Set UART flow control CTS/RTS, we don't want these, so turn them off
-   uart_set_hw_flow(UART_ID, false, false);
-
-   // Set our data format
-   uart_set_format(UART_ID, DATA_BITS, STOP_BITS, PARITY);
-
-   // Turn off FIFO's - we want to do this character by character
-   ///uart_set_fifo_enabled(UART_ID, false);
-
-   // Set up a RX interrupt
-   // We need to set up the handler first
-   // Select correct interrupt for the UART we are using
-
-
-    // And set up and enable the interrupt handlers
-    ///irq_set_exclusive_handler(UART1_IRQ, on_uart_rx);
-    ///irq_set_enabled(UART1_IRQ, true);
+   int result;
 
-    // Now enable the UART to send interrupts - RX only
-    ///uart_set_irq_enables(UART_ID, true, false);
+   // uart1 itself is set up by drv_uart, the AT client opens it from here
+   // and every write to the modem goes through the client
+   result = sim800_http_init();
 
-    ///uart_puts(UART_ID, "\nHello, uart interrupts\n");
+   return result;
 }
@@ -10,13 +10,11 @@
 #ifndef APPLICATIONS_SIM800_H_
 #define APPLICATIONS_SIM800_H_
 /*
-void send_data(char *msg, int first_val, int second_val);
-void send_apikey(char *msg, int temp, int humid);
-void send_command(uint8_t *buf);
+int send_data(char *msg, int first_val, int second_val);
 void send_test_sms(void);
 void make_test_call(void);
-void temperature_high_alart(void);
-void humidity_high_alart(void);
+void send_sms(const char *text);
+int sim800_init(void);
 */
 
 #endif /* APPLICATIONS_SIM800_H_ */
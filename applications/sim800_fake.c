@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        scripted SIM800 stand-in for the upload engine
+ * 2026-10-17     khair        lock-free receive ring
+ * 2026-10-17     khair        SMS prompt and text
+ */
+/*
+ * "fmodem": a character device that behaves like a SIM800 on the other end
+ * of the serial line. It keeps the bearer / HTTP service state the real
+ * modem keeps, answers with the same lines, and delays every answer by a
+ * configurable latency, so the upload engine can be run (and timed) on a
+ * board without a modem, or on any RT-Thread target.
+ *
+ * msh>fmodem                       show state and counters
+ * msh>fmodem delay <cmd> <net>     reply latency of plain / network commands, ms
+ * msh>fmodem status <code>         HTTP status reported by +HTTPACTION
+ * msh>fmodem fail <prefix>         answer ERROR to commands starting with prefix
+ * msh>fmodem mute <prefix>         never answer commands starting with prefix
+ * msh>fmodem clear                 remove fail / mute rules
+ * msh>fmodem drop                  network drops the bearer (+SAPBR 1: DEACT)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef SIM800_USING_FAKE_MODEM
+
+#define FMODEM_RX_BUFSZ         256
+#define FMODEM_LINE_MAX         160
+#define FMODEM_REPLY_MAX        48
+#define FMODEM_REPLY_NUM        8
+
+struct fmodem_reply
+{
+    rt_uint32_t delay_ms;
+    char text[FMODEM_REPLY_MAX];
+};
+
+struct fmodem
+{
+    struct rt_device parent;
+
+    struct rt_spscring rx;              /* worker -> AT client, no lock */
+    rt_uint8_t rx_pool[FMODEM_RX_BUFSZ];
+    rt_mq_t replies;
+    rt_thread_t worker;
+
+    char line[FMODEM_LINE_MAX];
+    rt_size_t line_len;
+    rt_bool_t line_end;             /* a '\r' just ended a line, its '\n' is not data */
+    rt_size_t data_left;            /* bytes still expected after DOWNLOAD */
+    rt_bool_t sms_text;             /* taking an SMS text after the "> " prompt */
+
+    rt_bool_t bearer_open;
+    rt_bool_t http_init;
+
+    /* script */
+    rt_uint32_t cmd_delay_ms;
+    rt_uint32_t net_delay_ms;
+    int http_status;
+    char fail_prefix[24];
+    char mute_prefix[24];
+
+    /* counters */
+    rt_uint32_t commands;
+    rt_uint32_t data_bytes;
+    rt_uint32_t sms_bytes;
+    rt_uint32_t sms_sent;
+};
+
+static struct fmodem fmodem;
+
+static void fmodem_queue(struct fmodem *fm, rt_uint32_t delay_ms, const char *fmt, ...)
+{
+    struct fmodem_reply reply;
+    va_list args;
+
+    reply.delay_ms = delay_ms;
+    va_start(args, fmt);
+    rt_vsnprintf(reply.text, sizeof(reply.text), fmt, args);
+    va_end(args);
+
+    rt_mq_send(fm->replies, &reply, sizeof(reply));
+}
+
+static rt_bool_t fmodem_match(const char *cmd, const char *prefix)
+{
+    return prefix[0] && !rt_strncmp(cmd, prefix, rt_strlen(prefix));
+}
+
+/* answer one complete command line, the same way a SIM800 would */
+static void fmodem_command(struct fmodem *fm, const char *cmd)
+{
+    rt_uint32_t d = fm->cmd_delay_ms;
+    int n = 0;
+
+    fm->commands++;
+
+    if (fmodem_match(cmd, fm->mute_prefix))
+        return;
+    if (fmodem_match(cmd, fm->fail_prefix))
+    {
+        fmodem_queue(fm, d, "\r\nERROR\r\n");
+        return;
+    }
+
+    if (!rt_strcmp(cmd, "AT+SAPBR=1,1"))
+    {
+        fmodem_queue(fm, fm->net_delay_ms, fm->bearer_open ? "\r\nERROR\r\n" : "\r\nOK\r\n");
+        fm->bearer_open = RT_TRUE;
+    }
+    else if (!rt_strcmp(cmd, "AT+SAPBR=0,1"))
+    {
+        fmodem_queue(fm, fm->net_delay_ms, fm->bearer_open ? "\r\nOK\r\n" : "\r\nERROR\r\n");
+        fm->bearer_open = RT_FALSE;
+        fm->http_init = RT_FALSE;
+    }
+    else if (!rt_strcmp(cmd, "AT+SAPBR=2,1"))
+    {
+        if (fm->bearer_open)
+            fmodem_queue(fm, d, "\r\n+SAPBR: 1,1,\"10.120.7.33\"\r\n");
+        else
+            fmodem_queue(fm, d, "\r\n+SAPBR: 1,3,\"0.0.0.0\"\r\n");
+        fmodem_queue(fm, 0, "\r\nOK\r\n");
+    }
+    else if (!rt_strcmp(cmd, "AT+HTTPINIT"))
+    {
+        fmodem_queue(fm, d, (fm->http_init || !fm->bearer_open) ? "\r\nERROR\r\n" : "\r\nOK\r\n");
+        fm->http_init = fm->bearer_open;
+    }
+    else if (!rt_strcmp(cmd, "AT+HTTPTERM"))
+    {
+        fmodem_queue(fm, d, fm->http_init ? "\r\nOK\r\n" : "\r\nERROR\r\n");
+        fm->http_init = RT_FALSE;
+    }
+    else if (!rt_strncmp(cmd, "AT+HTTPPARA=", 12))
+    {
+        fmodem_queue(fm, d, fm->http_init ? "\r\nOK\r\n" : "\r\nERROR\r\n");
+    }
+    else if (sscanf(cmd, "AT+HTTPDATA=%d", &n) == 1)
+    {
+        if (!fm->http_init || n <= 0)
+        {
+            fmodem_queue(fm, d, "\r\nERROR\r\n");
+            return;
+        }
+        fm->data_left = n;
+        fmodem_queue(fm, d, "\r\nDOWNLOAD\r\n");
+    }
+    else if (!rt_strncmp(cmd, "AT+HTTPACTION=", 14))
+    {
+        if (!fm->http_init)
+        {
+            fmodem_queue(fm, d, "\r\nERROR\r\n");
+            return;
+        }
+        fmodem_queue(fm, d, "\r\nOK\r\n");
+        fmodem_queue(fm, fm->net_delay_ms, "\r\n+HTTPACTION: 1,%d,%d\r\n",
+                     fm->http_status, fm->http_status == 200 ? 4 : 0);
+    }
+    else if (!rt_strncmp(cmd, "AT+CMGS=", 8))
+    {
+        /* the text follows the prompt, up to Ctrl-Z */
+        fm->sms_text = RT_TRUE;
+        fmodem_queue(fm, d, "\r\n> ");
+    }
+    else if (!rt_strncmp(cmd, "AT", 2))
+    {
+        fmodem_queue(fm, d, "\r\nOK\r\n");
+    }
+}
+
+static void fmodem_worker(void *parameter)
+{
+    struct fmodem *fm = (struct fmodem *)parameter;
+    struct fmodem_reply reply;
+    rt_size_t len;
+
+    while (1)
+    {
+        if (rt_mq_recv(fm->replies, &reply, sizeof(reply), RT_WAITING_FOREVER) != RT_EOK)
+            continue;
+
+        if (reply.delay_ms)
+            rt_thread_mdelay(reply.delay_ms);
+
+        len = rt_spscring_put(&fm->rx, (rt_uint8_t *)reply.text, rt_strlen(reply.text));
+
+        if (len && fm->parent.rx_indicate)
+            fm->parent.rx_indicate(&fm->parent, len);
+    }
+}
+
+static rt_err_t fmodem_open(rt_device_t dev, rt_uint16_t oflag)
+{
+    return RT_EOK;
+}
+
+static rt_ssize_t fmodem_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    struct fmodem *fm = (struct fmodem *)dev;
+
+    return rt_spscring_get(&fm->rx, buffer, size);
+}
+
+static rt_ssize_t fmodem_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    struct fmodem *fm = (struct fmodem *)dev;
+    const char *p = buffer;
+    rt_size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        if (fm->line_end && p[i] == '\n')
+        {
+            fm->line_end = RT_FALSE;
+            continue;
+        }
+        fm->line_end = RT_FALSE;
+
+        if (fm->data_left)
+        {
+            fm->data_bytes++;
+            if (--fm->data_left == 0)
+                fmodem_queue(fm, fm->cmd_delay_ms, "\r\nOK\r\n");
+            continue;
+        }
+
+        if (fm->sms_text)
+        {
+            if (p[i] == 0x1a)
+            {
+                fm->sms_text = RT_FALSE;
+                fmodem_queue(fm, fm->net_delay_ms, "\r\n+CMGS: %d\r\n", ++fm->sms_sent & 0xff);
+                fmodem_queue(fm, 0, "\r\nOK\r\n");
+            }
+            else if (p[i] == 0x1b)
+            {
+                /* ESC: the message is dropped */
+                fm->sms_text = RT_FALSE;
+            }
+            else
+            {
+                fm->sms_bytes++;
+            }
+            continue;
+        }
+
+        if (p[i] == '\r')
+        {
+            fm->line_end = RT_TRUE;
+            fm->line[fm->line_len] = '\0';
+            if (fm->line_len)
+                fmodem_command(fm, fm->line);
+            fm->line_len = 0;
+        }
+        else if (p[i] != '\n' && p[i] != 0x1b && fm->line_len < FMODEM_LINE_MAX - 1)
+        {
+            fm->line[fm->line_len++] = p[i];
+        }
+    }
+
+    return size;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops fmodem_ops =
+{
+    RT_NULL,
+    fmodem_open,
+    RT_NULL,
+    fmodem_read,
+    fmodem_write,
+    RT_NULL,
+};
+#endif
+
+int rt_hw_fmodem_init(void)
+{
+    struct fmodem *fm = &fmodem;
+
+    rt_spscring_init(&fm->rx, fm->rx_pool, sizeof(fm->rx_pool));
+    fm->replies = rt_mq_create("fmodem", sizeof(struct fmodem_reply), FMODEM_REPLY_NUM, RT_IPC_FLAG_FIFO);
+    fm->worker = rt_thread_create("fmodem", fmodem_worker, fm, 512, RT_THREAD_PRIORITY_MAX / 3, 5);
+    if (fm->replies == RT_NULL || fm->worker == RT_NULL)
+        return -RT_ENOMEM;
+
+    fm->cmd_delay_ms = 20;
+    fm->net_delay_ms = 600;
+    fm->http_status = 200;
+
+    fm->parent.type = RT_Device_Class_Char;
+#ifdef RT_USING_DEVICE_OPS
+    fm->parent.ops = &fmodem_ops;
+#else
+    fm->parent.open = fmodem_open;
+    fm->parent.read = fmodem_read;
+    fm->parent.write = fmodem_write;
+#endif
+
+    rt_thread_startup(fm->worker);
+
+    return rt_device_register(&fm->parent, "fmodem", RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX);
+}
+INIT_DEVICE_EXPORT(rt_hw_fmodem_init);
+
+#ifdef RT_USING_FINSH
+static void fmodem_cmd(int argc, char **argv)
+{
+    struct fmodem *fm = &fmodem;
+
+    if (argc == 4 && !rt_strcmp(argv[1], "delay"))
+    {
+        fm->cmd_delay_ms = atoi(argv[2]);
+        fm->net_delay_ms = atoi(argv[3]);
+    }
+    else if (argc == 3 && !rt_strcmp(argv[1], "status"))
+    {
+        fm->http_status = atoi(argv[2]);
+    }
+    else if (argc == 3 && !rt_strcmp(argv[1], "fail"))
+    {
+        rt_strncpy(fm->fail_prefix, argv[2], sizeof(fm->fail_prefix) - 1);
+    }
+    else if (argc == 3 && !rt_strcmp(argv[1], "mute"))
+    {
+        rt_strncpy(fm->mute_prefix, argv[2], sizeof(fm->mute_prefix) - 1);
+    }
+    else if (argc == 2 && !rt_strcmp(argv[1], "clear"))
+    {
+        fm->fail_prefix[0] = '\0';
+        fm->mute_prefix[0] = '\0';
+    }
+    else if (argc == 2 && !rt_strcmp(argv[1], "drop"))
+    {
+        if (fm->bearer_open)
+            fmodem_queue(fm, 0, "\r\n+SAPBR 1: DEACT\r\n");
+        fm->bearer_open = RT_FALSE;
+        fm->http_init = RT_FALSE;
+    }
+    else if (argc != 1)
+    {
+        rt_kprintf("Usage: fmodem [delay <cmd_ms> <net_ms> | status <code> | fail <prefix> | mute <prefix> | clear | drop]\n");
+        return;
+    }
+
+    rt_kprintf("bearer %s, http %s\n", fm->bearer_open ? "open" : "closed", fm->http_init ? "init" : "term");
+    rt_kprintf("latency %d/%d ms, HTTP status %d\n", fm->cmd_delay_ms, fm->net_delay_ms, fm->http_status);
+    rt_kprintf("fail '%s', mute '%s'\n", fm->fail_prefix, fm->mute_prefix);
+    rt_kprintf("%d commands, %d body bytes, %d SMS (%d bytes)\n", fm->commands, fm->data_bytes, fm->sms_sent,
+               fm->sms_bytes);
+}
+MSH_CMD_EXPORT_ALIAS(fmodem_cmd, fmodem, scripted SIM800 modem);
+#endif /* RT_USING_FINSH */
+
+#endif /* SIM800_USING_FAKE_MODEM */
@@ -0,0 +1,648 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        response-driven HTTP upload engine
+ * 2026-10-17     khair        keep the bearer and HTTP service up between posts
+ * 2026-10-17     khair        per-post Content-Type for JSON bodies
+ * 2026-10-17     khair        trace every AT command
+ * 2026-10-17     khair        SMS through the AT client
+ * 2026-10-17     khair        hold requests off around flash erases
+ * 2026-10-17     khair        send the SMS cancel from a byte of its own
+ * 2026-10-17     khair        put a flash erase off instead of waiting for a post
+ */
+/*
+ * HTTP POST over the SIM800 built-in HTTP stack.
+ *
+ * Every step of the upload is one AT command executed through the
+ * RT-Thread AT client: the step finishes as soon as the modem answers
+ * "OK" (or "ERROR"), or when its own timeout runs out. The lines the
+ * modem sends on its own are handled as URCs:
+ *
+ *   DOWNLOAD          - the modem is ready for the request body
+ *   "> "              - the modem is ready for the text of an SMS
+ *   +HTTPACTION: ...  - the request has completed, carries the HTTP status
+ *   +SAPBR 1: DEACT   - the network has dropped the bearer
+ *
+ * The bearer and the HTTP service are opened once and kept up, so a post
+ * on a live connection is just URL (when it changed), HTTPDATA and
+ * HTTPACTION. When a step fails the connection is downgraded to what is
+ * still known to work and the post is retried once from there.
+ *
+ * SMS go through the same client and lock, so their bytes never land in
+ * the middle of a request body. A flash erase takes the lock as well, so
+ * no answer is due from the modem while interrupts are off for it; when
+ * the lock is taken, the erase is put off rather than waiting.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <at.h>
+
+#include "sim800_http.h"
+#include "trace.h"
+
+#ifdef BSP_USING_ON_CHIP_FLASH
+#include "drv_flash.h"
+#endif
+
+#define DBG_TAG "sim800"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#define SIM800_HTTP_ACTION_POST     1
+#define SIM800_HTTPDATA_WINDOW_MS   10000
+#define SIM800_POST_ATTEMPTS        2
+#define SIM800_CMGS_TIMEOUT_MS      60000
+#define SIM800_CTRL_Z               0x1a
+#define SIM800_ESC                  0x1b
+
+struct sim800_http
+{
+    at_client_t client;
+    at_response_t resp;
+    rt_mutex_t lock;
+    rt_sem_t action_done;
+
+    /* connection kept between posts */
+    volatile enum sim800_conn_state conn;
+    char conn_url[AT_CMD_MAX_LEN];  /* URL currently set in the HTTP service */
+    char conn_content[40];          /* Content-Type currently set */
+    rt_tick_t last_activity;
+
+    /* request being uploaded */
+    const char *url;
+    const char *content_type;
+    const char *body;
+    rt_size_t body_len;
+    volatile rt_bool_t body_pending;
+
+    /* SMS being sent: the text and its Ctrl-Z, copied to RAM for the DMA */
+    char sms[SIM800_SMS_MAX_LEN + 1];
+    rt_size_t sms_len;
+    volatile rt_bool_t sms_pending;
+    rt_bool_t erasing;              /* a flash erase holds `lock` */
+
+    /* result of the last +HTTPACTION URC */
+    volatile int action_status;
+    volatile int action_len;
+
+    enum sim800_http_state failed_state;
+    struct sim800_http_stat stat;
+};
+
+static struct sim800_http sim800_http;
+/* the cancel, sent by itself; in RAM, as DMA cannot read flash during an erase */
+static rt_uint8_t sim800_esc = SIM800_ESC;
+
+static const char *const state_names[SIM800_HTTP_STATE_MAX] =
+{
+    "idle", "probe", "contype", "apn", "bearer", "query", "httpinit",
+    "cid", "url", "content", "data", "action", "httpterm", "close", "done", "fail",
+};
+
+const char *sim800_http_state_name(enum sim800_http_state state)
+{
+    if (state >= SIM800_HTTP_STATE_MAX)
+        return "?";
+    return state_names[state];
+}
+
+static void urc_download_func(struct at_client *client, const char *data, rt_size_t size)
+{
+    /* the client lock is held by the thread waiting for HTTPDATA's "OK",
+     * so the body goes straight to the device */
+    if (sim800_http.body_pending)
+    {
+        rt_device_write(client->device, 0, sim800_http.body, sim800_http.body_len);
+        sim800_http.body_pending = RT_FALSE;
+    }
+}
+
+static void urc_sms_prompt_func(struct at_client *client, const char *data, rt_size_t size)
+{
+    /* as for DOWNLOAD, the thread waiting for AT+CMGS's "OK" holds the lock */
+    if (sim800_http.sms_pending)
+    {
+        rt_device_write(client->device, 0, sim800_http.sms, sim800_http.sms_len);
+        sim800_http.sms_pending = RT_FALSE;
+    }
+}
+
+static void urc_httpaction_func(struct at_client *client, const char *data, rt_size_t size)
+{
+    int method = 0, status = -1, len = 0;
+
+    if (sscanf(data, "+HTTPACTION: %d,%d,%d", &method, &status, &len) < 2)
+    {
+        LOG_W("unexpected URC: %.*s", size, data);
+        return;
+    }
+
+    sim800_http.action_status = status;
+    sim800_http.action_len = len;
+    rt_sem_release(sim800_http.action_done);
+}
+
+static void urc_deact_func(struct at_client *client, const char *data, rt_size_t size)
+{
+    LOG_W("bearer deactivated by the network");
+    sim800_http.conn = SIM800_CONN_DOWN;
+    sim800_http.stat.deacts++;
+}
+
+static const struct at_urc urc_table[] =
+{
+    {"DOWNLOAD",        "\r\n", urc_download_func},
+    {"> ",              "",     urc_sms_prompt_func},
+    {"+HTTPACTION:",    "\r\n", urc_httpaction_func},
+    {"+SAPBR 1: DEACT", "\r\n", urc_deact_func},
+};
+
+/* run one command and wait for its final result code */
+static int sim800_http_exec(struct sim800_http *http, rt_uint32_t timeout_ms, const char *cmd)
+{
+    int result;
+
+    at_resp_set_info(http->resp, SIM800_RESP_BUFF_LEN, 0, rt_tick_from_millisecond(timeout_ms));
+    trace_begin(TRACE_AT_SEND, timeout_ms);
+    result = at_obj_exec_cmd(http->client, http->resp, "%s", cmd);
+    trace_end(TRACE_AT_ACK, result);
+    if (result == -RT_ETIMEOUT)
+        http->stat.timeouts++;
+    else
+        http->last_activity = rt_tick_get();
+
+    return result;
+}
+
+static enum sim800_http_state sim800_http_fail(struct sim800_http *http, enum sim800_http_state state)
+{
+    http->failed_state = state;
+    return SIM800_HTTP_FAIL;
+}
+
+/* execute `state` and return the state to enter next */
+static enum sim800_http_state sim800_http_step(struct sim800_http *http, enum sim800_http_state state)
+{
+    char cmd[AT_CMD_MAX_LEN];
+    int bearer = 0;
+
+    switch (state)
+    {
+    case SIM800_HTTP_PROBE:
+        if (sim800_http_exec(http, 1000, "ATE0") != RT_EOK)
+            return sim800_http_fail(http, state);
+        return SIM800_HTTP_BEARER_CONTYPE;
+
+    case SIM800_HTTP_BEARER_CONTYPE:
+        if (sim800_http_exec(http, 1000, "AT+SAPBR=3,1,\"CONTYPE\",\"GPRS\"") != RT_EOK)
+            return sim800_http_fail(http, state);
+        return SIM800_HTTP_BEARER_APN;
+
+    case SIM800_HTTP_BEARER_APN:
+        rt_snprintf(cmd, sizeof(cmd), "AT+SAPBR=3,1,\"APN\",\"%s\"", SIM800_APN);
+        if (sim800_http_exec(http, 1000, cmd) != RT_EOK)
+            return sim800_http_fail(http, state);
+        return SIM800_HTTP_BEARER_OPEN;
+
+    case SIM800_HTTP_BEARER_OPEN:
+        /* ERROR here usually means the bearer is already up, the query decides */
+        if (sim800_http_exec(http, 30000, "AT+SAPBR=1,1") == -RT_ETIMEOUT)
+            return sim800_http_fail(http, state);
+        return SIM800_HTTP_BEARER_QUERY;
+
+    case SIM800_HTTP_BEARER_QUERY:
+        if (sim800_http_exec(http, 2000, "AT+SAPBR=2,1") != RT_EOK
+                || at_resp_parse_line_args_by_kw(http->resp, "+SAPBR:", "+SAPBR: %*d,%d", &bearer) <= 0
+                || bearer != 1)
+        {
+            LOG_W("bearer not connected (status %d)", bearer);
+            http->conn = SIM800_CONN_DOWN;
+            return sim800_http_fail(http, state);
+        }
+        /* a healthy link that was only being re-checked goes straight on */
+        if (http->conn == SIM800_CONN_READY)
+            return SIM800_HTTP_URL;
+        http->conn = SIM800_CONN_BEARER;
+        return SIM800_HTTP_INIT;
+
+    case SIM800_HTTP_INIT:
+        if (sim800_http_exec(http, 2000, "AT+HTTPINIT") != RT_EOK)
+        {
+            /* a previous session may have been left open, close it and retry once */
+            sim800_http_exec(http, 2000, "AT+HTTPTERM");
+            if (sim800_http_exec(http, 2000, "AT+HTTPINIT") != RT_EOK)
+                return sim800_http_fail(http, state);
+        }
+        return SIM800_HTTP_CID;
+
+    case SIM800_HTTP_CID:
+        if (sim800_http_exec(http, 1000, "AT+HTTPPARA=\"CID\",1") != RT_EOK)
+            return sim800_http_fail(http, state);
+        http->conn = SIM800_CONN_READY;
+        http->conn_url[0] = '\0';
+        http->conn_content[0] = '\0';
+        return SIM800_HTTP_URL;
+
+    case SIM800_HTTP_URL:
+        if (!rt_strcmp(http->conn_url, http->url))
+            return SIM800_HTTP_CONTENT;
+        rt_snprintf(cmd, sizeof(cmd), "AT+HTTPPARA=\"URL\",\"%s\"", http->url);
+        if (sim800_http_exec(http, 1000, cmd) != RT_EOK)
+            return sim800_http_fail(http, state);
+        rt_strncpy(http->conn_url, http->url, sizeof(http->conn_url) - 1);
+        return SIM800_HTTP_CONTENT;
+
+    case SIM800_HTTP_CONTENT:
+        if (!rt_strcmp(http->conn_content, http->content_type))
+            return SIM800_HTTP_DATA;
+        rt_snprintf(cmd, sizeof(cmd), "AT+HTTPPARA=\"CONTENT\",\"%s\"", http->content_type);
+        if (sim800_http_exec(http, 1000, cmd) != RT_EOK)
+            return sim800_http_fail(http, state);
+        rt_strncpy(http->conn_content, http->content_type, sizeof(http->conn_content) - 1);
+        return SIM800_HTTP_DATA;
+
+    case SIM800_HTTP_DATA:
+        rt_snprintf(cmd, sizeof(cmd), "AT+HTTPDATA=%d,%d", http->body_len, SIM800_HTTPDATA_WINDOW_MS);
+        http->body_pending = RT_TRUE;
+        /* the body is written by the DOWNLOAD URC, "OK" follows once the
+         * modem has received all of it (10 bits per byte at 9600 baud) */
+        if (sim800_http_exec(http, 2000 + http->body_len * 10 * 1000 / 9600, cmd) != RT_EOK)
+        {
+            http->body_pending = RT_FALSE;
+            return sim800_http_fail(http, state);
+        }
+        return SIM800_HTTP_ACTION;
+
+    case SIM800_HTTP_ACTION:
+        http->action_status = -1;
+        rt_sem_control(http->action_done, RT_IPC_CMD_RESET, RT_NULL);
+        rt_snprintf(cmd, sizeof(cmd), "AT+HTTPACTION=%d", SIM800_HTTP_ACTION_POST);
+        if (sim800_http_exec(http, 2000, cmd) != RT_EOK)
+            return sim800_http_fail(http, state);
+        if (rt_sem_take(http->action_done, rt_tick_from_millisecond(30000)) != RT_EOK)
+        {
+            LOG_W("no +HTTPACTION within 30 s");
+            http->stat.timeouts++;
+            return sim800_http_fail(http, state);
+        }
+        http->stat.last_status = http->action_status;
+        if (http->action_status < 200 || http->action_status > 299)
+        {
+            LOG_W("POST %s returned %d", http->url, http->action_status);
+            return sim800_http_fail(http, state);
+        }
+        return SIM800_HTTP_DONE;
+
+    case SIM800_HTTP_TERM:
+        sim800_http_exec(http, 2000, "AT+HTTPTERM");
+        http->conn = SIM800_CONN_BEARER;
+        return SIM800_HTTP_BEARER_CLOSE;
+
+    case SIM800_HTTP_BEARER_CLOSE:
+        sim800_http_exec(http, 10000, "AT+SAPBR=0,1");
+        http->conn = SIM800_CONN_DOWN;
+        return SIM800_HTTP_DONE;
+
+    default:
+        return SIM800_HTTP_FAIL;
+    }
+}
+
+/* where a post starts, given what is known to be up */
+static enum sim800_http_state sim800_http_entry(struct sim800_http *http)
+{
+    switch (http->conn)
+    {
+    case SIM800_CONN_READY:
+        if (rt_tick_get() - http->last_activity < rt_tick_from_millisecond(SIM800_CONN_CHECK_MS))
+            return SIM800_HTTP_URL;
+        return SIM800_HTTP_BEARER_QUERY;
+    case SIM800_CONN_BEARER:
+        return SIM800_HTTP_BEARER_QUERY;
+    default:
+        return SIM800_HTTP_PROBE;
+    }
+}
+
+/* after a failed post, fall back to the part of the connection that can
+ * still be trusted */
+static void sim800_http_recover(struct sim800_http *http)
+{
+    if (http->failed_state >= SIM800_HTTP_URL && http->failed_state <= SIM800_HTTP_ACTION)
+    {
+        /* the HTTP service is in an unknown state, restart it */
+        sim800_http_exec(http, 2000, "AT+HTTPTERM");
+        if (http->conn != SIM800_CONN_DOWN)
+            http->conn = SIM800_CONN_BEARER;
+    }
+    else if (http->failed_state <= SIM800_HTTP_BEARER_QUERY)
+    {
+        http->conn = SIM800_CONN_DOWN;
+    }
+    else if (http->conn == SIM800_CONN_READY)
+    {
+        http->conn = SIM800_CONN_BEARER;
+    }
+    http->conn_url[0] = '\0';
+}
+
+static enum sim800_http_state sim800_http_run(struct sim800_http *http, enum sim800_http_state state)
+{
+    enum sim800_http_state next;
+    rt_tick_t start = 0, step_start;
+    rt_bool_t connecting = RT_FALSE;
+
+    http->failed_state = SIM800_HTTP_IDLE;
+
+    for (; state != SIM800_HTTP_DONE && state != SIM800_HTTP_FAIL; state = next)
+    {
+        if (state == SIM800_HTTP_PROBE || state == SIM800_HTTP_INIT)
+        {
+            if (!connecting)
+                start = rt_tick_get();
+            connecting = RT_TRUE;
+        }
+
+        step_start = rt_tick_get();
+        next = sim800_http_step(http, state);
+        http->stat.step_ticks[state] = rt_tick_get() - step_start;
+
+        if (connecting && http->conn == SIM800_CONN_READY)
+        {
+            if (http->stat.connects++)
+                http->stat.reconnects++;
+            http->stat.connect_ticks = rt_tick_get() - start;
+            connecting = RT_FALSE;
+        }
+    }
+
+    return state;
+}
+
+/**
+ * POST `len` bytes of `body` to `url` as `content_type` and wait for the
+ * HTTP result.
+ *
+ * The connection from the previous post is reused; it is only brought
+ * up again when it is down or a step on it fails.
+ *
+ * @return RT_EOK when the server answered with a 2xx status,
+ *         -RT_ETIMEOUT when the modem stopped answering,
+ *         -RT_ERROR for any other failure.
+ */
+int sim800_http_post(const char *url, const char *content_type, const char *body, rt_size_t len)
+{
+    struct sim800_http *http = &sim800_http;
+    enum sim800_http_state state = SIM800_HTTP_FAIL;
+    struct sim800_http_stat *stat = &http->stat;
+    rt_uint32_t timeouts;
+    rt_tick_t start;
+    int attempt;
+
+    if (http->client == RT_NULL)
+        return -RT_ERROR;
+
+    rt_mutex_take(http->lock, RT_WAITING_FOREVER);
+
+    http->url = url;
+    http->content_type = content_type;
+    http->body = body;
+    http->body_len = len;
+    stat->posts++;
+    stat->last_status = -1;
+    timeouts = stat->timeouts;
+    rt_memset(stat->step_ticks, 0, sizeof(stat->step_ticks));
+
+    start = rt_tick_get();
+    for (attempt = 0; attempt < SIM800_POST_ATTEMPTS; attempt++)
+    {
+        state = sim800_http_run(http, sim800_http_entry(http));
+        if (state == SIM800_HTTP_DONE)
+            break;
+
+        LOG_W("post failed in state '%s'", sim800_http_state_name(http->failed_state));
+        /* the server answered, the link is fine and a retry would not help */
+        if (http->failed_state == SIM800_HTTP_ACTION && stat->last_status > 0)
+            break;
+        sim800_http_recover(http);
+    }
+
+    stat->last_ticks = rt_tick_get() - start;
+    if (stat->last_ticks > stat->max_ticks)
+        stat->max_ticks = stat->last_ticks;
+
+    if (state == SIM800_HTTP_DONE)
+    {
+        if (stat->ok_posts++ == 0 || stat->last_ticks < stat->min_ticks)
+            stat->min_ticks = stat->last_ticks;
+        stat->sum_ticks += stat->last_ticks;
+    }
+    else
+    {
+        stat->failures++;
+        stat->last_fail_state = http->failed_state;
+        LOG_E("upload failed in state '%s'", sim800_http_state_name(http->failed_state));
+    }
+
+    rt_mutex_release(http->lock);
+
+    if (state == SIM800_HTTP_DONE)
+        return RT_EOK;
+    return stat->timeouts != timeouts ? -RT_ETIMEOUT : -RT_ERROR;
+}
+
+/**
+ * Terminate the HTTP service and close the bearer, e.g. before the modem
+ * is powered down. The next post brings them up again.
+ */
+void sim800_http_close(void)
+{
+    struct sim800_http *http = &sim800_http;
+
+    if (http->client == RT_NULL)
+        return;
+
+    rt_mutex_take(http->lock, RT_WAITING_FOREVER);
+    sim800_http_run(http, SIM800_HTTP_TERM);
+    http->conn_url[0] = '\0';
+    http->conn_content[0] = '\0';
+    rt_mutex_release(http->lock);
+}
+
+/**
+ * Send a text message, in text mode. The text is copied, so it need not
+ * outlive the call; a longer one than SIM800_SMS_MAX_LEN is cut. The call
+ * waits for any post in progress, and then for the network to take the
+ * message, which may be many seconds.
+ *
+ * @return RT_EOK when the modem reported the message sent,
+ *         -RT_ETIMEOUT when it stopped answering,
+ *         -RT_ERROR or -RT_EBUSY (the AT CLI is on) for any other failure.
+ */
+int sim800_sms_send(const char *number, const char *text)
+{
+    struct sim800_http *http = &sim800_http;
+    char cmd[40];
+    int result;
+
+    if (http->client == RT_NULL)
+        return -RT_ERROR;
+
+    rt_mutex_take(http->lock, RT_WAITING_FOREVER);
+
+    http->sms_len = rt_strlen(text);
+    if (http->sms_len > SIM800_SMS_MAX_LEN - 1)
+        http->sms_len = SIM800_SMS_MAX_LEN - 1;
+    rt_memcpy(http->sms, text, http->sms_len);
+    http->sms[http->sms_len++] = SIM800_CTRL_Z;
+    rt_snprintf(cmd, sizeof(cmd), "AT+CMGS=\"%s\"", number);
+
+    /* no other command between the mode, the prompt and the text */
+    rt_mutex_take(http->client->lock, RT_WAITING_FOREVER);
+    result = sim800_http_exec(http, 1000, "AT+CMGF=1");
+    if (result == RT_EOK)
+    {
+        http->sms_pending = RT_TRUE;
+        result = sim800_http_exec(http, SIM800_CMGS_TIMEOUT_MS, cmd);
+        if (http->sms_pending)
+        {
+            /* no prompt came; should it still, the ESC cancels the message.
+             * uart1 sends by DMA from the buffer it is given, and a late
+             * prompt may have the text on its way, so not from sms[] */
+            http->sms_pending = RT_FALSE;
+            rt_device_write(http->client->device, 0, &sim800_esc, 1);
+            if (result == RT_EOK)
+                result = -RT_ERROR;
+        }
+    }
+    rt_mutex_release(http->client->lock);
+
+    rt_mutex_release(http->lock);
+
+    if (result != RT_EOK)
+        LOG_E("SMS to %s failed (%d)", number, result);
+    return result;
+}
+
+#ifdef BSP_USING_ON_CHIP_FLASH
+/*
+ * An erase keeps interrupts off for about 45 ms, and the UART FIFO fills
+ * in under 3: no erase while a post or SMS is in progress. Those can take
+ * a minute, and the erasing thread holds its own locks meanwhile (the
+ * sample log's flash_lock), so it is not kept waiting: the erase is put
+ * off and its caller tries again. Lines the modem sends on its own, such
+ * as a dropped bearer, can still be cut.
+ */
+rt_err_t pico_flash_erase_begin(void)
+{
+    if (sim800_http.lock == RT_NULL)
+        return RT_EOK;
+    if (rt_mutex_take(sim800_http.lock, 0) != RT_EOK)
+        return -RT_EBUSY;
+    sim800_http.erasing = RT_TRUE;
+    return RT_EOK;
+}
+
+void pico_flash_erase_end(void)
+{
+    if (!sim800_http.erasing)
+        return;
+    sim800_http.erasing = RT_FALSE;
+    rt_mutex_release(sim800_http.lock);
+}
+#endif /* BSP_USING_ON_CHIP_FLASH */
+
+enum sim800_conn_state sim800_http_conn_state(void)
+{
+    return sim800_http.conn;
+}
+
+const struct sim800_http_stat *sim800_http_get_stat(void)
+{
+    return &sim800_http.stat;
+}
+
+int sim800_http_init(void)
+{
+    struct sim800_http *http = &sim800_http;
+
+    if (http->client != RT_NULL)
+        return RT_EOK;
+
+    if (at_client_init(SIM800_AT_DEVICE, SIM800_RECV_BUFF_LEN) != RT_EOK)
+        return -RT_ERROR;
+
+    http->client = at_client_get(SIM800_AT_DEVICE);
+    http->resp = at_create_resp(SIM800_RESP_BUFF_LEN, 0, rt_tick_from_millisecond(1000));
+    http->lock = rt_mutex_create("sim800", RT_IPC_FLAG_PRIO);
+    http->action_done = rt_sem_create("httpact", 0, RT_IPC_FLAG_FIFO);
+    if (http->client == RT_NULL || http->resp == RT_NULL
+            || http->lock == RT_NULL || http->action_done == RT_NULL)
+    {
+        LOG_E("no memory for the HTTP engine");
+        http->client = RT_NULL;
+        return -RT_ENOMEM;
+    }
+
+    at_obj_set_urc_table(http->client, urc_table, sizeof(urc_table) / sizeof(urc_table[0]));
+    http->conn = SIM800_CONN_DOWN;
+    http->stat.last_status = -1;
+
+    if (at_client_obj_wait_connect(http->client, 5000) != RT_EOK)
+        LOG_W("modem on %s is not answering yet", SIM800_AT_DEVICE);
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_FINSH
+#define TICK_MS(t)  ((rt_uint32_t)((t) * 1000 / RT_TICK_PER_SECOND))
+
+static void sim800(int argc, char **argv)
+{
+    static const char *const conn_names[] = {"down", "bearer", "ready"};
+    const struct sim800_http_stat *stat = &sim800_http.stat;
+    int i;
+
+    if (argc == 3 && !rt_strcmp(argv[1], "post"))
+    {
+        int result = sim800_http_post("api.thingspeak.com/update", SIM800_CONTENT_FORM,
+                                      argv[2], rt_strlen(argv[2]));
+        rt_kprintf("post: %d, HTTP %d, %d ms\n", result, stat->last_status, TICK_MS(stat->last_ticks));
+        return;
+    }
+    if (argc == 2 && !rt_strcmp(argv[1], "close"))
+    {
+        sim800_http_close();
+        return;
+    }
+    if (argc != 2 || rt_strcmp(argv[1], "stat"))
+    {
+        rt_kprintf("Usage: sim800 stat | sim800 post <body> | sim800 close\n");
+        return;
+    }
+
+    rt_kprintf("connection: %s\n", conn_names[sim800_http.conn]);
+    rt_kprintf("posts     : %d (%d failed)\n", stat->posts, stat->failures);
+    rt_kprintf("last fail : '%s'\n", sim800_http_state_name(stat->last_fail_state));
+    rt_kprintf("timeouts  : %d\n", stat->timeouts);
+    rt_kprintf("connects  : %d (%d reconnects, %d network drops), last %d ms\n",
+               stat->connects, stat->reconnects, stat->deacts, TICK_MS(stat->connect_ticks));
+    rt_kprintf("last HTTP : %d\n", stat->last_status);
+    rt_kprintf("latency   : last %d, min %d, mean %d, max %d ms\n",
+               TICK_MS(stat->last_ticks), TICK_MS(stat->min_ticks),
+               stat->ok_posts ? TICK_MS(stat->sum_ticks / stat->ok_posts) : 0,
+               TICK_MS(stat->max_ticks));
+    for (i = SIM800_HTTP_PROBE; i < SIM800_HTTP_DONE; i++)
+    {
+        if (stat->step_ticks[i])
+            rt_kprintf("  %-9s %d ms\n", sim800_http_state_name(i), TICK_MS(stat->step_ticks[i]));
+    }
+}
+MSH_CMD_EXPORT(sim800, SIM800 HTTP upload statistics and test post);
+#endif /* RT_USING_FINSH */
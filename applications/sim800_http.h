@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        response-driven HTTP upload engine
+ * 2026-10-17     khair        keep the bearer and HTTP service up between posts
+ * 2026-10-17     khair        per-post Content-Type for JSON bodies
+ * 2026-10-17     khair        SMS through the AT client
+ */
+#ifndef APPLICATIONS_SIM800_HTTP_H_
+#define APPLICATIONS_SIM800_HTTP_H_
+
+#include <rtthread.h>
+
+#ifdef SIM800_USING_FAKE_MODEM
+#define SIM800_AT_DEVICE            "fmodem"
+#else
+#define SIM800_AT_DEVICE            SIM800_DEVICE_NAME
+#endif
+
+#ifndef SIM800_APN
+#define SIM800_APN                  "gpinternet"
+#endif
+
+#define SIM800_RECV_BUFF_LEN        128
+#define SIM800_RESP_BUFF_LEN        128
+#define SIM800_SMS_MAX_LEN          160     /* text mode, the Ctrl-Z included */
+
+#define SIM800_CONTENT_FORM         "application/x-www-form-urlencoded"
+#define SIM800_CONTENT_JSON         "application/json"
+#define SIM800_CONTENT_BINARY       "application/octet-stream"
+
+/* re-check the bearer before a post when the link has been idle this long */
+#define SIM800_CONN_CHECK_MS        (60 * 1000)
+
+/* states of one upload, in the order they are normally visited */
+enum sim800_http_state
+{
+    SIM800_HTTP_IDLE = 0,
+    SIM800_HTTP_PROBE,              /* AT, echo off */
+    SIM800_HTTP_BEARER_CONTYPE,     /* AT+SAPBR=3,1,"CONTYPE","GPRS" */
+    SIM800_HTTP_BEARER_APN,         /* AT+SAPBR=3,1,"APN",... */
+    SIM800_HTTP_BEARER_OPEN,        /* AT+SAPBR=1,1 */
+    SIM800_HTTP_BEARER_QUERY,       /* AT+SAPBR=2,1 */
+    SIM800_HTTP_INIT,               /* AT+HTTPINIT */
+    SIM800_HTTP_CID,                /* AT+HTTPPARA="CID",1 */
+    SIM800_HTTP_URL,                /* AT+HTTPPARA="URL",..., skipped when unchanged */
+    SIM800_HTTP_CONTENT,            /* AT+HTTPPARA="CONTENT",..., skipped when unchanged */
+    SIM800_HTTP_DATA,               /* AT+HTTPDATA + body on DOWNLOAD */
+    SIM800_HTTP_ACTION,             /* AT+HTTPACTION=1, wait for +HTTPACTION: */
+    SIM800_HTTP_TERM,               /* AT+HTTPTERM, only when closing */
+    SIM800_HTTP_BEARER_CLOSE,       /* AT+SAPBR=0,1, only when closing */
+    SIM800_HTTP_DONE,
+    SIM800_HTTP_FAIL,
+
+    SIM800_HTTP_STATE_MAX
+};
+
+/* what is known to be up on the modem between posts */
+enum sim800_conn_state
+{
+    SIM800_CONN_DOWN = 0,           /* nothing, start from the probe */
+    SIM800_CONN_BEARER,             /* bearer probably up, HTTP service not */
+    SIM800_CONN_READY,              /* bearer and HTTP service up */
+};
+
+struct sim800_http_stat
+{
+    rt_uint32_t posts;              /* uploads started */
+    rt_uint32_t failures;           /* uploads that ended in SIM800_HTTP_FAIL */
+    rt_uint32_t timeouts;           /* steps that ran out of time */
+    rt_uint32_t connects;           /* bearer + HTTP service bring-ups */
+    rt_uint32_t reconnects;         /* bring-ups after the first one */
+    rt_uint32_t deacts;             /* bearer drops reported by the network */
+    int last_status;                /* HTTP status of the last +HTTPACTION, -1 if none */
+    enum sim800_http_state last_fail_state;
+    rt_tick_t connect_ticks;        /* duration of the last bring-up */
+    rt_tick_t last_ticks;           /* duration of the last upload */
+    rt_tick_t min_ticks;            /* fastest successful upload */
+    rt_tick_t max_ticks;            /* slowest upload seen */
+    rt_uint64_t sum_ticks;          /* all successful uploads, for the mean */
+    rt_uint32_t ok_posts;           /* successful uploads */
+    rt_tick_t step_ticks[SIM800_HTTP_STATE_MAX]; /* per step, last upload */
+};
+
+int sim800_http_init(void);
+int sim800_http_post(const char *url, const char *content_type, const char *body, rt_size_t len);
+void sim800_http_close(void);
+int sim800_sms_send(const char *number, const char *text);
+enum sim800_conn_state sim800_http_conn_state(void);
+const struct sim800_http_stat *sim800_http_get_stat(void);
+const char *sim800_http_state_name(enum sim800_http_state state);
+
+#endif /* APPLICATIONS_SIM800_HTTP_H_ */
@@ -6,6 +6,13 @@
  * Change Logs:
  * Date           Author       Notes
  * 2023-05-18     Md. Khairul Alam       the first version
+ * 2026-10-17     khair        dirty tracking, flush only the changed window
+ * 2026-10-17     khair        RT-Thread I2C bus transport, command bursts
+ * 2026-10-17     khair        column-byte glyph blitter with scale tables
+ * 2026-10-17     khair        integer Bresenham lines, masked span and rect fills
+ * 2026-10-17     khair        rectangle clear for partial redraws
+ * 2026-10-17     khair        types and prototypes in ssd1306_lcd.h
+ * 2026-10-17     khair        drawing checks and bench moved to tests/host
  */
 
 #include <pico/stdlib.h>
@@ -14,38 +21,18 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <rtconfig.h>
+#ifdef RT_USING_I2C
+#include <rtdevice.h>
+#endif
 
-typedef enum {
-    SET_CONTRAST = 0x81,
-    SET_ENTIRE_ON = 0xA4,
-    SET_NORM_INV = 0xA6,
-    SET_DISP = 0xAE,
-    SET_MEM_ADDR = 0x20,
-    SET_COL_ADDR = 0x21,
-    SET_PAGE_ADDR = 0x22,
-    SET_DISP_START_LINE = 0x40,
-    SET_SEG_REMAP = 0xA0,
-    SET_MUX_RATIO = 0xA8,
-    SET_COM_OUT_DIR = 0xC0,
-    SET_DISP_OFFSET = 0xD3,
-    SET_COM_PIN_CFG = 0xDA,
-    SET_DISP_CLK_DIV = 0xD5,
-    SET_PRECHARGE = 0xD9,
-    SET_VCOM_DESEL = 0xDB,
-    SET_CHARGE_PUMP = 0x8D
-} ssd1306_command_t;
-
-
-typedef struct {
-    uint8_t width;      /**< width of display */
-    uint8_t height;     /**< height of display */
-    uint8_t pages;      /**< stores pages of display (calculated on initialization*/
-    uint8_t address;    /**< i2c address of display*/
-    i2c_inst_t *i2c_i;  /**< i2c connection instance */
-    bool external_vcc;  /**< whether display uses external vcc */
-    uint8_t *buffer;    /**< display buffer */
-    size_t bufsize;     /**< buffer size */
-} ssd1306_t;
+#include "ssd1306_lcd.h"
+
+/* control bytes: a single command follows / data stream follows */
+#define SSD1306_CTRL_CMD    0x80
+#define SSD1306_CTRL_DATA   0x40
+/* SET_COL_ADDR and SET_PAGE_ADDR with their arguments, each after a control byte */
+#define SSD1306_WINDOW_LEN  (6*2+1)
 
 const uint8_t font_8x5[] =
 {
@@ -448,36 +435,25 @@ const uint8_t BMSPA_font[] = {
 };
 
 
-bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance);
-void ssd1306_deinit(ssd1306_t *p);
-void ssd1306_poweroff(ssd1306_t *p);
-void ssd1306_poweron(ssd1306_t *p);
-void ssd1306_contrast(ssd1306_t *p, uint8_t val);
-void ssd1306_invert(ssd1306_t *p, uint8_t inv);
-void ssd1306_show(ssd1306_t *p);
-void ssd1306_clear(ssd1306_t *p);
-void ssd1306_clear_pixel(ssd1306_t *p, uint32_t x, uint32_t y);
-void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y);
-void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
-void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
-void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
-void ssd1306_bmp_show_image_with_offset(ssd1306_t *p, const uint8_t *data, const long size, uint32_t x_offset, uint32_t y_offset);
-void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long size);
-void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c);
-void ssd1306_draw_char(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, char c);
-void ssd1306_draw_string_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, const char *s );
-void ssd1306_draw_string(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const char *s);
 //void animation(void);
 
 
 inline static void swap(int32_t *a, int32_t *b) {
-    int32_t *t=a;
+    int32_t t=*a;
     *a=*b;
-    *b=*t;
+    *b=t;
 }
 
-inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, char *name) {
-    switch(i2c_write_blocking(i2c, addr, src, len, false)) {
+inline static void fancy_write(ssd1306_t *p, const uint8_t *src, size_t len, char *name) {
+#ifdef RT_USING_I2C
+    if(p->bus) {
+        // sleeps while the bus driver sends it, other threads keep running
+        if(rt_i2c_master_send(p->bus, p->address, RT_I2C_WR, src, len)!=len)
+            printf("[%s] write failed!\n", name);
+        return;
+    }
+#endif
+    switch(i2c_write_blocking(p->i2c_i, p->address, src, len, false)) {
     case PICO_ERROR_GENERIC:
         printf("[%s] addr not acknowledged!\n", name);
         break;
@@ -490,9 +466,35 @@ inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src
     }
 }
 
+inline static void ssd1306_mark(ssd1306_t *p, uint32_t x, uint32_t page) {
+    p->dirty|=1u<<page;
+    if(x<p->dirty_x0) p->dirty_x0=x;
+    if(x>p->dirty_x1) p->dirty_x1=x;
+}
+
+// pages page0..page1, columns x0..x1
+inline static void ssd1306_mark_rect(ssd1306_t *p, uint32_t x0, uint32_t x1, uint32_t page0, uint32_t page1) {
+    p->dirty|=((2u<<page1)-1)&~((1u<<page0)-1);
+    if(x0<p->dirty_x0) p->dirty_x0=x0;
+    if(x1>p->dirty_x1) p->dirty_x1=x1;
+}
+
+inline static void ssd1306_mark_all(ssd1306_t *p) {
+    p->dirty=(1u<<p->pages)-1;
+    p->dirty_x0=0;
+    p->dirty_x1=p->width-1;
+}
+
 inline static void ssd1306_write(ssd1306_t *p, uint8_t val) {
     uint8_t d[2]= {0x00, val};
-    fancy_write(p->i2c_i, p->address, d, 2, "ssd1306_write");
+    fancy_write(p, d, 2, "ssd1306_write");
+}
+
+// several commands in one transaction: a Co=0 control byte, then the command bytes
+static void ssd1306_write_cmds(ssd1306_t *p, const uint8_t *cmds, size_t n) {
+    p->tx[0]=0x00;
+    memcpy(p->tx+1, cmds, n);
+    fancy_write(p, p->tx, n+1, "ssd1306_write_cmds");
 }
 
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance) {
@@ -512,6 +514,18 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
 
     ++(p->buffer);
 
+    p->shadow=malloc(p->bufsize);
+    p->tx=malloc(SSD1306_WINDOW_LEN+p->bufsize);
+    if(p->shadow==NULL || p->tx==NULL) {
+        free(p->shadow);
+        free(p->tx);
+        free(p->buffer-1);
+        p->bufsize=0;
+        return false;
+    }
+    p->shadow_valid=false;
+    ssd1306_mark_all(p);
+
     // from https://github.com/makerportal/rpi-pico-ssd1306
     uint8_t cmds[]= {
         SET_DISP,
@@ -546,13 +560,14 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
         0x00,  // horizontal
     };
 
-    for(size_t i=0; i<sizeof(cmds); ++i)
-        ssd1306_write(p, cmds[i]);
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
 
     return true;
 }
 
 inline void ssd1306_deinit(ssd1306_t *p) {
+    free(p->tx);
+    free(p->shadow);
     free(p->buffer-1);
 }
 
@@ -565,8 +580,8 @@ inline void ssd1306_poweron(ssd1306_t *p) {
 }
 
 inline void ssd1306_contrast(ssd1306_t *p, uint8_t val) {
-    ssd1306_write(p, SET_CONTRAST);
-    ssd1306_write(p, val);
+    uint8_t cmds[]= {SET_CONTRAST, val};
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
 }
 
 inline void ssd1306_invert(ssd1306_t *p, uint8_t inv) {
@@ -575,47 +590,130 @@ inline void ssd1306_invert(ssd1306_t *p, uint8_t inv) {
 
 inline void ssd1306_clear(ssd1306_t *p) {
     memset(p->buffer, 0, p->bufsize);
+    ssd1306_mark_all(p);
 }
 
 void ssd1306_clear_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
     if(x>=p->width || y>=p->height) return;
 
     p->buffer[x+p->width*(y>>3)]&=~(0x1<<(y&0x07));
+    ssd1306_mark(p, x, y>>3);
 }
 
 void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
     if(x>=p->width || y>=p->height) return;
 
     p->buffer[x+p->width*(y>>3)]|=0x1<<(y&0x07); // y>>3==y/8 && y&0x7==y%8
+    ssd1306_mark(p, x, y>>3);
 }
 
+/*
+ * Integer Bresenham. When both ends are on screen the pixel is tracked as
+ * a byte pointer and a bit mask, so a step is a pointer add or a shift;
+ * otherwise every pixel goes through the clipping ssd1306_draw_pixel().
+ * Horizontal and vertical lines are span fills.
+ */
 void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
-    if(x1>x2) {
-        swap(&x1, &x2);
-        swap(&y1, &y2);
-    }
-
-    if(x1==x2) {
+    if(y1==y2 || x1==x2) {
+        if(x1>x2)
+            swap(&x1, &x2);
         if(y1>y2)
             swap(&y1, &y2);
-        for(int32_t i=y1; i<=y2; ++i)
-            ssd1306_draw_pixel(p, x1, i);
+        if(x2<0 || y2<0)
+            return;
+        if(x1<0) x1=0;
+        if(y1<0) y1=0;
+        ssd1306_draw_square(p, x1, y1, x2-x1+1, y2-y1+1);
+        return;
+    }
+
+    int32_t dx=abs(x2-x1), sx=x1<x2?1:-1;
+    int32_t dy=-abs(y2-y1), sy=y1<y2?1:-1;
+    int32_t err=dx+dy, e2;
+
+    if((uint32_t)x1>=p->width || (uint32_t)x2>=p->width || (uint32_t)y1>=p->height || (uint32_t)y2>=p->height) {
+        for(;;) {
+            ssd1306_draw_pixel(p, x1, y1);
+            if(x1==x2 && y1==y2)
+                break;
+            e2=2*err;
+            if(e2>=dy) { err+=dy; x1+=sx; }
+            if(e2<=dx) { err+=dx; y1+=sy; }
+        }
         return;
     }
 
-    float m=(float) (y2-y1) / (float) (x2-x1);
+    ssd1306_mark_rect(p, sx>0?x1:x2, sx>0?x2:x1, (sy>0?y1:y2)>>3, (sy>0?y2:y1)>>3);
+
+    uint8_t *b=p->buffer+x1+p->width*(y1>>3);
+    uint8_t bit=1u<<(y1&7);
+    for(;;) {
+        *b|=bit;
+        if(x1==x2 && y1==y2)
+            break;
+        e2=2*err;
+        if(e2>=dy) {
+            err+=dy;
+            x1+=sx;
+            b+=sx;
+        }
+        if(e2<=dx) {
+            err+=dx;
+            y1+=sy;
+            if(sy>0) {
+                bit<<=1;
+                if(!bit) { bit=0x01; b+=p->width; }
+            } else {
+                bit>>=1;
+                if(!bit) { bit=0x80; b-=p->width; }
+            }
+        }
+    }
+}
+
+/*
+ * Filled rectangle: each page it covers gets one mask (all ones, or cut at
+ * the top/bottom edge), OR-ed into (or cleared from) every column of the span.
+ */
+static void ssd1306_fill_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool on) {
+    if(!width || !height || x>=p->width || y>=p->height)
+        return;
 
-    for(int32_t i=x1; i<=x2; ++i) {
-        float y=m*(float) (i-x1)+(float) y1;
-        ssd1306_draw_pixel(p, i, (uint32_t) y);
+    uint32_t x1=width>p->width-x?p->width-1:x+width-1;
+    uint32_t y1=height>p->height-y?p->height-1:y+height-1;
+    uint32_t page0=y>>3, page1=y1>>3;
+
+    for(uint32_t page=page0; page<=page1; ++page) {
+        uint8_t mask=0xff;
+        if(page==page0) mask&=0xff<<(y&7);
+        if(page==page1) mask&=0xff>>(7-(y1&7));
+
+        uint8_t *b=p->buffer+page*p->width;
+        if(on) {
+            for(uint32_t i=x; i<=x1; ++i)
+                b[i]|=mask;
+        } else {
+            for(uint32_t i=x; i<=x1; ++i)
+                b[i]&=~mask;
+        }
     }
+    ssd1306_mark_rect(p, x, x1, page0, page1);
 }
 
 void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    for(uint32_t i=0; i<width; ++i)
-        for(uint32_t j=0; j<height; ++j)
-            ssd1306_draw_pixel(p, x+i, y+j);
+    ssd1306_fill_square(p, x, y, width, height, true);
+}
+
+void ssd1306_clear_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    ssd1306_fill_square(p, x, y, width, height, false);
+}
+
+void ssd1306_draw_hline(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width) {
+    ssd1306_draw_square(p, x, y, width, 1);
+}
 
+void ssd1306_draw_vline(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t height) {
+    ssd1306_draw_square(p, x, y, 1, height);
 }
 
 void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
@@ -625,22 +723,100 @@ void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t wi
     ssd1306_draw_line(p, x+width, y, x+width, y+height);
 }
 
+/*
+ * Glyph columns are blitted as whole bytes. A font column byte (8 rows,
+ * LSB on top) is stretched vertically by `scale` through a table that
+ * repeats every bit scale times, then OR-ed into the pages it covers:
+ * straight byte writes when y is page-aligned, shifted and split across
+ * two pages otherwise. The column is repeated scale times horizontally.
+ */
+#define SSD1306_SPREAD(b, s) ( \
+    ((((b)>>0)&1u)*((1u<<(s))-1)<<(0*(s))) | ((((b)>>1)&1u)*((1u<<(s))-1)<<(1*(s))) | \
+    ((((b)>>2)&1u)*((1u<<(s))-1)<<(2*(s))) | ((((b)>>3)&1u)*((1u<<(s))-1)<<(3*(s))) | \
+    ((((b)>>4)&1u)*((1u<<(s))-1)<<(4*(s))) | ((((b)>>5)&1u)*((1u<<(s))-1)<<(5*(s))) | \
+    ((((b)>>6)&1u)*((1u<<(s))-1)<<(6*(s))) | ((((b)>>7)&1u)*((1u<<(s))-1)<<(7*(s))))
+#define SSD1306_T4(s, n)    SSD1306_SPREAD(n, s), SSD1306_SPREAD((n)+1, s), SSD1306_SPREAD((n)+2, s), SSD1306_SPREAD((n)+3, s)
+#define SSD1306_T16(s, n)   SSD1306_T4(s, n), SSD1306_T4(s, (n)+4), SSD1306_T4(s, (n)+8), SSD1306_T4(s, (n)+12)
+#define SSD1306_T64(s, n)   SSD1306_T16(s, n), SSD1306_T16(s, (n)+16), SSD1306_T16(s, (n)+32), SSD1306_T16(s, (n)+48)
+#define SSD1306_T256(s)     SSD1306_T64(s, 0), SSD1306_T64(s, 64), SSD1306_T64(s, 128), SSD1306_T64(s, 192)
+
+static const uint16_t ssd1306_spread2[256]= {SSD1306_T256(2)};
+static const uint32_t ssd1306_spread3[256]= {SSD1306_T256(3)};
+static const uint32_t ssd1306_spread4[256]= {SSD1306_T256(4)};
+
+// OR `bits` (LSB at row y) into column x, `bits` is at most 32 rows tall
+void ssd1306_blit_column(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t bits) {
+    uint32_t page=y>>3, shift=y&7;
+    uint8_t *col=p->buffer+x;
+
+    if(!bits)
+        return;
+
+    if(!shift) {
+        for(; bits && page<p->pages; ++page, bits>>=8) {
+            col[page*p->width]|=(uint8_t)bits;
+            ssd1306_mark(p, x, page);
+        }
+        return;
+    }
+
+    uint64_t v=(uint64_t)bits<<shift;
+    for(; v && page<p->pages; ++page, v>>=8) {
+        if((uint8_t)v) {
+            col[page*p->width]|=(uint8_t)v;
+            ssd1306_mark(p, x, page);
+        }
+    }
+}
+
+static inline uint32_t ssd1306_spread(uint8_t line, uint32_t scale) {
+    switch(scale) {
+    case 1:
+        return line;
+    case 2:
+        return ssd1306_spread2[line];
+    case 3:
+        return ssd1306_spread3[line];
+    default:
+        return ssd1306_spread4[line];
+    }
+}
+
 void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
     if(c<font[3]||c>font[4])
         return;
 
     uint32_t parts_per_line=(font[0]>>3)+((font[0]&7)>0);
-    for(uint8_t w=0; w<font[1]; ++w) { // width
-        uint32_t pp=(c-font[3])*font[1]*parts_per_line+w*parts_per_line+5;
-        for(uint32_t lp=0; lp<parts_per_line; ++lp) {
-            uint8_t line=font[pp];
 
-            for(int8_t j=0; j<8; ++j, line>>=1) {
-                if(line & 1)
-                    ssd1306_draw_square(p, x+w*scale, y+((lp<<3)+j)*scale, scale, scale);
+    if(scale==0 || scale>4) {
+        // no table that tall, draw every set bit as a square
+        for(uint8_t w=0; w<font[1]; ++w) { // width
+            uint32_t pp=(c-font[3])*font[1]*parts_per_line+w*parts_per_line+5;
+            for(uint32_t lp=0; lp<parts_per_line; ++lp) {
+                uint8_t line=font[pp];
+
+                for(int8_t j=0; j<8; ++j, line>>=1) {
+                    if(line & 1)
+                        ssd1306_draw_square(p, x+w*scale, y+((lp<<3)+j)*scale, scale, scale);
+                }
+
+                ++pp;
             }
+        }
+        return;
+    }
+
+    const uint8_t *glyph=font+5+(c-font[3])*font[1]*parts_per_line;
+    for(uint8_t w=0; w<font[1]; ++w, glyph+=parts_per_line) { // width
+        for(uint32_t lp=0; lp<parts_per_line; ++lp) {
+            uint32_t bits=ssd1306_spread(glyph[lp], scale);
+            uint32_t row=y+((lp<<3)*scale);
 
-            ++pp;
+            for(uint32_t i=0; i<scale; ++i) {
+                uint32_t col=x+w*scale+i;
+                if(col<p->width)
+                    ssd1306_blit_column(p, col, row, bits);
+            }
         }
     }
 }
@@ -721,19 +897,66 @@ inline void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long
     ssd1306_bmp_show_image_with_offset(p, data, size, 0, 0);
 }
 
+/*
+ * Send what changed since the last show. The pages and columns written
+ * since then are compared with the shadow copy of the panel, and the
+ * smallest window holding every difference goes out as one I2C transaction:
+ * the SET_COL_ADDR/SET_PAGE_ADDR window commands, then the window's bytes.
+ * Several draws followed by one show cost one transaction; a show with
+ * nothing changed sends nothing.
+ */
 void ssd1306_show(ssd1306_t *p) {
-    uint8_t payload[]= {SET_COL_ADDR, 0, p->width-1, SET_PAGE_ADDR, 0, p->pages-1};
-    if(p->width==64) {
-        payload[1]+=32;
-        payload[2]+=32;
+    uint32_t c0=p->width, c1=0, p0=p->pages, p1=0;
+
+    if(!p->dirty)
+        return;
+
+    for(uint32_t page=0; page<p->pages; ++page) {
+        if(!(p->dirty&(1u<<page)))
+            continue;
+
+        const uint8_t *row=p->buffer+page*p->width;
+        const uint8_t *old=p->shadow+page*p->width;
+        uint32_t x0=p->dirty_x0, x1=p->dirty_x1;
+
+        if(p->shadow_valid) {
+            while(x0<=x1 && row[x0]==old[x0]) ++x0;
+            if(x0>x1)
+                continue;
+            while(row[x1]==old[x1]) --x1;
+        }
+
+        if(page<p0) p0=page;
+        p1=page;
+        if(x0<c0) c0=x0;
+        if(x1>c1) c1=x1;
     }
 
-    for(size_t i=0; i<sizeof(payload); ++i)
-        ssd1306_write(p, payload[i]);
+    p->dirty=0;
+    p->dirty_x0=p->width;
+    p->dirty_x1=0;
+    if(p0>p1)
+        return;
 
-    *(p->buffer-1)=0x40;
+    uint8_t col_offset=p->width==64?32:0;
+    uint8_t *tx=p->tx;
+    *tx++=SSD1306_CTRL_CMD; *tx++=SET_COL_ADDR;
+    *tx++=SSD1306_CTRL_CMD; *tx++=c0+col_offset;
+    *tx++=SSD1306_CTRL_CMD; *tx++=c1+col_offset;
+    *tx++=SSD1306_CTRL_CMD; *tx++=SET_PAGE_ADDR;
+    *tx++=SSD1306_CTRL_CMD; *tx++=p0;
+    *tx++=SSD1306_CTRL_CMD; *tx++=p1;
+    *tx++=SSD1306_CTRL_DATA;
+
+    uint32_t n=c1-c0+1;
+    for(uint32_t page=p0; page<=p1; ++page) {
+        memcpy(tx, p->buffer+page*p->width+c0, n);
+        memcpy(p->shadow+page*p->width+c0, tx, n);
+        tx+=n;
+    }
+    p->shadow_valid=true;
 
-    fancy_write(p->i2c_i, p->address, p->buffer-1, p->bufsize+1, "ssd1306_show");
+    fancy_write(p, p->tx, tx-p->tx, "ssd1306_show");
 }
 
 /*
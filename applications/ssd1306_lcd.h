@@ -6,10 +6,83 @@
  * Change Logs:
  * Date           Author       Notes
  * 2023-05-13     khair       the first version
+ * 2026-10-17     khair       types and prototypes of ssd1306_lcd.c
  */
 #ifndef APPLICATIONS_SSD1306_LCD_H_
 #define APPLICATIONS_SSD1306_LCD_H_
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <hardware/i2c.h>
+#include <rtconfig.h>
+#ifdef RT_USING_I2C
+#include <rtdevice.h>
+#endif
 
+typedef enum {
+    SET_CONTRAST = 0x81,
+    SET_ENTIRE_ON = 0xA4,
+    SET_NORM_INV = 0xA6,
+    SET_DISP = 0xAE,
+    SET_MEM_ADDR = 0x20,
+    SET_COL_ADDR = 0x21,
+    SET_PAGE_ADDR = 0x22,
+    SET_DISP_START_LINE = 0x40,
+    SET_SEG_REMAP = 0xA0,
+    SET_MUX_RATIO = 0xA8,
+    SET_COM_OUT_DIR = 0xC0,
+    SET_DISP_OFFSET = 0xD3,
+    SET_COM_PIN_CFG = 0xDA,
+    SET_DISP_CLK_DIV = 0xD5,
+    SET_PRECHARGE = 0xD9,
+    SET_VCOM_DESEL = 0xDB,
+    SET_CHARGE_PUMP = 0x8D
+} ssd1306_command_t;
+
+
+typedef struct {
+    uint8_t width;      /**< width of display */
+    uint8_t height;     /**< height of display */
+    uint8_t pages;      /**< stores pages of display (calculated on initialization*/
+    uint8_t address;    /**< i2c address of display*/
+    i2c_inst_t *i2c_i;  /**< i2c connection instance */
+#ifdef RT_USING_I2C
+    struct rt_i2c_bus_device *bus; /**< RT-Thread i2c bus, used instead of i2c_i when set */
+#endif
+    bool external_vcc;  /**< whether display uses external vcc */
+    uint8_t *buffer;    /**< display buffer */
+    size_t bufsize;     /**< buffer size */
+    uint8_t *shadow;    /**< what the panel shows, as of the last show */
+    uint8_t *tx;        /**< window command + data of one show */
+    uint32_t dirty;     /**< pages written since the last show, one bit each */
+    uint8_t dirty_x0;   /**< first column written since the last show */
+    uint8_t dirty_x1;   /**< last column written since the last show */
+    bool shadow_valid;  /**< false until the first show, panel RAM unknown */
+} ssd1306_t;
+
+bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance);
+void ssd1306_deinit(ssd1306_t *p);
+void ssd1306_poweroff(ssd1306_t *p);
+void ssd1306_poweron(ssd1306_t *p);
+void ssd1306_contrast(ssd1306_t *p, uint8_t val);
+void ssd1306_invert(ssd1306_t *p, uint8_t inv);
+void ssd1306_show(ssd1306_t *p);
+void ssd1306_clear(ssd1306_t *p);
+void ssd1306_clear_pixel(ssd1306_t *p, uint32_t x, uint32_t y);
+void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y);
+void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void ssd1306_draw_hline(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width);
+void ssd1306_draw_vline(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t height);
+void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+void ssd1306_clear_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+void ssd1306_bmp_show_image_with_offset(ssd1306_t *p, const uint8_t *data, const long size, uint32_t x_offset, uint32_t y_offset);
+void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long size);
+void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c);
+void ssd1306_draw_char(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, char c);
+void ssd1306_draw_string_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, const char *s );
+void ssd1306_draw_string(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const char *s);
+void ssd1306_blit_column(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t bits);
 
 #endif /* APPLICATIONS_SSD1306_LCD_H_ */
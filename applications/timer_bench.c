@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        rt_timer cost at 10/100/1000 timers
+ */
+/*
+ * msh>timer_bench [count...]
+ *
+ * Times the kernel timer container with the given numbers of hard timers
+ * active (10, 100 and 1000 by default), on top of the application's own:
+ *
+ *   start   rt_timer_start() with random timeouts, all of it IRQ-off
+ *   stop    rt_timer_stop() of active timers, IRQ-off
+ *   next    rt_timer_next_timeout_tick(), which tickless idle calls
+ *   tick    the SysTick interrupt while the timers expire, which runs
+ *           rt_timer_check() with interrupts off
+ *
+ * Everything is in CPU cycles, read from SysTick, average / worst; the
+ * calls are timed with interrupts off so nothing else is counted. Build
+ * once with RT_TIMER_USING_WHEEL and once without to compare the wheel
+ * with the sorted list. Sleep modes are held off while it runs, so the
+ * tick keeps running.
+ */
+#include <stdlib.h>
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+
+#if defined(RT_USING_FINSH) && defined(TIMER_USING_BENCH)
+
+#define TIMER_BENCH_SPAN        (2 * RT_TICK_PER_SECOND)   /* timeouts are 1..SPAN ticks */
+#define TIMER_BENCH_ISR_SYSTICK 15                          /* SysTick exception number */
+
+struct timer_bench_cost
+{
+    rt_uint32_t total;
+    rt_uint32_t count;
+    rt_uint32_t max;
+};
+
+static struct timer_bench_cost timer_bench_isr;
+static rt_uint32_t timer_bench_isr_start;
+static volatile rt_uint32_t timer_bench_fired;
+static rt_uint32_t timer_bench_seed = 1;
+
+static rt_uint32_t timer_bench_rand(void)
+{
+    timer_bench_seed = timer_bench_seed * 1103515245 + 12345;
+    return timer_bench_seed >> 8;
+}
+
+/* SysTick counts CPU cycles down and reloads at zero */
+rt_inline rt_uint32_t timer_bench_cycles(void)
+{
+    return mpu_hw->cvr;
+}
+
+rt_inline rt_uint32_t timer_bench_elapsed(rt_uint32_t start)
+{
+    rt_uint32_t now = mpu_hw->cvr;
+
+    return start >= now ? start - now : start + mpu_hw->rvr + 1 - now;
+}
+
+static void timer_bench_add(struct timer_bench_cost *cost, rt_uint32_t cycles)
+{
+    cost->total += cycles;
+    cost->count++;
+    if (cycles > cost->max)
+        cost->max = cycles;
+}
+
+static rt_uint32_t timer_bench_ipsr(void)
+{
+    rt_uint32_t ipsr;
+
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return ipsr & 0x3f;
+}
+
+/* the tick interrupt is the only one timed: the hooks see every one */
+static void timer_bench_irq_enter(void)
+{
+    if (timer_bench_ipsr() == TIMER_BENCH_ISR_SYSTICK)
+        timer_bench_isr_start = timer_bench_cycles();
+}
+
+static void timer_bench_irq_leave(void)
+{
+    if (timer_bench_ipsr() == TIMER_BENCH_ISR_SYSTICK)
+        timer_bench_add(&timer_bench_isr, timer_bench_elapsed(timer_bench_isr_start));
+}
+
+static void timer_bench_timeout(void *parameter)
+{
+    timer_bench_fired++;
+}
+
+static void timer_bench_print(const char *name, const struct timer_bench_cost *cost)
+{
+    rt_kprintf(" %s %d/%d", name, cost->count ? cost->total / cost->count : 0, cost->max);
+}
+
+static void timer_bench_run(struct rt_timer *timers, int n)
+{
+    struct timer_bench_cost start = {0}, stop = {0}, next = {0};
+    rt_base_t level;
+    rt_uint32_t c;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        rt_timer_init(&timers[i], "tbench", timer_bench_timeout, RT_NULL,
+                      1 + timer_bench_rand() % TIMER_BENCH_SPAN, RT_TIMER_FLAG_ONE_SHOT);
+    }
+
+    /* start them all and let them expire with the tick timed */
+    rt_memset(&timer_bench_isr, 0, sizeof(timer_bench_isr));
+    timer_bench_fired = 0;
+    rt_interrupt_enter_sethook(timer_bench_irq_enter);
+    rt_interrupt_leave_sethook(timer_bench_irq_leave);
+    for (i = 0; i < n; i++)
+    {
+        level = rt_hw_interrupt_disable();
+        c = timer_bench_cycles();
+        rt_timer_start(&timers[i]);
+        timer_bench_add(&start, timer_bench_elapsed(c));
+        rt_hw_interrupt_enable(level);
+    }
+    for (i = 0; i < 16; i++)
+    {
+        level = rt_hw_interrupt_disable();
+        c = timer_bench_cycles();
+        (void)rt_timer_next_timeout_tick();
+        timer_bench_add(&next, timer_bench_elapsed(c));
+        rt_hw_interrupt_enable(level);
+    }
+    rt_thread_delay(TIMER_BENCH_SPAN + 2);
+    rt_interrupt_enter_sethook(RT_NULL);
+    rt_interrupt_leave_sethook(RT_NULL);
+
+    /* start them again and stop them while active */
+    for (i = 0; i < n; i++)
+        rt_timer_start(&timers[i]);
+    for (i = 0; i < n; i++)
+    {
+        level = rt_hw_interrupt_disable();
+        c = timer_bench_cycles();
+        rt_timer_stop(&timers[i]);
+        timer_bench_add(&stop, timer_bench_elapsed(c));
+        rt_hw_interrupt_enable(level);
+    }
+
+    for (i = 0; i < n; i++)
+        rt_timer_detach(&timers[i]);
+
+    rt_kprintf("%4d timers:", n);
+    timer_bench_print("start", &start);
+    timer_bench_print("stop", &stop);
+    timer_bench_print("next", &next);
+    timer_bench_print("tick", &timer_bench_isr);
+    rt_kprintf(", %d/%d fired\n", timer_bench_fired, n);
+}
+
+static void timer_bench(int argc, char **argv)
+{
+    static const int counts[] = {10, 100, 1000};
+    struct rt_timer *timers;
+    int i, n, max = 0;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (atoi(argv[i]) > max)
+            max = atoi(argv[i]);
+    }
+    if (argc < 2)
+        max = counts[sizeof(counts) / sizeof(counts[0]) - 1];
+    if (max <= 0)
+    {
+        rt_kprintf("usage: timer_bench [count...]\n");
+        return;
+    }
+
+    timers = rt_malloc(max * sizeof(struct rt_timer));
+    if (timers == RT_NULL)
+    {
+        rt_kprintf("no memory for %d timers\n", max);
+        return;
+    }
+
+#ifdef RT_USING_PM
+    rt_pm_request(PM_SLEEP_MODE_NONE);
+#endif
+#ifdef RT_TIMER_USING_WHEEL
+    rt_kprintf("timing wheel");
+#else
+    rt_kprintf("sorted list");
+#endif
+    rt_kprintf(", cycles avg/max at %d MHz, timeouts 1..%d ticks\n",
+               clock_get_hz(clk_sys) / 1000000, TIMER_BENCH_SPAN);
+    if (argc < 2)
+    {
+        for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+            timer_bench_run(timers, counts[i]);
+    }
+    else
+    {
+        for (i = 1; i < argc; i++)
+        {
+            n = atoi(argv[i]);
+            if (n > 0)
+                timer_bench_run(timers, n);
+        }
+    }
+#ifdef RT_USING_PM
+    rt_pm_release(PM_SLEEP_MODE_NONE);
+#endif
+
+    rt_free(timers);
+}
+MSH_CMD_EXPORT(timer_bench, time rt_timer start/stop/expiry: timer_bench [count...]);
+
+#endif /* RT_USING_FINSH && TIMER_USING_BENCH */
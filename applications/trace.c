@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        binary event trace
+ */
+/*
+ * msh>trace [start|stop|clear|dump]
+ *
+ * A flight recorder of kernel and application events, fed from the
+ * kernel hooks and the markers in trace.h:
+ *
+ *   switch   the scheduler switched to a thread
+ *   irq      entry to and exit from an interrupt that calls
+ *            rt_interrupt_enter/leave
+ *   ipc      a thread about to take, having taken, or releasing a
+ *            semaphore, mutex, event, mailbox or message queue
+ *   timer    a timeout function starting and returning
+ *   marker   a sensor sample, a display flush and an AT command sent and
+ *            answered, as points or begin/end pairs
+ *
+ * Every event is one 12-byte record in a ring per core, overwritten once
+ * the ring is full, so the last TRACE_BUF_EVENTS of each core are kept.
+ * Core1 runs no kernel and only writes markers into its ring. A record
+ * is claimed with interrupts masked for a few instructions, as the M0+
+ * has no exclusive access; each ring has a single writer, its own core.
+ * The time is the low word of the 1 MHz timer, so the cores agree on it.
+ *
+ * "trace" alone shows the state and the cost of one record. "trace dump"
+ * stops the recording while it prints, as lines starting "TRACE ":
+ *
+ *   H <version> <events per ring> <time now>
+ *   O <object> <class> <name>          every live kernel object
+ *   E <core> <time> <what> <object>    events, oldest first
+ *
+ * all in hex, <what> being the type in the top byte and its argument
+ * below. tools/trace2json.py turns a log holding them into a Chrome trace
+ * for chrome://tracing or ui.perfetto.dev.
+ */
+#include <rthw.h>
+#include <rtthread.h>
+
+#include "hardware/sync.h"
+#include "hardware/structs/systick.h"
+#include "hardware/structs/timer.h"
+#include "hardware/timer.h"
+
+#include "trace.h"
+
+#ifdef APP_USING_TRACE
+
+#if TRACE_BUF_EVENTS & (TRACE_BUF_EVENTS - 1)
+#error "TRACE_BUF_EVENTS must be a power of two"
+#endif
+
+#define TRACE_VERSION           1
+#define TRACE_CORES             2
+#define TRACE_COST_RUNS         16
+
+/* record types, the decoder knows them by number */
+enum trace_type
+{
+    TRACE_SWITCH = 1,                   /* arg: priority, object: thread */
+    TRACE_IRQ_ENTER,                    /* arg: exception number */
+    TRACE_IRQ_EXIT,
+    TRACE_IPC_TRYTAKE,                  /* arg: object class, object: the IPC */
+    TRACE_IPC_TAKE,
+    TRACE_IPC_PUT,
+    TRACE_TIMER_ENTER,                  /* object: the timer */
+    TRACE_TIMER_EXIT,
+    TRACE_MARK,                         /* arg: marker, object: its value */
+    TRACE_BEGIN,
+    TRACE_END,
+};
+
+struct trace_event
+{
+    rt_uint32_t time;                   /* microseconds */
+    rt_uint32_t what;                   /* type << 24 | argument */
+    rt_uint32_t object;
+};
+
+struct trace_ring
+{
+    rt_uint32_t head;                   /* records ever written */
+    struct trace_event event[TRACE_BUF_EVENTS];
+};
+
+static struct
+{
+    volatile rt_bool_t on;
+    struct trace_ring ring[TRACE_CORES];
+} trace;
+
+/* from RAM, so a hook never waits on a flash cache miss */
+static void __not_in_flash_func(trace_put)(rt_uint32_t type, rt_uint32_t arg, rt_uint32_t object)
+{
+    struct trace_ring *ring;
+    struct trace_event *e;
+    rt_base_t level;
+
+    if (!trace.on)
+        return;
+
+    ring = &trace.ring[get_core_num()];
+    level = rt_hw_interrupt_disable();
+    e = &ring->event[ring->head & (TRACE_BUF_EVENTS - 1)];
+    e->time = timer_hw->timerawl;
+    e->what = type << 24 | (arg & 0xffffff);
+    e->object = object;
+    ring->head++;
+    rt_hw_interrupt_enable(level);
+}
+
+void trace_mark(enum trace_marker id, rt_uint32_t value)
+{
+    trace_put(TRACE_MARK, id, value);
+}
+
+void trace_begin(enum trace_marker id, rt_uint32_t value)
+{
+    trace_put(TRACE_BEGIN, id, value);
+}
+
+void trace_end(enum trace_marker id, rt_uint32_t value)
+{
+    trace_put(TRACE_END, id, value);
+}
+
+rt_inline rt_uint32_t trace_ipsr(void)
+{
+    rt_uint32_t ipsr;
+
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return ipsr & 0x3f;
+}
+
+static void trace_scheduler_hook(struct rt_thread *from, struct rt_thread *to)
+{
+    trace_put(TRACE_SWITCH, to->current_priority, (rt_uint32_t)to);
+}
+
+static void trace_irq_enter(void)
+{
+    trace_put(TRACE_IRQ_ENTER, trace_ipsr(), 0);
+}
+
+static void trace_irq_leave(void)
+{
+    trace_put(TRACE_IRQ_EXIT, trace_ipsr(), 0);
+}
+
+static void trace_trytake_hook(struct rt_object *object)
+{
+    trace_put(TRACE_IPC_TRYTAKE, object->type & ~RT_Object_Class_Static, (rt_uint32_t)object);
+}
+
+static void trace_take_hook(struct rt_object *object)
+{
+    trace_put(TRACE_IPC_TAKE, object->type & ~RT_Object_Class_Static, (rt_uint32_t)object);
+}
+
+static void trace_put_hook(struct rt_object *object)
+{
+    trace_put(TRACE_IPC_PUT, object->type & ~RT_Object_Class_Static, (rt_uint32_t)object);
+}
+
+static void trace_timer_enter(struct rt_timer *timer)
+{
+    trace_put(TRACE_TIMER_ENTER, 0, (rt_uint32_t)timer);
+}
+
+static void trace_timer_exit(struct rt_timer *timer)
+{
+    trace_put(TRACE_TIMER_EXIT, 0, (rt_uint32_t)timer);
+}
+
+static int trace_init(void)
+{
+    rt_scheduler_sethook(trace_scheduler_hook);
+    rt_interrupt_enter_sethook(trace_irq_enter);
+    rt_interrupt_leave_sethook(trace_irq_leave);
+    rt_object_trytake_sethook(trace_trytake_hook);
+    rt_object_take_sethook(trace_take_hook);
+    rt_object_put_sethook(trace_put_hook);
+    rt_timer_enter_sethook(trace_timer_enter);
+    rt_timer_exit_sethook(trace_timer_exit);
+    trace.on = RT_TRUE;
+
+    return RT_EOK;
+}
+INIT_APP_EXPORT(trace_init);
+
+#ifdef RT_USING_FINSH
+static const char *const trace_class[] =
+{
+    [RT_Object_Class_Thread] = "thread",
+    [RT_Object_Class_Semaphore] = "sem",
+    [RT_Object_Class_Mutex] = "mutex",
+    [RT_Object_Class_Event] = "event",
+    [RT_Object_Class_MailBox] = "mailbox",
+    [RT_Object_Class_MessageQueue] = "mq",
+    [RT_Object_Class_Timer] = "timer",
+};
+
+static void trace_dump_objects(void)
+{
+    struct rt_object_information *info;
+    struct rt_object *object;
+    struct rt_list_node *node;
+    int i;
+
+    for (i = 0; i < sizeof(trace_class) / sizeof(trace_class[0]); i++)
+    {
+        if (trace_class[i] == RT_NULL)
+            continue;
+        info = rt_object_get_information((enum rt_object_class_type)i);
+        if (info == RT_NULL)
+            continue;
+
+        rt_enter_critical();
+        rt_list_for_each(node, &info->object_list)
+        {
+            object = rt_list_entry(node, struct rt_object, list);
+            rt_kprintf("TRACE O %08x %s %.*s\n", (rt_uint32_t)object, trace_class[i],
+                       RT_NAME_MAX, object->name);
+        }
+        rt_exit_critical();
+    }
+}
+
+static void trace_dump(void)
+{
+    rt_bool_t was_on = trace.on;
+    struct trace_ring *ring;
+    struct trace_event *e;
+    rt_uint32_t i, n;
+    int core;
+
+    /* a record core1 is in the middle of is as good as lost */
+    trace.on = RT_FALSE;
+    __dmb();
+    busy_wait_us_32(10);
+
+    rt_kprintf("TRACE H %x %x %08x\n", TRACE_VERSION, TRACE_BUF_EVENTS, timer_hw->timerawl);
+    trace_dump_objects();
+    for (core = 0; core < TRACE_CORES; core++)
+    {
+        ring = &trace.ring[core];
+        n = ring->head < TRACE_BUF_EVENTS ? ring->head : TRACE_BUF_EVENTS;
+        for (i = ring->head - n; i != ring->head; i++)
+        {
+            e = &ring->event[i & (TRACE_BUF_EVENTS - 1)];
+            rt_kprintf("TRACE E %x %08x %08x %08x\n", core, e->time, e->what, e->object);
+        }
+    }
+
+    trace.on = was_on;
+}
+
+static void trace_clear(void)
+{
+    rt_bool_t was_on = trace.on;
+
+    trace.on = RT_FALSE;
+    __dmb();
+    busy_wait_us_32(10);
+    trace.ring[0].head = trace.ring[1].head = 0;
+    __dmb();
+    trace.on = was_on;
+}
+
+/* CPU cycles of one record, the call included; the rings keep their state */
+static rt_uint32_t trace_cost(void)
+{
+    struct trace_ring *ring = &trace.ring[get_core_num()];
+    rt_uint32_t head, start, end, i;
+    rt_bool_t was_on = trace.on;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    head = ring->head;
+    trace.on = RT_TRUE;
+    start = mpu_hw->cvr;
+    for (i = 0; i < TRACE_COST_RUNS; i++)
+        trace_mark(0, i);
+    end = mpu_hw->cvr;
+    ring->head = head;
+    trace.on = was_on;
+    rt_hw_interrupt_enable(level);
+
+    /* SysTick counts down; the runs are far shorter than a tick */
+    if (end > start)
+        start += mpu_hw->rvr + 1;
+    return (start - end) / TRACE_COST_RUNS;
+}
+
+static void trace_cmd(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        rt_kprintf("trace %s, %d events per core, written core0 %u core1 %u, %u cycles each\n",
+                   trace.on ? "on" : "off", TRACE_BUF_EVENTS, trace.ring[0].head, trace.ring[1].head,
+                   trace_cost());
+    }
+    else if (!rt_strcmp(argv[1], "start"))
+    {
+        trace.on = RT_TRUE;
+    }
+    else if (!rt_strcmp(argv[1], "stop"))
+    {
+        trace.on = RT_FALSE;
+    }
+    else if (!rt_strcmp(argv[1], "clear"))
+    {
+        trace_clear();
+    }
+    else if (!rt_strcmp(argv[1], "dump"))
+    {
+        trace_dump();
+    }
+    else
+    {
+        rt_kprintf("usage: trace [start|stop|clear|dump]\n");
+    }
+}
+MSH_CMD_EXPORT_ALIAS(trace_cmd, trace, record kernel and application events: trace [start|stop|clear|dump]);
+#endif /* RT_USING_FINSH */
+
+#endif /* APP_USING_TRACE */
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        binary event trace
+ */
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <rtthread.h>
+
+/* application markers, the decoder names them */
+enum trace_marker
+{
+    TRACE_SAMPLE = 1,                   /* a sensor reading, value: the ADC tick */
+    TRACE_DISPLAY_FLUSH,                /* a display refresh, on core1 */
+    TRACE_AT_SEND,                      /* an AT command sent, value: its timeout */
+    TRACE_AT_ACK,                       /* its answer, value: the result */
+};
+
+#ifdef APP_USING_TRACE
+void trace_mark(enum trace_marker id, rt_uint32_t value);
+void trace_begin(enum trace_marker id, rt_uint32_t value);
+void trace_end(enum trace_marker id, rt_uint32_t value);
+#else
+#define trace_mark(id, value)           do {} while (0)
+#define trace_begin(id, value)          do {} while (0)
+#define trace_end(id, value)            do {} while (0)
+#endif
+
+#endif /* __TRACE_H__ */
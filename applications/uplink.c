@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        store-and-forward uploads from the sample log
+ * 2026-10-17     khair        keep samples on auth errors, split refused batches
+ * 2026-10-17     khair        batch size from sample_batch_limit()
+ */
+/*
+ * Uploads go out of the sample log rather than out of RAM, so an outage
+ * or a reboot only delays them. The log is the queue: everything from the
+ * acknowledged cursor to its head is still to be sent, one sample every
+ * UPLINK_SAMPLE_INTERVAL seconds of sample time.
+ *
+ * The cursor moves when the server answers 2xx. Each move is appended to
+ * a journal on the "upq" partition: 32-byte marks numbered by a
+ * generation, filled into two sectors in turn, with the sector erased
+ * before its first mark. The newest intact mark is the cursor at boot, so
+ * a power cut during a write or an erase costs at most one batch sent
+ * twice.
+ *
+ * A 400 or 413 may be down to one bad sample or to the size of the batch,
+ * so the batch is sent again in halves, down to a single sample, and only
+ * a single sample the server still refuses is skipped. The batch size
+ * doubles back with each accepted post; after a 413, only up to half the
+ * size refused, for an hour. 401, 403 and 404 mean the settings are wrong,
+ * not the samples: those posts are counted as denied and retried like any
+ * other failure, 408, 429, 5xx or no answer at all, and nothing is
+ * skipped. Without a channel id sample_batch_limit() is 1, and the backlog
+ * goes out a sample a post.
+ *
+ * After an outage the backlog goes out in full batches, one every
+ * UPLINK_MIN_INTERVAL seconds, as fast as the server takes them. Failed
+ * posts are retried with a backoff that doubles up to ten minutes. When
+ * the backlog fills half the log, the oldest of it is thinned to one
+ * sample every 2, 4 and up to 8 intervals so it is cleared before the log
+ * wraps over it. What the log overwrites regardless is counted as lost.
+ * RAM use is one batch of samples.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <rtthread.h>
+
+#include "sample_batch.h"
+#include "sample_log.h"
+#include "sim800_http.h"
+#include "uplink.h"
+
+#ifdef APP_USING_UPLINK
+
+#include <fal.h>
+
+#define DBG_TAG "uplink"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#define UPLINK_SECTOR_SIZE      4096
+#define UPLINK_MARK_NONE        0xffffffffu
+#define UPLINK_CHUNK            8       /* samples read from the log at a time */
+#define UPLINK_RETRY_MIN        20      /* seconds */
+#define UPLINK_RETRY_MAX        600
+#define UPLINK_IDLE             20      /* seconds between looks at a caught-up log */
+#define UPLINK_CEILING_HOLD     3600    /* seconds a 413 keeps batches to half its size */
+
+enum uplink_result
+{
+    UPLINK_SENT,
+    UPLINK_RETRY,                   /* no answer, or one that may change */
+    UPLINK_DENIED,                  /* the channel or its key is wrong */
+    UPLINK_REFUSED,                 /* the server will not take these samples */
+    UPLINK_TOO_LARGE,               /* nor this many at a time */
+};
+
+/* an acknowledged position in the log */
+struct uplink_mark
+{
+    rt_uint32_t gen;                /* marks written before this one */
+    rt_uint32_t seq;                /* sample_log_cursor */
+    rt_uint16_t index;
+    rt_uint16_t boot;
+    rt_uint32_t time;               /* of the last sample sent in `boot` */
+    rt_uint32_t reserved[3];
+    rt_uint32_t crc;
+};
+
+struct uplink
+{
+    const struct fal_partition *part;
+    rt_uint32_t slots;              /* marks the partition holds */
+    rt_uint32_t gen;                /* of the next mark */
+
+    struct sample_log_cursor ack;   /* first sample not yet accepted */
+    rt_uint32_t ack_time;           /* of the last sample accepted in ack.boot */
+    struct sample_log_cursor next;  /* just after the batch in `out` */
+    rt_uint32_t next_thinned;
+
+    rt_uint32_t limit;              /* most samples in a batch, less after a 400 or 413 */
+    rt_uint32_t ceiling;            /* what `limit` grows back to */
+    rt_tick_t ceiling_tick;         /* when a 413 last lowered it */
+    rt_uint32_t retry;              /* seconds before the next try after a failure */
+    rt_tick_t last_post;
+    rt_bool_t draining;             /* full batches are going out back to back */
+    rt_tick_t drain_start;
+    rt_uint32_t drain_sent;
+
+    struct sample out[SAMPLE_BATCH_SIZE];
+    struct uplink_stat stat;
+};
+
+static struct uplink uplink;
+
+static rt_uint32_t uplink_mark_crc(const struct uplink_mark *mark)
+{
+    return sample_log_crc(0, mark, offsetof(struct uplink_mark, crc));
+}
+
+/* the newest intact mark, or RT_FALSE if there is none */
+static rt_bool_t uplink_recover(struct uplink *up, struct uplink_mark *best)
+{
+    struct uplink_mark mark;
+    rt_bool_t found = RT_FALSE;
+    rt_uint32_t i;
+
+    for (i = 0; i < up->slots; i++)
+    {
+        if (fal_partition_read(up->part, i * sizeof(mark), (rt_uint8_t *)&mark, sizeof(mark)) < 0)
+            continue;
+        if (mark.gen == UPLINK_MARK_NONE || mark.gen % up->slots != i || mark.crc != uplink_mark_crc(&mark))
+            continue;
+        if (!found || mark.gen > best->gen)
+        {
+            *best = mark;
+            found = RT_TRUE;
+        }
+    }
+    return found;
+}
+
+static void uplink_write_mark(struct uplink *up)
+{
+    struct uplink_mark mark;
+    rt_uint32_t slot = up->gen % up->slots;
+
+    if (slot * sizeof(mark) % UPLINK_SECTOR_SIZE == 0
+        && fal_partition_erase(up->part, slot * sizeof(mark), UPLINK_SECTOR_SIZE) < 0)
+        up->stat.errors++;
+
+    rt_memset(&mark, 0xff, sizeof(mark));
+    mark.gen = up->gen++;
+    mark.seq = up->ack.seq;
+    mark.index = up->ack.index;
+    mark.boot = up->ack.boot;
+    mark.time = up->ack_time;
+    mark.crc = uplink_mark_crc(&mark);
+    if (fal_partition_write(up->part, slot * sizeof(mark), (rt_uint8_t *)&mark, sizeof(mark)) < 0)
+        up->stat.errors++;
+    else
+        up->stat.marks++;
+}
+
+/* pages between the cursor and the head of the log; counts what the log overwrote */
+static rt_uint32_t uplink_depth(struct uplink *up)
+{
+    struct sample_log_cursor oldest, newest;
+
+    sample_log_oldest(&oldest);
+    sample_log_newest(&newest);
+    if (up->ack.seq < oldest.seq)
+    {
+        LOG_W("pages %d..%d overwritten before they were sent", up->ack.seq, oldest.seq - 1);
+        up->stat.lost += oldest.seq - up->ack.seq;
+        up->ack.seq = oldest.seq;
+        up->ack.index = 0;
+    }
+
+    up->stat.depth = newest.seq - up->ack.seq;
+    if (up->stat.depth > up->stat.max_depth)
+        up->stat.max_depth = up->stat.depth;
+
+    return up->stat.depth;
+}
+
+/* seconds between the samples taken from a backlog filling `depth` pages */
+static rt_uint32_t uplink_spacing(rt_uint32_t depth)
+{
+    rt_uint32_t capacity = sample_log_capacity();
+
+    if (depth * 10 >= capacity * 9)
+        return 8 * UPLINK_SAMPLE_INTERVAL;
+    if (depth * 4 >= capacity * 3)
+        return 4 * UPLINK_SAMPLE_INTERVAL;
+    if (depth * 2 >= capacity)
+        return 2 * UPLINK_SAMPLE_INTERVAL;
+    return UPLINK_SAMPLE_INTERVAL;
+}
+
+/*
+ * Fills `out` with the next batch from the cursor on, at most `max`
+ * samples of one boot at least `spacing` seconds apart, and leaves `next`
+ * just after the last one taken. Returns how many.
+ */
+static rt_uint32_t uplink_collect(struct uplink *up, rt_uint32_t spacing, rt_uint32_t max)
+{
+    struct sample chunk[UPLINK_CHUNK];
+    struct sample_log_cursor before;
+    rt_uint32_t n = 0, keep = up->ack_time;
+    rt_uint16_t boot = up->ack.boot;
+    rt_bool_t have = boot != 0;
+    rt_ssize_t got, i;
+
+    up->next = up->ack;
+    up->next_thinned = 0;
+    while (n < max)
+    {
+        before = up->next;
+        got = sample_log_read(&up->next, chunk, UPLINK_CHUNK);
+        if (got <= 0)
+            break;
+        if (up->next.boot != boot)
+        {
+            /* a batch holds one boot, times restart with the next */
+            if (n > 0)
+            {
+                up->next = before;
+                break;
+            }
+            boot = up->next.boot;
+            have = RT_FALSE;
+        }
+
+        for (i = 0; i < got && n < max; i++)
+        {
+            if (have && chunk[i].time - keep < spacing)
+            {
+                if (spacing > UPLINK_SAMPLE_INTERVAL)
+                    up->next_thinned++;
+                continue;
+            }
+            up->out[n++] = chunk[i];
+            keep = chunk[i].time;
+            have = RT_TRUE;
+        }
+        if (i < got)
+        {
+            /* full part way through the chunk, read again up to its last sample */
+            up->next = before;
+            sample_log_read(&up->next, chunk, i);
+            break;
+        }
+    }
+    up->next.boot = boot;
+
+    return n;
+}
+
+/* a batch is sent when full, when the boot it is from has ended, or when
+ * its oldest sample waited long enough */
+static rt_bool_t uplink_due(struct uplink *up, rt_uint32_t n)
+{
+    return n >= up->limit || up->next.boot != sample_log_boot()
+           || rt_tick_get() / RT_TICK_PER_SECOND - up->out[0].time >= SAMPLE_BATCH_MAX_AGE;
+}
+
+static void uplink_drain_stat(struct uplink *up, rt_bool_t full, rt_uint32_t sent)
+{
+    rt_tick_t ticks;
+
+    if (full && !up->draining)
+    {
+        up->draining = RT_TRUE;
+        up->drain_start = rt_tick_get();
+        up->drain_sent = 0;
+    }
+    up->drain_sent += sent;
+    if (!full && up->draining)
+    {
+        ticks = rt_tick_get() - up->drain_start;
+        if (ticks > 0)
+            up->stat.drain_rate = (rt_uint64_t)up->drain_sent * 60 * RT_TICK_PER_SECOND / ticks;
+        LOG_I("backlog drained, %d samples at %d a minute", up->drain_sent, up->stat.drain_rate);
+        up->draining = RT_FALSE;
+    }
+}
+
+/* posts `n` samples from `out` */
+static enum uplink_result uplink_post(struct uplink *up, rt_uint32_t n)
+{
+    rt_int32_t wait;
+    int result, status;
+
+    /* the server takes one post every UPLINK_MIN_INTERVAL */
+    wait = (rt_int32_t)(up->last_post + UPLINK_MIN_INTERVAL * RT_TICK_PER_SECOND - rt_tick_get());
+    if (up->stat.posts > 0 && wait > 0)
+        rt_thread_delay(wait);
+
+    up->stat.posts++;
+    up->last_post = rt_tick_get();
+    result = sample_batch_post(up->out, n, up->next.boot, up->next.boot == up->ack.boot ? up->ack_time : 0);
+    if (result == RT_EOK)
+    {
+        up->stat.sent += n;
+        return UPLINK_SENT;
+    }
+
+    up->stat.failures++;
+    status = sim800_http_get_stat()->last_status;
+    switch (status)
+    {
+    case 401:
+    case 403:
+    case 404:
+        LOG_E("server denied the channel (%d), check its id and key; samples kept", status);
+        return UPLINK_DENIED;
+    case 400:
+        LOG_W("server refused %d samples (%d)", n, status);
+        return UPLINK_REFUSED;
+    case 413:
+        LOG_W("server refused %d samples (%d)", n, status);
+        return UPLINK_TOO_LARGE;
+    default:
+        return UPLINK_RETRY;
+    }
+}
+
+static void uplink_ack(struct uplink *up, rt_uint32_t n)
+{
+    up->ack = up->next;
+    up->ack_time = up->out[n - 1].time;
+    up->stat.thinned += up->next_thinned;
+    uplink_write_mark(up);
+}
+
+/**
+ * Open the acknowledgement journal and find where uploading stopped. Call
+ * after sample_log_init().
+ */
+int uplink_init(void)
+{
+    struct uplink *up = &uplink;
+    struct sample_log_cursor newest;
+    struct uplink_mark mark = {0};
+
+    up->part = fal_partition_find(UPLINK_PARTITION);
+    if (up->part == RT_NULL || up->part->len < 2 * UPLINK_SECTOR_SIZE)
+    {
+        LOG_E("no usable partition \"%s\"", UPLINK_PARTITION);
+        up->part = RT_NULL;
+        return -RT_ERROR;
+    }
+    up->slots = up->part->len / UPLINK_SECTOR_SIZE * (UPLINK_SECTOR_SIZE / sizeof(struct uplink_mark));
+    up->limit = sample_batch_limit();
+    up->ceiling = sample_batch_limit();
+    up->retry = UPLINK_RETRY_MIN;
+
+    sample_log_newest(&newest);
+    if (uplink_recover(up, &mark) && mark.seq <= newest.seq)
+    {
+        up->gen = mark.gen + 1;
+        up->ack.seq = mark.seq;
+        up->ack.index = mark.index;
+        up->ack.boot = mark.boot;
+        up->ack_time = mark.time;
+    }
+    else
+    {
+        /* nothing sent yet, or the log was wiped: start from its oldest page */
+        sample_log_oldest(&up->ack);
+        up->gen = 0;
+    }
+    LOG_I("%d pages waiting from page %d", uplink_depth(up), up->ack.seq);
+
+    return RT_EOK;
+}
+
+/*
+ * Collects the next batch and posts it if it is due. Returns the seconds
+ * to wait before the next call.
+ */
+static rt_uint32_t uplink_step(struct uplink *up)
+{
+    rt_uint32_t n, wait;
+    rt_bool_t full;
+
+    n = uplink_collect(up, uplink_spacing(uplink_depth(up)), up->limit);
+    if (n == 0 || !uplink_due(up, n))
+    {
+        uplink_drain_stat(up, RT_FALSE, 0);
+        return UPLINK_IDLE;
+    }
+
+    switch (uplink_post(up, n))
+    {
+    case UPLINK_SENT:
+        full = n == up->limit;
+        up->retry = UPLINK_RETRY_MIN;
+        if (rt_tick_get() - up->ceiling_tick >= UPLINK_CEILING_HOLD * RT_TICK_PER_SECOND)
+            up->ceiling = sample_batch_limit();
+        up->limit = up->limit * 2 < up->ceiling ? up->limit * 2 : up->ceiling;
+        uplink_ack(up, n);
+        uplink_drain_stat(up, full, n);
+        return 0;
+
+    case UPLINK_TOO_LARGE:
+        /* a size limit holds for the next batches too */
+        up->ceiling = n > 1 ? n / 2 : 1;
+        up->ceiling_tick = rt_tick_get();
+        /* fall through */
+    case UPLINK_REFUSED:
+        if (n > 1)
+        {
+            up->limit = n / 2;
+            LOG_W("sending %d at a time", up->limit);
+            return 0;
+        }
+        LOG_W("skipping the sample at %d s of boot %d", up->out[0].time, up->next.boot);
+        up->stat.rejected++;
+        uplink_ack(up, 1);
+        return 0;
+
+    case UPLINK_DENIED:
+        up->stat.denied++;
+        break;
+
+    default:
+        break;
+    }
+
+    wait = up->retry;
+    LOG_W("%d pages waiting, next try in %d s", up->stat.depth, wait);
+    up->retry = up->retry * 2 < UPLINK_RETRY_MAX ? up->retry * 2 : UPLINK_RETRY_MAX;
+    return wait;
+}
+
+/**
+ * Upload from the log for ever. Runs in the thread that owns the modem
+ * uploads.
+ */
+void uplink_run(void)
+{
+    struct uplink *up = &uplink;
+    rt_uint32_t wait;
+
+    while (up->part == RT_NULL)
+        rt_thread_mdelay(UPLINK_IDLE * 1000);
+
+    while (1)
+    {
+        wait = uplink_step(up);
+        if (wait > 0)
+            rt_thread_mdelay(wait * 1000);
+    }
+}
+
+const struct uplink_stat *uplink_get_stat(void)
+{
+    return &uplink.stat;
+}
+
+#ifdef RT_USING_FINSH
+static void uplink_cmd(int argc, char **argv)
+{
+    struct uplink *up = &uplink;
+    const struct uplink_stat *st = &up->stat;
+
+    if (up->part == RT_NULL)
+    {
+        rt_kprintf("uplink not open\n");
+        return;
+    }
+
+    rt_kprintf("acknowledged up to page %d sample %d (boot %d), %d of %d pages waiting, most %d\n", up->ack.seq,
+               up->ack.index, up->ack.boot, st->depth, sample_log_capacity(), st->max_depth);
+    rt_kprintf("every %d s now, posts %d, failed %d, sent %d samples\n", uplink_spacing(st->depth), st->posts,
+               st->failures, st->sent);
+    rt_kprintf("denied %d, rejected %d, thinned %d, pages lost %d\n", st->denied, st->rejected, st->thinned,
+               st->lost);
+    if (up->limit < sample_batch_limit())
+        rt_kprintf("batches cut to %d samples after a refusal\n", up->limit);
+    if (up->draining)
+        rt_kprintf("draining: %d samples in %d s\n", up->drain_sent, (rt_tick_get() - up->drain_start) / RT_TICK_PER_SECOND);
+    rt_kprintf("last drain %d samples a minute, marks %d, flash errors %d\n", st->drain_rate, st->marks, st->errors);
+}
+MSH_CMD_EXPORT_ALIAS(uplink_cmd, uplink, show the store-and-forward upload queue);
+#endif /* RT_USING_FINSH */
+
+#endif /* APP_USING_UPLINK */
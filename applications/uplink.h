@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        store-and-forward uploads from the sample log
+ * 2026-10-17     khair        count denied posts
+ */
+#ifndef APPLICATIONS_UPLINK_H_
+#define APPLICATIONS_UPLINK_H_
+
+#include <rtthread.h>
+
+#ifndef UPLINK_PARTITION
+#define UPLINK_PARTITION            "upq"
+#endif
+
+#ifndef UPLINK_SAMPLE_INTERVAL
+#define UPLINK_SAMPLE_INTERVAL      20      /* seconds between uploaded samples */
+#endif
+
+#ifndef UPLINK_MIN_INTERVAL
+#define UPLINK_MIN_INTERVAL         15      /* seconds between posts */
+#endif
+
+struct uplink_stat
+{
+    rt_uint32_t sent;               /* samples the server accepted */
+    rt_uint32_t posts;              /* batches posted */
+    rt_uint32_t failures;           /* posts to be tried again */
+    rt_uint32_t denied;             /* failures on 401, 403, 404 or no channel set */
+    rt_uint32_t rejected;           /* samples skipped, each refused alone by a 400 or 413 */
+    rt_uint32_t thinned;            /* backlog samples left out to catch up */
+    rt_uint32_t lost;               /* pages overwritten in the log before they were sent */
+    rt_uint32_t depth;              /* pages waiting at the last look */
+    rt_uint32_t max_depth;
+    rt_uint32_t drain_rate;         /* samples a minute through the last backlog drain */
+    rt_uint32_t marks;              /* acknowledgements written to flash */
+    rt_uint32_t errors;             /* failed flash operations */
+};
+
+int uplink_init(void);
+void uplink_run(void);
+const struct uplink_stat *uplink_get_stat(void);
+
+#endif /* APPLICATIONS_UPLINK_H_ */
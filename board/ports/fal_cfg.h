@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        first version
+ */
+
+#ifndef _FAL_CFG_H_
+#define _FAL_CFG_H_
+
+#include <rtconfig.h>
+#include <board.h>
+
+/* ===================== Flash device Configuration ========================= */
+extern const struct fal_flash_dev pico_onchip_flash;
+
+#ifdef SAMPLE_LOG_USING_SELFTEST
+/* RAM-backed flash with NOR semantics, for the sample log self-test */
+extern const struct fal_flash_dev sample_log_sim_flash;
+#define SAMPLE_LOG_SIM_FLASH    &sample_log_sim_flash,
+#else
+#define SAMPLE_LOG_SIM_FLASH
+#endif
+
+/* flash device table */
+#define FAL_FLASH_DEV_TABLE                                          \
+{                                                                    \
+    &pico_onchip_flash,                                              \
+    SAMPLE_LOG_SIM_FLASH                                             \
+}
+
+/* ====================== Partition Configuration ========================== */
+#ifdef FAL_PART_HAS_TABLE_CFG
+
+#ifdef SAMPLE_LOG_USING_SELFTEST
+#define SAMPLE_LOG_SIM_PART     {FAL_PART_MAGIC_WORD, "logsim", "logsim", 0, 16 * 1024, 0},
+#else
+#define SAMPLE_LOG_SIM_PART
+#endif
+
+/* partition table, the firmware must end below "log" */
+#define FAL_PART_TABLE                                                               \
+{                                                                                    \
+    {FAL_PART_MAGIC_WORD,  "app", "onchip",          0, 1528 * 1024, 0},             \
+    {FAL_PART_MAGIC_WORD,  "upq", "onchip", 1528 * 1024,    8 * 1024, 0},            \
+    {FAL_PART_MAGIC_WORD,  "log", "onchip", 1536 * 1024,  512 * 1024, 0},            \
+    SAMPLE_LOG_SIM_PART                                                              \
+}
+#endif /* FAL_PART_HAS_TABLE_CFG */
+
+#endif /* _FAL_CFG_H_ */
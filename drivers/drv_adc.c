@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author         Notes
+ * 2026-10-17     khair          first version
+ * 2026-10-17     khair          capture on core1
+ */
+
+/*
+ * Free-running ADC capture. The ADC converts the inputs in BSP_ADC_INPUTS
+ * round robin, paced by its clock divider, and two DMA channels chained to
+ * each other move the FIFO into a pair of block buffers: while one buffer
+ * fills, the other holds a complete block. The only interrupt is the DMA
+ * completion at the end of each block, which re-arms the finished channel
+ * and wakes the reader.
+ *
+ * The reader decimates the newest block with a boxcar (a first-order CIC
+ * whose decimation equals its length): the BSP_ADC_DECIMATION conversions
+ * of each input are summed and scaled to a 12.4 fixed-point code. Averaging
+ * N conversions of a slow signal gains log4(N) bits over a single one, so
+ * the default 1024 gives up to five more bits than the 9.5 ENOB of a single
+ * conversion, bounded in practice by the ADC's DNL.
+ *
+ * With BSP_ADC_USING_CORE1 the capture belongs to core1 instead: the block
+ * interrupt is DMA_IRQ_1, enabled on core1 only, and core1 decimates with
+ * pico_adc_capture_poll(). That side uses no RT-Thread services; it only
+ * reads the tick counter. rt_hw_adc_init() still sets everything up from
+ * core0 at boot, and pico_adc_capture_start() on core1 starts it.
+ */
+
+#include <rthw.h>
+#include <rtdevice.h>
+
+#include "drv_adc.h"
+
+#include "adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#ifdef BSP_USING_ADC
+
+#define DBG_TAG "drv.adc"
+#define DBG_LVL DBG_WARNING
+#include <rtdbg.h>
+
+#define PICO_ADC_CHANNELS       ((BSP_ADC_INPUTS & 1) + ((BSP_ADC_INPUTS >> 1) & 1) + \
+                                 ((BSP_ADC_INPUTS >> 2) & 1) + ((BSP_ADC_INPUTS >> 3) & 1))
+#define PICO_ADC_BLOCK_LEN      (PICO_ADC_CHANNELS * BSP_ADC_DECIMATION)
+#define PICO_ADC_DECIM_SHIFT    (__builtin_ctz(BSP_ADC_DECIMATION) - PICO_ADC_FRAC_BITS)
+#define PICO_ADC_ERR_BIT        (1u << 15)
+
+#ifdef BSP_ADC_USING_CORE1
+#define PICO_ADC_DMA_IRQ        DMA_IRQ_1
+#define PICO_ADC_DMA_INTS       (dma_hw->ints1)
+#else
+#define PICO_ADC_DMA_IRQ        DMA_IRQ_0
+#define PICO_ADC_DMA_INTS       (dma_hw->ints0)
+#endif
+
+#if PICO_ADC_CHANNELS == 0 || (BSP_ADC_INPUTS & ~0xf)
+#error "BSP_ADC_INPUTS must select some of ADC inputs 0..3"
+#endif
+#if (BSP_ADC_DECIMATION & (BSP_ADC_DECIMATION - 1)) || BSP_ADC_DECIMATION < (1 << PICO_ADC_FRAC_BITS)
+#error "BSP_ADC_DECIMATION must be a power of two, at least 16"
+#endif
+
+struct pico_adc_capture
+{
+    int dma_chan[2];
+    rt_uint8_t input[PICO_ADC_CHANNELS];        /* ADC input of each slot in a frame */
+
+    /* written by the DMA ISR */
+    volatile rt_uint32_t seq;
+    volatile rt_uint8_t ready;
+    volatile rt_tick_t tick;
+    struct rt_completion done;
+
+    rt_uint32_t last_seq;
+    struct pico_adc_block last;
+    struct pico_adc_stat stat;
+
+    rt_uint16_t buf[2][PICO_ADC_BLOCK_LEN];
+};
+
+static struct pico_adc_capture adc_capture;
+
+/* shared on PICO_ADC_DMA_IRQ, only acts on the capture channels */
+static void pico_adc_dma_isr(void)
+{
+    struct pico_adc_capture *cap = &adc_capture;
+    rt_uint32_t ints = PICO_ADC_DMA_INTS;
+    int i;
+
+    if (!(ints & ((1u << cap->dma_chan[0]) | (1u << cap->dma_chan[1]))))
+        return;
+
+#ifndef BSP_ADC_USING_CORE1
+    rt_interrupt_enter();
+#endif
+    for (i = 0; i < 2; i++)
+    {
+        if (!(ints & (1u << cap->dma_chan[i])))
+            continue;
+        PICO_ADC_DMA_INTS = 1u << cap->dma_chan[i];
+        /* the other channel is already running; rewind this one so it is
+         * ready when the chain comes back to it (the count reloads itself) */
+        dma_channel_set_write_addr(cap->dma_chan[i], cap->buf[i], false);
+        cap->ready = i;
+        cap->tick = rt_tick_get();
+        cap->seq++;
+        cap->stat.blocks++;
+    }
+#ifdef BSP_ADC_USING_CORE1
+    __sev();                                /* wake the core1 loop out of WFE */
+#else
+    rt_completion_done(&cap->done);
+    rt_interrupt_leave();
+#endif
+}
+
+static void pico_adc_decimate(struct pico_adc_capture *cap, const rt_uint16_t *buf,
+                              struct pico_adc_block *block)
+{
+    rt_uint32_t sum[PICO_ADC_CHANNELS] = {0};
+    rt_uint16_t lo[PICO_ADC_CHANNELS], hi[PICO_ADC_CHANNELS];
+    rt_uint32_t errors = 0;
+    rt_uint16_t s;
+    int i, c;
+
+    for (c = 0; c < PICO_ADC_CHANNELS; c++)
+    {
+        lo[c] = 0xfff;
+        hi[c] = 0;
+    }
+
+    for (i = 0; i < PICO_ADC_BLOCK_LEN; i += PICO_ADC_CHANNELS)
+    {
+        for (c = 0; c < PICO_ADC_CHANNELS; c++)
+        {
+            s = buf[i + c];
+            if (s & PICO_ADC_ERR_BIT)
+                errors++;
+            s &= 0xfff;
+            sum[c] += s;
+            if (s < lo[c])
+                lo[c] = s;
+            if (s > hi[c])
+                hi[c] = s;
+        }
+    }
+
+    rt_memset(block->code, 0, sizeof(block->code));
+    rt_memset(block->min, 0, sizeof(block->min));
+    rt_memset(block->max, 0, sizeof(block->max));
+    for (c = 0; c < PICO_ADC_CHANNELS; c++)
+    {
+        block->code[cap->input[c]] = sum[c] >> PICO_ADC_DECIM_SHIFT;
+        block->min[cap->input[c]] = lo[c];
+        block->max[cap->input[c]] = hi[c];
+    }
+    block->errors = errors;
+}
+
+/*
+ * Decimates the newest block, on the core that owns the capture. Blocks
+ * that completed since the last one taken are counted as missed, not
+ * queued.
+ */
+static void pico_adc_take(struct pico_adc_capture *cap, struct pico_adc_block *block)
+{
+    rt_uint32_t seq;
+    rt_uint8_t ready;
+    rt_tick_t tick;
+    rt_base_t level;
+
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+        seq = cap->seq;
+        ready = cap->ready;
+        tick = cap->tick;
+        rt_hw_interrupt_enable(level);
+
+        pico_adc_decimate(cap, cap->buf[ready], block);
+
+        /* the DMA starts rewriting this buffer once the next block completes */
+        if (cap->seq == seq)
+            break;
+        cap->stat.overruns++;
+    }
+
+    if (adc_hw->fcs & ADC_FCS_OVER_BITS)
+    {
+        adc_hw->fcs |= ADC_FCS_OVER_BITS;   /* write-one-to-clear */
+        cap->stat.fifo_overflows++;
+    }
+    if (seq - cap->last_seq > 1)
+        cap->stat.missed += seq - cap->last_seq - 1;
+    cap->last_seq = seq;
+    cap->stat.reads++;
+    cap->stat.errors += block->errors;
+
+    block->seq = seq;
+    block->tick = tick;
+    cap->last = *block;
+}
+
+#ifdef BSP_ADC_USING_CORE1
+/**
+ * Hooks the block interrupt to the calling core and starts converting.
+ * Called once, on core1.
+ */
+void pico_adc_capture_start(void)
+{
+    struct pico_adc_capture *cap = &adc_capture;
+
+    irq_add_shared_handler(PICO_ADC_DMA_IRQ, pico_adc_dma_isr, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(PICO_ADC_DMA_IRQ, true);
+
+    dma_channel_start(cap->dma_chan[0]);
+    adc_run(true);
+}
+
+/**
+ * Decimates the newest block if one completed since the last call. Never
+ * blocks; for the core1 loop.
+ */
+rt_bool_t pico_adc_capture_poll(struct pico_adc_block *block)
+{
+    struct pico_adc_capture *cap = &adc_capture;
+
+    if (cap->seq == cap->last_seq)
+        return RT_FALSE;
+
+    pico_adc_take(cap, block);
+    return RT_TRUE;
+}
+#else
+/*
+ * Waits for the next block, then decimates the newest one.
+ */
+rt_err_t pico_adc_capture_read(struct pico_adc_block *block, rt_int32_t timeout)
+{
+    struct pico_adc_capture *cap = &adc_capture;
+    rt_err_t err;
+
+    RT_ASSERT(block != RT_NULL);
+
+    err = rt_completion_wait(&cap->done, timeout);
+    if (err != RT_EOK)
+        return err;
+
+    pico_adc_take(cap, block);
+    return RT_EOK;
+}
+#endif /* BSP_ADC_USING_CORE1 */
+
+const struct pico_adc_stat *pico_adc_get_stat(void)
+{
+    return &adc_capture.stat;
+}
+
+int rt_hw_adc_init(void)
+{
+    struct pico_adc_capture *cap = &adc_capture;
+    dma_channel_config c;
+    rt_uint32_t rate = BSP_ADC_SAMPLE_RATE * PICO_ADC_CHANNELS;
+    float div;
+    int i, n = 0;
+
+    /* a conversion takes 96 ADC clocks, the divider integer part is 16 bits */
+    div = (float)clock_get_hz(clk_adc) / rate - 1;
+    if (div < 96 || div >= 65536)
+    {
+        LOG_E("%d conversions/s out of range", rate);
+        return -RT_EINVAL;
+    }
+
+    adc_init();
+    for (i = 0; i < PICO_ADC_INPUT_MAX; i++)
+    {
+        if (BSP_ADC_INPUTS & (1 << i))
+        {
+            adc_gpio_init(26 + i);
+            cap->input[n++] = i;
+        }
+    }
+
+    /* round robin starts from the selected input and goes up the mask, so
+     * every frame of PICO_ADC_CHANNELS samples is in cap->input order */
+    adc_select_input(cap->input[0]);
+    adc_set_round_robin(BSP_ADC_INPUTS);
+    adc_fifo_setup(true, true, 1, true, false);
+    adc_set_clkdiv(div);
+
+    rt_completion_init(&cap->done);
+    cap->dma_chan[0] = dma_claim_unused_channel(true);
+    cap->dma_chan[1] = dma_claim_unused_channel(true);
+    for (i = 0; i < 2; i++)
+    {
+        c = dma_channel_get_default_config(cap->dma_chan[i]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, DREQ_ADC);
+        channel_config_set_chain_to(&c, cap->dma_chan[i ^ 1]);
+        dma_channel_configure(cap->dma_chan[i], &c, cap->buf[i], &adc_hw->fifo, PICO_ADC_BLOCK_LEN, false);
+#ifdef BSP_ADC_USING_CORE1
+        dma_channel_set_irq1_enabled(cap->dma_chan[i], true);
+#else
+        dma_channel_set_irq0_enabled(cap->dma_chan[i], true);
+#endif
+    }
+
+#ifndef BSP_ADC_USING_CORE1
+    irq_add_shared_handler(PICO_ADC_DMA_IRQ, pico_adc_dma_isr, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(PICO_ADC_DMA_IRQ, true);
+
+    dma_channel_start(cap->dma_chan[0]);
+    adc_run(true);
+#endif
+
+    return RT_EOK;
+}
+INIT_DEVICE_EXPORT(rt_hw_adc_init);
+
+#ifdef RT_USING_FINSH
+static void adc_capture_cmd(int argc, char **argv)
+{
+    struct pico_adc_capture *cap = &adc_capture;
+    struct pico_adc_block *b = &cap->last;
+    int c, in;
+
+    rt_kprintf("inputs 0x%x, %d conversions/s each, %d per reading\n",
+               BSP_ADC_INPUTS, BSP_ADC_SAMPLE_RATE, BSP_ADC_DECIMATION);
+    rt_kprintf("blocks %d, read %d, missed %d, overruns %d, fifo overflows %d, errors %d\n",
+               cap->stat.blocks, cap->stat.reads, cap->stat.missed, cap->stat.overruns,
+               cap->stat.fifo_overflows, cap->stat.errors);
+    if (!cap->stat.reads)
+        return;
+
+    rt_kprintf("block %d at tick %d:\n", b->seq, b->tick);
+    for (c = 0; c < PICO_ADC_CHANNELS; c++)
+    {
+        in = cap->input[c];
+        rt_kprintf("  input %d: %4d.%02d  (%d..%d)\n", in, b->code[in] >> PICO_ADC_FRAC_BITS,
+                   (b->code[in] & ((1 << PICO_ADC_FRAC_BITS) - 1)) * 100 >> PICO_ADC_FRAC_BITS,
+                   b->min[in], b->max[in]);
+    }
+}
+MSH_CMD_EXPORT_ALIAS(adc_capture_cmd, adc, show the ADC capture state);
+#endif /* RT_USING_FINSH */
+
+#endif /* BSP_USING_ADC */
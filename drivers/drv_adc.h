@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author         Notes
+ * 2026-10-17     khair          first version
+ */
+
+#ifndef __DRV_ADC_H__
+#define __DRV_ADC_H__
+
+#include <rtthread.h>
+
+#include "board.h"
+
+/* decimated codes are 12.4 fixed point: ADC LSB << PICO_ADC_FRAC_BITS */
+#define PICO_ADC_FRAC_BITS      4
+#define PICO_ADC_INPUT_MAX      4       /* GPIO 26..29 */
+
+#ifndef BSP_ADC_INPUTS
+#define BSP_ADC_INPUTS          0x3
+#endif
+#ifndef BSP_ADC_SAMPLE_RATE
+#define BSP_ADC_SAMPLE_RATE     512
+#endif
+#ifndef BSP_ADC_DECIMATION
+#define BSP_ADC_DECIMATION      1024
+#endif
+
+/* one decimated reading of every captured input */
+struct pico_adc_block
+{
+    rt_uint32_t seq;                            /* block number since start */
+    rt_tick_t tick;                             /* when the block completed */
+    rt_uint16_t code[PICO_ADC_INPUT_MAX];       /* mean, 12.4 fixed point */
+    rt_uint16_t min[PICO_ADC_INPUT_MAX];        /* raw 12 bit extremes in the block */
+    rt_uint16_t max[PICO_ADC_INPUT_MAX];
+    rt_uint16_t errors;                         /* conversions flagged bad by the ADC */
+};
+
+struct pico_adc_stat
+{
+    rt_uint32_t blocks;                         /* blocks completed by DMA */
+    rt_uint32_t reads;                          /* blocks decimated for a reader */
+    rt_uint32_t missed;                         /* blocks nobody read in time */
+    rt_uint32_t overruns;                       /* blocks rewritten while being read */
+    rt_uint32_t fifo_overflows;                 /* conversions lost in the ADC FIFO */
+    rt_uint32_t errors;                         /* conversions flagged bad by the ADC */
+};
+
+int rt_hw_adc_init(void);
+#ifdef BSP_ADC_USING_CORE1
+void pico_adc_capture_start(void);
+rt_bool_t pico_adc_capture_poll(struct pico_adc_block *block);
+#else
+rt_err_t pico_adc_capture_read(struct pico_adc_block *block, rt_int32_t timeout);
+#endif
+const struct pico_adc_stat *pico_adc_get_stat(void);
+
+#endif /* __DRV_ADC_H__ */
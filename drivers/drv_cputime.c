@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author         Notes
+ * 2026-10-17     khair          first version
+ */
+
+/*
+ * CPU time on the RP2040's 64-bit microsecond timer. The Cortex-M0+ has no
+ * DWT cycle counter for cputime_cortexm.c to read, but the timer counts
+ * from clk_ref in every sleep mode used here and never wraps, so one
+ * cputime tick is one microsecond since boot. The cputimer timeouts run on
+ * a hardware alarm of the same timer.
+ */
+
+#include <rthw.h>
+#include <rtdevice.h>
+
+#include "drv_cputime.h"
+
+#include "hardware/timer.h"
+
+#ifdef BSP_USING_CPUTIME
+
+static void (*pico_cputime_timeout)(void *param);
+static void *pico_cputime_param;
+
+static uint64_t pico_cputime_getres(void)
+{
+    /* nanoseconds per tick, scaled by 10^6 as cputime.c expects */
+    return 1000ULL * (1000UL * 1000);
+}
+
+static uint64_t pico_cputime_gettime(void)
+{
+    return time_us_64();
+}
+
+static void pico_cputime_alarm_cb(uint alarm_num)
+{
+    void (*timeout)(void *param) = pico_cputime_timeout;
+
+    rt_interrupt_enter();
+    if (timeout != RT_NULL)
+        timeout(pico_cputime_param);
+    rt_interrupt_leave();
+}
+
+static int pico_cputime_settimeout(uint64_t tick, void (*timeout)(void *param), void *param)
+{
+    absolute_time_t target;
+    rt_base_t level;
+
+    if (timeout == RT_NULL)
+    {
+        hardware_alarm_cancel(BSP_CPUTIME_ALARM);
+        pico_cputime_timeout = RT_NULL;
+        return 0;
+    }
+
+    level = rt_hw_interrupt_disable();
+    pico_cputime_timeout = timeout;
+    pico_cputime_param = param;
+    /* a time already past is not armed by the SDK, so it fires at once instead */
+    update_us_since_boot(&target, tick);
+    while (hardware_alarm_set_target(BSP_CPUTIME_ALARM, target))
+        update_us_since_boot(&target, time_us_64() + 1);
+    rt_hw_interrupt_enable(level);
+
+    return 0;
+}
+
+static const struct rt_clock_cputime_ops pico_cputime_ops =
+{
+    pico_cputime_getres,
+    pico_cputime_gettime,
+    pico_cputime_settimeout,
+};
+
+int rt_hw_cputime_init(void)
+{
+    hardware_alarm_claim(BSP_CPUTIME_ALARM);
+    hardware_alarm_set_callback(BSP_CPUTIME_ALARM, pico_cputime_alarm_cb);
+    clock_cpu_setops(&pico_cputime_ops);
+
+    return RT_EOK;
+}
+INIT_DEVICE_EXPORT(rt_hw_cputime_init);
+
+#endif /* BSP_USING_CPUTIME */
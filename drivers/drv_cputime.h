@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author         Notes
+ * 2026-10-17     khair          first version
+ */
+
+#ifndef __DRV_CPUTIME_H__
+#define __DRV_CPUTIME_H__
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "board.h"
+
+#ifndef BSP_CPUTIME_ALARM
+#define BSP_CPUTIME_ALARM       1       /* PM has alarm 0, the default alarm pool alarm 3 */
+#endif
+
+int rt_hw_cputime_init(void);
+
+#endif /* __DRV_CPUTIME_H__ */
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author         Notes
+ * 2026-10-17     khair          first version
+ * 2026-10-17     khair          wait for DMA reading flash, count in lost ticks
+ * 2026-10-17     khair          an erase can be put off
+ */
+
+/*
+ * The QSPI flash behind XIP as a FAL flash device, "onchip". Reads go
+ * through the XIP window. Erase and program use hardware_flash, which
+ * runs from RAM, and XIP is off while they run, so interrupts are
+ * disabled on this core for each 4 KB sector erase (about 45 ms) or
+ * 256-byte page program (under 1 ms) and the other core is parked. Long
+ * erases are split per sector, so interrupts come back in between.
+ *
+ * Before interrupts go off, the driver waits for any DMA channel still
+ * reading from flash (a UART TX of a string constant) to finish, since it
+ * would read garbage with XIP off. While they are off:
+ *
+ *   - SysTick runs on, but only one of the ticks that run out is taken
+ *     when they come back; the driver counts the rest in from the
+ *     microsecond timer, so rt_tick_get() does not fall behind. Timers due
+ *     meanwhile fire together at the next tick, up to 45 ms late.
+ *   - UART RX is not serviced. A UART FIFO holds 32 bytes, about 2.8 ms
+ *     at 115200 baud, so what arrives beyond that during an erase is lost.
+ *     pico_flash_erase_begin/end let the application quiet the senders
+ *     first; the modem driver puts an erase off while a request is on.
+ *     Such an erase fails with -RT_EBUSY and is retried by its caller.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <string.h>
+
+#include "drv_flash.h"
+
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/flash.h"
+#include "hardware/regs/addressmap.h"
+#include "hardware/structs/scb.h"
+#include "hardware/structs/systick.h"
+#include "hardware/timer.h"
+
+#ifdef BSP_USING_ON_CHIP_FLASH
+
+#include <fal.h>
+
+#define DBG_TAG "drv.flash"
+#define DBG_LVL DBG_WARNING
+#include <rtdbg.h>
+
+rt_weak void pico_flash_lockout_begin(void)
+{
+}
+
+rt_weak void pico_flash_lockout_end(void)
+{
+}
+
+rt_weak rt_err_t pico_flash_erase_begin(void)
+{
+    return RT_EOK;
+}
+
+rt_weak void pico_flash_erase_end(void)
+{
+}
+
+/* a channel that is still reading through the XIP window */
+static rt_bool_t pico_flash_dma_busy(void)
+{
+    rt_uint32_t addr;
+    uint ch;
+
+    for (ch = 0; ch < NUM_DMA_CHANNELS; ch++)
+    {
+        if (!dma_channel_is_busy(ch))
+            continue;
+        addr = dma_hw->ch[ch].read_addr;
+        if (addr >= XIP_BASE && addr < XIP_SRAM_BASE)
+            return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+/*
+ * Interrupts off with no DMA reading flash. Only this core starts
+ * transfers once the other one is parked, so none can begin after the
+ * check; until then it waits a tick at a time.
+ */
+static rt_base_t pico_flash_quiesce(void)
+{
+    rt_base_t level;
+
+    for (;;)
+    {
+        level = rt_hw_interrupt_disable();
+        if (!pico_flash_dma_busy())
+            return level;
+        rt_hw_interrupt_enable(level);
+        rt_thread_delay(1);
+    }
+}
+
+static rt_uint32_t pico_flash_tick_us(void)
+{
+    return (rt_uint64_t)(mpu_hw->rvr + 1) * 1000000 / clock_get_hz(clk_sys);
+}
+
+/* the time of the last tick SysTick counted, with interrupts off */
+static rt_uint32_t pico_flash_tick_mark(rt_uint32_t tick_us)
+{
+    rt_uint32_t reload = mpu_hw->rvr, us;
+
+    us = (rt_uint64_t)(reload - mpu_hw->cvr) * tick_us / (reload + 1);
+    /* one that ran out already and is waiting is counted as well */
+    if (scb_hw->icsr & M0PLUS_ICSR_PENDSTSET_BITS)
+        us += tick_us;
+
+    return time_us_32() - us;
+}
+
+/* the ticks since the mark, less the one the pending SysTick will count */
+static void pico_flash_tick_catch_up(rt_uint32_t mark, rt_uint32_t tick_us)
+{
+    rt_uint32_t ticks = (time_us_32() - mark) / tick_us;
+
+    if (ticks > 1)
+        rt_tick_set(rt_tick_get() + ticks - 1);
+}
+
+static int pico_flash_init(void)
+{
+    return 0;
+}
+
+static int pico_flash_read(long offset, rt_uint8_t *buf, size_t size)
+{
+    memcpy(buf, (const void *)(XIP_BASE + offset), size);
+
+    return size;
+}
+
+static void pico_flash_program_page(rt_uint32_t offset, const rt_uint8_t *data)
+{
+    rt_uint32_t tick_us = pico_flash_tick_us(), mark;
+    rt_base_t level;
+
+    pico_flash_lockout_begin();
+    level = pico_flash_quiesce();
+    mark = pico_flash_tick_mark(tick_us);
+    flash_range_program(offset, data, FLASH_PAGE_SIZE);
+    pico_flash_tick_catch_up(mark, tick_us);
+    rt_hw_interrupt_enable(level);
+    pico_flash_lockout_end();
+}
+
+/*
+ * Programs whole pages. Bytes of a page outside the request are sent as
+ * 0xff, which leaves them unchanged, so unaligned writes need no read back.
+ * The source must not be in flash.
+ */
+static int pico_flash_write(long offset, const rt_uint8_t *buf, size_t size)
+{
+    rt_uint8_t page[FLASH_PAGE_SIZE];
+    rt_uint32_t addr = offset, start, len;
+    size_t done = 0;
+
+    while (done < size)
+    {
+        start = addr & (FLASH_PAGE_SIZE - 1);
+        len = FLASH_PAGE_SIZE - start;
+        if (len > size - done)
+            len = size - done;
+
+        if (len == FLASH_PAGE_SIZE)
+        {
+            pico_flash_program_page(addr, buf + done);
+        }
+        else
+        {
+            memset(page, 0xff, sizeof(page));
+            memcpy(page + start, buf + done, len);
+            pico_flash_program_page(addr - start, page);
+        }
+        addr += len;
+        done += len;
+    }
+
+    return size;
+}
+
+/* erases every sector the range touches, one at a time */
+static int pico_flash_erase(long offset, size_t size)
+{
+    rt_uint32_t addr = offset & ~(FLASH_SECTOR_SIZE - 1);
+    rt_uint32_t end = RT_ALIGN(offset + size, FLASH_SECTOR_SIZE);
+    rt_uint32_t tick_us = pico_flash_tick_us(), mark;
+    rt_base_t level;
+
+    if (pico_flash_erase_begin() != RT_EOK)
+        return -RT_EBUSY;
+    for (; addr < end; addr += FLASH_SECTOR_SIZE)
+    {
+        pico_flash_lockout_begin();
+        level = pico_flash_quiesce();
+        mark = pico_flash_tick_mark(tick_us);
+        flash_range_erase(addr, FLASH_SECTOR_SIZE);
+        pico_flash_tick_catch_up(mark, tick_us);
+        rt_hw_interrupt_enable(level);
+        pico_flash_lockout_end();
+    }
+    pico_flash_erase_end();
+
+    return size;
+}
+
+const struct fal_flash_dev pico_onchip_flash =
+{
+    .name = "onchip",
+    .addr = XIP_BASE,
+    .len = PICO_FLASH_SIZE_BYTES,
+    .blk_size = FLASH_SECTOR_SIZE,
+    .ops = {pico_flash_init, pico_flash_read, pico_flash_write, pico_flash_erase},
+    .write_gran = 1,
+};
+
+int rt_hw_flash_init(void)
+{
+    return fal_init() > 0 ? RT_EOK : -RT_ERROR;
+}
+INIT_DEVICE_EXPORT(rt_hw_flash_init);
+
+#endif /* BSP_USING_ON_CHIP_FLASH */
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author         Notes
+ * 2026-10-17     khair          first version
+ * 2026-10-17     khair          an erase can be put off
+ */
+
+#ifndef __DRV_FLASH_H__
+#define __DRV_FLASH_H__
+
+#include <rtthread.h>
+
+#include "board.h"
+
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES   (2 * 1024 * 1024)
+#endif
+
+int rt_hw_flash_init(void);
+
+/*
+ * Called around every erase and program with interrupts still enabled.
+ * XIP is unusable while the flash is busy, so whatever runs code from
+ * flash on the other core must be parked in RAM between the two. The
+ * default versions do nothing.
+ */
+void pico_flash_lockout_begin(void);
+void pico_flash_lockout_end(void);
+
+/*
+ * Called once around each erase, from the erasing thread, before the
+ * lockout. Interrupts are off for about 45 ms per sector, longer than a
+ * UART RX FIFO lasts, so a driver that expects input should hold it off
+ * here. When it cannot do so at once, begin returns -RT_EBUSY and the
+ * erase fails with -RT_EBUSY without touching the flash, for the caller to
+ * try again later; end is only called after begin succeeded. The default
+ * versions do nothing.
+ */
+rt_err_t pico_flash_erase_begin(void);
+void pico_flash_erase_end(void);
+
+#endif /* __DRV_FLASH_H__ */
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author         Notes
+ * 2026-10-17     khair          first version
+ */
+
+/*
+ * i2c0 as an RT-Thread I2C bus. Writes that end with a STOP are fed to
+ * IC_DATA_CMD by DMA and the caller sleeps on a completion until the
+ * controller reports STOP_DET (or TX_ABRT), so a 1 KB display refresh
+ * costs no CPU while it is on the wire. Transactions from several threads
+ * queue on the bus lock of the I2C core. Reads and writes without a STOP
+ * are short and use the blocking pico-sdk calls.
+ */
+
+#include "drv_i2c.h"
+
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#ifdef BSP_USING_I2C0
+
+#define DBG_TAG "drv.i2c"
+#define DBG_LVL DBG_WARNING
+#include <rtdbg.h>
+
+struct pico_i2c_bus
+{
+    struct rt_i2c_bus_device parent;
+    i2c_inst_t *inst;
+    rt_uint32_t irqno;
+    int dma_chan;
+    struct rt_completion done;
+    volatile rt_uint32_t abort_source;
+    /* IC_DATA_CMD only takes 16/32-bit writes, so bytes are widened here */
+    rt_uint16_t words[PICO_I2C_DMA_MAX_LEN];
+};
+
+static struct pico_i2c_bus i2c0_bus;
+
+static void pico_i2c0_isr(void)
+{
+    struct pico_i2c_bus *i2c = &i2c0_bus;
+    i2c_hw_t *hw = i2c->inst->hw;
+    rt_uint32_t stat;
+
+    rt_interrupt_enter();
+    stat = hw->intr_stat;
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS)
+    {
+        /* NACK or lost arbitration: the FIFO is flushed, stop feeding it */
+        i2c->abort_source = hw->tx_abrt_source;
+        (void)hw->clr_tx_abrt;
+        dma_channel_abort(i2c->dma_chan);
+    }
+    if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS)
+    {
+        (void)hw->clr_stop_det;
+        hw->intr_mask = 0;
+        rt_completion_done(&i2c->done);
+    }
+    rt_interrupt_leave();
+}
+
+static rt_ssize_t pico_i2c_dma_write(struct pico_i2c_bus *i2c, rt_uint16_t addr,
+                                     const rt_uint8_t *buf, rt_uint16_t len)
+{
+    i2c_hw_t *hw = i2c->inst->hw;
+    rt_int32_t timeout;
+    rt_err_t err;
+    rt_uint16_t i;
+
+    for (i = 0; i < len; i++)
+        i2c->words[i] = buf[i];
+    if (i2c->inst->restart_on_next)
+        i2c->words[0] |= I2C_IC_DATA_CMD_RESTART_BITS;
+    i2c->words[len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    i2c->inst->restart_on_next = false;
+
+    hw->enable = 0;
+    hw->tar = addr;
+    hw->enable = 1;
+
+    i2c->abort_source = 0;
+    rt_completion_init(&i2c->done);
+    (void)hw->clr_intr;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+    dma_channel_transfer_from_buffer_now(i2c->dma_chan, i2c->words, len);
+
+    /* 9 bit times per byte, plus margin for clock stretching */
+    timeout = rt_tick_from_millisecond(10 + len * 9 * 1000 / BSP_I2C0_CLOCK * 2);
+    err = rt_completion_wait(&i2c->done, timeout);
+    hw->intr_mask = 0;
+
+    if (err != RT_EOK)
+    {
+        dma_channel_abort(i2c->dma_chan);
+        LOG_W("write to 0x%02x timed out", addr);
+        return -RT_ETIMEOUT;
+    }
+    if (i2c->abort_source)
+    {
+        LOG_D("write to 0x%02x aborted (0x%08x)", addr, i2c->abort_source);
+        return -RT_EIO;
+    }
+
+    return len;
+}
+
+static rt_ssize_t pico_i2c_master_xfer(struct rt_i2c_bus_device *bus,
+                                       struct rt_i2c_msg msgs[],
+                                       rt_uint32_t num)
+{
+    struct pico_i2c_bus *i2c = (struct pico_i2c_bus *)bus;
+    struct rt_i2c_msg *msg;
+    rt_ssize_t ret;
+    rt_uint32_t i;
+    bool nostop;
+
+    for (i = 0; i < num; i++)
+    {
+        msg = &msgs[i];
+        nostop = (msg->flags & RT_I2C_NO_STOP) != 0;
+
+        if (msg->flags & RT_I2C_ADDR_10BIT)
+            return -RT_EINVAL;
+
+        if (msg->flags & RT_I2C_RD)
+            ret = i2c_read_blocking(i2c->inst, msg->addr, msg->buf, msg->len, nostop);
+        else if (!nostop && msg->len > 0 && msg->len <= PICO_I2C_DMA_MAX_LEN)
+            ret = pico_i2c_dma_write(i2c, msg->addr, msg->buf, msg->len);
+        else
+            ret = i2c_write_blocking(i2c->inst, msg->addr, msg->buf, msg->len, nostop);
+
+        if (ret != msg->len && !(msg->flags & RT_I2C_IGNORE_NACK))
+            return ret < 0 ? -RT_EIO : (rt_ssize_t)i;
+    }
+
+    return num;
+}
+
+static const struct rt_i2c_bus_device_ops pico_i2c_ops =
+{
+    pico_i2c_master_xfer,
+    RT_NULL,
+    RT_NULL,
+};
+
+int rt_hw_i2c_init(void)
+{
+    struct pico_i2c_bus *i2c = &i2c0_bus;
+    dma_channel_config c;
+
+    i2c->inst = i2c0;
+    i2c->irqno = I2C0_IRQ;
+
+    i2c_init(i2c->inst, BSP_I2C0_CLOCK);
+    gpio_set_function(BSP_I2C0_SDA_PIN, GPIO_FUNC_I2C);
+    gpio_set_function(BSP_I2C0_SCL_PIN, GPIO_FUNC_I2C);
+    gpio_pull_up(BSP_I2C0_SDA_PIN);
+    gpio_pull_up(BSP_I2C0_SCL_PIN);
+
+    /* ask for data while a few bytes are still queued, the bus never idles */
+    i2c->inst->hw->dma_tdlr = 4;
+
+    i2c->dma_chan = dma_claim_unused_channel(true);
+    c = dma_channel_get_default_config(i2c->dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, DREQ_I2C0_TX);
+    dma_channel_configure(i2c->dma_chan, &c, &i2c->inst->hw->data_cmd, RT_NULL, 0, false);
+
+    irq_set_exclusive_handler(i2c->irqno, pico_i2c0_isr);
+    irq_set_enabled(i2c->irqno, true);
+
+    i2c->parent.ops = &pico_i2c_ops;
+
+    return rt_i2c_bus_device_register(&i2c->parent, "i2c0");
+}
+INIT_DEVICE_EXPORT(rt_hw_i2c_init);
+
+#endif /* BSP_USING_I2C0 */
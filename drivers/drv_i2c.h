@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author         Notes
+ * 2026-10-17     khair          first version
+ */
+
+#ifndef __DRV_I2C_H__
+#define __DRV_I2C_H__
+
+#include <rtdevice.h>
+#include <rtthread.h>
+
+#include "board.h"
+
+#ifndef BSP_I2C0_SDA_PIN
+#define BSP_I2C0_SDA_PIN        16
+#endif
+#ifndef BSP_I2C0_SCL_PIN
+#define BSP_I2C0_SCL_PIN        17
+#endif
+#ifndef BSP_I2C0_CLOCK
+#define BSP_I2C0_CLOCK          400000
+#endif
+
+/* longest write sent by DMA, one 16-bit IC_DATA_CMD word per byte; a full
+ * 128x64 SSD1306 frame with its window header fits */
+#define PICO_I2C_DMA_MAX_LEN    1040
+
+int rt_hw_i2c_init(void);
+
+#endif /* __DRV_I2C_H__ */
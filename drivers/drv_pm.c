@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author         Notes
+ * 2026-10-17     khair          first version
+ */
+
+/*
+ * Power management for the RT-Thread PM framework. The idle thread hands
+ * the CPU to pm.c, which picks a sleep mode and calls back into the ops
+ * below:
+ *
+ *   IDLE     WFI with the tick running; any interrupt, the tick included,
+ *            wakes the CPU
+ *   LIGHT    tickless WFI: SysTick is stopped and a hardware alarm of the
+ *            always-on microsecond timer is set for the next RT-Thread
+ *            timeout, then the ticks slept through are made up at once
+ *   DEEP     tickless as LIGHT, with SLEEPDEEP set so that while both
+ *            cores sleep the clocks of the blocks left out of
+ *            PICO_PM_SLEEP_EN0/1 are gated
+ *
+ * STANDBY and SHUTDOWN sleep as DEEP. The RP2040's DORMANT state stops
+ * every oscillator, the timer included, and only wakes on a GPIO edge or
+ * the RTC; it would stop the modem UART and the ADC capture that feed the
+ * application between samples, so it is not used.
+ *
+ * The timer runs from clk_ref and keeps counting through every mode here.
+ * The next wakeup is the earliest of the RT-Thread timers and lptimers,
+ * so rt_thread_mdelay() and friends keep their timing in every mode; an
+ * interrupt that wakes the CPU early (a UART byte, the core1 doorbell)
+ * just ends the sleep sooner, and the part of a tick left over is carried
+ * into the next one.
+ */
+
+#include <rthw.h>
+#include <rtdevice.h>
+
+#include "drv_pm.h"
+
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/structs/scb.h"
+#include "hardware/structs/systick.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+#ifdef BSP_USING_PM
+
+/* clocks kept through DEEP: memories, bus, timer, UARTs, ADC, DMA, XIP,
+ * both I2C (sensor bus and display) and what the chip needs to wake up */
+#define PICO_PM_SLEEP_EN0   (CLOCKS_SLEEP_EN0_CLK_SYS_SRAM3_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_SRAM2_BITS | \
+                             CLOCKS_SLEEP_EN0_CLK_SYS_SRAM1_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_SRAM0_BITS | \
+                             CLOCKS_SLEEP_EN0_CLK_SYS_SIO_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_ROSC_BITS | \
+                             CLOCKS_SLEEP_EN0_CLK_SYS_ROM_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_RESETS_BITS | \
+                             CLOCKS_SLEEP_EN0_CLK_SYS_PSM_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_PLL_USB_BITS | \
+                             CLOCKS_SLEEP_EN0_CLK_SYS_PLL_SYS_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_PADS_BITS | \
+                             CLOCKS_SLEEP_EN0_CLK_SYS_VREG_AND_CHIP_RESET_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_IO_BITS | \
+                             CLOCKS_SLEEP_EN0_CLK_SYS_I2C1_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_I2C0_BITS | \
+                             CLOCKS_SLEEP_EN0_CLK_SYS_DMA_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_BUSFABRIC_BITS | \
+                             CLOCKS_SLEEP_EN0_CLK_SYS_BUSCTRL_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_ADC_BITS | \
+                             CLOCKS_SLEEP_EN0_CLK_ADC_ADC_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_CLOCKS_BITS)
+/* gated: SPI0/1, PWM, PIO0/1, JTAG, RTC */
+
+#define PICO_PM_SLEEP_EN1   (CLOCKS_SLEEP_EN1_CLK_SYS_XOSC_BITS | CLOCKS_SLEEP_EN1_CLK_SYS_XIP_BITS | \
+                             CLOCKS_SLEEP_EN1_CLK_SYS_WATCHDOG_BITS | CLOCKS_SLEEP_EN1_CLK_SYS_UART1_BITS | \
+                             CLOCKS_SLEEP_EN1_CLK_PERI_UART1_BITS | CLOCKS_SLEEP_EN1_CLK_SYS_UART0_BITS | \
+                             CLOCKS_SLEEP_EN1_CLK_PERI_UART0_BITS | CLOCKS_SLEEP_EN1_CLK_SYS_TIMER_BITS | \
+                             CLOCKS_SLEEP_EN1_CLK_SYS_SYSCFG_BITS | CLOCKS_SLEEP_EN1_CLK_SYS_SRAM5_BITS | \
+                             CLOCKS_SLEEP_EN1_CLK_SYS_SRAM4_BITS)
+/* gated: USB, TBMAN, SYSINFO */
+
+struct pico_pm
+{
+    rt_uint32_t tick_us;            /* SysTick period */
+    rt_uint64_t start;              /* when the tick stopped, less the part of a tick already run */
+    rt_uint32_t carry;              /* us slept past the last whole tick */
+    rt_bool_t ticking;
+#ifdef BSP_PM_USING_STAT
+    struct pico_pm_stat stat;
+#endif
+};
+
+static struct pico_pm pico_pm;
+
+static void pico_pm_alarm_cb(uint alarm_num)
+{
+    /* only here to wake the CPU; pm.c makes up the ticks */
+}
+
+/* stop SysTick and work out how far into the current tick it was */
+static rt_uint32_t pico_pm_tick_stop(void)
+{
+    rt_uint32_t reload, count, us;
+
+    mpu_hw->csr &= ~M0PLUS_SYST_CSR_ENABLE_BITS;
+    reload = mpu_hw->rvr;
+    count = mpu_hw->cvr;
+    us = (rt_uint64_t)(reload - count) * pico_pm.tick_us / (reload + 1);
+    if (scb_hw->icsr & M0PLUS_ICSR_PENDSTSET_BITS)
+    {
+        /* the tick ran out before it stopped: rt_tick_set() counts it */
+        scb_hw->icsr = M0PLUS_ICSR_PENDSTCLR_BITS;
+        us += pico_pm.tick_us;
+    }
+
+    return us;
+}
+
+static void pico_pm_tick_start(void)
+{
+    *(io_rw_32 *)&mpu_hw->cvr = 0;  /* any write reloads it: a whole tick from now */
+    mpu_hw->csr |= M0PLUS_SYST_CSR_ENABLE_BITS;
+}
+
+static void pico_pm_sleep(struct rt_pm *pm, rt_uint8_t mode)
+{
+    rt_uint32_t sleep_en0, sleep_en1;
+#ifdef BSP_PM_USING_STAT
+    rt_uint64_t t;
+#endif
+
+    if (mode == PM_SLEEP_MODE_NONE)
+        return;
+
+#ifdef BSP_PM_USING_STAT
+    t = time_us_64();
+#endif
+    if (mode == PM_SLEEP_MODE_IDLE || mode == PM_SLEEP_MODE_LIGHT)
+    {
+        __wfi();
+    }
+    else
+    {
+        sleep_en0 = clocks_hw->sleep_en0;
+        sleep_en1 = clocks_hw->sleep_en1;
+        clocks_hw->sleep_en0 = PICO_PM_SLEEP_EN0;
+        clocks_hw->sleep_en1 = PICO_PM_SLEEP_EN1;
+        scb_hw->scr |= M0PLUS_SCR_SLEEPDEEP_BITS;
+
+        __wfi();
+
+        scb_hw->scr &= ~M0PLUS_SCR_SLEEPDEEP_BITS;
+        clocks_hw->sleep_en0 = sleep_en0;
+        clocks_hw->sleep_en1 = sleep_en1;
+    }
+#ifdef BSP_PM_USING_STAT
+    pico_pm.stat.entries[mode]++;
+    pico_pm.stat.time_us[mode] += time_us_64() - t;
+#endif
+}
+
+/* one clock for every run mode: the UART baud dividers and the SysTick
+ * reload are worked out for clk_sys at boot, and changing it would skew
+ * both, so the run modes are accepted and change nothing */
+static void pico_pm_run(struct rt_pm *pm, rt_uint8_t mode)
+{
+}
+
+static void pico_pm_timer_start(struct rt_pm *pm, rt_uint32_t timeout)
+{
+    absolute_time_t target;
+    rt_uint64_t us;
+
+    pico_pm.start = time_us_64() - pico_pm_tick_stop() - pico_pm.carry;
+    pico_pm.carry = 0;
+    pico_pm.ticking = RT_FALSE;
+
+    us = (rt_uint64_t)timeout * pico_pm.tick_us;
+    if (timeout == RT_TICK_MAX || us > PICO_PM_MAX_SLEEP_US)
+        us = PICO_PM_MAX_SLEEP_US;
+    /* the alarm is due from the start of the current tick; if that has
+     * passed already the pending interrupt makes the WFI return at once */
+    update_us_since_boot(&target, pico_pm.start + us);
+    if (hardware_alarm_set_target(BSP_PM_ALARM, target))
+        irq_set_pending(TIMER_IRQ_0 + BSP_PM_ALARM);
+}
+
+static void pico_pm_timer_stop(struct rt_pm *pm)
+{
+    hardware_alarm_cancel(BSP_PM_ALARM);
+    if (!pico_pm.ticking)
+    {
+        pico_pm.ticking = RT_TRUE;
+        pico_pm_tick_start();
+    }
+}
+
+static rt_tick_t pico_pm_timer_get_tick(struct rt_pm *pm)
+{
+    rt_uint64_t us;
+    rt_tick_t ticks;
+
+    us = time_us_64() - pico_pm.start;
+    ticks = us / pico_pm.tick_us;
+    pico_pm.carry = us - (rt_uint64_t)ticks * pico_pm.tick_us;
+#ifdef BSP_PM_USING_STAT
+    if (!(timer_hw->armed & (1u << BSP_PM_ALARM)))
+        pico_pm.stat.timer_wakeups++;
+    pico_pm.stat.ticks_skipped += ticks;
+#endif
+
+    return ticks;
+}
+
+static const struct rt_pm_ops pico_pm_ops =
+{
+    pico_pm_sleep,
+    pico_pm_run,
+    pico_pm_timer_start,
+    pico_pm_timer_stop,
+    pico_pm_timer_get_tick,
+};
+
+/*
+ * pm.c only looks at the lptimers for DEEP, but every delay in this system
+ * is an ordinary rt_timer and the alarm keeps time in DEEP as well as in
+ * LIGHT, so both modes wake for whichever of the two is due first.
+ */
+rt_tick_t pm_timer_next_timeout_tick(rt_uint8_t mode)
+{
+    rt_tick_t now, timer, lptimer;
+
+    switch (mode)
+    {
+    case PM_SLEEP_MODE_LIGHT:
+    case PM_SLEEP_MODE_DEEP:
+    case PM_SLEEP_MODE_STANDBY:
+    case PM_SLEEP_MODE_SHUTDOWN:
+        now = rt_tick_get();
+        timer = rt_timer_next_timeout_tick();
+        lptimer = rt_lptimer_next_timeout_tick();
+        if (timer == RT_TICK_MAX)
+            return lptimer;
+        if (lptimer == RT_TICK_MAX)
+            return timer;
+        return (lptimer - now < timer - now) ? lptimer : timer;
+    }
+
+    return RT_TICK_MAX;
+}
+
+int rt_hw_pm_init(void)
+{
+    struct pico_pm *pm = &pico_pm;
+
+    pm->tick_us = (rt_uint64_t)(mpu_hw->rvr + 1) * 1000000 / clock_get_hz(clk_sys);
+    pm->ticking = RT_TRUE;
+#ifdef BSP_PM_USING_STAT
+    pm->stat.since = time_us_64();
+#endif
+
+    hardware_alarm_claim(BSP_PM_ALARM);
+    hardware_alarm_set_callback(BSP_PM_ALARM, pico_pm_alarm_cb);
+
+    rt_system_pm_init(&pico_pm_ops, (1 << PM_SLEEP_MODE_LIGHT) | (1 << PM_SLEEP_MODE_DEEP) |
+                      (1 << PM_SLEEP_MODE_STANDBY) | (1 << PM_SLEEP_MODE_SHUTDOWN), RT_NULL);
+    /* pm.c starts with NONE requested, which would keep the CPU awake */
+    rt_pm_release(PM_SLEEP_MODE_NONE);
+
+    return RT_EOK;
+}
+INIT_DEVICE_EXPORT(rt_hw_pm_init);
+
+#ifdef BSP_PM_USING_STAT
+const struct pico_pm_stat *pico_pm_get_stat(void)
+{
+    return &pico_pm.stat;
+}
+
+void pico_pm_reset_stat(void)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rt_memset(&pico_pm.stat, 0, sizeof(pico_pm.stat));
+    pico_pm.stat.since = time_us_64();
+    rt_hw_interrupt_enable(level);
+}
+
+#ifdef RT_USING_FINSH
+static void pm_stat_cmd(int argc, char **argv)
+{
+    static const char *const names[PM_SLEEP_MODE_MAX] = {"none", "idle", "light", "deep", "standby", "shutdown"};
+    struct pico_pm_stat s;
+    rt_uint64_t window, asleep = 0;
+    rt_uint32_t wakeups = 0, ms;
+    rt_base_t level;
+    int i;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "reset"))
+    {
+        pico_pm_reset_stat();
+        return;
+    }
+
+    level = rt_hw_interrupt_disable();
+    s = pico_pm.stat;
+    window = time_us_64() - s.since;
+    rt_hw_interrupt_enable(level);
+    if (window < 1000)
+        return;
+
+    for (i = PM_SLEEP_MODE_IDLE; i < PM_SLEEP_MODE_MAX; i++)
+    {
+        wakeups += s.entries[i];
+        asleep += s.time_us[i];
+    }
+    ms = window / 1000;
+    rt_kprintf("window %d.%03d s, tick %d us, %d wakeups/s (%d by the alarm), %d ticks skipped\n",
+               ms / 1000, ms % 1000, pico_pm.tick_us, (rt_uint32_t)((rt_uint64_t)wakeups * 1000 / ms),
+               s.timer_wakeups, s.ticks_skipped);
+    rt_kprintf("  %-8s %10s %8s\n", "mode", "sleeps", "time");
+    rt_kprintf("  %-8s %10s %5d.%d%%\n", "awake", "-",
+               (rt_uint32_t)((window - asleep) * 1000 / window) / 10,
+               (rt_uint32_t)((window - asleep) * 1000 / window) % 10);
+    for (i = PM_SLEEP_MODE_IDLE; i < PM_SLEEP_MODE_MAX; i++)
+    {
+        if (!s.entries[i])
+            continue;
+        rt_kprintf("  %-8s %10d %5d.%d%%\n", names[i], s.entries[i],
+                   (rt_uint32_t)(s.time_us[i] * 1000 / window) / 10,
+                   (rt_uint32_t)(s.time_us[i] * 1000 / window) % 10);
+    }
+}
+MSH_CMD_EXPORT_ALIAS(pm_stat_cmd, pm_stat, show wakeups and time per sleep mode: pm_stat [reset]);
+#endif /* RT_USING_FINSH */
+#endif /* BSP_PM_USING_STAT */
+
+#endif /* BSP_USING_PM */
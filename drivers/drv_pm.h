@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author         Notes
+ * 2026-10-17     khair          first version
+ */
+
+#ifndef __DRV_PM_H__
+#define __DRV_PM_H__
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "board.h"
+
+#ifndef BSP_PM_ALARM
+#define BSP_PM_ALARM            0       /* the default alarm pool has alarm 3 */
+#endif
+
+/* longest single tickless sleep, the timer wakes the CPU at least this often */
+#define PICO_PM_MAX_SLEEP_US    (30u * 60u * 1000000u)
+
+struct pico_pm_stat
+{
+    rt_uint64_t since;                          /* start of the window, us since boot */
+    rt_uint32_t entries[PM_SLEEP_MODE_MAX];     /* sleeps entered in each mode */
+    rt_uint64_t time_us[PM_SLEEP_MODE_MAX];     /* time spent in each mode */
+    rt_uint32_t timer_wakeups;                  /* tickless sleeps ended by the alarm */
+    rt_uint32_t ticks_skipped;                  /* ticks made up after tickless sleeps */
+};
+
+int rt_hw_pm_init(void);
+#ifdef BSP_PM_USING_STAT
+const struct pico_pm_stat *pico_pm_get_stat(void);
+void pico_pm_reset_stat(void);
+#endif
+
+#endif /* __DRV_PM_H__ */
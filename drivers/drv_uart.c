@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-17     khair        uart1: RX FIFO with timeout IRQ, DMA TX
  */
 
 #include <rthw.h>
@@ -15,6 +16,7 @@
 
 #include "hardware/uart.h"
 #include "hardware/irq.h"
+#include "hardware/dma.h"
 
 #define UART_ID uart0
 #define BAUD_RATE 115200
@@ -154,12 +156,14 @@ int rt_hw_uart_init(void)
 }
 // INIT_DEVICE_EXPORT(rt_hw_uart_init);
 
-// We are using pins 0 and 1, but see the GPIO function select table in the
-// datasheet for information on which other pins can be used.
-#define UART1_TX_PIN 11
-#define UART1_RX_PIN 12
+// The SIM800 is wired to pins 8 and 9, see the GPIO function select table in
+// the datasheet for information on which other pins can be used.
+#define UART1_TX_PIN 8
+#define UART1_RX_PIN 9
 #define BAUD_RATE1 9600
 
+#define UART1_RX_BUFSZ 256
+
 static struct pico_uart1_dev uart1_dev;
 
 struct pico_uart1_dev
@@ -167,13 +171,18 @@ struct pico_uart1_dev
     struct rt_serial_device parent;
     rt_uint32_t uart_periph;
     rt_uint32_t irqno;
+    int tx_dma_chan;
 };
 
+/*
+ * The RX FIFO interrupts at half full and on the receive timeout (32 bit
+ * periods without a new byte), so a modem reply costs one or two ISRs
+ * instead of one per byte. rt_hw_serial_isr() drains the whole FIFO.
+ */
 void pico_uart1_isr(void)
 {
     rt_interrupt_enter();
-    /* read interrupt status and clear it */
-    if (uart_is_readable(uart1)) /* rx ind */
+    if (uart_get_hw(uart1)->mis & (UART_UARTMIS_RXMIS_BITS | UART_UARTMIS_RTMIS_BITS))
     {
         rt_hw_serial_isr(&uart1_dev.parent, RT_SERIAL_EVENT_RX_IND);
     }
@@ -181,6 +190,20 @@ void pico_uart1_isr(void)
     rt_interrupt_leave();
 }
 
+/* shared on DMA_IRQ_0, only acts on the TX channel */
+static void pico_uart1_dma_isr(void)
+{
+    rt_uint32_t mask = 1u << uart1_dev.tx_dma_chan;
+
+    if (!(dma_hw->ints0 & mask))
+        return;
+
+    rt_interrupt_enter();
+    dma_hw->ints0 = mask;
+    rt_hw_serial_isr(&uart1_dev.parent, RT_SERIAL_EVENT_TX_DMADONE);
+    rt_interrupt_leave();
+}
+
 /*
  * UART interface
  */
@@ -189,20 +212,45 @@ static rt_err_t pico_uart1_configure(struct rt_serial_device *serial, struct ser
     return RT_EOK;
 }
 
+static void pico_uart1_dma_tx_config(void)
+{
+    dma_channel_config c;
+
+    if (uart1_dev.tx_dma_chan >= 0)
+        return;
+
+    uart1_dev.tx_dma_chan = dma_claim_unused_channel(true);
+
+    c = dma_channel_get_default_config(uart1_dev.tx_dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, DREQ_UART1_TX);
+    dma_channel_configure(uart1_dev.tx_dma_chan, &c, &uart_get_hw(uart1)->dr, RT_NULL, 0, false);
+
+    dma_channel_set_irq0_enabled(uart1_dev.tx_dma_chan, true);
+    irq_add_shared_handler(DMA_IRQ_0, pico_uart1_dma_isr, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
 static rt_err_t pico_uart1_control(struct rt_serial_device *serial, int cmd, void *arg)
 {
     switch (cmd)
     {
     /* enable interrupt */
     case RT_DEVICE_CTRL_SET_INT:
-        // Set up a RX interrupt
-        // We need to set up the handler first
-        // And set up and enable the interrupt handlers
         irq_set_exclusive_handler(UART1_IRQ, pico_uart1_isr);
         irq_set_enabled(UART1_IRQ, true);
 
-        // Now enable the UART to send interrupts - RX only
-        uart_set_irq_enables(uart1, true, false);
+        // RX interrupt at half full (16 bytes) plus the receive timeout
+        hw_write_masked(&uart_get_hw(uart1)->ifls, 2 << UART_UARTIFLS_RXIFLSEL_LSB,
+                        UART_UARTIFLS_RXIFLSEL_BITS);
+        uart_get_hw(uart1)->imsc = UART_UARTIMSC_RXIM_BITS | UART_UARTIMSC_RTIM_BITS;
+        break;
+
+    case RT_DEVICE_CTRL_CONFIG:
+        if ((rt_ubase_t)arg == RT_DEVICE_FLAG_DMA_TX)
+            pico_uart1_dma_tx_config();
         break;
     }
     return RT_EOK;
@@ -222,7 +270,8 @@ static int pico_uart1_getc(struct rt_serial_device *serial)
 
     if (uart_is_readable(uart1))
     {
-        ch = uart_get_hw(uart1)->dr;
+        // the upper bits of DR carry the error flags of the byte
+        ch = uart_get_hw(uart1)->dr & 0xff;
     }
     else
     {
@@ -232,13 +281,24 @@ static int pico_uart1_getc(struct rt_serial_device *serial)
     return ch;
 }
 
+static rt_ssize_t pico_uart1_dma_transmit(struct rt_serial_device *serial, rt_uint8_t *buf, rt_size_t size, int direction)
+{
+    if (direction != RT_SERIAL_DMA_TX)
+        return 0;
+
+    // the serial core keeps `buf` queued until TX_DMADONE
+    dma_channel_transfer_from_buffer_now(uart1_dev.tx_dma_chan, buf, size);
+
+    return size;
+}
+
 const static struct rt_uart_ops _uart1_ops =
 {
     pico_uart1_configure,
     pico_uart1_control,
     pico_uart1_putc,
     pico_uart1_getc,
-    RT_NULL,
+    pico_uart1_dma_transmit,
 };
 
 /*
@@ -268,15 +328,20 @@ int rt_hw_uart1_init(void)
     // Set our data format
     uart_set_format(uart1, DATA_BITS, STOP_BITS, PARITY);
 
-    // Turn off FIFO's - we want to do this character by character
-    uart_set_fifo_enabled(uart1, false);
+    // Keep the FIFOs, RX is drained on the FIFO level and timeout interrupts
+    // and TX is fed by DMA
+    uart_set_fifo_enabled(uart1, true);
 
+    config.baud_rate = BAUD_RATE1;
+    config.bufsz = UART1_RX_BUFSZ;
+
+    uart1_dev.tx_dma_chan = -1;
     uart1_dev.parent.ops = &_uart1_ops;
     uart1_dev.parent.config = config;
 
     ret = rt_hw_serial_register(&uart1_dev.parent,
                                 "uart1",
-                                RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX,
+                                RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX | RT_DEVICE_FLAG_DMA_TX,
                                 &uart1_dev);
 
     return ret;
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef SPSCRING_H__
+#define SPSCRING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rtthread.h>
+
+/*
+ * Single-producer single-consumer byte ring.
+ *
+ * One context writes and one context reads, each may be a thread or an
+ * interrupt, and neither takes a lock: the producer is the only writer of
+ * write_index and the consumer the only writer of read_index. Both indexes
+ * run freely and are masked into the power-of-two buffer, so the ring holds
+ * its whole size and full is write_index - read_index == size.
+ *
+ * The producer fills the space rt_spscring_reserve() hands out in place
+ * and publishes it with rt_spscring_commit(); the consumer works on what
+ * rt_spscring_peek_span() shows and frees it with rt_spscring_consume().
+ * Commit orders the data before the index, peek orders the index before
+ * the data, and consume orders the reads before the space is given back.
+ * rt_spscring_put/get copy on top of the same calls.
+ *
+ * A second producer or consumer needs a lock of its own around its side.
+ */
+struct rt_spscring
+{
+    rt_uint8_t *buffer_ptr;
+    rt_uint32_t mask;                   /* size - 1 */
+    volatile rt_uint32_t write_index;   /* bytes ever committed */
+    volatile rt_uint32_t read_index;    /* bytes ever consumed */
+};
+
+rt_err_t rt_spscring_init(struct rt_spscring *rb, rt_uint8_t *pool, rt_uint32_t size);
+void rt_spscring_reset(struct rt_spscring *rb);
+
+/* producer side */
+rt_size_t rt_spscring_reserve(struct rt_spscring *rb, rt_uint8_t **ptr, rt_size_t length);
+void rt_spscring_commit(struct rt_spscring *rb, rt_size_t length);
+rt_size_t rt_spscring_put(struct rt_spscring *rb, const rt_uint8_t *ptr, rt_size_t length);
+
+/* consumer side */
+rt_size_t rt_spscring_peek_span(struct rt_spscring *rb, rt_uint8_t **ptr);
+void rt_spscring_consume(struct rt_spscring *rb, rt_size_t length);
+rt_size_t rt_spscring_get(struct rt_spscring *rb, rt_uint8_t *ptr, rt_size_t length);
+
+/** return the size of data in the ring, exact on the consumer side */
+rt_inline rt_size_t rt_spscring_data_len(struct rt_spscring *rb)
+{
+    return rb->write_index - rb->read_index;
+}
+
+/** return the free space in the ring, exact on the producer side */
+rt_inline rt_size_t rt_spscring_space_len(struct rt_spscring *rb)
+{
+    return rb->mask + 1 - (rb->write_index - rb->read_index);
+}
+
+/** return the size of the ring in bytes */
+rt_inline rt_size_t rt_spscring_get_size(struct rt_spscring *rb)
+{
+    RT_ASSERT(rb != RT_NULL);
+    return rb->mask + 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
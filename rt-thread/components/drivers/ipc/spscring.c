@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+
+#include <rtthread.h>
+#include <rthw.h>
+#include <rtdevice.h>
+#include <string.h>
+
+/*
+ * Orders the buffer against the indexes, for the other side on this core
+ * (an interrupt) as well as on another one. rt_hw_dmb() is only real with
+ * RT_USING_CACHE, so the compilers' own barrier is used where there is one.
+ */
+#if defined(__GNUC__)
+#define SPSCRING_BARRIER()      __sync_synchronize()
+#elif defined(__CC_ARM)
+#define SPSCRING_BARRIER()      __dmb(0xf)
+#else
+#define SPSCRING_BARRIER()      rt_hw_dmb()
+#endif
+
+/**
+ * @brief Initialize the ring.
+ *
+ * @param rb        A pointer to the ring object.
+ * @param pool      A pointer to the buffer.
+ * @param size      The size of the buffer in bytes, a power of two.
+ *
+ * @return Return RT_EOK, or -RT_EINVAL when the size is not a power of two.
+ */
+rt_err_t rt_spscring_init(struct rt_spscring *rb, rt_uint8_t *pool, rt_uint32_t size)
+{
+    RT_ASSERT(rb != RT_NULL);
+
+    if (size == 0 || (size & (size - 1)) || size > 0x80000000UL)
+        return -RT_EINVAL;
+
+    rb->buffer_ptr = pool;
+    rb->mask = size - 1;
+    rb->write_index = rb->read_index = 0;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_spscring_init);
+
+/**
+ * @brief Empty the ring. Neither side may be using it meanwhile.
+ *
+ * @param rb        A pointer to the ring object.
+ */
+void rt_spscring_reset(struct rt_spscring *rb)
+{
+    RT_ASSERT(rb != RT_NULL);
+
+    rb->write_index = rb->read_index = 0;
+}
+RTM_EXPORT(rt_spscring_reset);
+
+/**
+ * @brief Get free space to fill in place. Producer side.
+ *
+ * The space is contiguous, so it may be less than the ring has free when
+ * that wraps round the end of the buffer; a second call after the commit
+ * gets the rest. Nothing is visible to the consumer before the commit.
+ *
+ * @param rb        A pointer to the ring object.
+ * @param ptr       Set to the start of the space, RT_NULL when there is none.
+ * @param length    The most space wanted in bytes.
+ *
+ * @return Return the bytes of space at *ptr, at most length.
+ */
+rt_size_t rt_spscring_reserve(struct rt_spscring *rb, rt_uint8_t **ptr, rt_size_t length)
+{
+    rt_uint32_t write_index, offset;
+    rt_size_t size;
+
+    RT_ASSERT(rb != RT_NULL);
+
+    write_index = rb->write_index;
+    size = rb->mask + 1 - (write_index - rb->read_index);
+    /* the consumer is done with the space before it is written again */
+    SPSCRING_BARRIER();
+
+    offset = write_index & rb->mask;
+    if (size > rb->mask + 1 - offset)
+        size = rb->mask + 1 - offset;
+    if (size > length)
+        size = length;
+
+    *ptr = size ? &rb->buffer_ptr[offset] : RT_NULL;
+
+    return size;
+}
+RTM_EXPORT(rt_spscring_reserve);
+
+/**
+ * @brief Publish filled space to the consumer. Producer side.
+ *
+ * @param rb        A pointer to the ring object.
+ * @param length    The bytes filled, at most what rt_spscring_reserve() gave.
+ */
+void rt_spscring_commit(struct rt_spscring *rb, rt_size_t length)
+{
+    RT_ASSERT(rb != RT_NULL);
+    RT_ASSERT(length <= rt_spscring_space_len(rb));
+
+    /* the data before the index that shows it */
+    SPSCRING_BARRIER();
+    rb->write_index += length;
+}
+RTM_EXPORT(rt_spscring_commit);
+
+/**
+ * @brief Get the data to work on in place. Consumer side.
+ *
+ * The data is contiguous, so it may be less than the ring holds when that
+ * wraps round the end of the buffer; a second call after the consume gets
+ * the rest.
+ *
+ * @param rb        A pointer to the ring object.
+ * @param ptr       Set to the start of the data, RT_NULL when there is none.
+ *
+ * @return Return the bytes of data at *ptr.
+ */
+rt_size_t rt_spscring_peek_span(struct rt_spscring *rb, rt_uint8_t **ptr)
+{
+    rt_uint32_t read_index, offset;
+    rt_size_t size;
+
+    RT_ASSERT(rb != RT_NULL);
+
+    read_index = rb->read_index;
+    size = rb->write_index - read_index;
+    /* the index before the data it shows */
+    SPSCRING_BARRIER();
+
+    offset = read_index & rb->mask;
+    if (size > rb->mask + 1 - offset)
+        size = rb->mask + 1 - offset;
+
+    *ptr = size ? &rb->buffer_ptr[offset] : RT_NULL;
+
+    return size;
+}
+RTM_EXPORT(rt_spscring_peek_span);
+
+/**
+ * @brief Give data back to the producer as free space. Consumer side.
+ *
+ * @param rb        A pointer to the ring object.
+ * @param length    The bytes done with, at most what is in the ring.
+ */
+void rt_spscring_consume(struct rt_spscring *rb, rt_size_t length)
+{
+    RT_ASSERT(rb != RT_NULL);
+    RT_ASSERT(length <= rt_spscring_data_len(rb));
+
+    /* the data read before the space is written again */
+    SPSCRING_BARRIER();
+    rb->read_index += length;
+}
+RTM_EXPORT(rt_spscring_consume);
+
+/**
+ * @brief Copy data into the ring. Producer side. If the free space is
+ *        insufficient, it puts what fits.
+ *
+ * @param rb        A pointer to the ring object.
+ * @param ptr       A pointer to the data.
+ * @param length    The size of the data in bytes.
+ *
+ * @return Return the bytes put into the ring.
+ */
+rt_size_t rt_spscring_put(struct rt_spscring *rb, const rt_uint8_t *ptr, rt_size_t length)
+{
+    rt_uint8_t *span;
+    rt_size_t size, done = 0;
+
+    /* at most twice, the second time from the start of the buffer */
+    while (done < length && (size = rt_spscring_reserve(rb, &span, length - done)) > 0)
+    {
+        memcpy(span, ptr + done, size);
+        rt_spscring_commit(rb, size);
+        done += size;
+    }
+
+    return done;
+}
+RTM_EXPORT(rt_spscring_put);
+
+/**
+ * @brief Copy data out of the ring. Consumer side.
+ *
+ * @param rb        A pointer to the ring object.
+ * @param ptr       A pointer to the buffer for the data.
+ * @param length    The size of the buffer in bytes.
+ *
+ * @return Return the bytes taken from the ring.
+ */
+rt_size_t rt_spscring_get(struct rt_spscring *rb, rt_uint8_t *ptr, rt_size_t length)
+{
+    rt_uint8_t *span;
+    rt_size_t size, done = 0;
+
+    while (done < length && (size = rt_spscring_peek_span(rb, &span)) > 0)
+    {
+        if (size > length - done)
+            size = length - done;
+        memcpy(ptr + done, span, size);
+        rt_spscring_consume(rb, size);
+        done += size;
+    }
+
+    return done;
+}
+RTM_EXPORT(rt_spscring_get);
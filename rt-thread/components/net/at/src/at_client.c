@@ -10,6 +10,7 @@
  * 2018-08-17     chenyong     multiple client support
  * 2021-03-17     Meco Man     fix a buf of leaking memory
  * 2021-07-14     Sszl         fix a buf of leaking memory
+ * 2026-10-17     khair        open the device in DMA TX mode when supported
  */
 
 #include <at.h>
@@ -931,6 +932,7 @@ int at_client_init(const char *dev_name,  rt_size_t recv_bufsz)
     int idx = 0;
     int result = RT_EOK;
     rt_err_t open_result = RT_EOK;
+    rt_uint16_t tx_flag = 0;
     at_client_t client = RT_NULL;
 
     RT_ASSERT(dev_name);
@@ -965,12 +967,15 @@ int at_client_init(const char *dev_name,  rt_size_t recv_bufsz)
     {
         RT_ASSERT(client->device->type == RT_Device_Class_Char);
 
+        /* send by DMA when the device supports it */
+        tx_flag = client->device->flag & RT_DEVICE_FLAG_DMA_TX;
+
         /* using DMA mode first */
-        open_result = rt_device_open(client->device, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_DMA_RX);
+        open_result = rt_device_open(client->device, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_DMA_RX | tx_flag);
         /* using interrupt mode when DMA mode not supported */
         if (open_result == -RT_EIO)
         {
-            open_result = rt_device_open(client->device, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX);
+            open_result = rt_device_open(client->device, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX | tx_flag);
         }
         RT_ASSERT(open_result == RT_EOK);
 
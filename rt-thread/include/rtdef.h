@@ -1022,6 +1022,10 @@ typedef rt_mem_t rt_smem_t;
 typedef rt_mem_t rt_slab_t;
 #endif /* RT_USING_SLAB */
 
+#ifdef RT_USING_TLSF
+typedef rt_mem_t rt_tlsf_t;
+#endif /* RT_USING_TLSF */
+
 #ifdef RT_USING_MEMHEAP
 /**
  * memory item on the heap
@@ -339,6 +339,17 @@ void *rt_slab_realloc(rt_slab_t m, void *ptr, rt_size_t size);
 void rt_slab_free(rt_slab_t m, void *ptr);
 #endif
 
+#ifdef RT_USING_TLSF
+/**
+ * tlsf object interface
+ */
+rt_tlsf_t rt_tlsf_init(const char *name, void *begin_addr, rt_size_t size);
+rt_err_t rt_tlsf_detach(rt_tlsf_t m);
+void *rt_tlsf_alloc(rt_tlsf_t m, rt_size_t size);
+void *rt_tlsf_realloc(rt_tlsf_t m, void *rmem, rt_size_t newsize);
+void rt_tlsf_free(rt_tlsf_t m, void *rmem);
+#endif
+
 /**@}*/
 
 /**
@@ -12,6 +12,7 @@
  * 2010-10-14     Bernard      fix rt_realloc issue when realloc a NULL pointer.
  * 2017-07-14     armink       fix rt_realloc issue when new size is 0
  * 2018-10-02     Bernard      Add 64bit support
+ * 2026-10-17     khair        skip the other algorithms in memcheck/memtrace
  */
 
 /*
@@ -560,7 +561,7 @@ RTM_EXPORT(rt_smem_free);
 #ifdef RT_USING_FINSH
 #include <finsh.h>
 
-#ifdef RT_USING_MEMTRACE
+#if defined(RT_USING_MEMTRACE) && !defined(RT_USING_TLSF_AS_HEAP)
 int memcheck(int argc, char *argv[])
 {
     int position;
@@ -584,6 +585,9 @@ int memcheck(int argc, char *argv[])
         /* find the specified object */
         if (name != RT_NULL && rt_strncmp(name, object->name, RT_NAME_MAX) != 0)
             continue;
+        /* the slab and tlsf objects are of the same class */
+        if (rt_strcmp(((rt_mem_t)object)->algorithm, "small") != 0)
+            continue;
         /* mem object */
         m = (struct rt_small_mem *)object;
         /* check mem */
@@ -630,6 +634,9 @@ int memtrace(int argc, char **argv)
         /* find the specified object */
         if (name != RT_NULL && rt_strncmp(name, object->name, RT_NAME_MAX) != 0)
             continue;
+        /* the slab and tlsf objects are of the same class */
+        if (rt_strcmp(((rt_mem_t)object)->algorithm, "small") != 0)
+            continue;
         /* mem object */
         m = (struct rt_small_mem *)object;
         /* show memory information */
@@ -664,7 +671,7 @@ int memtrace(int argc, char **argv)
     return 0;
 }
 MSH_CMD_EXPORT(memtrace, dump memory trace information);
-#endif /* RT_USING_MEMTRACE */
+#endif /* RT_USING_MEMTRACE && !RT_USING_TLSF_AS_HEAP */
 #endif /* RT_USING_FINSH */
 
 #endif /* defined (RT_USING_SMALL_MEM) */
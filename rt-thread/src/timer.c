@@ -19,13 +19,49 @@
  * 2021-08-15     supperthomas add the comment
  * 2022-01-07     Gabriel      Moving __on_rt_xxxxx_hook to timer.c
  * 2022-04-19     Stanley      Correct descriptions
+ * 2026-10-17     khair        add the hierarchical timing wheel
  */
 
 #include <rtthread.h>
 #include <rthw.h>
 
+#ifdef RT_TIMER_USING_WHEEL
+/*
+ * Hierarchical timing wheel: RT_TIMER_WHEEL_LEVELS levels of 32 slots.
+ * Level 0 holds the timers due in the next 32 ticks, one slot per tick;
+ * each slot of level n covers 32^n ticks and is cascaded down into the
+ * levels below when the wheel reaches it. Starting and stopping a timer
+ * is O(1), and rt_timer_check() only visits the ticks that have a timer
+ * or a cascade of a slot that holds one: the bitmaps of all levels give
+ * the next such tick, so after the tick jumps ahead (tickless idle) it
+ * catches up in one step per occupied slot on the way. Timers due in the
+ * same tick expire in the order they reached level 0, which is not always
+ * the order they were started in.
+ */
+#define RT_TIMER_WHEEL_BITS             5       /* slots per level: a 32-bit bitmap */
+#define RT_TIMER_WHEEL_SLOTS            (1UL << RT_TIMER_WHEEL_BITS)
+#define RT_TIMER_WHEEL_MASK             (RT_TIMER_WHEEL_SLOTS - 1)
+#define RT_TIMER_WHEEL_LEVELS           4
+/* timers due further out than this are parked in the last slot within
+ * reach and placed again from there */
+#define RT_TIMER_WHEEL_SPAN             (1UL << (RT_TIMER_WHEEL_BITS * RT_TIMER_WHEEL_LEVELS))
+
+struct _timer_wheel
+{
+    rt_tick_t now;                                  /* next tick to expire */
+    rt_uint32_t pending[RT_TIMER_WHEEL_LEVELS];     /* slots that may hold a timer */
+    rt_list_t slot[RT_TIMER_WHEEL_LEVELS][RT_TIMER_WHEEL_SLOTS];
+};
+
+typedef struct _timer_wheel _timer_list_t;
+#define _TIMER_LIST_SIZE                1
+#else
+typedef rt_list_t _timer_list_t;
+#define _TIMER_LIST_SIZE                RT_TIMER_SKIP_LIST_LEVEL
+#endif /* RT_TIMER_USING_WHEEL */
+
 /* hard timer list */
-static rt_list_t _timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+static _timer_list_t _timer_list[_TIMER_LIST_SIZE];
 
 #ifdef RT_USING_TIMER_SOFT
 
@@ -43,7 +79,7 @@ static rt_list_t _timer_list[RT_TIMER_SKIP_LIST_LEVEL];
 /* soft timer status */
 static rt_uint8_t _soft_timer_status = RT_SOFT_TIMER_IDLE;
 /* soft timer list */
-static rt_list_t _soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+static _timer_list_t _soft_timer_list[_TIMER_LIST_SIZE];
 static struct rt_thread _timer_thread;
 rt_align(RT_ALIGN_SIZE)
 static rt_uint8_t _timer_thread_stack[RT_TIMER_THREAD_STACK_SIZE];
@@ -144,6 +180,375 @@ static void _timer_init(rt_timer_t timer,
     }
 }
 
+#ifdef RT_TIMER_USING_WHEEL
+/**
+ * @brief [internal] Rotate a slot bitmap so that slot n comes first
+ */
+rt_inline rt_uint32_t _timer_wheel_rotate(rt_uint32_t bits, rt_uint32_t n)
+{
+    n &= RT_TIMER_WHEEL_MASK;
+    return n ? (bits >> n) | (bits << (RT_TIMER_WHEEL_SLOTS - n)) : bits;
+}
+
+/**
+ * @brief [internal] Put a timer in the slot for its timeout tick
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param timer is the timer, not in any list
+ */
+static void _timer_wheel_put(struct _timer_wheel *wheel, rt_timer_t timer)
+{
+    rt_tick_t delta;
+    rt_uint32_t index;
+    int level;
+
+    delta = timer->timeout_tick - wheel->now;
+    if (delta >= RT_TICK_MAX / 2)
+    {
+        /* due already: expire with the next tick checked */
+        delta = 0;
+    }
+    else if (delta >= RT_TIMER_WHEEL_SPAN)
+    {
+        delta = RT_TIMER_WHEEL_SPAN - 1;
+    }
+
+    /* the lowest level whose slots reach that far; a slot of level n is
+     * cascaded at the start of its span, after now and before the timeout */
+    for (level = 0; delta >= (1UL << (RT_TIMER_WHEEL_BITS * (level + 1))); level++);
+    index = ((wheel->now + delta) >> (RT_TIMER_WHEEL_BITS * level)) & RT_TIMER_WHEEL_MASK;
+
+    rt_list_insert_before(&wheel->slot[level][index], &timer->row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+    wheel->pending[level] |= 1UL << index;
+}
+
+/**
+ * @brief [internal] Move the slots of the upper levels that start at the
+ *        current tick down to the levels below
+ *
+ * @param wheel is the timer wheel, with now at a multiple of 32 ticks
+ */
+static void _timer_wheel_cascade(struct _timer_wheel *wheel)
+{
+    struct rt_timer *t;
+    rt_list_t *slot;
+    rt_uint32_t index;
+    int level;
+
+    for (level = 1; level < RT_TIMER_WHEEL_LEVELS; level++)
+    {
+        index = (wheel->now >> (RT_TIMER_WHEEL_BITS * level)) & RT_TIMER_WHEEL_MASK;
+        slot = &wheel->slot[level][index];
+        wheel->pending[level] &= ~(1UL << index);
+
+        /* every timer lands in a lower level or a later slot */
+        while (!rt_list_isempty(slot))
+        {
+            t = rt_list_entry(slot->next, struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+            rt_list_remove(&t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+            _timer_wheel_put(wheel, t);
+        }
+
+        /* the next level turns only when this one wraps */
+        if (index != 0)
+            break;
+    }
+}
+
+/**
+ * @brief [internal] Ticks from now to the next level 0 slot that may hold a
+ *        timer, or to the next cascade of an upper slot that may, whichever
+ *        comes first; nothing happens in between
+ *
+ * @param wheel is the timer wheel, with the slot of now already cleared
+ *
+ * @return the distance, or RT_TIMER_WHEEL_SPAN if no slot may hold a timer
+ */
+static rt_tick_t _timer_wheel_skip(struct _timer_wheel *wheel)
+{
+    rt_uint32_t base, pending, shift;
+    rt_tick_t tick, skip = RT_TIMER_WHEEL_SPAN;
+    int level;
+
+    for (level = 0; level < RT_TIMER_WHEEL_LEVELS; level++)
+    {
+        /* as in _timer_list_next_timeout(): upper slots from the one after now */
+        shift = RT_TIMER_WHEEL_BITS * level;
+        base = (wheel->now >> shift) + (level ? 1 : 0);
+        pending = _timer_wheel_rotate(wheel->pending[level], base);
+        if (pending == 0)
+            continue;
+
+        /* a slot of level n is cascaded at the first tick of its span */
+        tick = (rt_tick_t)(base + __rt_ffs(pending) - 1) << shift;
+        if (tick - wheel->now < skip)
+            skip = tick - wheel->now;
+    }
+
+    return skip;
+}
+
+/**
+ * @brief [internal] Initialize a timer wheel
+ *
+ * @param timer_list is the timer wheel
+ */
+static void _timer_list_init(_timer_list_t timer_list[])
+{
+    int level, i;
+
+    timer_list->now = rt_tick_get();
+    for (level = 0; level < RT_TIMER_WHEEL_LEVELS; level++)
+    {
+        timer_list->pending[level] = 0;
+        for (i = 0; i < RT_TIMER_WHEEL_SLOTS; i++)
+        {
+            rt_list_init(&timer_list->slot[level][i]);
+        }
+    }
+}
+
+/**
+ * @brief [internal] Insert a timer, O(1)
+ *
+ * @param timer_list is the timer wheel
+ *
+ * @param timer is the timer, with its timeout tick set
+ */
+rt_inline void _timer_list_insert(_timer_list_t timer_list[], rt_timer_t timer)
+{
+    _timer_wheel_put(timer_list, timer);
+}
+
+/**
+ * @brief [internal] Find the first expired timer, turning the wheel up to
+ *        current_tick; each pass goes straight to the next slot or cascade
+ *        that may hold a timer, so catching up after a long tickless sleep
+ *        takes one pass per such slot, not one per 32 ticks
+ *
+ * @param timer_list is the timer wheel
+ *
+ * @param current_tick is the current tick
+ *
+ * @return the first expired timer, still in its slot, or RT_NULL
+ */
+static rt_timer_t _timer_list_expired(_timer_list_t timer_list[], rt_tick_t current_tick)
+{
+    struct _timer_wheel *wheel = timer_list;
+    rt_uint32_t index;
+    rt_tick_t next;
+
+    while ((current_tick - wheel->now) < RT_TICK_MAX / 2)
+    {
+        index = wheel->now & RT_TIMER_WHEEL_MASK;
+        if (!rt_list_isempty(&wheel->slot[0][index]))
+        {
+            return rt_list_entry(wheel->slot[0][index].next,
+                                 struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+        }
+        wheel->pending[0] &= ~(1UL << index);
+
+        /* the cascades skipped on the way have empty slots; the one at
+         * next, if next is on a 32-tick boundary, is done here */
+        next = wheel->now + _timer_wheel_skip(wheel);
+        if ((current_tick - next) >= RT_TICK_MAX / 2)
+            next = current_tick + 1;
+
+        wheel->now = next;
+        if ((next & RT_TIMER_WHEEL_MASK) == 0)
+            _timer_wheel_cascade(wheel);
+    }
+
+    return RT_NULL;
+}
+
+/**
+ * @brief  Find the next emtpy timer ticks
+ *
+ * @param timer_list is the timer wheel
+ *
+ * @param timeout_tick is the next timer's ticks
+ *
+ * @return  Return the operation status. If the return value is RT_EOK, the function is successfully executed.
+ *          If the return value is any other values, it means this operation failed.
+ */
+static rt_err_t _timer_list_next_timeout(_timer_list_t timer_list[], rt_tick_t *timeout_tick)
+{
+    struct _timer_wheel *wheel = timer_list;
+    struct rt_timer *t;
+    rt_list_t *node, *slot;
+    rt_uint32_t base, pending, k;
+    rt_tick_t tick, next = 0;
+    rt_bool_t found = RT_FALSE;
+    rt_base_t level;
+    int lvl;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    /* the first occupied slot of each level: exact on level 0, the earliest
+     * timer in that one slot above it; the earliest of those is next */
+    for (lvl = 0; lvl < RT_TIMER_WHEEL_LEVELS; lvl++)
+    {
+        /* level 0 starts at the slot of now, the others one after it */
+        base = (wheel->now >> (RT_TIMER_WHEEL_BITS * lvl)) + (lvl ? 1 : 0);
+        pending = _timer_wheel_rotate(wheel->pending[lvl], base);
+
+        while (pending)
+        {
+            k = __rt_ffs(pending) - 1;
+            pending &= ~(1UL << k);
+            slot = &wheel->slot[lvl][(base + k) & RT_TIMER_WHEEL_MASK];
+            if (rt_list_isempty(slot))
+            {
+                wheel->pending[lvl] &= ~(1UL << ((base + k) & RT_TIMER_WHEEL_MASK));
+                continue;
+            }
+
+            if (lvl == 0)
+            {
+                tick = wheel->now + k;
+            }
+            else
+            {
+                t = rt_list_entry(slot->next, struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+                tick = t->timeout_tick;
+                for (node = slot->next->next; node != slot; node = node->next)
+                {
+                    t = rt_list_entry(node, struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+                    if ((t->timeout_tick - wheel->now) < (tick - wheel->now))
+                        tick = t->timeout_tick;
+                }
+            }
+
+            if (!found || (tick - wheel->now) < (next - wheel->now))
+                next = tick;
+            found = RT_TRUE;
+            break;
+        }
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    if (!found)
+        return -RT_ERROR;
+
+    *timeout_tick = next;
+    return RT_EOK;
+}
+#else
+/**
+ * @brief [internal] Initialize a timer list
+ *
+ * @param timer_list is the array of time list
+ */
+static void _timer_list_init(_timer_list_t timer_list[])
+{
+    int i;
+
+    for (i = 0; i < RT_TIMER_SKIP_LIST_LEVEL; i++)
+    {
+        rt_list_init(timer_list + i);
+    }
+}
+
+/**
+ * @brief [internal] Insert a timer in timeout order
+ *
+ * @param timer_list is the array of time list
+ *
+ * @param timer is the timer, with its timeout tick set
+ */
+static void _timer_list_insert(_timer_list_t timer_list[], rt_timer_t timer)
+{
+    unsigned int row_lvl;
+    rt_list_t *row_head[RT_TIMER_SKIP_LIST_LEVEL];
+    unsigned int tst_nr;
+    static unsigned int random_nr;
+
+    row_head[0]  = &timer_list[0];
+    for (row_lvl = 0; row_lvl < RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
+    {
+        for (; row_head[row_lvl] != timer_list[row_lvl].prev;
+             row_head[row_lvl]  = row_head[row_lvl]->next)
+        {
+            struct rt_timer *t;
+            rt_list_t *p = row_head[row_lvl]->next;
+
+            /* fix up the entry pointer */
+            t = rt_list_entry(p, struct rt_timer, row[row_lvl]);
+
+            /* If we have two timers that timeout at the same time, it's
+             * preferred that the timer inserted early get called early.
+             * So insert the new timer to the end the the some-timeout timer
+             * list.
+             */
+            if ((t->timeout_tick - timer->timeout_tick) == 0)
+            {
+                continue;
+            }
+            else if ((t->timeout_tick - timer->timeout_tick) < RT_TICK_MAX / 2)
+            {
+                break;
+            }
+        }
+        if (row_lvl != RT_TIMER_SKIP_LIST_LEVEL - 1)
+            row_head[row_lvl + 1] = row_head[row_lvl] + 1;
+    }
+
+    /* Interestingly, this super simple timer insert counter works very very
+     * well on distributing the list height uniformly. By means of "very very
+     * well", I mean it beats the randomness of timer->timeout_tick very easily
+     * (actually, the timeout_tick is not random and easy to be attacked). */
+    random_nr++;
+    tst_nr = random_nr;
+
+    rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL - 1],
+                         &(timer->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+    for (row_lvl = 2; row_lvl <= RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
+    {
+        if (!(tst_nr & RT_TIMER_SKIP_LIST_MASK))
+            rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL - row_lvl],
+                                 &(timer->row[RT_TIMER_SKIP_LIST_LEVEL - row_lvl]));
+        else
+            break;
+        /* Shift over the bits we have tested. Works well with 1 bit and 2
+         * bits. */
+        tst_nr >>= (RT_TIMER_SKIP_LIST_MASK + 1) >> 1;
+    }
+}
+
+/**
+ * @brief [internal] Find the first expired timer
+ *
+ * @param timer_list is the array of time list
+ *
+ * @param current_tick is the current tick
+ *
+ * @return the first expired timer, still in the list, or RT_NULL
+ */
+static rt_timer_t _timer_list_expired(_timer_list_t timer_list[], rt_tick_t current_tick)
+{
+    struct rt_timer *t;
+
+    if (rt_list_isempty(&timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+        return RT_NULL;
+
+    t = rt_list_entry(timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
+                      struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+
+    /*
+     * It supposes that the new tick shall less than the half duration of
+     * tick max.
+     */
+    if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
+        return t;
+
+    return RT_NULL;
+}
+
 /**
  * @brief  Find the next emtpy timer ticks
  *
@@ -154,7 +559,7 @@ static void _timer_init(rt_timer_t timer,
  * @return  Return the operation status. If the return value is RT_EOK, the function is successfully executed.
  *          If the return value is any other values, it means this operation failed.
  */
-static rt_err_t _timer_list_next_timeout(rt_list_t timer_list[], rt_tick_t *timeout_tick)
+static rt_err_t _timer_list_next_timeout(_timer_list_t timer_list[], rt_tick_t *timeout_tick)
 {
     struct rt_timer *timer;
     rt_base_t level;
@@ -179,6 +584,7 @@ static rt_err_t _timer_list_next_timeout(rt_list_t timer_list[], rt_tick_t *time
 
     return -RT_ERROR;
 }
+#endif /* RT_TIMER_USING_WHEEL */
 
 /**
  * @brief Remove the timer
@@ -406,13 +812,9 @@ RTM_EXPORT(rt_timer_delete);
  */
 rt_err_t rt_timer_start(rt_timer_t timer)
 {
-    unsigned int row_lvl;
-    rt_list_t *timer_list;
+    _timer_list_t *timer_list;
     rt_base_t level;
     rt_bool_t need_schedule;
-    rt_list_t *row_head[RT_TIMER_SKIP_LIST_LEVEL];
-    unsigned int tst_nr;
-    static unsigned int random_nr;
 
     /* parameter check */
     RT_ASSERT(timer != RT_NULL);
@@ -444,56 +846,7 @@ rt_err_t rt_timer_start(rt_timer_t timer)
         timer_list = _timer_list;
     }
 
-    row_head[0]  = &timer_list[0];
-    for (row_lvl = 0; row_lvl < RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
-    {
-        for (; row_head[row_lvl] != timer_list[row_lvl].prev;
-             row_head[row_lvl]  = row_head[row_lvl]->next)
-        {
-            struct rt_timer *t;
-            rt_list_t *p = row_head[row_lvl]->next;
-
-            /* fix up the entry pointer */
-            t = rt_list_entry(p, struct rt_timer, row[row_lvl]);
-
-            /* If we have two timers that timeout at the same time, it's
-             * preferred that the timer inserted early get called early.
-             * So insert the new timer to the end the the some-timeout timer
-             * list.
-             */
-            if ((t->timeout_tick - timer->timeout_tick) == 0)
-            {
-                continue;
-            }
-            else if ((t->timeout_tick - timer->timeout_tick) < RT_TICK_MAX / 2)
-            {
-                break;
-            }
-        }
-        if (row_lvl != RT_TIMER_SKIP_LIST_LEVEL - 1)
-            row_head[row_lvl + 1] = row_head[row_lvl] + 1;
-    }
-
-    /* Interestingly, this super simple timer insert counter works very very
-     * well on distributing the list height uniformly. By means of "very very
-     * well", I mean it beats the randomness of timer->timeout_tick very easily
-     * (actually, the timeout_tick is not random and easy to be attacked). */
-    random_nr++;
-    tst_nr = random_nr;
-
-    rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL - 1],
-                         &(timer->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-    for (row_lvl = 2; row_lvl <= RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
-    {
-        if (!(tst_nr & RT_TIMER_SKIP_LIST_MASK))
-            rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL - row_lvl],
-                                 &(timer->row[RT_TIMER_SKIP_LIST_LEVEL - row_lvl]));
-        else
-            break;
-        /* Shift over the bits we have tested. Works well with 1 bit and 2
-         * bits. */
-        tst_nr >>= (RT_TIMER_SKIP_LIST_MASK + 1) >> 1;
-    }
+    _timer_list_insert(timer_list, timer);
 
     timer->parent.flag |= RT_TIMER_FLAG_ACTIVATED;
 
@@ -660,51 +1013,40 @@ void rt_timer_check(void)
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
-    while (!rt_list_isempty(&_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+    while ((t = _timer_list_expired(_timer_list, current_tick)) != RT_NULL)
     {
-        t = rt_list_entry(_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
-                          struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
-
-        /*
-         * It supposes that the new tick shall less than the half duration of
-         * tick max.
-         */
-        if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
-        {
-            RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
+        RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
 
-            /* remove timer from timer list firstly */
-            _timer_remove(t);
-            if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
-            {
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-            }
-            /* add timer to temporary list  */
-            rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-            /* call timeout function */
-            t->timeout_func(t->parameter);
+        /* remove timer from timer list firstly */
+        _timer_remove(t);
+        if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
+        {
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+        }
+        /* add timer to temporary list  */
+        rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        /* call timeout function */
+        t->timeout_func(t->parameter);
 
-            /* re-get tick */
-            current_tick = rt_tick_get();
+        /* re-get tick */
+        current_tick = rt_tick_get();
 
-            RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
-            RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
+        RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
+        RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
 
-            /* Check whether the timer object is detached or started again */
-            if (rt_list_isempty(&list))
-            {
-                continue;
-            }
-            rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-            if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
-                (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
-            {
-                /* start it */
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-                rt_timer_start(t);
-            }
+        /* Check whether the timer object is detached or started again */
+        if (rt_list_isempty(&list))
+        {
+            continue;
+        }
+        rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+            (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+        {
+            /* start it */
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            rt_timer_start(t);
         }
-        else break;
     }
 
     /* enable interrupt */
@@ -744,59 +1086,48 @@ void rt_soft_timer_check(void)
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
-    while (!rt_list_isempty(&_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+    for (current_tick = rt_tick_get();
+         (t = _timer_list_expired(_soft_timer_list, current_tick)) != RT_NULL;
+         current_tick = rt_tick_get())
     {
-        t = rt_list_entry(_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
-                            struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+        RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
 
-        current_tick = rt_tick_get();
-
-        /*
-         * It supposes that the new tick shall less than the half duration of
-         * tick max.
-         */
-        if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
+        /* remove timer from timer list firstly */
+        _timer_remove(t);
+        if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
         {
-            RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
-
-            /* remove timer from timer list firstly */
-            _timer_remove(t);
-            if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
-            {
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-            }
-            /* add timer to temporary list  */
-            rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+        }
+        /* add timer to temporary list  */
+        rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
 
-            _soft_timer_status = RT_SOFT_TIMER_BUSY;
-            /* enable interrupt */
-            rt_hw_interrupt_enable(level);
+        _soft_timer_status = RT_SOFT_TIMER_BUSY;
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
 
-            /* call timeout function */
-            t->timeout_func(t->parameter);
+        /* call timeout function */
+        t->timeout_func(t->parameter);
 
-            RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
-            RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
+        RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
+        RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
 
-            /* disable interrupt */
-            level = rt_hw_interrupt_disable();
+        /* disable interrupt */
+        level = rt_hw_interrupt_disable();
 
-            _soft_timer_status = RT_SOFT_TIMER_IDLE;
-            /* Check whether the timer object is detached or started again */
-            if (rt_list_isempty(&list))
-            {
-                continue;
-            }
-            rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-            if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
-                (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
-            {
-                /* start it */
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-                rt_timer_start(t);
-            }
+        _soft_timer_status = RT_SOFT_TIMER_IDLE;
+        /* Check whether the timer object is detached or started again */
+        if (rt_list_isempty(&list))
+        {
+            continue;
+        }
+        rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+            (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+        {
+            /* start it */
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            rt_timer_start(t);
         }
-        else break; /* not check anymore */
     }
     /* enable interrupt */
     rt_hw_interrupt_enable(level);
@@ -850,12 +1181,7 @@ static void _timer_thread_entry(void *parameter)
  */
 void rt_system_timer_init(void)
 {
-    rt_size_t i;
-
-    for (i = 0; i < sizeof(_timer_list) / sizeof(_timer_list[0]); i++)
-    {
-        rt_list_init(_timer_list + i);
-    }
+    _timer_list_init(_timer_list);
 }
 
 /**
@@ -866,14 +1192,7 @@ void rt_system_timer_init(void)
 void rt_system_timer_thread_init(void)
 {
 #ifdef RT_USING_TIMER_SOFT
-    int i;
-
-    for (i = 0;
-         i < sizeof(_soft_timer_list) / sizeof(_soft_timer_list[0]);
-         i++)
-    {
-        rt_list_init(_soft_timer_list + i);
-    }
+    _timer_list_init(_soft_timer_list);
 
     /* start software timer thread */
     rt_thread_init(&_timer_thread,
@@ -0,0 +1,721 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+
+/*
+ * Two-Level Segregated Fit memory allocator, after M. Masmano, I. Ripoll,
+ * A. Crespo and J. Real, "TLSF: a New Dynamic Memory Allocator for Real-Time
+ * Systems", ECRTS 2004.
+ *
+ * Free blocks sit in size-class lists indexed by two levels: the first level
+ * is the power of two of the size, the second splits each power of two into
+ * TLSF_SL_INDEX_COUNT linear classes. A bitmap at each level marks the
+ * non-empty lists, so finding a fitting block is a couple of find-first-set
+ * operations and allocation and release run in bounded time whatever the
+ * heap holds, unlike the small memory algorithm which walks the free list.
+ *
+ * Every block starts with a header holding the block just below it in memory
+ * and its payload size, whose low bits flag whether the block and the one
+ * below it are free; the header of a free block is followed by its list
+ * links. An empty used block closes the pool so no walk runs past the end.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#if defined (RT_USING_TLSF)
+
+#define TLSF_SL_INDEX_COUNT_LOG2    4
+#define TLSF_SL_INDEX_COUNT         (1 << TLSF_SL_INDEX_COUNT_LOG2)
+
+/* the biggest block is below 2^TLSF_FL_INDEX_MAX, 16MB keeps the tables small */
+#ifndef TLSF_FL_INDEX_MAX
+#ifdef ARCH_CPU_64BIT
+#define TLSF_FL_INDEX_MAX           32
+#else
+#define TLSF_FL_INDEX_MAX           24
+#endif /* ARCH_CPU_64BIT */
+#endif /* TLSF_FL_INDEX_MAX */
+
+/* block sizes are multiples of the alignment, one size per class below SMALL */
+#if RT_ALIGN_SIZE > 16
+#error "TLSF supports RT_ALIGN_SIZE up to 16"
+#elif RT_ALIGN_SIZE > 8
+#define TLSF_ALIGN_SIZE_LOG2        4
+#elif RT_ALIGN_SIZE > 4 || defined(ARCH_CPU_64BIT)
+#define TLSF_ALIGN_SIZE_LOG2        3
+#else
+#define TLSF_ALIGN_SIZE_LOG2        2
+#endif
+#define TLSF_ALIGN_SIZE             (1UL << TLSF_ALIGN_SIZE_LOG2)
+
+#define TLSF_FL_INDEX_SHIFT         (TLSF_SL_INDEX_COUNT_LOG2 + TLSF_ALIGN_SIZE_LOG2)
+#define TLSF_FL_INDEX_COUNT         (TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1)
+#define TLSF_SMALL_BLOCK_SIZE       (1UL << TLSF_FL_INDEX_SHIFT)
+#define TLSF_BLOCK_SIZE_MAX         ((1UL << TLSF_FL_INDEX_MAX) - TLSF_ALIGN_SIZE)
+
+/**
+ * memory block on the tlsf heap
+ */
+struct rt_tlsf_block
+{
+    struct rt_tlsf_block   *prev_phys;        /**< block just below in memory */
+    rt_size_t               size;             /**< payload size and the flags below */
+#ifdef RT_USING_MEMTRACE
+    rt_uint8_t              thread[4];        /**< thread name */
+#endif /* RT_USING_MEMTRACE */
+};
+
+/**
+ * free list links, in the payload of a free block
+ */
+struct rt_tlsf_link
+{
+    struct rt_tlsf_block   *next;
+    struct rt_tlsf_block   *prev;
+};
+
+/**
+ * Base structure of tlsf memory object
+ */
+struct rt_tlsf
+{
+    struct rt_memory        parent;                 /**< inherit from rt_memory */
+    struct rt_tlsf_block   *heap_ptr;               /**< first block of the pool */
+    struct rt_tlsf_block   *heap_end;               /**< used block closing the pool */
+    rt_uint32_t             fl_bitmap;              /**< non-empty first level classes */
+    rt_uint32_t             sl_bitmap[TLSF_FL_INDEX_COUNT];
+    struct rt_tlsf_block   *blocks[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];
+};
+
+#define TLSF_BLOCK_FREE         0x1
+#define TLSF_BLOCK_PREV_FREE    0x2
+#define TLSF_BLOCK_FLAGS        (TLSF_BLOCK_FREE | TLSF_BLOCK_PREV_FREE)
+
+#define SIZEOF_STRUCT_BLOCK     RT_ALIGN(sizeof(struct rt_tlsf_block), TLSF_ALIGN_SIZE)
+#define MIN_SIZE_ALIGNED        RT_ALIGN(sizeof(struct rt_tlsf_link), TLSF_ALIGN_SIZE)
+
+#define BLOCK_SIZE(_block)      ((_block)->size & ~(rt_size_t)TLSF_BLOCK_FLAGS)
+#define BLOCK_ISFREE(_block)    ((_block)->size & TLSF_BLOCK_FREE)
+#define BLOCK_PTR(_block)       ((rt_uint8_t *)(_block) + SIZEOF_STRUCT_BLOCK)
+#define BLOCK_FROM_PTR(_ptr)    ((struct rt_tlsf_block *)((rt_uint8_t *)(_ptr) - SIZEOF_STRUCT_BLOCK))
+#define BLOCK_NEXT(_block)      ((struct rt_tlsf_block *)(BLOCK_PTR(_block) + BLOCK_SIZE(_block)))
+#define BLOCK_LINK(_block)      ((struct rt_tlsf_link *)BLOCK_PTR(_block))
+
+#if TLSF_SL_INDEX_COUNT > 32 || TLSF_FL_INDEX_COUNT > 32
+#error "TLSF class bitmaps are 32 bits"
+#endif
+
+#ifdef RT_USING_MEMTRACE
+rt_inline void rt_tlsf_setname(struct rt_tlsf_block *block, const char *name)
+{
+    int index;
+    for (index = 0; index < sizeof(block->thread); index ++)
+    {
+        if (name[index] == '\0') break;
+        block->thread[index] = name[index];
+    }
+
+    for (; index < sizeof(block->thread); index ++)
+    {
+        block->thread[index] = ' ';
+    }
+}
+#endif /* RT_USING_MEMTRACE */
+
+/* index of the highest bit set, word must not be 0 */
+rt_inline int _tlsf_fls(rt_uint32_t word)
+{
+    int bit = 0;
+
+    if (word & 0xffff0000) { word >>= 16; bit += 16; }
+    if (word & 0xff00)     { word >>= 8;  bit += 8;  }
+    if (word & 0xf0)       { word >>= 4;  bit += 4;  }
+    if (word & 0xc)        { word >>= 2;  bit += 2;  }
+    if (word & 0x2)        { bit += 1; }
+
+    return bit;
+}
+
+/* index of the lowest bit set, word must not be 0 */
+rt_inline int _tlsf_ffs(rt_uint32_t word)
+{
+    return __rt_ffs((int)word) - 1;
+}
+
+/* the class a free block of this size belongs to */
+rt_inline void _tlsf_mapping(rt_size_t size, int *fl, int *sl)
+{
+    if (size < TLSF_SMALL_BLOCK_SIZE)
+    {
+        *fl = 0;
+        *sl = (int)(size >> TLSF_ALIGN_SIZE_LOG2);
+    }
+    else
+    {
+        int bit = _tlsf_fls((rt_uint32_t)size);
+
+        *sl = (int)(size >> (bit - TLSF_SL_INDEX_COUNT_LOG2)) ^ TLSF_SL_INDEX_COUNT;
+        *fl = bit - TLSF_FL_INDEX_SHIFT + 1;
+    }
+}
+
+/* the first class whose every block fits this size */
+rt_inline void _tlsf_mapping_search(rt_size_t size, int *fl, int *sl)
+{
+    if (size >= TLSF_SMALL_BLOCK_SIZE)
+        size += (1UL << (_tlsf_fls((rt_uint32_t)size) - TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+
+    _tlsf_mapping(size, fl, sl);
+}
+
+static void _tlsf_remove(struct rt_tlsf *tlsf, struct rt_tlsf_block *block, int fl, int sl)
+{
+    struct rt_tlsf_link *link = BLOCK_LINK(block);
+
+    if (link->next)
+        BLOCK_LINK(link->next)->prev = link->prev;
+    if (link->prev)
+        BLOCK_LINK(link->prev)->next = link->next;
+    else
+    {
+        tlsf->blocks[fl][sl] = link->next;
+        if (link->next == RT_NULL)
+        {
+            tlsf->sl_bitmap[fl] &= ~(1UL << sl);
+            if (tlsf->sl_bitmap[fl] == 0)
+                tlsf->fl_bitmap &= ~(1UL << fl);
+        }
+    }
+}
+
+static void _tlsf_insert(struct rt_tlsf *tlsf, struct rt_tlsf_block *block)
+{
+    struct rt_tlsf_link *link = BLOCK_LINK(block);
+    int fl, sl;
+
+    _tlsf_mapping(BLOCK_SIZE(block), &fl, &sl);
+    link->prev = RT_NULL;
+    link->next = tlsf->blocks[fl][sl];
+    if (link->next)
+        BLOCK_LINK(link->next)->prev = block;
+    tlsf->blocks[fl][sl] = block;
+    tlsf->sl_bitmap[fl] |= 1UL << sl;
+    tlsf->fl_bitmap |= 1UL << fl;
+}
+
+rt_inline void _tlsf_unlink(struct rt_tlsf *tlsf, struct rt_tlsf_block *block)
+{
+    int fl, sl;
+
+    _tlsf_mapping(BLOCK_SIZE(block), &fl, &sl);
+    _tlsf_remove(tlsf, block, fl, sl);
+}
+
+/* take the head of the first non-empty class at or above fl/sl */
+static struct rt_tlsf_block *_tlsf_take(struct rt_tlsf *tlsf, int fl, int sl)
+{
+    struct rt_tlsf_block *block;
+    rt_uint32_t map;
+
+    map = tlsf->sl_bitmap[fl] & (~0UL << sl);
+    if (map == 0)
+    {
+        map = (fl + 1 < 32) ? tlsf->fl_bitmap & (~0UL << (fl + 1)) : 0;
+        if (map == 0)
+            return RT_NULL;
+
+        fl = _tlsf_ffs(map);
+        map = tlsf->sl_bitmap[fl];
+    }
+    sl = _tlsf_ffs(map);
+
+    block = tlsf->blocks[fl][sl];
+    RT_ASSERT(block != RT_NULL);
+    _tlsf_remove(tlsf, block, fl, sl);
+
+    return block;
+}
+
+/* give the tail of a used block beyond size back to the free lists */
+static void _tlsf_trim(struct rt_tlsf *tlsf, struct rt_tlsf_block *block, rt_size_t size)
+{
+    struct rt_tlsf_block *rest, *next;
+    rt_size_t rest_size;
+
+    if (BLOCK_SIZE(block) < size + SIZEOF_STRUCT_BLOCK + MIN_SIZE_ALIGNED)
+        return;
+
+    rest_size = BLOCK_SIZE(block) - size - SIZEOF_STRUCT_BLOCK;
+    block->size = size | (block->size & TLSF_BLOCK_FLAGS);
+    tlsf->parent.used -= rest_size + SIZEOF_STRUCT_BLOCK;
+
+    rest = BLOCK_NEXT(block);
+    rest->prev_phys = block;
+    rest->size = rest_size | TLSF_BLOCK_FREE;
+#ifdef RT_USING_MEMTRACE
+    rt_tlsf_setname(rest, "    ");
+#endif /* RT_USING_MEMTRACE */
+
+    next = BLOCK_NEXT(rest);
+    if (BLOCK_ISFREE(next))
+    {
+        _tlsf_unlink(tlsf, next);
+        rest->size += SIZEOF_STRUCT_BLOCK + BLOCK_SIZE(next);
+        next = BLOCK_NEXT(rest);
+    }
+    next->prev_phys = rest;
+    next->size |= TLSF_BLOCK_PREV_FREE;
+
+    _tlsf_insert(tlsf, rest);
+}
+
+/**
+ * @brief This function will initialize a tlsf memory management algorithm.
+ *
+ * @param name is the name of the tlsf memory management object.
+ *
+ * @param begin_addr the beginning address of memory.
+ *
+ * @param size is the size of the memory.
+ *
+ * @return Return a pointer to the memory object. When the return value is RT_NULL, it means the init failed.
+ */
+rt_tlsf_t rt_tlsf_init(const char *name, void *begin_addr, rt_size_t size)
+{
+    struct rt_tlsf_block *block;
+    struct rt_tlsf *tlsf;
+    rt_ubase_t begin_align, end_align, mem_size;
+
+    tlsf = (struct rt_tlsf *)RT_ALIGN((rt_ubase_t)begin_addr, TLSF_ALIGN_SIZE);
+    begin_align = RT_ALIGN((rt_ubase_t)tlsf + sizeof(*tlsf), TLSF_ALIGN_SIZE);
+    end_align   = RT_ALIGN_DOWN((rt_ubase_t)begin_addr + size, TLSF_ALIGN_SIZE);
+
+    if (end_align > begin_align &&
+        end_align - begin_align >= 2 * SIZEOF_STRUCT_BLOCK + MIN_SIZE_ALIGNED)
+    {
+        /* one free block spanning the pool, and the used block closing it */
+        mem_size = end_align - begin_align - 2 * SIZEOF_STRUCT_BLOCK;
+        if (mem_size > TLSF_BLOCK_SIZE_MAX)
+            mem_size = TLSF_BLOCK_SIZE_MAX;
+    }
+    else
+    {
+        rt_kprintf("tlsf init, error begin address 0x%x, and end address 0x%x\n",
+                   (rt_ubase_t)begin_addr, (rt_ubase_t)begin_addr + size);
+
+        return RT_NULL;
+    }
+
+    rt_memset(tlsf, 0, sizeof(*tlsf));
+    /* initialize tlsf memory object */
+    rt_object_init(&(tlsf->parent.parent), RT_Object_Class_Memory, name);
+    tlsf->parent.algorithm = "tlsf";
+    tlsf->parent.address = begin_align;
+    tlsf->parent.total = mem_size + SIZEOF_STRUCT_BLOCK;
+
+    RT_DEBUG_LOG(RT_DEBUG_MEM, ("tlsf init, heap begin address 0x%x, size %d\n",
+                                begin_align, mem_size));
+
+    block = (struct rt_tlsf_block *)begin_align;
+    block->prev_phys = RT_NULL;
+    block->size = mem_size | TLSF_BLOCK_FREE;
+#ifdef RT_USING_MEMTRACE
+    rt_tlsf_setname(block, "INIT");
+#endif /* RT_USING_MEMTRACE */
+    tlsf->heap_ptr = block;
+
+    tlsf->heap_end = BLOCK_NEXT(block);
+    tlsf->heap_end->prev_phys = block;
+    tlsf->heap_end->size = 0 | TLSF_BLOCK_PREV_FREE;
+#ifdef RT_USING_MEMTRACE
+    rt_tlsf_setname(tlsf->heap_end, "INIT");
+#endif /* RT_USING_MEMTRACE */
+
+    _tlsf_insert(tlsf, block);
+
+    return &tlsf->parent;
+}
+RTM_EXPORT(rt_tlsf_init);
+
+/**
+ * @brief This function will remove a tlsf memory from the system.
+ *
+ * @param m the tlsf memory management object.
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_tlsf_detach(rt_tlsf_t m)
+{
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    rt_object_detach(&(m->parent));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_tlsf_detach);
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * @brief Allocate a block of memory with a minimum of 'size' bytes, in a time
+ *        that does not depend on the state of the heap.
+ *
+ * @param m the tlsf memory management object.
+ *
+ * @param size is the minimum size of the requested block in bytes.
+ *
+ * @return the pointer to allocated memory or NULL if no free memory was found.
+ */
+void *rt_tlsf_alloc(rt_tlsf_t m, rt_size_t size)
+{
+    struct rt_tlsf_block *block;
+    struct rt_tlsf *tlsf;
+    int fl, sl;
+
+    if (size == 0)
+        return RT_NULL;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    tlsf = (struct rt_tlsf *)m;
+    if (size > tlsf->parent.total)
+    {
+        RT_DEBUG_LOG(RT_DEBUG_MEM, ("no memory\n"));
+
+        return RT_NULL;
+    }
+
+    /* alignment size, and room for the links once it is freed */
+    size = RT_ALIGN(size, TLSF_ALIGN_SIZE);
+    if (size < MIN_SIZE_ALIGNED)
+        size = MIN_SIZE_ALIGNED;
+
+    _tlsf_mapping_search(size, &fl, &sl);
+    if (fl >= TLSF_FL_INDEX_COUNT)
+        return RT_NULL;
+
+    block = _tlsf_take(tlsf, fl, sl);
+    if (block == RT_NULL)
+    {
+        RT_DEBUG_LOG(RT_DEBUG_MEM, ("no memory\n"));
+
+        return RT_NULL;
+    }
+    RT_ASSERT(BLOCK_SIZE(block) >= size);
+
+    block->size &= ~(rt_size_t)TLSF_BLOCK_FREE;
+    BLOCK_NEXT(block)->size &= ~(rt_size_t)TLSF_BLOCK_PREV_FREE;
+    tlsf->parent.used += BLOCK_SIZE(block) + SIZEOF_STRUCT_BLOCK;
+    _tlsf_trim(tlsf, block, size);
+    if (tlsf->parent.max < tlsf->parent.used)
+        tlsf->parent.max = tlsf->parent.used;
+#ifdef RT_USING_MEMTRACE
+    if (rt_thread_self())
+        rt_tlsf_setname(block, rt_thread_self()->parent.name);
+    else
+        rt_tlsf_setname(block, "NONE");
+#endif /* RT_USING_MEMTRACE */
+
+    RT_DEBUG_LOG(RT_DEBUG_MEM, ("allocate memory at 0x%x, size: %d\n",
+                                (rt_ubase_t)BLOCK_PTR(block), BLOCK_SIZE(block)));
+
+    return BLOCK_PTR(block);
+}
+RTM_EXPORT(rt_tlsf_alloc);
+
+/**
+ * @brief This function will change the size of previously allocated memory block.
+ *        It shrinks and grows into a free neighbour in place, and only copies
+ *        when the block below the next used one is too small.
+ *
+ * @param m the tlsf memory management object.
+ *
+ * @param rmem is the pointer to memory allocated by rt_tlsf_alloc.
+ *
+ * @param newsize is the required new size.
+ *
+ * @return the changed memory block address.
+ */
+void *rt_tlsf_realloc(rt_tlsf_t m, void *rmem, rt_size_t newsize)
+{
+    struct rt_tlsf_block *block, *next;
+    struct rt_tlsf *tlsf;
+    rt_size_t size;
+    void *nmem;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    tlsf = (struct rt_tlsf *)m;
+    if (newsize > tlsf->parent.total)
+    {
+        RT_DEBUG_LOG(RT_DEBUG_MEM, ("realloc: out of memory\n"));
+
+        return RT_NULL;
+    }
+    else if (newsize == 0)
+    {
+        rt_tlsf_free(m, rmem);
+        return RT_NULL;
+    }
+
+    /* allocate a new memory block */
+    if (rmem == RT_NULL)
+        return rt_tlsf_alloc(m, newsize);
+
+    block = BLOCK_FROM_PTR(rmem);
+    RT_ASSERT(block >= tlsf->heap_ptr && block < tlsf->heap_end);
+    RT_ASSERT(!BLOCK_ISFREE(block));
+
+    newsize = RT_ALIGN(newsize, TLSF_ALIGN_SIZE);
+    if (newsize < MIN_SIZE_ALIGNED)
+        newsize = MIN_SIZE_ALIGNED;
+
+    size = BLOCK_SIZE(block);
+    if (newsize > size)
+    {
+        next = BLOCK_NEXT(block);
+        if (!BLOCK_ISFREE(next) || size + SIZEOF_STRUCT_BLOCK + BLOCK_SIZE(next) < newsize)
+        {
+            /* expand memory */
+            nmem = rt_tlsf_alloc(m, newsize);
+            if (nmem != RT_NULL)
+            {
+                rt_memcpy(nmem, rmem, size);
+                rt_tlsf_free(m, rmem);
+            }
+
+            return nmem;
+        }
+
+        /* take the free block above in */
+        _tlsf_unlink(tlsf, next);
+        block->size += SIZEOF_STRUCT_BLOCK + BLOCK_SIZE(next);
+        tlsf->parent.used += SIZEOF_STRUCT_BLOCK + BLOCK_SIZE(next);
+        next = BLOCK_NEXT(block);
+        next->prev_phys = block;
+        next->size &= ~(rt_size_t)TLSF_BLOCK_PREV_FREE;
+    }
+
+    _tlsf_trim(tlsf, block, newsize);
+    if (tlsf->parent.max < tlsf->parent.used)
+        tlsf->parent.max = tlsf->parent.used;
+
+    return rmem;
+}
+RTM_EXPORT(rt_tlsf_realloc);
+
+/**
+ * @brief This function will release the previously allocated memory block by
+ *        rt_tlsf_alloc, merging it with the free blocks around it.
+ *
+ * @param m the tlsf memory management object.
+ *
+ * @param rmem the address of memory which will be released.
+ */
+void rt_tlsf_free(rt_tlsf_t m, void *rmem)
+{
+    struct rt_tlsf_block *block, *prev, *next;
+    struct rt_tlsf *tlsf;
+
+    if (rmem == RT_NULL)
+        return;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+    RT_ASSERT((((rt_ubase_t)rmem) & (TLSF_ALIGN_SIZE - 1)) == 0);
+
+    tlsf = (struct rt_tlsf *)m;
+    block = BLOCK_FROM_PTR(rmem);
+    RT_ASSERT(block >= tlsf->heap_ptr && block < tlsf->heap_end);
+    RT_ASSERT(!BLOCK_ISFREE(block));
+    RT_ASSERT(BLOCK_NEXT(block) <= tlsf->heap_end && BLOCK_NEXT(block)->prev_phys == block);
+
+    RT_DEBUG_LOG(RT_DEBUG_MEM, ("release memory 0x%x, size: %d\n",
+                                (rt_ubase_t)rmem, BLOCK_SIZE(block)));
+
+    tlsf->parent.used -= BLOCK_SIZE(block) + SIZEOF_STRUCT_BLOCK;
+    block->size |= TLSF_BLOCK_FREE;
+#ifdef RT_USING_MEMTRACE
+    rt_tlsf_setname(block, "    ");
+#endif /* RT_USING_MEMTRACE */
+
+    /* merge with the free blocks on either side */
+    if (block->size & TLSF_BLOCK_PREV_FREE)
+    {
+        prev = block->prev_phys;
+        RT_ASSERT(BLOCK_ISFREE(prev));
+        _tlsf_unlink(tlsf, prev);
+        prev->size += SIZEOF_STRUCT_BLOCK + BLOCK_SIZE(block);
+        block = prev;
+    }
+    next = BLOCK_NEXT(block);
+    if (BLOCK_ISFREE(next))
+    {
+        _tlsf_unlink(tlsf, next);
+        block->size += SIZEOF_STRUCT_BLOCK + BLOCK_SIZE(next);
+        next = BLOCK_NEXT(block);
+    }
+    next->prev_phys = block;
+    next->size |= TLSF_BLOCK_PREV_FREE;
+
+    _tlsf_insert(tlsf, block);
+}
+RTM_EXPORT(rt_tlsf_free);
+
+/**@}*/
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+#if defined(RT_USING_MEMTRACE) && defined(RT_USING_TLSF_AS_HEAP)
+static struct rt_tlsf *_tlsf_object(struct rt_object *object, const char *name)
+{
+    /* the small memory and slab objects are of the same class */
+    if (name != RT_NULL && rt_strncmp(name, object->name, RT_NAME_MAX) != 0)
+        return RT_NULL;
+    if (rt_strcmp(((rt_mem_t)object)->algorithm, "tlsf") != 0)
+        return RT_NULL;
+
+    return (struct rt_tlsf *)object;
+}
+
+int memcheck(int argc, char *argv[])
+{
+    rt_base_t level;
+    struct rt_tlsf_block *block, *prev;
+    struct rt_tlsf *m;
+    struct rt_object_information *information;
+    struct rt_list_node *node;
+    const char *error;
+    char *name;
+
+    name = argc > 1 ? argv[1] : RT_NULL;
+    level = rt_hw_interrupt_disable();
+    /* get mem object */
+    information = rt_object_get_information(RT_Object_Class_Memory);
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node  = node->next)
+    {
+        m = _tlsf_object(rt_list_entry(node, struct rt_object, list), name);
+        if (m == RT_NULL)
+            continue;
+        /* walk the blocks in address order, checking the headers link up */
+        for (prev = RT_NULL, block = m->heap_ptr; block != m->heap_end; prev = block, block = BLOCK_NEXT(block))
+        {
+            if (block < m->heap_ptr || block > m->heap_end)
+                error = "out of the pool";
+            else if (block->prev_phys != prev)
+                error = "broken block chain";
+            else if (prev != RT_NULL && !!(block->size & TLSF_BLOCK_PREV_FREE) != !!BLOCK_ISFREE(prev))
+                error = "stale free flag";
+            else if (prev != RT_NULL && BLOCK_ISFREE(block) && BLOCK_ISFREE(prev))
+                error = "unmerged free blocks";
+            else if (BLOCK_ISFREE(block) && BLOCK_LINK(block)->next &&
+                     BLOCK_LINK(BLOCK_LINK(block)->next)->prev != block)
+                error = "broken free list";
+            else
+                continue;
+            goto __exit;
+        }
+        if (m->heap_end->prev_phys != prev)
+        {
+            error = "broken block chain";
+            goto __exit;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+
+    return 0;
+__exit:
+    rt_kprintf("Memory block wrong: %s\n", error);
+    rt_kprintf("   name: %s\n", m->parent.parent.name);
+    rt_kprintf("address: 0x%08x\n", block);
+    rt_kprintf("   prev: 0x%08x\n", block->prev_phys);
+    rt_kprintf("   size: %d\n", BLOCK_SIZE(block));
+    rt_hw_interrupt_enable(level);
+
+    return 0;
+}
+MSH_CMD_EXPORT(memcheck, check memory data);
+
+int memtrace(int argc, char **argv)
+{
+    struct rt_tlsf_block *block;
+    struct rt_tlsf *m;
+    struct rt_object_information *information;
+    struct rt_list_node *node;
+    rt_size_t free_size, free_max, free_count;
+    char *name;
+
+    name = argc > 1 ? argv[1] : RT_NULL;
+    /* get mem object */
+    information = rt_object_get_information(RT_Object_Class_Memory);
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node  = node->next)
+    {
+        m = _tlsf_object(rt_list_entry(node, struct rt_object, list), name);
+        if (m == RT_NULL)
+            continue;
+        /* show memory information */
+        rt_kprintf("\nmemory heap address:\n");
+        rt_kprintf("name    : %s\n", m->parent.parent.name);
+        rt_kprintf("total   : %d\n", m->parent.total);
+        rt_kprintf("used    : %d\n", m->parent.used);
+        rt_kprintf("max_used: %d\n", m->parent.max);
+        rt_kprintf("heap_ptr: 0x%08x\n", m->heap_ptr);
+        rt_kprintf("heap_end: 0x%08x\n", m->heap_end);
+        rt_kprintf("\n--memory item information --\n");
+        free_size = free_max = free_count = 0;
+        for (block = m->heap_ptr; block != m->heap_end; block = BLOCK_NEXT(block))
+        {
+            int size = BLOCK_SIZE(block);
+
+            rt_kprintf("[0x%08x - ", block);
+            if (size < 1024)
+                rt_kprintf("%5d", size);
+            else if (size < 1024 * 1024)
+                rt_kprintf("%4dK", size / 1024);
+            else
+                rt_kprintf("%4dM", size / (1024 * 1024));
+
+            rt_kprintf("] %c%c%c%c\n", block->thread[0], block->thread[1], block->thread[2], block->thread[3]);
+            if (BLOCK_ISFREE(block))
+            {
+                free_size += size;
+                free_count++;
+                if (size > free_max)
+                    free_max = size;
+            }
+        }
+        /* how much of the free memory cannot be had in one allocation */
+        rt_kprintf("\nfree    : %d in %d blocks, largest %d\n", free_size, free_count, free_max);
+        rt_kprintf("fragmentation: %d%%\n",
+                   free_size ? (int)(100 - (rt_uint64_t)free_max * 100 / free_size) : 0);
+    }
+    return 0;
+}
+MSH_CMD_EXPORT(memtrace, dump memory trace information);
+#endif /* RT_USING_MEMTRACE && RT_USING_TLSF_AS_HEAP */
+#endif /* RT_USING_FINSH */
+
+#endif /* defined (RT_USING_TLSF) */
@@ -15,7 +15,8 @@
 #define RT_HOOK_USING_FUNC_PTR
 #define RT_USING_IDLE_HOOK
 #define RT_IDLE_HOOK_LIST_SIZE 4
-#define IDLE_THREAD_STACK_SIZE 256
+#define IDLE_THREAD_STACK_SIZE 512
+#define RT_TIMER_USING_WHEEL
 
 /* kservice optimization */
 
@@ -36,7 +37,8 @@
 
 #define RT_USING_MEMPOOL
 #define RT_USING_SMALL_MEM
-#define RT_USING_SMALL_MEM_AS_HEAP
+#define RT_USING_TLSF
+#define RT_USING_TLSF_AS_HEAP
 #define RT_USING_HEAP
 /* end of Memory Management */
 
@@ -76,6 +78,9 @@
 /* DFS: device virtual file system */
 
 /* end of DFS: device virtual file system */
+#define RT_USING_FAL
+#define FAL_DEBUG 0
+#define FAL_PART_HAS_TABLE_CFG
 
 /* Device Drivers */
 
@@ -85,7 +90,13 @@
 #define RT_USING_SERIAL_V1
 #define RT_SERIAL_USING_DMA
 #define RT_SERIAL_RB_BUFSZ 64
+#define RT_USING_CPUTIME
+#define CPUTIME_TIMER_FREQ 0
+#define RT_USING_I2C
 #define RT_USING_PIN
+#define RT_USING_PM
+#define PM_TICKLESS_THRESHOLD_TIME 2
+#define RT_USING_SENSOR
 
 /* Using USB */
 
@@ -110,6 +121,12 @@
 
 /* Network */
 
+#define RT_USING_AT
+#define AT_USING_CLIENT
+#define AT_CLIENT_NUM_MAX 1
+#define AT_USING_CLI
+#define AT_CMD_MAX_LEN 128
+#define AT_SW_VERSION_NUM 0x10301
 /* end of Network */
 
 /* Utilities */
@@ -264,9 +281,57 @@
 
 #define SOC_RP2040
 
+/* On-chip Peripheral Drivers */
+
+#define BSP_USING_I2C0
+#define BSP_I2C0_SDA_PIN 16
+#define BSP_I2C0_SCL_PIN 17
+#define BSP_I2C0_CLOCK 400000
+#define BSP_USING_ON_CHIP_FLASH
+#define BSP_USING_ADC
+#define BSP_ADC_INPUTS 0x3
+#define BSP_ADC_SAMPLE_RATE 512
+#define BSP_ADC_DECIMATION 1024
+#define BSP_USING_PM
+#define BSP_PM_ALARM 0
+#define BSP_USING_CPUTIME
+#define BSP_CPUTIME_ALARM 1
+/* end of On-chip Peripheral Drivers */
+
 /* Onboard Peripheral Drivers */
 
 /* end of Onboard Peripheral Drivers */
 /* end of Hardware Drivers Config */
 
+/* Application Config */
+
+#define SIM800_DEVICE_NAME "uart1"
+#define SIM800_APN "gpinternet"
+#define HSM20G_USING_SENSOR
+#define HSM20G_FIFO_MAX 16
+#define HSM20G_USING_SENSOR_BENCH
+#define APP_USING_SAMPLE_LOG
+#define APP_USING_UPLINK
+#define UPLINK_SAMPLE_INTERVAL 20
+#define UPLINK_MIN_INTERVAL 15
+#define THINGSPEAK_CHANNEL_ID "0"
+#define THINGSPEAK_WRITE_KEY "B3FPE7GTVY1ISGQS"
+#define SAMPLE_BATCH_SIZE 30
+#define SAMPLE_BATCH_MAX_AGE 900
+#define ALARM_TEMP_LOW 0
+#define ALARM_TEMP_HIGH 400
+#define ALARM_TEMP_HYSTERESIS 50
+#define ALARM_HUMID_LOW 0
+#define ALARM_HUMID_HIGH 5000
+#define ALARM_HUMID_HYSTERESIS 200
+#define ALARM_DWELL_S 10
+#define ALARM_ESCALATE_S 900
+#define ALARM_LEVEL_MAX 3
+#define MKT_ACTIVATION_ENERGY 83144
+#define MKT_LOW_LIMIT 200
+#define MKT_HIGH_LIMIT 800
+#define MKT_FREEZE_LIMIT 0
+#define MKT_HOT_LIMIT 2500
+/* end of Application Config */
+
 #endif
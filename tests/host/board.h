@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* the part of board/board.h and pico/stdlib.h the drivers use, for the mock hardware */
+enum gpio_function
+{
+    GPIO_FUNC_UART = 2,
+};
+
+static inline void gpio_set_function(unsigned int gpio, enum gpio_function fn)
+{
+}
+
+int rt_hw_uart_init(void);
+
+#endif /* __BOARD_H__ */
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef RTHOST_DRIVERS_ADC_H__
+#define RTHOST_DRIVERS_ADC_H__
+
+#include <stdint.h>
+
+/* the pico-sdk ADC calls, as the BSP's drivers/adc.h copy of them; the test that needs them defines them */
+void adc_init(void);
+void adc_gpio_init(unsigned int gpio);
+void adc_select_input(unsigned int input);
+uint16_t adc_read(void);
+
+#endif /* RTHOST_DRIVERS_ADC_H__ */
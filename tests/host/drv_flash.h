@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef __DRV_FLASH_H__
+#define __DRV_FLASH_H__
+
+#include <rtthread.h>
+
+/* the erase hooks of drivers/drv_flash.h, without board.h */
+rt_err_t pico_flash_erase_begin(void);
+void pico_flash_erase_end(void);
+
+#endif /* __DRV_FLASH_H__ */
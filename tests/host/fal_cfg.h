@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef _FAL_CFG_H_
+#define _FAL_CFG_H_
+
+/*
+ * The board's fal_cfg.h pulls in board.h and the pico-sdk. The host tests
+ * have no device or partition tables: each one that needs FAL provides
+ * fal_partition_find/read/write/erase over its own flash.
+ */
+#include <rtconfig.h>
+
+#endif /* _FAL_CFG_H_ */
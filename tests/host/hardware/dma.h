@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef RTHOST_HARDWARE_DMA_H__
+#define RTHOST_HARDWARE_DMA_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * The pico-sdk DMA calls; the test that includes a driver defines them,
+ * and runs the channels itself. A channel's configuration is kept as
+ * fields rather than packed into a CTRL word.
+ */
+#define NUM_DMA_CHANNELS    12
+
+enum dma_channel_transfer_size
+{
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+#define DREQ_UART0_TX       20
+#define DREQ_UART1_TX       22
+
+typedef struct
+{
+    enum dma_channel_transfer_size size;
+    bool read_increment;
+    bool write_increment;
+    unsigned int dreq;
+} dma_channel_config;
+
+typedef struct
+{
+    volatile uint32_t intr;
+    volatile uint32_t inte0;
+    volatile uint32_t intf0;
+    volatile uint32_t ints0;
+} dma_hw_t;
+
+extern dma_hw_t rthost_dma_hw;
+#define dma_hw  (&rthost_dma_hw)
+
+int dma_claim_unused_channel(bool required);
+dma_channel_config dma_channel_get_default_config(unsigned int channel);
+void dma_channel_configure(unsigned int channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, unsigned int transfer_count, bool trigger);
+void dma_channel_set_irq0_enabled(unsigned int channel, bool enabled);
+void dma_channel_transfer_from_buffer_now(unsigned int channel, const volatile void *read_addr,
+                                          uint32_t transfer_count);
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size)
+{
+    c->size = size;
+}
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr)
+{
+    c->read_increment = incr;
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr)
+{
+    c->write_increment = incr;
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, unsigned int dreq)
+{
+    c->dreq = dreq;
+}
+
+#endif /* RTHOST_HARDWARE_DMA_H__ */
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef RTHOST_HARDWARE_GPIO_H__
+#define RTHOST_HARDWARE_GPIO_H__
+
+/* nothing of it is used by the code under test, only included */
+
+#endif /* RTHOST_HARDWARE_GPIO_H__ */
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef RTHOST_HARDWARE_IRQ_H__
+#define RTHOST_HARDWARE_IRQ_H__
+
+#include <stdbool.h>
+
+/* the pico-sdk interrupt controller calls; the test that includes a driver defines them */
+#define DMA_IRQ_0       11
+#define UART0_IRQ       20
+#define UART1_IRQ       21
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY  0x80
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(unsigned int num, irq_handler_t handler);
+void irq_add_shared_handler(unsigned int num, irq_handler_t handler, unsigned char order_priority);
+void irq_set_enabled(unsigned int num, bool enabled);
+
+#endif /* RTHOST_HARDWARE_IRQ_H__ */
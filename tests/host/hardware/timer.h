@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef RTHOST_HARDWARE_TIMER_H__
+#define RTHOST_HARDWARE_TIMER_H__
+
+#include <stdint.h>
+#include <time.h>
+
+/* the pico-sdk microsecond timer, from the host's monotonic clock */
+static inline uint64_t time_us_64(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static inline uint32_t time_us_32(void)
+{
+    return (uint32_t)time_us_64();
+}
+
+#endif /* RTHOST_HARDWARE_TIMER_H__ */
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef RTHOST_HARDWARE_UART_H__
+#define RTHOST_HARDWARE_UART_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * The PL011 registers of the RP2040 as plain memory, and the pico-sdk
+ * calls on them; the test that includes a driver defines the calls and
+ * models what the hardware does with the registers.
+ */
+typedef struct
+{
+    volatile uint32_t dr;
+    volatile uint32_t rsr;
+    uint32_t _pad0[4];
+    volatile uint32_t fr;
+    uint32_t _pad1;
+    volatile uint32_t ilpr;
+    volatile uint32_t ibrd;
+    volatile uint32_t fbrd;
+    volatile uint32_t lcr_h;
+    volatile uint32_t cr;
+    volatile uint32_t ifls;
+    volatile uint32_t imsc;
+    volatile uint32_t ris;
+    volatile uint32_t mis;
+    volatile uint32_t icr;
+    volatile uint32_t dmacr;
+} uart_hw_t;
+
+typedef struct uart_inst uart_inst_t;
+
+extern uart_hw_t rthost_uart_hw[2];
+#define uart0   ((uart_inst_t *)&rthost_uart_hw[0])
+#define uart1   ((uart_inst_t *)&rthost_uart_hw[1])
+
+typedef enum
+{
+    UART_PARITY_NONE,
+    UART_PARITY_EVEN,
+    UART_PARITY_ODD,
+} uart_parity_t;
+
+#define UART_UARTIFLS_RXIFLSEL_LSB  3
+#define UART_UARTIFLS_RXIFLSEL_BITS 0x00000038
+#define UART_UARTIMSC_RXIM_BITS     0x00000010
+#define UART_UARTIMSC_RTIM_BITS     0x00000040
+#define UART_UARTMIS_RXMIS_BITS     0x00000010
+#define UART_UARTMIS_RTMIS_BITS     0x00000040
+
+static inline uart_hw_t *uart_get_hw(uart_inst_t *uart)
+{
+    return (uart_hw_t *)uart;
+}
+
+static inline void hw_write_masked(volatile uint32_t *addr, uint32_t values, uint32_t write_mask)
+{
+    *addr = (*addr & ~write_mask) | (values & write_mask);
+}
+
+unsigned int uart_init(uart_inst_t *uart, unsigned int baudrate);
+unsigned int uart_set_baudrate(uart_inst_t *uart, unsigned int baudrate);
+void uart_set_hw_flow(uart_inst_t *uart, bool cts, bool rts);
+void uart_set_format(uart_inst_t *uart, unsigned int data_bits, unsigned int stop_bits, uart_parity_t parity);
+void uart_set_fifo_enabled(uart_inst_t *uart, bool enabled);
+void uart_set_irq_enables(uart_inst_t *uart, bool rx_has_data, bool tx_needs_data);
+bool uart_is_readable(uart_inst_t *uart);
+void uart_putc_raw(uart_inst_t *uart, char c);
+
+#endif /* RTHOST_HARDWARE_UART_H__ */
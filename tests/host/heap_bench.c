@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./heap_bench [calls=100000] [seed=1] [pool size]
+ *
+ * rt-thread/src/mem.c (small) and rt-thread/src/tlsf.c, linked side by
+ * side, replaying one allocation trace each on a pool of the same size:
+ * the synthetic mix of the on-target heap_bench, many small objects, AT
+ * lines and HTTP bodies of a few hundred bytes and the odd kilobyte-sized
+ * batch, each living for a random number of calls. Per heap:
+ *
+ *   alloc   rt_smem_alloc() / rt_tlsf_alloc(), ns average / worst
+ *   free    rt_smem_free() / rt_tlsf_free(), ns average / worst
+ *   fail    allocations the heap could not satisfy
+ *   peak    the most the heap had in use, headers included
+ *   frag    the share of the free memory the largest allocation still
+ *           possible cannot reach, at the end of the trace
+ *
+ * The pool is half again the trace's peak by default, as on the target.
+ * Block headers are larger with the host's 8-byte pointers, so fail, peak
+ * and frag are not the board's figures, but both heaps pay the same; the
+ * on-target heap_bench also replays traces recorded from the application.
+ * Every block is filled when allocated and checked when freed, and both
+ * heaps must be back to empty after the trace.
+ */
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "rthost.h"
+
+#define BENCH_CALLS     100000
+#define BENCH_SLOTS     128         /* blocks followed at once */
+#define BENCH_FREE      0           /* size of a free in the trace */
+/* mem.c keeps the pool in 32 bits of each block header, so it must lie below 4 GB */
+#define BENCH_POOL_AT   ((void *)0x40000000)
+
+struct bench_op
+{
+    rt_uint32_t size;               /* bytes allocated, BENCH_FREE for a free */
+    rt_uint16_t slot;               /* which block, shared by its alloc and free */
+};
+
+struct bench_cost
+{
+    rt_uint64_t total;
+    rt_uint32_t count;
+    rt_uint32_t max;
+};
+
+struct bench_algo
+{
+    const char *name;
+    rt_mem_t (*init)(const char *name, void *begin_addr, rt_size_t size);
+    void *(*alloc)(rt_mem_t m, rt_size_t size);
+    void (*free)(rt_mem_t m, void *ptr);
+    rt_err_t (*detach)(rt_mem_t m);
+};
+
+static struct bench_op *bench_trace;
+static int bench_len;
+static rt_uint32_t bench_seed = 1;
+static rt_uint32_t bench_clock_cost;
+
+static rt_uint64_t bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (rt_uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static rt_uint32_t bench_rand(void)
+{
+    bench_seed = bench_seed * 1103515245 + 12345;
+    return bench_seed >> 8;
+}
+
+static void bench_add(struct bench_cost *cost, rt_uint64_t start)
+{
+    rt_uint64_t ns = bench_ns() - start;
+
+    ns = ns > bench_clock_cost ? ns - bench_clock_cost : 0;
+    cost->total += ns;
+    cost->count++;
+    if (ns > cost->max)
+        cost->max = ns;
+}
+
+/* the least two back-to-back clock reads ever differ by */
+static void bench_calibrate(void)
+{
+    rt_uint64_t t0, ns;
+    int i;
+
+    bench_clock_cost = ~0u;
+    for (i = 0; i < 10000; i++)
+    {
+        t0 = bench_ns();
+        ns = bench_ns() - t0;
+        if (ns < bench_clock_cost)
+            bench_clock_cost = ns;
+    }
+}
+
+/* the on-target heap_bench_synth(), with the same draws */
+static void bench_synth(int calls)
+{
+    rt_bool_t live[BENCH_SLOTS] = {0};
+    rt_uint32_t size, r;
+    int slot;
+
+    bench_trace = malloc(calls * sizeof(struct bench_op));
+    RTHOST_CHECK(bench_trace != RT_NULL, "no memory for %d calls", calls);
+    for (bench_len = 0; bench_len < calls; bench_len++)
+    {
+        slot = bench_rand() % BENCH_SLOTS;
+        bench_trace[bench_len].slot = slot;
+        if (live[slot])
+        {
+            live[slot] = RT_FALSE;
+            bench_trace[bench_len].size = BENCH_FREE;
+            continue;
+        }
+
+        r = bench_rand() % 100;
+        if (r < 55)
+            size = 8 + bench_rand() % 56;
+        else if (r < 90)
+            size = 64 + bench_rand() % 448;
+        else
+            size = 512 + bench_rand() % 1536;
+        live[slot] = RT_TRUE;
+        bench_trace[bench_len].size = size;
+    }
+}
+
+/* the most the trace has allocated at once, payload only */
+static rt_uint32_t bench_peak(void)
+{
+    rt_uint32_t live[BENCH_SLOTS] = {0};
+    rt_uint32_t now = 0, peak = 0;
+    int i;
+
+    for (i = 0; i < bench_len; i++)
+    {
+        now -= live[bench_trace[i].slot];
+        live[bench_trace[i].slot] = bench_trace[i].size;
+        now += bench_trace[i].size;
+        if (now > peak)
+            peak = now;
+    }
+
+    return peak;
+}
+
+/* the largest block the heap can still hand out in one piece */
+static rt_size_t bench_largest(const struct bench_algo *algo, rt_mem_t m)
+{
+    rt_size_t lo = 0, hi = m->total, mid;
+    void *p;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo + 1) / 2;
+        p = algo->alloc(m, mid);
+        if (p != RT_NULL)
+        {
+            algo->free(m, p);
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+
+    return lo;
+}
+
+/* the block in a slot holds its slot number, all through */
+static void bench_verify(const struct bench_algo *algo, const rt_uint8_t *p, rt_uint32_t size, int slot)
+{
+    rt_uint32_t i;
+
+    for (i = 0; i < size; i++)
+        RTHOST_CHECK(p[i] == (rt_uint8_t)slot, "%s: byte %u of slot %d overwritten", algo->name, i, slot);
+}
+
+static void bench_replay(const struct bench_algo *algo, void *pool, rt_size_t size)
+{
+    struct bench_cost alloc = {0}, release = {0};
+    void *blocks[BENCH_SLOTS] = {0};
+    rt_uint32_t sizes[BENCH_SLOTS] = {0};
+    const struct bench_op *op;
+    rt_size_t free_size, largest, empty;
+    int i, fail = 0;
+    rt_uint64_t t0;
+    rt_mem_t m;
+
+    m = algo->init("hbench", pool, size);
+    RTHOST_CHECK(m != RT_NULL, "%s: no heap in %d bytes", algo->name, (int)size);
+    empty = m->used;
+
+    for (i = 0; i < bench_len; i++)
+    {
+        op = &bench_trace[i];
+        if (blocks[op->slot] != RT_NULL)
+        {
+            bench_verify(algo, blocks[op->slot], sizes[op->slot], op->slot);
+            t0 = bench_ns();
+            algo->free(m, blocks[op->slot]);
+            bench_add(&release, t0);
+            blocks[op->slot] = RT_NULL;
+        }
+        if (op->size != BENCH_FREE)
+        {
+            t0 = bench_ns();
+            blocks[op->slot] = algo->alloc(m, op->size);
+            bench_add(&alloc, t0);
+            if (blocks[op->slot] == RT_NULL)
+            {
+                fail++;
+                continue;
+            }
+            memset(blocks[op->slot], op->slot, op->size);
+            sizes[op->slot] = op->size;
+        }
+    }
+
+    free_size = m->total - m->used;
+    largest = bench_largest(algo, m);
+    for (i = 0; i < BENCH_SLOTS; i++)
+    {
+        if (blocks[i] != RT_NULL)
+        {
+            bench_verify(algo, blocks[i], sizes[i], i);
+            algo->free(m, blocks[i]);
+        }
+    }
+
+    printf("%-5s: alloc %u/%u free %u/%u, fail %d, peak %d, frag %d%% (largest %d of %d free)\n", algo->name,
+           alloc.count ? (unsigned)(alloc.total / alloc.count) : 0, alloc.max,
+           release.count ? (unsigned)(release.total / release.count) : 0, release.max, fail, (int)m->max,
+           free_size ? 100 - (int)(largest * 100 / free_size) : 0, (int)largest, (int)free_size);
+    RTHOST_CHECK(m->used == empty, "%s: %d bytes in use after freeing everything", algo->name,
+                 (int)(m->used - empty));
+    algo->detach(m);
+}
+
+static void bench_smem_free(rt_mem_t m, void *ptr)
+{
+    rt_smem_free(ptr);
+}
+
+static const struct bench_algo bench_algos[] =
+{
+    {"small", rt_smem_init, rt_smem_alloc, bench_smem_free, rt_smem_detach},
+    {"tlsf", rt_tlsf_init, rt_tlsf_alloc, rt_tlsf_free, rt_tlsf_detach},
+};
+
+int main(int argc, char **argv)
+{
+    int calls = argc > 1 ? atoi(argv[1]) : BENCH_CALLS;
+    rt_uint32_t seed = argc > 2 ? strtoul(argv[2], RT_NULL, 0) : 1;
+    rt_size_t size;
+    void *pool;
+    int i;
+
+    RTHOST_CHECK(calls > 0, "no calls to replay");
+    bench_seed = seed;
+    bench_synth(calls);
+    size = argc > 3 ? strtoul(argv[3], RT_NULL, 0) : bench_peak() * 3 / 2 + 2048;
+
+    pool = mmap(BENCH_POOL_AT, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    RTHOST_CHECK(pool != MAP_FAILED && (uintptr_t)pool + size <= 0x100000000ull,
+                 "no %d byte pool below 4 GB", (int)size);
+    bench_calibrate();
+
+    printf("synthetic trace, seed %u, %d calls, %d byte pool, ns avg/max, %u ns per clock read taken off\n",
+           (unsigned)seed, bench_len, (int)size, bench_clock_cost);
+    for (i = 0; i < (int)(sizeof(bench_algos) / sizeof(bench_algos[0])); i++)
+        bench_replay(&bench_algos[i], pool, size);
+
+    munmap(pool, size);
+    free(bench_trace);
+
+    return 0;
+}
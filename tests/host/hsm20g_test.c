@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./hsm20g_test
+ *
+ * applications/hsm20g.c's interpolated tables against the datasheet
+ * polynomials in double precision, at every 12.4 fixed-point ADC code from
+ * 0 to 4095.9375: both conversions must stay within 0.05 units of the
+ * curve everywhere. The 12-bit codes of the polling path are among them.
+ * Only the conversion is tested, so the sensor framework part is left out.
+ */
+#include <math.h>
+
+#include "rthost.h"
+
+#undef HSM20G_USING_SENSOR
+#include "../../applications/hsm20g.c"
+
+#define HSM20G_TEST_MAX_ERR     0.05    /* degC and %RH */
+
+rt_err_t pico_adc_capture_read(struct pico_adc_block *block, rt_int32_t timeout)
+{
+    return -RT_ERROR;
+}
+
+static void hsm20g_test_curve(const char *name, int32_t (*convert)(uint32_t), double (*poly)(double))
+{
+    double v, err, max_err = 0;
+    uint32_t code, worst = 0;
+
+    for (code = 0; code < (4096 << PICO_ADC_FRAC_BITS); code++)
+    {
+        v = code * 3.3 / (4096 << PICO_ADC_FRAC_BITS);
+        err = fabs(convert(code) / 100.0 - poly(v));
+        RTHOST_CHECK(err <= HSM20G_TEST_MAX_ERR, "%s at code %u.%04u: %d is %.4f off %.4f", name,
+                     code >> PICO_ADC_FRAC_BITS, (code & ((1 << PICO_ADC_FRAC_BITS) - 1)) * 625,
+                     convert(code), err, poly(v));
+        if (err > max_err)
+        {
+            max_err = err;
+            worst = code;
+        }
+    }
+    printf("%s: %u codes, max error %.4f at code %u.%04u (limit %.2f)\n", name, code, max_err,
+           worst >> PICO_ADC_FRAC_BITS, (worst & ((1 << PICO_ADC_FRAC_BITS) - 1)) * 625, HSM20G_TEST_MAX_ERR);
+}
+
+static double hsm20g_test_temp(double v)
+{
+    return HSM20G_TEMP_POLY(v);
+}
+
+static double hsm20g_test_humid(double v)
+{
+    return HSM20G_HUMID_POLY(v);
+}
+
+int main(int argc, char **argv)
+{
+    hsm20g_test_curve("temperature", hsm20g_temperature, hsm20g_test_temp);
+    hsm20g_test_curve("humidity", hsm20g_humidity, hsm20g_test_humid);
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./mkt_test
+ *
+ * applications/mkt.c against double precision. The interpolated Q31
+ * Arrhenius weights are checked at every 0.01 degC of the table's range
+ * against exp(), and mkt_from_sum() must give back the temperature a sum
+ * of exact weights stands for. Then synthetic traces go through the
+ * streaming engine, and every window is compared with MKT and excursion
+ * time computed with exp() per sample over exactly the samples the window
+ * should hold. The traces run once from a low tick and once across the
+ * tick wrapping around; the reference counts hours on a 64-bit tick.
+ */
+#include <math.h>
+#include <string.h>
+
+#include "rthost.h"
+
+#include "../../applications/mkt.c"
+
+#define MKT_TEST_MAX_ERR    1           /* 0.01 degC */
+#define MKT_TEST_MAX_REL    0.0014      /* weight interpolation, see mkt.c */
+
+struct mkt_ref
+{
+    double sum;
+    rt_uint32_t count;
+    rt_uint64_t band_ms[MKT_BAND_MAX];
+};
+
+static struct mkt mkt_test;
+static rt_uint32_t mkt_test_seed;
+
+/* the weight mkt_table tabulates, in units of the weight at MKT_TABLE_MAX */
+static double mkt_ref_weight(rt_int32_t temperature)
+{
+    return exp(MKT_E_OVER_R * (1 / MKT_T_TOP - 1 / ((temperature + MKT_KELVIN) / 100.0)));
+}
+
+static void mkt_test_table(void)
+{
+    double exact, rel, max_rel = 0;
+    rt_int32_t t, got, max_err = 0;
+    rt_uint64_t sum;
+
+    for (t = MKT_TABLE_MIN; t <= MKT_TABLE_MAX; t++)
+    {
+        /* the chords of a convex curve lie above it, give or take the rounding to Q31 */
+        exact = mkt_ref_weight(t) * MKT_WEIGHT_ONE;
+        RTHOST_CHECK(mkt_weight(t) >= exact - 1, "the weight at %d is %u, below exp()'s %.1f", t, mkt_weight(t),
+                     exact);
+        rel = (mkt_weight(t) - 1) / exact - 1;
+        if (rel > max_rel)
+            max_rel = rel;
+
+        /* a thousand samples of one temperature average to it */
+        sum = (rt_uint64_t)(mkt_ref_weight(t) * MKT_WEIGHT_ONE * 1000 + 0.5);
+        got = mkt_from_sum(sum, 1000);
+        RTHOST_CHECK(got == t, "mkt_from_sum() of %d is %d", t, got);
+
+        got = abs(mkt_from_sum(mkt_weight(t), 1) - t);
+        if (got > max_err)
+            max_err = got;
+    }
+    printf("table: %d..%d, weights at most %.4f %% over exp(), MKT of one sample off by %d\n", MKT_TABLE_MIN,
+           MKT_TABLE_MAX, max_rel * 100, max_err);
+    RTHOST_CHECK(max_rel <= MKT_TEST_MAX_REL, "the weights are %g over exp()", max_rel);
+    RTHOST_CHECK(max_err <= MKT_TEST_MAX_ERR, "one sample's MKT is %d off", max_err);
+    RTHOST_CHECK(mkt_weight(MKT_TABLE_MIN - 500) == mkt_table[0]
+                 && mkt_weight(MKT_TABLE_MAX + 500) == mkt_table[MKT_TABLE_LEN - 1],
+                 "readings outside the table do not weigh as its ends");
+    RTHOST_CHECK(mkt_from_sum(0, 0) == MKT_NONE, "an empty window has an MKT");
+}
+
+static rt_int32_t mkt_test_rand(rt_int32_t lo, rt_int32_t hi)
+{
+    mkt_test_seed = mkt_test_seed * 1103515245 + 12345;
+    return lo + (rt_int32_t)((mkt_test_seed >> 8) % (rt_uint32_t)(hi - lo + 1));
+}
+
+static rt_int32_t mkt_test_ref_mkt(const struct mkt_ref *ref)
+{
+    double kelvin;
+
+    if (ref->count == 0)
+        return MKT_NONE;
+    kelvin = MKT_E_OVER_R / -log(ref->sum / ref->count);
+    return (rt_int32_t)floor(kelvin * 100 - MKT_KELVIN + 0.5);
+}
+
+/*
+ * trace 0: constant 5 degC, 2 s
+ * trace 1: 2..8 degC sine, 1 h period, 2 s, one day
+ * trace 2: random walk over -40..85 degC, 30 s, 9 days, with gaps
+ * trace 3: one reading every three days
+ *
+ * Traces are generated, not stored, and replayed for each reference.
+ */
+static rt_int32_t mkt_test_sample(int trace, rt_uint32_t i, rt_uint64_t *tick, rt_int32_t prev)
+{
+    switch (trace)
+    {
+    case 0:
+        *tick += 2 * RT_TICK_PER_SECOND;
+        return 500;
+    case 1:
+        *tick += 2 * RT_TICK_PER_SECOND;
+        return 500 + (rt_int32_t)floor(300 * sin(i * 2 * 3.14159265358979 / 1800) + 0.5);
+    case 2:
+        *tick += (mkt_test_rand(0, 99) ? 30 : mkt_test_rand(60, 7200)) * RT_TICK_PER_SECOND;
+        prev += mkt_test_rand(-150, 150);
+        return prev < MKT_TABLE_MIN ? MKT_TABLE_MIN : prev > MKT_TABLE_MAX ? MKT_TABLE_MAX : prev;
+    default:
+        *tick += 3 * 24 * MKT_HOUR_TICKS;
+        return mkt_test_rand(-500, 1500);
+    }
+}
+
+/* reference sums over the samples a window holds once `end` is the newest */
+static void mkt_test_reference(int trace, rt_uint32_t n, rt_uint64_t start, rt_uint32_t hours, rt_uint64_t end,
+                               struct mkt_ref *ref)
+{
+    rt_uint64_t tick = start, prev_tick = 0;
+    rt_int32_t t = 500;
+    rt_uint32_t i, dt;
+    int band;
+
+    memset(ref, 0, sizeof(*ref));
+    mkt_test_seed = trace + 1;
+    for (i = 0; i < n; i++)
+    {
+        t = mkt_test_sample(trace, i, &tick, t);
+        dt = i && tick - prev_tick <= MKT_MAX_GAP_TICKS ? (tick - prev_tick) * 1000 / RT_TICK_PER_SECOND : 0;
+        prev_tick = tick;
+        if (hours && tick / MKT_HOUR_TICKS + hours <= end / MKT_HOUR_TICKS)
+            continue;
+
+        ref->sum += exp(-MKT_E_OVER_R / ((t + MKT_KELVIN) / 100.0));
+        ref->count++;
+        band = mkt_band_of(t);
+        if (band >= 0)
+            ref->band_ms[band] += dt;
+    }
+}
+
+static void mkt_test_trace(int trace, rt_uint32_t n, rt_uint64_t start)
+{
+    static const rt_uint32_t hours[MKT_WINDOW_MAX] = {24, MKT_HOURS, 0};
+    static const char *const names[MKT_WINDOW_MAX] = {"24 h", "7 d", "boot"};
+    struct mkt_report report;
+    struct mkt_ref ref;
+    rt_uint64_t tick = start;
+    rt_int32_t t = 500, expect, err, max_err = 0;
+    rt_uint32_t i, w, b;
+
+    memset(&mkt_test, 0, sizeof(mkt_test));
+    mkt_test_seed = trace + 1;
+    for (i = 0; i < n; i++)
+    {
+        t = mkt_test_sample(trace, i, &tick, t);
+        mkt_engine_add(&mkt_test, t, (rt_tick_t)tick);
+    }
+
+    for (w = 0; w < MKT_WINDOW_MAX; w++)
+    {
+        mkt_test_reference(trace, n, start, hours[w], tick, &ref);
+        mkt_engine_get(&mkt_test, w, &report);
+
+        expect = mkt_test_ref_mkt(&ref);
+        RTHOST_CHECK((report.mkt == MKT_NONE) == (expect == MKT_NONE), "trace %d from %#llx, %s: MKT %d, %d wanted",
+                     trace, (unsigned long long)start, names[w], report.mkt, expect);
+        err = abs(report.mkt - expect);
+        if (err > max_err)
+            max_err = err;
+
+        RTHOST_CHECK(report.samples == ref.count, "trace %d from %#llx, %s: %u samples, %u wanted", trace,
+                     (unsigned long long)start, names[w], report.samples, ref.count);
+        for (b = 0; b < MKT_BAND_MAX; b++)
+            RTHOST_CHECK(report.excursion_min[b] == ref.band_ms[b] / 60000,
+                         "trace %d from %#llx, %s: %u min %s, %u wanted", trace, (unsigned long long)start,
+                         names[w], report.excursion_min[b], mkt_band_name(b),
+                         (rt_uint32_t)(ref.band_ms[b] / 60000));
+    }
+
+    printf("trace %d from tick %#llx to %#llx: %u samples, max MKT error %d (0.01 degC)\n", trace,
+           (unsigned long long)start, (unsigned long long)tick, n, max_err);
+    RTHOST_CHECK(max_err <= MKT_TEST_MAX_ERR, "trace %d: MKT %d off", trace, max_err);
+}
+
+int main(void)
+{
+    /* a few days short of the wrap, and not on an hour */
+    const rt_uint64_t wrap = 0x100000000ull - 4 * 24 * MKT_HOUR_TICKS - 12345;
+
+    RTHOST_CHECK(mkt_init() == RT_EOK, "no lock");
+    mkt_test_table();
+
+    mkt_test_trace(0, 1000, 12345);
+    mkt_test_trace(1, 24 * 1800, 12345);
+    mkt_test_trace(2, 9 * 24 * 120, 12345);
+    mkt_test_trace(3, 10, 12345);
+
+    mkt_test_trace(1, 24 * 1800, 0x100000000ull - 12 * MKT_HOUR_TICKS - 12345);
+    mkt_test_trace(2, 9 * 24 * 120, wrap);
+    mkt_test_trace(3, 10, wrap);
+
+    return 0;
+}
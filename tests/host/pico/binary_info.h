@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef RTHOST_PICO_BINARY_INFO_H__
+#define RTHOST_PICO_BINARY_INFO_H__
+
+/* binary info only annotates the image; nothing to stand in for */
+
+#endif /* RTHOST_PICO_BINARY_INFO_H__ */
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef RTHOST_PICO_STDLIB_H__
+#define RTHOST_PICO_STDLIB_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/timer.h"
+
+/* the pico-sdk error codes the drivers check for */
+enum pico_error_codes
+{
+    PICO_OK = 0,
+    PICO_ERROR_GENERIC = -1,
+    PICO_ERROR_TIMEOUT = -2,
+};
+
+#endif /* RTHOST_PICO_STDLIB_H__ */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./reading_stress [seconds] [readers]
+ *
+ * applications/reading.c under real concurrency: one pthread publishes
+ * readings as fast as it can while the readers copy them. Every field of
+ * a reading is derived from its generation, so a copy that mixes two
+ * readings, or one that goes back in time, is caught. Build it with
+ * -fsanitize=thread as well to have the accesses checked.
+ */
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "rthost.h"
+
+#include "../../applications/reading.c"
+
+#define READERS_MAX     16
+
+static struct reading_snapshot snap;
+static volatile int stop;
+
+struct reader_result
+{
+    unsigned long reads, retries, torn, backwards;
+};
+
+static void reading_of(rt_uint32_t n, struct reading *r)
+{
+    r->temperature = (rt_int32_t)n;
+    r->humidity = (rt_int32_t)~n;
+    r->tick = n * 2654435761u;
+    r->flags = n ^ 0x5a5a5a5a;
+}
+
+static void *writer(void *arg)
+{
+    unsigned long *published = arg;
+    struct reading r;
+    rt_uint32_t n = 0;
+
+    while (!__atomic_load_n(&stop, __ATOMIC_RELAXED))
+    {
+        reading_of(++n, &r);
+        reading_publish(&snap, &r);
+    }
+    *published = n;
+
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    struct reader_result *res = arg;
+    struct reading r, want;
+    rt_uint32_t gen, last = 0, retries = 0;
+
+    while (!__atomic_load_n(&stop, __ATOMIC_RELAXED))
+    {
+        gen = reading_copy(&snap, &r, &retries);
+        res->reads++;
+        if (gen == 0)
+            continue;
+
+        reading_of(gen, &want);
+        if (memcmp(&r, &want, sizeof(r)) != 0)
+            res->torn++;
+        if (gen < last)
+            res->backwards++;
+        last = gen;
+    }
+    res->retries = retries;
+
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    int seconds = argc > 1 ? atoi(argv[1]) : 2;
+    int readers = argc > 2 ? atoi(argv[2]) : 4;
+    struct reader_result res[READERS_MAX] = {0}, sum = {0};
+    pthread_t wt, rt[READERS_MAX];
+    unsigned long published = 0;
+    int i;
+
+    if (readers < 1 || readers > READERS_MAX)
+        readers = 4;
+
+    reading_snapshot_init(&snap);
+    pthread_create(&wt, NULL, writer, &published);
+    for (i = 0; i < readers; i++)
+        pthread_create(&rt[i], NULL, reader, &res[i]);
+
+    sleep(seconds);
+    __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+
+    pthread_join(wt, NULL);
+    for (i = 0; i < readers; i++)
+    {
+        pthread_join(rt[i], NULL);
+        sum.reads += res[i].reads;
+        sum.retries += res[i].retries;
+        sum.torn += res[i].torn;
+        sum.backwards += res[i].backwards;
+    }
+
+    printf("%lu published, %lu reads by %d readers, %lu retries, %lu torn, %lu out of order\n",
+           published, sum.reads, readers, sum.retries, sum.torn, sum.backwards);
+    RTHOST_CHECK(published > 0 && sum.reads > 0, "nothing ran");
+    RTHOST_CHECK(sum.torn == 0 && sum.backwards == 0, "inconsistent copies");
+
+    return 0;
+}
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./ring_bench [megabytes=16]
+ *
+ * rt-thread/components/drivers/ipc/spscring.c against ringbuffer.c, both
+ * with a 1024 byte ring as the on-target ring_bench. Megabytes go through
+ * in chunks of 1, 16 and 128 bytes; each chunk comes from a source buffer
+ * and is summed on the way out, as by a parser.
+ *
+ * On one thread, in ns per chunk:
+ *
+ *   rb        rt_ringbuffer_put/get
+ *   spsc      rt_spscring_put/get
+ *   inplace   rt_spscring_reserve/commit and peek_span/consume, the sum
+ *             taken in the ring without the copy out
+ *
+ * Between a producer and a consumer thread, in MB/s:
+ *
+ *   rb+lock   rt_ringbuffer with a mutex around every call, which it
+ *             needs when the two sides run at once
+ *   spsc      rt_spscring_put/get, no lock
+ *   inplace   reserve/commit against peek_span/consume, no lock
+ *
+ * The on-target ring_bench gives the one-thread figures in cycles of the
+ * M0+, with interrupts masked for rt_ringbuffer as an interrupt producer
+ * needs; the two-thread ones are what the lock costs with the sides on
+ * as many cores as the host has. Every sum is checked against the bytes
+ * sent.
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+
+#include "rthost.h"
+
+#include "../../rt-thread/components/drivers/ipc/ringbuffer.c"
+#include "../../rt-thread/components/drivers/ipc/spscring.c"
+
+#define BENCH_SIZE          1024    /* bytes in the ring */
+#define BENCH_CHUNK_MAX     128
+
+enum bench_kind
+{
+    BENCH_RB,
+    BENCH_SPSC,
+    BENCH_INPLACE,
+};
+
+static const char *const bench_name[] = {"rb", "spsc", "inplace"};
+
+static rt_uint8_t bench_pool[BENCH_SIZE];
+static rt_uint8_t bench_src[BENCH_CHUNK_MAX];
+
+static struct
+{
+    enum bench_kind kind;
+    rt_size_t chunk;
+    rt_uint64_t total;
+    struct rt_ringbuffer rb;
+    struct rt_spscring spsc;
+    pthread_mutex_t lock;
+} bench;
+
+static rt_uint64_t bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (rt_uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static rt_uint32_t bench_sum(const rt_uint8_t *p, rt_size_t n)
+{
+    rt_uint32_t sum = 0;
+
+    while (n--)
+        sum += *p++;
+    return sum;
+}
+
+/* what total bytes of the source, chunk by chunk, sum to */
+static rt_uint32_t bench_expect(rt_uint64_t total, rt_size_t chunk)
+{
+    return (rt_uint32_t)(total / chunk) * bench_sum(bench_src, chunk);
+}
+
+/* ns per chunk to move total bytes through the ring on this thread */
+static rt_uint32_t bench_one(enum bench_kind kind, rt_uint64_t total, rt_size_t chunk)
+{
+    rt_uint8_t dst[BENCH_CHUNK_MAX], *span;
+    rt_uint64_t moved, start;
+    rt_uint32_t sum = 0;
+    rt_size_t n;
+
+    rt_ringbuffer_init(&bench.rb, bench_pool, sizeof(bench_pool));
+    rt_spscring_init(&bench.spsc, bench_pool, sizeof(bench_pool));
+
+    start = bench_ns();
+    for (moved = 0; moved < total; moved += chunk)
+    {
+        switch (kind)
+        {
+        case BENCH_RB:
+            rt_ringbuffer_put(&bench.rb, bench_src, chunk);
+            n = rt_ringbuffer_get(&bench.rb, dst, chunk);
+            sum += bench_sum(dst, n);
+            break;
+
+        case BENCH_SPSC:
+            rt_spscring_put(&bench.spsc, bench_src, chunk);
+            n = rt_spscring_get(&bench.spsc, dst, chunk);
+            sum += bench_sum(dst, n);
+            break;
+
+        case BENCH_INPLACE:
+            /* the chunk size divides the ring, so a span never wraps */
+            n = rt_spscring_reserve(&bench.spsc, &span, chunk);
+            memcpy(span, bench_src, n);
+            rt_spscring_commit(&bench.spsc, n);
+            n = rt_spscring_peek_span(&bench.spsc, &span);
+            sum += bench_sum(span, n);
+            rt_spscring_consume(&bench.spsc, n);
+            break;
+        }
+    }
+    start = bench_ns() - start;
+    RTHOST_CHECK(sum == bench_expect(total, chunk), "%s, chunk %d: the sum is %u, %u wanted", bench_name[kind],
+                 (int)chunk, sum, bench_expect(total, chunk));
+
+    return (rt_uint32_t)(start * chunk / total);
+}
+
+static void *bench_producer(void *arg)
+{
+    rt_uint64_t moved = 0;
+    rt_uint8_t *span;
+    rt_size_t n;
+
+    while (moved < bench.total)
+    {
+        switch (bench.kind)
+        {
+        case BENCH_RB:
+            pthread_mutex_lock(&bench.lock);
+            n = rt_ringbuffer_put(&bench.rb, bench_src, bench.chunk);
+            pthread_mutex_unlock(&bench.lock);
+            break;
+
+        case BENCH_SPSC:
+            n = rt_spscring_put(&bench.spsc, bench_src, bench.chunk);
+            break;
+
+        default:
+            n = rt_spscring_reserve(&bench.spsc, &span, bench.chunk);
+            memcpy(span, bench_src, n);
+            rt_spscring_commit(&bench.spsc, n);
+            break;
+        }
+        /* whole chunks only, so the consumer's sum comes out the same */
+        RTHOST_CHECK(n == 0 || n == bench.chunk, "a chunk of %d split", (int)bench.chunk);
+        if (n == 0)
+            sched_yield();
+        moved += n;
+    }
+
+    return NULL;
+}
+
+/* MB/s from a producer thread to this one */
+static rt_uint32_t bench_two(enum bench_kind kind, rt_uint64_t total, rt_size_t chunk)
+{
+    rt_uint8_t dst[BENCH_CHUNK_MAX], *span;
+    rt_uint64_t moved = 0, start;
+    rt_uint32_t sum = 0;
+    pthread_t pt;
+    rt_size_t n;
+
+    rt_ringbuffer_init(&bench.rb, bench_pool, sizeof(bench_pool));
+    rt_spscring_init(&bench.spsc, bench_pool, sizeof(bench_pool));
+    bench.kind = kind;
+    bench.chunk = chunk;
+    bench.total = total;
+
+    start = bench_ns();
+    pthread_create(&pt, NULL, bench_producer, NULL);
+    while (moved < total)
+    {
+        switch (kind)
+        {
+        case BENCH_RB:
+            pthread_mutex_lock(&bench.lock);
+            n = rt_ringbuffer_get(&bench.rb, dst, chunk);
+            pthread_mutex_unlock(&bench.lock);
+            sum += bench_sum(dst, n);
+            break;
+
+        case BENCH_SPSC:
+            n = rt_spscring_get(&bench.spsc, dst, chunk);
+            sum += bench_sum(dst, n);
+            break;
+
+        default:
+            /* a chunk at a time, as the producer committed them */
+            n = rt_spscring_peek_span(&bench.spsc, &span);
+            if (n > chunk)
+                n = chunk;
+            sum += bench_sum(span, n);
+            rt_spscring_consume(&bench.spsc, n);
+            break;
+        }
+        if (n == 0)
+            sched_yield();
+        moved += n;
+    }
+    pthread_join(pt, NULL);
+    start = bench_ns() - start;
+    RTHOST_CHECK(sum == bench_expect(total, chunk), "%s, chunk %d, two threads: the sum is %u, %u wanted",
+                 bench_name[kind], (int)chunk, sum, bench_expect(total, chunk));
+
+    return (rt_uint32_t)(total * 1000 / start);
+}
+
+int main(int argc, char **argv)
+{
+    static const rt_size_t chunks[] = {1, 16, BENCH_CHUNK_MAX};
+    rt_uint64_t total = (argc > 1 ? strtoul(argv[1], RT_NULL, 0) : 16) << 20;
+    int i, kind;
+
+    RTHOST_CHECK(total > 0, "no bytes to move");
+    for (i = 0; i < (int)sizeof(bench_src); i++)
+        bench_src[i] = i;
+    pthread_mutex_init(&bench.lock, NULL);
+
+    printf("%d MB through a %d byte ring, one thread, ns per chunk\n", (int)(total >> 20), BENCH_SIZE);
+    for (i = 0; i < (int)(sizeof(chunks) / sizeof(chunks[0])); i++)
+    {
+        printf("chunk %3d:", (int)chunks[i]);
+        for (kind = BENCH_RB; kind <= BENCH_INPLACE; kind++)
+            printf(" %s %u", bench_name[kind], bench_one((enum bench_kind)kind, total, chunks[i]));
+        printf("\n");
+    }
+
+#if defined(__SANITIZE_THREAD__)
+    printf("two threads skipped: ThreadSanitizer does not model the ring's fences\n");
+    return 0;
+#endif
+    printf("two threads, MB/s\n");
+    for (i = 0; i < (int)(sizeof(chunks) / sizeof(chunks[0])); i++)
+    {
+        printf("chunk %3d:", (int)chunks[i]);
+        for (kind = BENCH_RB; kind <= BENCH_INPLACE; kind++)
+        {
+            printf(" %s %u", kind == BENCH_RB ? "rb+lock" : bench_name[kind],
+                   bench_two((enum bench_kind)kind, total, chunks[i]));
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
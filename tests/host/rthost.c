@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#include <stdarg.h>
+#include <string.h>
+
+#include "rthost.h"
+
+rt_tick_t rthost_tick;
+int rthost_irq_off;
+
+int rt_kprintf(const char *fmt, ...)
+{
+    va_list args;
+    int n;
+
+    va_start(args, fmt);
+    n = vprintf(fmt, args);
+    va_end(args);
+
+    return n;
+}
+
+int rt_snprintf(char *buf, rt_size_t size, const char *fmt, ...)
+{
+    va_list args;
+    int n;
+
+    va_start(args, fmt);
+    n = vsnprintf(buf, size, fmt, args);
+    va_end(args);
+
+    return n;
+}
+
+void rt_assert_handler(const char *ex, const char *func, rt_size_t line)
+{
+    printf("FAIL assertion \"%s\" in %s:%d\n", ex, func, (int)line);
+    abort();
+}
+
+void *rt_memset(void *s, int c, rt_ubase_t n)
+{
+    return memset(s, c, n);
+}
+
+void *rt_memcpy(void *dst, const void *src, rt_ubase_t n)
+{
+    return memcpy(dst, src, n);
+}
+
+rt_int32_t rt_strcmp(const char *a, const char *b)
+{
+    return strcmp(a, b);
+}
+
+rt_size_t rt_strlen(const char *s)
+{
+    return strlen(s);
+}
+
+rt_int32_t rt_strncmp(const char *a, const char *b, rt_size_t n)
+{
+    return strncmp(a, b, n);
+}
+
+char *rt_strncpy(char *dst, const char *src, rt_size_t n)
+{
+    return strncpy(dst, src, n);
+}
+
+int rt_vsnprintf(char *buf, rt_size_t size, const char *fmt, va_list args)
+{
+    return vsnprintf(buf, size, fmt, args);
+}
+
+void *rt_malloc(rt_size_t size)
+{
+    return malloc(size);
+}
+
+void *rt_calloc(rt_size_t count, rt_size_t size)
+{
+    return calloc(count, size);
+}
+
+void rt_free(void *ptr)
+{
+    free(ptr);
+}
+
+rt_tick_t rt_tick_get(void)
+{
+    return rthost_tick;
+}
+
+rt_err_t rt_thread_delay(rt_tick_t tick)
+{
+    rthost_tick += tick;
+    return RT_EOK;
+}
+
+rt_err_t rt_thread_mdelay(rt_int32_t ms)
+{
+    rthost_tick += rt_tick_from_millisecond(ms);
+    return RT_EOK;
+}
+
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms)
+{
+    return (rt_tick_t)ms * RT_TICK_PER_SECOND / 1000;
+}
+
+rt_base_t rt_hw_interrupt_disable(void)
+{
+    return rthost_irq_off++;
+}
+
+void rt_hw_interrupt_enable(rt_base_t level)
+{
+    rthost_irq_off = (int)level;
+}
+
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_detach(rt_mutex_t mutex)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_init(rt_sem_t sem, const char *name, rt_uint32_t value, rt_uint8_t flag)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_detach(rt_sem_t sem)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_release(rt_sem_t sem)
+{
+    return RT_EOK;
+}
+
+/* no threads: code that starts one sees it fail */
+rt_thread_t rt_thread_create(const char *name, void (*entry)(void *parameter), void *parameter,
+                             rt_uint32_t stack_size, rt_uint8_t priority, rt_uint32_t tick)
+{
+    return RT_NULL;
+}
+
+rt_err_t rt_thread_startup(rt_thread_t thread)
+{
+    return -RT_ERROR;
+}
+
+rt_thread_t rt_thread_self(void)
+{
+    return RT_NULL;
+}
+
+/* no scheduler: whoever was woken runs when the test gets to it */
+void rt_schedule(void)
+{
+}
+
+int __rt_ffs(int value)
+{
+    return __builtin_ffs(value);
+}
+
+/*
+ * Objects are only marked with their class, static ones are never
+ * registered anywhere and there is no heap for the others.
+ */
+void (*rt_object_take_hook)(struct rt_object *object);
+void (*rt_object_put_hook)(struct rt_object *object);
+
+void rt_object_init(struct rt_object *object, enum rt_object_class_type type, const char *name)
+{
+    object->type = type | RT_Object_Class_Static;
+}
+
+void rt_object_detach(rt_object_t object)
+{
+    object->type = 0;
+}
+
+rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
+{
+    return RT_NULL;
+}
+
+void rt_object_delete(rt_object_t object)
+{
+}
+
+rt_uint8_t rt_object_get_type(rt_object_t object)
+{
+    return object->type & ~RT_Object_Class_Static;
+}
+
+rt_bool_t rt_object_is_systemobject(rt_object_t object)
+{
+    return (object->type & RT_Object_Class_Static) ? RT_TRUE : RT_FALSE;
+}
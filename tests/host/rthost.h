@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef RTHOST_H__
+#define RTHOST_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <rtthread.h>
+#include <rthw.h>
+
+/*
+ * Kernel stand-ins for the host tests, in rthost.c.
+ *
+ * There is no scheduler: the tick only moves when a test sets it or
+ * sleeps, and the IPC calls succeed at once, which is right for code that
+ * a test drives from a single thread. Tests that race the code under test
+ * against itself use pthreads, and only on code that takes no kernel lock.
+ * Objects can be initialised and detached, but not looked up or allocated.
+ */
+
+/* what rt_tick_get() returns; rt_thread_delay/mdelay move it on */
+extern rt_tick_t rthost_tick;
+
+/* rt_hw_interrupt_disable() nesting, 0 when "interrupts" are on */
+extern int rthost_irq_off;
+
+#define RTHOST_CHECK(cond, ...)                                     \
+    do                                                              \
+    {                                                               \
+        if (!(cond))                                                \
+        {                                                           \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);             \
+            printf(__VA_ARGS__);                                    \
+            printf("\n");                                           \
+            exit(1);                                                \
+        }                                                           \
+    } while (0)
+
+#endif /* RTHOST_H__ */
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./sample_codec_fuzz [rounds=20000]
+ *
+ * applications/sample_codec.c through msh>sample_codec_bench: the size
+ * and speed table for the synthetic traces, then `rounds` random streams
+ * round-tripped through buffers of random size and cut short. The times
+ * are the PC's, only the sizes compare with a board.
+ */
+#include "rthost.h"
+
+#define SAMPLE_CODEC_USING_BENCH
+#include "../../applications/sample_codec.c"
+
+int main(int argc, char **argv)
+{
+    char *args[] = {"sample_codec_bench", argc > 1 ? argv[1] : "20000"};
+
+    RTHOST_CHECK(sample_codec_bench(2, args) == RT_EOK, "the codec did not round-trip");
+
+    return 0;
+}
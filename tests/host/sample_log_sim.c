@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./sample_log_sim
+ *
+ * applications/sample_log.c on its "logsim" RAM flash: the selftest that
+ * msh>sample_log_selftest runs on a board, with its power cuts, reopens
+ * and read-backs. FAL is reduced to the one partition, straight onto the
+ * simulated flash device.
+ */
+#include <string.h>
+
+#include "rthost.h"
+
+#define SAMPLE_LOG_USING_SELFTEST
+#include "../../applications/sample_log.c"
+
+static const struct fal_partition sim_part =
+{
+    .name = "logsim",
+    .flash_name = "logsim",
+    .offset = 0,
+    .len = 16 * 1024,
+};
+
+const struct fal_partition *fal_partition_find(const char *name)
+{
+    return strcmp(name, sim_part.name) ? RT_NULL : &sim_part;
+}
+
+int fal_partition_read(const struct fal_partition *part, uint32_t addr, uint8_t *buf, size_t size)
+{
+    return sample_log_sim_flash.ops.read(part->offset + addr, buf, size);
+}
+
+int fal_partition_write(const struct fal_partition *part, uint32_t addr, const uint8_t *buf, size_t size)
+{
+    return sample_log_sim_flash.ops.write(part->offset + addr, buf, size);
+}
+
+int fal_partition_erase(const struct fal_partition *part, uint32_t addr, size_t size)
+{
+    return sample_log_sim_flash.ops.erase(part->offset + addr, size);
+}
+
+int main(void)
+{
+    RTHOST_CHECK(sample_log_selftest(0, RT_NULL) == RT_EOK, "the sample log selftest failed");
+
+    return 0;
+}
@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./sim800_sim
+ *
+ * applications/sim800_http.c against the fake modem of sim800_fake.c, in
+ * simulated time. The AT client here is a synchronous stand-in: a command
+ * is written to the fake, and the replies it queues are parsed as they
+ * fall due, the way the client's parser thread would, until the final
+ * result code or the command's timeout. So the time every state of the
+ * upload takes is exactly the modem's latency, and is checked as such: a
+ * first post brings the connection up, later ones only send the data, and
+ * a drop, a mute modem, a server error and the SMS paths each take the
+ * steps and the time they should.
+ */
+#include <stdarg.h>
+#include <string.h>
+
+#include "rthost.h"
+#include <at.h>
+#include "sim800_http.h"
+
+#define SIM800_USING_FAKE_MODEM
+#include "../../rt-thread/components/drivers/ipc/spscring.c"
+#include "../../applications/sim800_fake.c"
+
+#define SIM_REPLIES     32
+#define SIM_URL         "api.thingspeak.com/update"
+#define SIM_BODY        "api_key=XXXXXXXXXXXXXXXX&field1=2345&field2=61"
+
+/* what the fake modem has said and the client not yet heard, and when */
+static struct
+{
+    struct fmodem_reply reply;
+    rt_tick_t due;
+} sim_replies[SIM_REPLIES];
+static rt_uint32_t sim_head, sim_tail;
+static rt_tick_t sim_last_due;
+
+static struct at_client sim_client;
+static struct rt_mutex sim_client_lock, sim_http_lock;
+static struct rt_semaphore sim_action;
+static const struct at_urc *sim_urc;
+static rt_size_t sim_urc_size;
+static char sim_line[SIM800_RECV_BUFF_LEN];
+static rt_size_t sim_line_len;
+static int sim_final;               /* 1 for OK, -1 for ERROR, 0 while there is none */
+
+/* the fake's worker thread: each reply waits for the one before it, then its delay */
+rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    const struct fmodem_reply *reply = buffer;
+    rt_tick_t start = (rt_int32_t)(sim_last_due - rthost_tick) > 0 ? sim_last_due : rthost_tick;
+
+    RTHOST_CHECK(sim_tail - sim_head < SIM_REPLIES, "the fake modem has too much to say");
+    sim_replies[sim_tail % SIM_REPLIES].reply = *reply;
+    sim_replies[sim_tail % SIM_REPLIES].due = sim_last_due = start + rt_tick_from_millisecond(reply->delay_ms);
+    sim_tail++;
+
+    return RT_EOK;
+}
+
+rt_mq_t rt_mq_create(const char *name, rt_size_t msg_size, rt_size_t max_msgs, rt_uint8_t flag)
+{
+    return RT_NULL;
+}
+
+rt_err_t rt_mq_recv(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t timeout)
+{
+    return -RT_ETIMEOUT;
+}
+
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags)
+{
+    return RT_EOK;
+}
+
+rt_ssize_t rt_device_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    return dev->write(dev, pos, buffer, size);
+}
+
+static const struct at_urc *sim_urc_match(void)
+{
+    rt_size_t i, prefix, suffix;
+
+    for (i = 0; i < sim_urc_size; i++)
+    {
+        prefix = strlen(sim_urc[i].cmd_prefix);
+        suffix = strlen(sim_urc[i].cmd_suffix);
+        if (sim_line_len >= prefix + suffix && !memcmp(sim_line, sim_urc[i].cmd_prefix, prefix)
+            && !memcmp(sim_line + sim_line_len - suffix, sim_urc[i].cmd_suffix, suffix))
+            return &sim_urc[i];
+    }
+
+    return RT_NULL;
+}
+
+/* one byte from the modem, as the client's parser takes it */
+static void sim_recv(char ch)
+{
+    at_response_t resp = sim_client.resp;
+    const struct at_urc *urc;
+
+    if (sim_line_len < sizeof(sim_line) - 1)
+        sim_line[sim_line_len++] = ch;
+    sim_line[sim_line_len] = '\0';
+
+    /* a URC is recognised as soon as it is complete, "> " has no line end */
+    urc = sim_urc_match();
+    if (urc != RT_NULL)
+    {
+        sim_line_len = 0;
+        urc->func(&sim_client, sim_line, strlen(sim_line));
+        return;
+    }
+    if (sim_line_len < 2 || sim_line[sim_line_len - 2] != '\r' || sim_line[sim_line_len - 1] != '\n')
+        return;
+
+    sim_line[sim_line_len - 2] = '\0';
+    sim_line_len = 0;
+    if (!strcmp(sim_line, "OK"))
+    {
+        sim_final = 1;
+    }
+    else if (!strcmp(sim_line, "ERROR"))
+    {
+        sim_final = -1;
+    }
+    else if (sim_line[0] && resp != RT_NULL && resp->buf_len + strlen(sim_line) + 1 <= resp->buf_size)
+    {
+        strcpy(resp->buf + resp->buf_len, sim_line);
+        resp->buf_len += strlen(sim_line) + 1;
+        resp->line_counts++;
+    }
+}
+
+static rt_bool_t sim_have_final(void)
+{
+    return sim_final != 0;
+}
+
+static rt_bool_t sim_have_action(void)
+{
+    return sim_action.value > 0;
+}
+
+/* time passes up to `until`, the replies due meanwhile are parsed, until `done` */
+static rt_bool_t sim_wait(rt_tick_t until, rt_bool_t (*done)(void))
+{
+    struct fmodem_reply reply;
+    const char *p;
+
+    while (!done())
+    {
+        if (sim_head == sim_tail || (rt_int32_t)(sim_replies[sim_head % SIM_REPLIES].due - until) > 0)
+        {
+            rthost_tick = until;
+            return RT_FALSE;
+        }
+        if ((rt_int32_t)(sim_replies[sim_head % SIM_REPLIES].due - rthost_tick) > 0)
+            rthost_tick = sim_replies[sim_head % SIM_REPLIES].due;
+        /* parsing may make the modem say more, which may reuse the slot */
+        reply = sim_replies[sim_head++ % SIM_REPLIES].reply;
+        for (p = reply.text; *p; p++)
+            sim_recv(*p);
+    }
+
+    return RT_TRUE;
+}
+
+int at_client_init(const char *dev_name, rt_size_t recv_bufsz)
+{
+    rt_mutex_init(&sim_client_lock, "at", RT_IPC_FLAG_PRIO);
+    sim_client.lock = &sim_client_lock;
+    sim_client.device = &fmodem.parent;
+
+    return RT_EOK;
+}
+
+at_client_t at_client_get(const char *dev_name)
+{
+    return &sim_client;
+}
+
+int at_client_obj_wait_connect(at_client_t client, rt_uint32_t timeout)
+{
+    return RT_EOK;
+}
+
+int at_obj_set_urc_table(at_client_t client, const struct at_urc *table, rt_size_t size)
+{
+    sim_urc = table;
+    sim_urc_size = size;
+
+    return RT_EOK;
+}
+
+at_response_t at_resp_set_info(at_response_t resp, rt_size_t buf_size, rt_size_t line_num, rt_int32_t timeout)
+{
+    RTHOST_CHECK(buf_size <= resp->buf_size, "a response buffer cannot grow here");
+    resp->line_num = line_num;
+    resp->timeout = timeout;
+
+    return resp;
+}
+
+at_response_t at_create_resp(rt_size_t buf_size, rt_size_t line_num, rt_int32_t timeout)
+{
+    at_response_t resp = calloc(1, sizeof(*resp));
+
+    resp->buf = calloc(1, buf_size);
+    resp->buf_size = buf_size;
+
+    return at_resp_set_info(resp, buf_size, line_num, timeout);
+}
+
+int at_obj_exec_cmd(at_client_t client, at_response_t resp, const char *cmd_expr, ...)
+{
+    char cmd[AT_CMD_MAX_LEN + 2];
+    va_list args;
+    int len;
+
+    va_start(args, cmd_expr);
+    len = vsnprintf(cmd, AT_CMD_MAX_LEN, cmd_expr, args);
+    va_end(args);
+    strcpy(cmd + len, "\r\n");
+
+    resp->buf_len = 0;
+    resp->line_counts = 0;
+    client->resp = resp;
+    sim_final = 0;
+    rt_device_write(client->device, 0, cmd, len + 2);
+
+    if (!sim_wait(rthost_tick + resp->timeout, sim_have_final))
+        sim_final = 0;
+    client->resp = RT_NULL;
+
+    return sim_final > 0 ? RT_EOK : sim_final < 0 ? -RT_ERROR : -RT_ETIMEOUT;
+}
+
+int at_resp_parse_line_args_by_kw(at_response_t resp, const char *keyword, const char *resp_expr, ...)
+{
+    const char *line = resp->buf;
+    va_list args;
+    rt_size_t i;
+    int n;
+
+    for (i = 0; i < resp->line_counts && !strstr(line, keyword); i++)
+        line += strlen(line) + 1;
+    if (i == resp->line_counts)
+        return -1;
+
+    va_start(args, resp_expr);
+    n = vsscanf(line, resp_expr, args);
+    va_end(args);
+
+    return n;
+}
+
+rt_mutex_t rt_mutex_create(const char *name, rt_uint8_t flag)
+{
+    return &sim_http_lock;
+}
+
+rt_sem_t rt_sem_create(const char *name, rt_uint32_t value, rt_uint8_t flag)
+{
+    sim_action.value = value;
+    return &sim_action;
+}
+
+/* +HTTPACTION is waited for on a semaphore, which lets time pass as well */
+static rt_err_t sim_sem_take(rt_sem_t sem, rt_int32_t timeout)
+{
+    RTHOST_CHECK(sem == &sim_action, "an unknown semaphore");
+    if (!sim_wait(rthost_tick + timeout, sim_have_action))
+        return -RT_ETIMEOUT;
+    sem->value--;
+
+    return RT_EOK;
+}
+
+static rt_err_t sim_sem_release(rt_sem_t sem)
+{
+    sem->value++;
+    return RT_EOK;
+}
+
+static rt_err_t sim_sem_control(rt_sem_t sem, int cmd, void *arg)
+{
+    sem->value = (rt_uint32_t)(rt_ubase_t)arg;
+    return RT_EOK;
+}
+
+#define rt_sem_take         sim_sem_take
+#define rt_sem_release      sim_sem_release
+#define rt_sem_control      sim_sem_control
+#include "../../applications/sim800_http.c"
+
+/* posts and checks the result, and what each state took against `want`, in ticks */
+static void sim_post(const char *what, const char *url, int result, const rt_tick_t *want)
+{
+    const struct sim800_http_stat *stat = sim800_http_get_stat();
+    int got, i;
+
+    got = sim800_http_post(url, SIM800_CONTENT_FORM, SIM_BODY, strlen(SIM_BODY));
+
+    printf("%-10s %3d, %5d ms:", what, got, TICK_MS(stat->last_ticks));
+    for (i = SIM800_HTTP_PROBE; i < SIM800_HTTP_DONE; i++)
+    {
+        if (stat->step_ticks[i])
+            printf(" %s %d", sim800_http_state_name(i), TICK_MS(stat->step_ticks[i]));
+    }
+    printf("\n");
+
+    RTHOST_CHECK(got == result, "%s: the post returned %d, %d wanted", what, got, result);
+    for (i = SIM800_HTTP_PROBE; want != RT_NULL && i < SIM800_HTTP_DONE; i++)
+    {
+        RTHOST_CHECK(stat->step_ticks[i] == want[i], "%s: state '%s' took %d ticks, %d wanted", what,
+                     sim800_http_state_name(i), stat->step_ticks[i], want[i]);
+    }
+}
+
+/* fault injection, as the fmodem command sets it */
+static void sim_fmodem(const char *fail, const char *mute)
+{
+    strcpy(fmodem.fail_prefix, fail);
+    strcpy(fmodem.mute_prefix, mute);
+}
+
+int main(void)
+{
+    const struct sim800_http_stat *stat = sim800_http_get_stat();
+    struct fmodem *fm = &fmodem;
+    rt_tick_t d, n, connect[SIM800_HTTP_STATE_MAX] = {0}, live[SIM800_HTTP_STATE_MAX] = {0};
+    rt_tick_t checked[SIM800_HTTP_STATE_MAX] = {0}, moved[SIM800_HTTP_STATE_MAX] = {0};
+    rt_uint32_t commands, sent, bytes;
+    char text[300];
+    int i;
+
+    rt_spscring_init(&fm->rx, fm->rx_pool, sizeof(fm->rx_pool));
+    fm->parent.write = fmodem_write;
+    fm->cmd_delay_ms = 20;
+    fm->net_delay_ms = 600;
+    fm->http_status = 200;
+    d = rt_tick_from_millisecond(fm->cmd_delay_ms);
+    n = rt_tick_from_millisecond(fm->net_delay_ms);
+
+    /* every step is answered after the command latency, the network ones after its own */
+    for (i = SIM800_HTTP_PROBE; i <= SIM800_HTTP_CONTENT; i++)
+        connect[i] = d;
+    connect[SIM800_HTTP_BEARER_OPEN] = n;
+    connect[SIM800_HTTP_DATA] = live[SIM800_HTTP_DATA] = 2 * d;        /* DOWNLOAD, then OK */
+    connect[SIM800_HTTP_ACTION] = live[SIM800_HTTP_ACTION] = d + n;    /* OK, then +HTTPACTION */
+    memcpy(checked, live, sizeof(live));
+    checked[SIM800_HTTP_BEARER_QUERY] = d;
+    memcpy(moved, live, sizeof(live));
+    moved[SIM800_HTTP_URL] = d;
+
+    RTHOST_CHECK(sim800_http_init() == RT_EOK, "no HTTP engine");
+
+    sim_post("connect", SIM_URL, RT_EOK, connect);
+    RTHOST_CHECK(sim800_http_conn_state() == SIM800_CONN_READY && stat->connects == 1, "not connected");
+    RTHOST_CHECK(stat->connect_ticks == 6 * d + n, "the connection took %d ticks", stat->connect_ticks);
+    sim_post("live", SIM_URL, RT_EOK, live);
+    RTHOST_CHECK(stat->last_ticks == 3 * d + n, "a post on a live link took %d ticks", stat->last_ticks);
+
+    /* idle for longer than the bearer is trusted: queried once, then straight on */
+    rthost_tick += rt_tick_from_millisecond(SIM800_CONN_CHECK_MS);
+    sim_post("idle", SIM_URL, RT_EOK, checked);
+    sim_post("new url", SIM_URL "?x=1", RT_EOK, moved);
+
+    /* the network drops the bearer: the post fails on HTTPDATA, then connects again */
+    fmodem_queue(fm, 0, "\r\n+SAPBR 1: DEACT\r\n");
+    fm->bearer_open = RT_FALSE;
+    fm->http_init = RT_FALSE;
+    sim_post("drop", SIM_URL, RT_EOK, RT_NULL);
+    RTHOST_CHECK(stat->deacts == 1 && stat->reconnects == 1, "%d drops, %d reconnects", stat->deacts,
+                 stat->reconnects);
+    RTHOST_CHECK(stat->step_ticks[SIM800_HTTP_BEARER_OPEN] == n && stat->step_ticks[SIM800_HTTP_ACTION] == d + n,
+                 "the reconnect took the wrong steps");
+
+    /* the server refuses: one attempt, the status is kept */
+    fm->http_status = 500;
+    commands = fm->commands;
+    sim_post("server", SIM_URL, -RT_ERROR, RT_NULL);
+    RTHOST_CHECK(stat->last_status == 500 && fm->commands - commands == 2, "retried a refused post");
+    fm->http_status = 200;
+
+    /* no answer to HTTPACTION: 2 s per attempt, and the connection is restarted */
+    sim_fmodem("", "AT+HTTPACTION");
+    sim_post("mute", SIM_URL, -RT_ETIMEOUT, RT_NULL);
+    RTHOST_CHECK(stat->step_ticks[SIM800_HTTP_ACTION] == rt_tick_from_millisecond(2000), "HTTPACTION waited %d ticks",
+                 stat->step_ticks[SIM800_HTTP_ACTION]);
+    sim_fmodem("", "");
+    sim_post("recovered", SIM_URL, RT_EOK, RT_NULL);
+
+    /* an SMS: the text after the prompt, up to Ctrl-Z, and the network's answer */
+    sent = fm->sms_sent;
+    RTHOST_CHECK(sim800_sms_send("+10000000000", "door open") == RT_EOK, "the SMS failed");
+    RTHOST_CHECK(fm->sms_sent == sent + 1 && fm->sms_bytes == strlen("door open"), "the SMS text did not arrive");
+
+    /* a longer text is cut to fit */
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    RTHOST_CHECK(sim800_sms_send("+10000000000", text) == RT_EOK, "the long SMS failed");
+    RTHOST_CHECK(fm->sms_bytes == strlen("door open") + SIM800_SMS_MAX_LEN - 1, "%d SMS bytes", fm->sms_bytes);
+
+    /* refused, and never answered: the ESC that follows must not spoil the next command */
+    sim_fmodem("AT+CMGS", "");
+    RTHOST_CHECK(sim800_sms_send("+10000000000", "lost") == -RT_ERROR, "a refused SMS was sent");
+    sim_fmodem("", "AT+CMGS");
+    sent = fm->sms_sent;
+    RTHOST_CHECK(sim800_sms_send("+10000000000", "lost") == -RT_ETIMEOUT, "a muted SMS was sent");
+    sim_fmodem("", "");
+
+    /* should the prompt still come, the text must not follow it into the next command */
+    bytes = fm->sms_bytes;
+    fmodem_queue(fm, 0, "\r\n> ");
+
+    /* a minute without an answer, so the bearer is checked first */
+    sim_post("after sms", SIM_URL, RT_EOK, checked);
+    RTHOST_CHECK(fm->sms_sent == sent && fm->sms_bytes == bytes, "a cancelled SMS was sent");
+
+    /* whole bodies only, no command bytes taken as data or the other way round */
+    RTHOST_CHECK(fm->data_bytes % strlen(SIM_BODY) == 0, "the modem took %d body bytes", fm->data_bytes);
+    printf("%d posts, %d failed, %d timeouts, %d connects, %d SMS\n", stat->posts, stat->failures, stat->timeouts,
+           stat->connects, fm->sms_sent);
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./spscring_stress [megabytes=50] [ring size=256]
+ *
+ * rt-thread/components/drivers/ipc/spscring.c under real concurrency: one
+ * pthread produces a numbered byte stream, through reserve/commit and put
+ * in random sizes, while another takes it through peek/consume and get and
+ * checks every byte arrives once and in order. The indexes start just
+ * short of wrapping around, so that is crossed as well.
+ *
+ * ThreadSanitizer does not model the fences the ring orders its indexes
+ * with, and reports the plain accesses to them as races, so under
+ * -fsanitize=thread the stress is skipped.
+ */
+#include <pthread.h>
+#include <sched.h>
+
+#include "rthost.h"
+
+#include "../../rt-thread/components/drivers/ipc/spscring.c"
+
+#define STRESS_CHUNK    100
+
+static struct rt_spscring ring;
+static rt_uint8_t pool[1 << 16];
+static unsigned long total;
+
+/* byte seq of the stream, not repeating with any ring size */
+static rt_uint8_t stress_byte(unsigned long seq)
+{
+    return (rt_uint8_t)(((rt_uint32_t)seq * 0x9e3779b1u) >> 24);
+}
+
+/* an LCG per side, so the two run through different sizes */
+static rt_uint32_t stress_rand(rt_uint32_t *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+static void *producer(void *arg)
+{
+    rt_uint8_t chunk[STRESS_CHUNK], *span;
+    rt_uint32_t seed = 1, r;
+    unsigned long seq = 0;
+    rt_size_t n, i;
+
+    while (seq < total)
+    {
+        r = stress_rand(&seed);
+        n = 1 + (r >> 8) % (STRESS_CHUNK - 3);
+        if (n > total - seq)
+            n = total - seq;
+        if (r & 1)
+        {
+            for (i = 0; i < n; i++)
+                chunk[i] = stress_byte(seq + i);
+            n = rt_spscring_put(&ring, chunk, n);
+        }
+        else
+        {
+            n = rt_spscring_reserve(&ring, &span, n);
+            for (i = 0; i < n; i++)
+                span[i] = stress_byte(seq + i);
+            rt_spscring_commit(&ring, n);
+        }
+        seq += n;
+        /* each side stalls now and then, so the ring runs full and empty */
+        if (n == 0 || (r & 0x3f) == 0)
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    unsigned long *bad = arg;
+    rt_uint8_t chunk[STRESS_CHUNK], *span;
+    rt_uint32_t seed = 7, r;
+    unsigned long seq = 0;
+    rt_size_t n, i;
+
+    while (seq < total)
+    {
+        r = stress_rand(&seed);
+        if (r & 1)
+        {
+            n = rt_spscring_get(&ring, chunk, 1 + (r >> 8) % 64);
+            span = chunk;
+        }
+        else
+        {
+            n = rt_spscring_peek_span(&ring, &span);
+            if (n > 1 + (r >> 8) % 80)
+                n = 1 + (r >> 8) % 80;
+        }
+        for (i = 0; i < n; i++)
+        {
+            if (span[i] != stress_byte(seq + i) && (*bad)++ < 10)
+                printf("byte %lu is %u, %u wanted\n", seq + i, span[i], stress_byte(seq + i));
+        }
+        if (span != chunk)
+            rt_spscring_consume(&ring, n);
+        seq += n;
+        if (n == 0 || (r & 0x3f) == 0)
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    rt_uint32_t size = argc > 2 ? strtoul(argv[2], RT_NULL, 0) : 256;
+    unsigned long bad = 0;
+    pthread_t pt, ct;
+
+#if defined(__SANITIZE_THREAD__)
+    printf("skipped: ThreadSanitizer does not model the ring's fences\n");
+    return 0;
+#endif
+
+    total = (argc > 1 ? strtoul(argv[1], RT_NULL, 0) : 50) << 20;
+    RTHOST_CHECK(rt_spscring_init(&ring, pool, 100) == -RT_EINVAL && rt_spscring_init(&ring, pool, 0) == -RT_EINVAL,
+                 "a size that is not a power of two was taken");
+    RTHOST_CHECK(size <= sizeof(pool) && rt_spscring_init(&ring, pool, size) == RT_EOK, "no ring of %u bytes",
+                 (unsigned)size);
+    ring.write_index = ring.read_index = 0xffffff00u;
+
+    pthread_create(&pt, NULL, producer, NULL);
+    pthread_create(&ct, NULL, consumer, &bad);
+    pthread_join(pt, NULL);
+    pthread_join(ct, NULL);
+
+    printf("%lu bytes through a %u byte ring, %lu wrong, %u left\n", total, (unsigned)size, bad,
+           (unsigned)rt_spscring_data_len(&ring));
+    RTHOST_CHECK(bad == 0, "the stream was corrupted");
+    RTHOST_CHECK(rt_spscring_data_len(&ring) == 0 && ring.write_index == 0xffffff00u + (rt_uint32_t)total,
+                 "the indexes do not add up");
+
+    return 0;
+}
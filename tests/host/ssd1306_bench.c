@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./ssd1306_bench [loops=2000]
+ *
+ * applications/ssd1306_lcd.c's drawing timed against the per-pixel
+ * versions it replaced (ssd1306_ref.h), in an off-screen framebuffer, in
+ * ns of the host per call, the clear before each one included:
+ *
+ *   string  "T: 23.45 C" at scales 1 to 4, on a page boundary and off it:
+ *           a square per font bit against the byte blitter
+ *   fan     96 lines from the centre to every 4th border pixel: the float
+ *           slope the driver first had, per-pixel Bresenham, and Bresenham
+ *           with a byte pointer
+ *   rects   16 filled rectangles, per pixel against span fills
+ *
+ * ssd1306_test checks the two give the same pixels. The M0+ has no FPU
+ * and slower memory, so the ratios on the board are larger than here.
+ */
+#include <string.h>
+#include <time.h>
+
+#include "rthost.h"
+
+#include "../../applications/ssd1306_lcd.c"
+#include "ssd1306_ref.h"
+
+static ssd1306_t disp;
+static uint32_t bench_loops;
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    return (int)len;
+}
+
+rt_ssize_t rt_i2c_master_send(struct rt_i2c_bus_device *bus, rt_uint16_t addr, rt_uint16_t flags,
+                              const rt_uint8_t *buf, rt_uint32_t count)
+{
+    return count;
+}
+
+static rt_uint64_t bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (rt_uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/* the float-slope line this driver used to have */
+static void bench_float_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    float m, y;
+    int32_t i;
+
+    if (x1 > x2)
+    {
+        swap(&x1, &x2);
+        swap(&y1, &y2);
+    }
+
+    if (x1 == x2)
+    {
+        if (y1 > y2)
+            swap(&y1, &y2);
+        for (i = y1; i <= y2; ++i)
+            ssd1306_draw_pixel(p, x1, i);
+        return;
+    }
+
+    m = (float)(y2 - y1) / (float)(x2 - x1);
+    for (i = x1; i <= x2; ++i)
+    {
+        y = m * (float)(i - x1) + (float)y1;
+        ssd1306_draw_pixel(p, i, (uint32_t)y);
+    }
+}
+
+static void bench_fan(void (*line)(ssd1306_t *, int32_t, int32_t, int32_t, int32_t))
+{
+    int32_t x, y;
+
+    for (x = 0; x < disp.width; x += 4)
+    {
+        line(&disp, 63, 31, x, 0);
+        line(&disp, 63, 31, x, disp.height - 1);
+    }
+    for (y = 0; y < disp.height; y += 4)
+    {
+        line(&disp, 63, 31, 0, y);
+        line(&disp, 63, 31, disp.width - 1, y);
+    }
+}
+
+static void bench_rects(void (*rect)(ssd1306_t *, uint32_t, uint32_t, uint32_t, uint32_t))
+{
+    uint32_t i;
+
+    for (i = 0; i < 16; ++i)
+        rect(&disp, i * 5, i * 3, 40 + i, 5 + i);
+}
+
+/* ns per call of draw(), on a cleared framebuffer each time */
+#define BENCH_TIME(draw)                                    \
+    ({                                                      \
+        rt_uint64_t t0 = bench_ns();                        \
+        uint32_t i;                                         \
+        for (i = 0; i < bench_loops; ++i)                   \
+        {                                                   \
+            ssd1306_clear(&disp);                           \
+            draw;                                           \
+        }                                                   \
+        (unsigned)((bench_ns() - t0) / bench_loops);        \
+    })
+
+int main(int argc, char **argv)
+{
+    const char *text = "T: 23.45 C";
+    unsigned per_pixel, float_line, fast;
+    uint32_t scale, y;
+
+    bench_loops = argc > 1 ? strtoul(argv[1], RT_NULL, 0) : 2000;
+    RTHOST_CHECK(bench_loops > 0, "no loops");
+    ref_display(&disp);
+
+    printf("draw_string \"%s\", ns per call over %u loops\n", text, bench_loops);
+    printf("scale  y    per-pixel  blitter\n");
+    for (scale = 1; scale <= 4; ++scale)
+    {
+        for (y = 24; y <= 27; y += 3)
+        {
+            per_pixel = BENCH_TIME(ref_string(&disp, 0, y, scale, text));
+            fast = BENCH_TIME(ssd1306_draw_string(&disp, 0, y, scale, text));
+            printf("%-5u  %-3u  %-9u  %u\n", scale, y, per_pixel, fast);
+        }
+    }
+
+    float_line = BENCH_TIME(bench_fan(bench_float_line));
+    per_pixel = BENCH_TIME(bench_fan(ref_line));
+    fast = BENCH_TIME(bench_fan(ssd1306_draw_line));
+    printf("96-line fan, ns per fan: float %u, per-pixel Bresenham %u, Bresenham %u\n", float_line, per_pixel,
+           fast);
+
+    per_pixel = BENCH_TIME(bench_rects(ref_rect));
+    fast = BENCH_TIME(bench_rects(ssd1306_draw_square));
+    printf("16 filled rects, ns per set: per-pixel %u, span fill %u\n", per_pixel, fast);
+
+    free(disp.buffer);
+
+    return 0;
+}
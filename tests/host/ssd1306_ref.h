@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+#ifndef SSD1306_REF_H__
+#define SSD1306_REF_H__
+
+/*
+ * The per-pixel drawing applications/ssd1306_lcd.c used before its byte
+ * blitter, Bresenham lines and span fills, for ssd1306_test to compare
+ * with and ssd1306_bench to time against. Include after the driver.
+ */
+
+/* a glyph as one scale x scale square per set font bit */
+static void ref_char(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c)
+{
+    uint32_t parts_per_line, pp, lp;
+    uint8_t w, line;
+    int8_t j;
+
+    if (c < font[3] || c > font[4])
+        return;
+
+    parts_per_line = (font[0] >> 3) + ((font[0] & 7) > 0);
+    for (w = 0; w < font[1]; ++w)
+    {
+        pp = (c - font[3]) * font[1] * parts_per_line + w * parts_per_line + 5;
+        for (lp = 0; lp < parts_per_line; ++lp, ++pp)
+        {
+            line = font[pp];
+            for (j = 0; j < 8; ++j, line >>= 1)
+            {
+                if (line & 1)
+                    ssd1306_draw_square(p, x + w * scale, y + ((lp << 3) + j) * scale, scale, scale);
+            }
+        }
+    }
+}
+
+static void ref_string(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const char *s)
+{
+    int32_t x_n;
+
+    for (x_n = x; *s; x_n += (font_8x5[1] + font_8x5[2]) * scale)
+        ref_char(p, x_n, y, scale, font_8x5, *(s++));
+}
+
+/* textbook Bresenham, one ssd1306_draw_pixel() per pixel */
+static void ref_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    int32_t dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+    int32_t dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+    int32_t err = dx + dy, e2;
+
+    for (;;)
+    {
+        ssd1306_draw_pixel(p, x1, y1);
+        if (x1 == x2 && y1 == y2)
+            break;
+        e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+static void ref_rect(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < width; ++i)
+        for (j = 0; j < height; ++j)
+            ssd1306_draw_pixel(p, x + i, y + j);
+}
+
+static void ref_clear_rect(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < width; ++i)
+        for (j = 0; j < height; ++j)
+            ssd1306_clear_pixel(p, x + i, y + j);
+}
+
+/* an off-screen 128x64 framebuffer, nothing is sent to a panel */
+static void ref_display(ssd1306_t *p)
+{
+    memset(p, 0, sizeof(*p));
+    p->width = 128;
+    p->height = 64;
+    p->pages = 8;
+    p->bufsize = p->pages * p->width;
+    p->buffer = calloc(1, p->bufsize);
+    RTHOST_CHECK(p->buffer != RT_NULL, "no framebuffer");
+}
+
+#endif /* SSD1306_REF_H__ */
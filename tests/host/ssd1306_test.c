@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./ssd1306_test [lines=200000] [seed=1]
+ *
+ * applications/ssd1306_lcd.c's drawing against the per-pixel versions it
+ * replaced (ssd1306_ref.h), pixel for pixel in an off-screen framebuffer:
+ *
+ *   chars   every glyph of font_8x5 and two out of its range, at scales
+ *           1 to 5, at every row and at columns that cut it off the
+ *           right edge: the byte blitter against a square per font bit
+ *   lines   random ends on and off the screen, Bresenham with its byte
+ *           pointer against one ssd1306_draw_pixel() per pixel
+ *   rects   random fills and clears, clipped or not, against per pixel
+ *
+ * Every draw must also have marked all it changed as dirty, so that
+ * ssd1306_show() sends it.
+ */
+#include <string.h>
+
+#include "rthost.h"
+
+#include "../../applications/ssd1306_lcd.c"
+#include "ssd1306_ref.h"
+
+static ssd1306_t ref, drv;
+static uint8_t before[128 * 8];
+static rt_uint32_t test_seed = 1;
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    return (int)len;
+}
+
+rt_ssize_t rt_i2c_master_send(struct rt_i2c_bus_device *bus, rt_uint16_t addr, rt_uint16_t flags,
+                              const rt_uint8_t *buf, rt_uint32_t count)
+{
+    return count;
+}
+
+static rt_int32_t test_rand(rt_int32_t lo, rt_int32_t hi)
+{
+    test_seed = test_seed * 1103515245 + 12345;
+    return lo + (rt_int32_t)((test_seed >> 8) % (rt_uint32_t)(hi - lo + 1));
+}
+
+/* both framebuffers as they are, and nothing dirty in the driver's */
+static void test_begin(void)
+{
+    memcpy(before, drv.buffer, drv.bufsize);
+    drv.dirty = 0;
+    drv.dirty_x0 = drv.width;
+    drv.dirty_x1 = 0;
+}
+
+static void test_clear(void)
+{
+    memset(ref.buffer, 0, ref.bufsize);
+    memset(drv.buffer, 0, drv.bufsize);
+    test_begin();
+}
+
+/* the same pixels, and every byte that changed inside the dirty window */
+static void test_compare(const char *what)
+{
+    uint32_t i, page, x;
+
+    for (i = 0; i < drv.bufsize; i++)
+    {
+        page = i / drv.width;
+        x = i % drv.width;
+        RTHOST_CHECK(drv.buffer[i] == ref.buffer[i], "%s: column %u page %u is %#x, %#x wanted", what, x, page,
+                     drv.buffer[i], ref.buffer[i]);
+        RTHOST_CHECK(drv.buffer[i] == before[i]
+                     || ((drv.dirty & (1u << page)) && x >= drv.dirty_x0 && x <= drv.dirty_x1),
+                     "%s: column %u page %u changed but is not dirty", what, x, page);
+    }
+}
+
+static void test_chars(void)
+{
+    static const uint32_t xs[] = {0, 3, 124};
+    uint32_t scale, x, y, n = 0;
+    char what[64];
+    int c;
+
+    for (c = font_8x5[3] - 1; c <= font_8x5[4] + 1; c++)
+    {
+        for (scale = 1; scale <= 5; scale++)
+        {
+            for (x = 0; x < sizeof(xs) / sizeof(xs[0]); x++)
+            {
+                for (y = 0; y < drv.height; y++, n++)
+                {
+                    test_clear();
+                    ref_char(&ref, xs[x], y, scale, font_8x5, c);
+                    ssd1306_draw_char(&drv, xs[x], y, scale, c);
+                    rt_snprintf(what, sizeof(what), "char %d scale %u at %u,%u", c, scale, xs[x], y);
+                    test_compare(what);
+                }
+            }
+        }
+    }
+
+    /* a string over what is there already */
+    for (scale = 1; scale <= 4; scale++)
+    {
+        for (y = 0; y < drv.height; y += 3, n++)
+        {
+            test_begin();
+            ref_string(&ref, 0, y, scale, "T: 23.45 C");
+            ssd1306_draw_string(&drv, 0, y, scale, "T: 23.45 C");
+            rt_snprintf(what, sizeof(what), "string scale %u at 0,%u", scale, y);
+            test_compare(what);
+        }
+    }
+    printf("chars: %u draws the same\n", n);
+}
+
+static void test_lines(int count)
+{
+    rt_int32_t x1, y1, x2, y2;
+    char what[64];
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        /* mostly on screen, sometimes past an edge */
+        x1 = test_rand(-8, drv.width + 7);
+        y1 = test_rand(-8, drv.height + 7);
+        x2 = test_rand(0, 3) ? test_rand(0, drv.width - 1) : test_rand(-8, drv.width + 7);
+        y2 = test_rand(0, 3) ? test_rand(0, drv.height - 1) : test_rand(-8, drv.height + 7);
+        if (test_rand(0, 7) == 0)
+            y2 = y1;
+        else if (test_rand(0, 7) == 0)
+            x2 = x1;
+        if (i % 16 == 0)
+            test_clear();
+        else
+            test_begin();
+
+        ref_line(&ref, x1, y1, x2, y2);
+        ssd1306_draw_line(&drv, x1, y1, x2, y2);
+        rt_snprintf(what, sizeof(what), "line %d,%d to %d,%d", x1, y1, x2, y2);
+        test_compare(what);
+    }
+    printf("lines: %d draws the same\n", count);
+}
+
+static void test_rects(int count)
+{
+    uint32_t x, y, w, h;
+    char what[64];
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        x = test_rand(0, drv.width + 8);
+        y = test_rand(0, drv.height + 8);
+        w = test_rand(0, drv.width + 8);
+        h = test_rand(0, drv.height + 8);
+        if (i % 16 == 0)
+            test_clear();
+        else
+            test_begin();
+
+        if (i & 1)
+        {
+            ref_clear_rect(&ref, x, y, w, h);
+            ssd1306_clear_square(&drv, x, y, w, h);
+        }
+        else
+        {
+            ref_rect(&ref, x, y, w, h);
+            ssd1306_draw_square(&drv, x, y, w, h);
+        }
+        rt_snprintf(what, sizeof(what), "%s %u,%u %ux%u", i & 1 ? "clear" : "fill", x, y, w, h);
+        test_compare(what);
+    }
+    printf("rects: %d fills and clears the same\n", count);
+}
+
+int main(int argc, char **argv)
+{
+    int lines = argc > 1 ? atoi(argv[1]) : 200000;
+
+    if (argc > 2)
+        test_seed = strtoul(argv[2], RT_NULL, 0);
+    ref_display(&ref);
+    ref_display(&drv);
+
+    test_chars();
+    test_lines(lines);
+    test_rects(lines / 4);
+
+    free(ref.buffer);
+    free(drv.buffer);
+
+    return 0;
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./timer_bench [count...]
+ *
+ * rt-thread/src/timer.c, built with the timing wheel (timer_bench) and
+ * with the sorted list (timer_list_bench), timed with the given numbers
+ * of hard timers active (10, 100 and 1000 by default):
+ *
+ *   start   rt_timer_start() with random timeouts
+ *   stop    rt_timer_stop() of active timers
+ *   next    rt_timer_next_timeout_tick(), which tickless idle calls
+ *   tick    rt_timer_check() on every tick while the timers expire
+ *   irq     the longest stretch with interrupts off, over all of those
+ *
+ * Everything is in nanoseconds of the host, average / worst, with the cost
+ * of reading the clock taken off, over several rounds; the worst cases
+ * include whatever the host scheduler adds. The calls are timed on even
+ * rounds and the interrupt locks on odd ones, so neither clock read is
+ * counted in the other. The on-target timer_bench gives the same figures
+ * in cycles of the M0+; this is for comparing the two containers without
+ * a board, and how they scale.
+ */
+#include <string.h>
+#include <time.h>
+
+#include "rthost.h"
+
+/* the kernel's interrupt locks, timed */
+static rt_base_t bench_irq_disable(void);
+static void bench_irq_enable(rt_base_t level);
+#define rt_hw_interrupt_disable bench_irq_disable
+#define rt_hw_interrupt_enable  bench_irq_enable
+
+#ifdef TIMER_BENCH_LIST
+#undef RT_TIMER_USING_WHEEL
+#endif
+#include "../../rt-thread/src/timer.c"
+
+#undef rt_hw_interrupt_disable
+#undef rt_hw_interrupt_enable
+
+#define BENCH_TIMERS_MAX    10000
+#define BENCH_SPAN          (2 * RT_TICK_PER_SECOND)    /* timeouts are 1..SPAN ticks */
+#define BENCH_ROUNDS        20
+
+struct bench_cost
+{
+    rt_uint64_t total;
+    rt_uint32_t count;
+    rt_uint32_t max;
+};
+
+static struct rt_timer timers[BENCH_TIMERS_MAX];
+static rt_uint32_t bench_fired;
+static rt_uint32_t bench_seed = 1;
+static rt_uint32_t bench_clock_cost;
+static rt_bool_t bench_irq_timed;
+static rt_uint64_t bench_irq_start;
+static rt_uint32_t bench_irq_max;
+
+static rt_uint64_t bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (rt_uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static rt_base_t bench_irq_disable(void)
+{
+    if (rthost_irq_off == 0 && bench_irq_timed)
+        bench_irq_start = bench_ns();
+    return rthost_irq_off++;
+}
+
+static void bench_irq_enable(rt_base_t level)
+{
+    rt_uint64_t ns;
+
+    rthost_irq_off = (int)level;
+    if (level == 0 && bench_irq_timed)
+    {
+        ns = bench_ns() - bench_irq_start;
+        if (ns > bench_irq_max)
+            bench_irq_max = ns;
+    }
+}
+
+static rt_uint32_t bench_rand(void)
+{
+    bench_seed = bench_seed * 1103515245 + 12345;
+    return bench_seed >> 8;
+}
+
+static void bench_add(struct bench_cost *cost, rt_uint64_t start)
+{
+    rt_uint64_t ns = bench_ns() - start;
+
+    if (bench_irq_timed)
+        return;
+    ns = ns > bench_clock_cost ? ns - bench_clock_cost : 0;
+    cost->total += ns;
+    cost->count++;
+    if (ns > cost->max)
+        cost->max = ns;
+}
+
+static void bench_print(const char *name, const struct bench_cost *cost)
+{
+    printf(" %s %u/%u", name, cost->count ? (unsigned)(cost->total / cost->count) : 0, cost->max);
+}
+
+static void bench_timeout(void *parameter)
+{
+    bench_fired++;
+}
+
+/* the least two back-to-back clock reads ever differ by */
+static void bench_calibrate(void)
+{
+    rt_uint64_t t0, ns;
+    int i;
+
+    bench_clock_cost = ~0u;
+    for (i = 0; i < 10000; i++)
+    {
+        t0 = bench_ns();
+        ns = bench_ns() - t0;
+        if (ns < bench_clock_cost)
+            bench_clock_cost = ns;
+    }
+}
+
+static void bench_run(int n)
+{
+    struct bench_cost start = {0}, stop = {0}, next = {0}, tick = {0};
+    rt_uint64_t t0;
+    rt_uint32_t irq_max = 0;
+    int round, i;
+
+    for (round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (i = 0; i < n; i++)
+        {
+            rt_timer_init(&timers[i], "bench", bench_timeout, RT_NULL, 1 + bench_rand() % BENCH_SPAN,
+                          RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+        }
+
+        /* start them all and let them expire */
+        bench_irq_timed = round & 1;
+        bench_irq_max = 0;
+        bench_fired = 0;
+        for (i = 0; i < n; i++)
+        {
+            t0 = bench_ns();
+            rt_timer_start(&timers[i]);
+            bench_add(&start, t0);
+        }
+        for (i = 0; i < 16; i++)
+        {
+            t0 = bench_ns();
+            (void)rt_timer_next_timeout_tick();
+            bench_add(&next, t0);
+        }
+        for (i = 0; i <= BENCH_SPAN; i++)
+        {
+            rthost_tick++;
+            t0 = bench_ns();
+            rt_timer_check();
+            bench_add(&tick, t0);
+        }
+        RTHOST_CHECK(bench_fired == (rt_uint32_t)n, "%d timers, %u fired", n, bench_fired);
+
+        /* start them again and stop them while active */
+        for (i = 0; i < n; i++)
+            rt_timer_start(&timers[i]);
+        for (i = 0; i < n; i++)
+        {
+            t0 = bench_ns();
+            rt_timer_stop(&timers[i]);
+            bench_add(&stop, t0);
+        }
+        if (bench_irq_max > irq_max)
+            irq_max = bench_irq_max;
+
+        for (i = 0; i < n; i++)
+            rt_timer_detach(&timers[i]);
+        RTHOST_CHECK(rthost_irq_off == 0, "interrupts left off");
+    }
+
+    printf("%5d timers:", n);
+    bench_print("start", &start);
+    bench_print("stop", &stop);
+    bench_print("next", &next);
+    bench_print("tick", &tick);
+    printf(" irq %u\n", irq_max);
+}
+
+int main(int argc, char **argv)
+{
+    static const int counts[] = {10, 100, 1000};
+    int i, n;
+
+    rthost_tick = 0xffffff00u;
+    rt_system_timer_init();
+    bench_calibrate();
+
+#ifdef RT_TIMER_USING_WHEEL
+    printf("timing wheel");
+#else
+    printf("sorted list");
+#endif
+    printf(", ns avg/max, timeouts 1..%d ticks, %d rounds, %u ns per clock read taken off\n", BENCH_SPAN,
+           BENCH_ROUNDS, bench_clock_cost);
+    if (argc < 2)
+    {
+        for (i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++)
+            bench_run(counts[i]);
+    }
+    for (i = 1; i < argc; i++)
+    {
+        n = atoi(argv[i]);
+        RTHOST_CHECK(n > 0 && n <= BENCH_TIMERS_MAX, "1..%d timers", BENCH_TIMERS_MAX);
+        bench_run(n);
+    }
+
+    return 0;
+}
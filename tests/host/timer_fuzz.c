@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./timer_fuzz [steps=2000000] [timers=300] [seed=1] [first tick=0xfff00000]
+ *
+ * rt-thread/src/timer.c, built with the timing wheel (timer_fuzz) and
+ * with the sorted list (timer_list_fuzz), against a model that knows when
+ * every timer is due. Random timers are started, restarted and stopped,
+ * one-shot and periodic, from 0 ticks to past the wheel's span, while the
+ * tick moves on by one or jumps ahead as after a tickless sleep. No timer
+ * may fire early, late, twice or after it was stopped, and
+ * rt_timer_next_timeout_tick() must name the earliest one due. The tick
+ * starts just short of wrapping around, so that is crossed as well.
+ */
+#include "rthost.h"
+
+#ifdef TIMER_FUZZ_LIST
+#undef RT_TIMER_USING_WHEEL
+#endif
+#include "../../rt-thread/src/timer.c"
+
+#define TIMERS_MAX      2000
+#define JUMP_MAX        5000            /* ticks of a tickless sleep */
+
+static struct
+{
+    struct rt_timer timer;
+    rt_tick_t due;
+    rt_bool_t active, periodic;
+} fuzz[TIMERS_MAX];
+
+static unsigned long fired, errors;
+
+#define FUZZ_ERROR(...)                                             \
+    do                                                              \
+    {                                                               \
+        if (errors++ < 20)                                          \
+        {                                                           \
+            printf(__VA_ARGS__);                                    \
+            printf("\n");                                           \
+        }                                                           \
+    } while (0)
+
+static void fuzz_timeout(void *parameter)
+{
+    int i = (int)(rt_ubase_t)parameter;
+
+    if (!fuzz[i].active)
+    {
+        FUZZ_ERROR("timer %d fired while stopped, tick %u", i, rthost_tick);
+        return;
+    }
+    /* late only by a jump of the tick, which fuzz_check_late() sees */
+    if ((rt_int32_t)(rthost_tick - fuzz[i].due) < 0)
+        FUZZ_ERROR("timer %d due at %u fired early at %u", i, fuzz[i].due, rthost_tick);
+
+    fired++;
+    if (fuzz[i].periodic)
+        fuzz[i].due = rthost_tick + fuzz[i].timer.init_tick;
+    else
+        fuzz[i].active = RT_FALSE;
+}
+
+/* mostly short, some up to minutes, a few beyond the wheel's span */
+static rt_tick_t fuzz_timeout_ticks(void)
+{
+    int r = rand() % 100;
+
+    if (r < 60)
+        return rand() % 40;
+    if (r < 90)
+        return rand() % 3000;
+    if (r < 97)
+        return rand() % 200000;
+    return rand() % (1u << 26);
+}
+
+static void fuzz_start(int i)
+{
+    rt_tick_t ticks = fuzz_timeout_ticks();
+
+    fuzz[i].periodic = ticks > 0 && rand() % 8 == 0;
+    rt_timer_control(&fuzz[i].timer, RT_TIMER_CTRL_SET_TIME, &ticks);
+    rt_timer_control(&fuzz[i].timer, fuzz[i].periodic ? RT_TIMER_CTRL_SET_PERIODIC : RT_TIMER_CTRL_SET_ONESHOT,
+                     RT_NULL);
+    rt_timer_start(&fuzz[i].timer);
+    fuzz[i].active = RT_TRUE;
+    fuzz[i].due = rthost_tick + ticks;
+}
+
+/* the model's earliest due tick against the kernel's */
+static void fuzz_check_next(int n)
+{
+    rt_tick_t want = RT_TICK_MAX, next;
+    rt_bool_t any = RT_FALSE;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        if (fuzz[i].active && (!any || (rt_int32_t)(fuzz[i].due - want) < 0))
+        {
+            want = fuzz[i].due;
+            any = RT_TRUE;
+        }
+    }
+
+    next = rt_timer_next_timeout_tick();
+    if (!any && next != RT_TICK_MAX)
+        FUZZ_ERROR("next timeout %u with no timer running", next);
+    /* a timer made due by a restart at the current tick fires with the next one */
+    else if (any && next != want && !((rt_int32_t)(want - rthost_tick) <= 0 && (rt_int32_t)(next - rthost_tick) <= 1))
+        FUZZ_ERROR("next timeout %u, %u wanted, tick %u", next, want, rthost_tick);
+}
+
+/* after a check, nothing that is due may still be running */
+static void fuzz_check_late(int n)
+{
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        if (fuzz[i].active && (rt_int32_t)(rthost_tick - fuzz[i].due) >= 0)
+        {
+            FUZZ_ERROR("timer %d due at %u still running at %u", i, fuzz[i].due, rthost_tick);
+            fuzz[i].active = RT_FALSE;
+            rt_timer_stop(&fuzz[i].timer);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    long step, steps = argc > 1 ? atol(argv[1]) : 2000000;
+    int i, op, n = argc > 2 ? atoi(argv[2]) : 300;
+
+    srand(argc > 3 ? atoi(argv[3]) : 1);
+    rthost_tick = argc > 4 ? strtoul(argv[4], RT_NULL, 0) : 0xfff00000;
+    if (n < 1 || n > TIMERS_MAX)
+        n = 300;
+
+    rt_system_timer_init();
+    for (i = 0; i < n; i++)
+        rt_timer_init(&fuzz[i].timer, "fuzz", fuzz_timeout, (void *)(rt_ubase_t)i, 1, RT_TIMER_FLAG_ONE_SHOT);
+
+    for (step = 0; step < steps; step++)
+    {
+        op = rand() % 10;
+        i = rand() % n;
+        if (op < 4)
+        {
+            fuzz_start(i);
+        }
+        else if (op < 5)
+        {
+            rt_timer_stop(&fuzz[i].timer);
+            fuzz[i].active = RT_FALSE;
+        }
+        else
+        {
+            fuzz_check_next(n);
+            rthost_tick += rand() % 20 == 0 ? 1 + rand() % JUMP_MAX : 1;
+            rt_timer_check();
+            fuzz_check_late(n);
+        }
+        RTHOST_CHECK(rthost_irq_off == 0, "interrupts left off at step %ld", step);
+    }
+
+    printf("%s: %ld steps, %d timers, %lu expiries, tick %u: %lu errors\n",
+#ifdef RT_TIMER_USING_WHEEL
+           "wheel",
+#else
+           "list",
+#endif
+           steps, n, fired, rthost_tick, errors);
+    RTHOST_CHECK(errors == 0, "the timers disagree with the model");
+
+    return 0;
+}
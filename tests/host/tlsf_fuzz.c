@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./tlsf_fuzz [steps=1000000] [seed=1] [pool size] [pool offset=3]
+ *
+ * rt-thread/src/tlsf.c under random alloc, realloc and free of sizes from
+ * a byte to past half the pool, on a pool that starts unaligned. Every
+ * block is filled with a pattern that must survive until it is freed or
+ * moved by realloc, and the heap is walked after each step: boundary tags,
+ * free flags, coalescing, the used count, and every free block in the list
+ * and bitmaps of its size class. When all is freed the pool must be one
+ * free block again.
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include "rthost.h"
+
+/* the BSP's rtconfig.h is for a 32-bit core; 8-byte pointers need 8-byte blocks */
+#if UINTPTR_MAX > 0xffffffffu && !defined(ARCH_CPU_64BIT)
+#define ARCH_CPU_64BIT
+#endif
+#include "../../rt-thread/src/tlsf.c"
+
+#define FUZZ_PTRS       400
+
+static rt_uint8_t pool[1 << 18];
+
+static struct
+{
+    rt_uint8_t *ptr;
+    rt_size_t size;
+    rt_uint8_t pattern;
+} fuzz[FUZZ_PTRS];
+
+/* the whole heap, block by block and class by class */
+static void tlsf_check(struct rt_tlsf *t, long step)
+{
+    struct rt_tlsf_block *b, *prev = RT_NULL, *p;
+    rt_size_t used = 0, free_blocks = 0, listed = 0;
+    int fl, sl, f, s;
+
+    for (b = t->heap_ptr; b != t->heap_end; prev = b, b = BLOCK_NEXT(b))
+    {
+        RTHOST_CHECK(b < t->heap_end, "step %ld: block %p past the end", step, b);
+        RTHOST_CHECK(b->prev_phys == prev, "step %ld: block %p has the wrong neighbour", step, b);
+        RTHOST_CHECK(!(b->size & TLSF_BLOCK_PREV_FREE) == !(prev && BLOCK_ISFREE(prev)),
+                     "step %ld: block %p has the wrong previous-free flag", step, b);
+        RTHOST_CHECK(!(prev && BLOCK_ISFREE(prev) && BLOCK_ISFREE(b)),
+                     "step %ld: free blocks %p and %p not merged", step, prev, b);
+        RTHOST_CHECK(BLOCK_SIZE(b) >= MIN_SIZE_ALIGNED, "step %ld: block %p of %d bytes", step, b,
+                     (int)BLOCK_SIZE(b));
+        if (BLOCK_ISFREE(b))
+            free_blocks++;
+        else
+            used += BLOCK_SIZE(b) + SIZEOF_STRUCT_BLOCK;
+    }
+    RTHOST_CHECK(t->heap_end->prev_phys == prev && !(t->heap_end->size & TLSF_BLOCK_PREV_FREE) == !BLOCK_ISFREE(prev),
+                 "step %ld: the end block does not close the heap", step);
+    RTHOST_CHECK(used == t->parent.used, "step %ld: %d bytes used, %d counted", step, (int)used,
+                 (int)t->parent.used);
+
+    for (fl = 0; fl < TLSF_FL_INDEX_COUNT; fl++)
+    {
+        RTHOST_CHECK(!(t->fl_bitmap & (1u << fl)) == !t->sl_bitmap[fl], "step %ld: first level %d bitmap", step,
+                     fl);
+        for (sl = 0; sl < TLSF_SL_INDEX_COUNT; sl++)
+        {
+            RTHOST_CHECK(!(t->sl_bitmap[fl] & (1u << sl)) == !t->blocks[fl][sl],
+                         "step %ld: second level %d/%d bitmap", step, fl, sl);
+            for (p = RT_NULL, b = t->blocks[fl][sl]; b != RT_NULL; p = b, b = BLOCK_LINK(b)->next)
+            {
+                RTHOST_CHECK(BLOCK_ISFREE(b) && BLOCK_LINK(b)->prev == p, "step %ld: free list %d/%d broken at %p",
+                             step, fl, sl, b);
+                _tlsf_mapping(BLOCK_SIZE(b), &f, &s);
+                RTHOST_CHECK(f == fl && s == sl, "step %ld: block of %d bytes in class %d/%d", step,
+                             (int)BLOCK_SIZE(b), fl, sl);
+                listed++;
+            }
+        }
+    }
+    RTHOST_CHECK(listed == free_blocks, "step %ld: %d free blocks, %d in the lists", step, (int)free_blocks,
+                 (int)listed);
+}
+
+/* mostly small, some pages, a few larger than half the pool */
+static rt_size_t fuzz_size(void)
+{
+    int r = rand() % 100;
+
+    if (r < 50)
+        return 1 + rand() % 64;
+    if (r < 85)
+        return 1 + rand() % 1024;
+    if (r < 98)
+        return 1 + rand() % 8192;
+    return 1 + rand() % 150000;
+}
+
+static void fuzz_fill(int i)
+{
+    fuzz[i].pattern = rand();
+    memset(fuzz[i].ptr, fuzz[i].pattern, fuzz[i].size);
+}
+
+/* the first n bytes of block i still hold its pattern */
+static void fuzz_verify(int i, const rt_uint8_t *ptr, rt_size_t n, long step)
+{
+    rt_size_t k;
+
+    for (k = 0; k < n; k++)
+        RTHOST_CHECK(ptr[k] == fuzz[i].pattern, "step %ld: block %d corrupt at byte %d of %d", step, i, (int)k,
+                     (int)fuzz[i].size);
+}
+
+int main(int argc, char **argv)
+{
+    long step, steps = argc > 1 ? atol(argv[1]) : 1000000;
+    int offset = argc > 4 ? atoi(argv[4]) : 3;
+    rt_size_t size = argc > 3 ? strtoul(argv[3], RT_NULL, 0) : sizeof(pool) - 13;
+    unsigned long fails = 0;
+    struct rt_tlsf *t;
+    rt_uint8_t *ptr;
+    rt_size_t n;
+    int i, op;
+
+    srand(argc > 2 ? atoi(argv[2]) : 1);
+    RTHOST_CHECK(offset >= 0 && offset + size <= sizeof(pool), "the pool is %d bytes", (int)sizeof(pool));
+
+    t = (struct rt_tlsf *)rt_tlsf_init("fuzz", pool + offset, size);
+    RTHOST_CHECK(t != RT_NULL, "no heap");
+    tlsf_check(t, 0);
+
+    for (step = 1; step <= steps; step++)
+    {
+        i = rand() % FUZZ_PTRS;
+        op = rand() % 10;
+        if (fuzz[i].ptr && op < 6)
+        {
+            fuzz_verify(i, fuzz[i].ptr, fuzz[i].size, step);
+            rt_tlsf_free(&t->parent, fuzz[i].ptr);
+            fuzz[i].ptr = RT_NULL;
+        }
+        else if (fuzz[i].ptr)
+        {
+            /* moved or not, what fits of the old contents must come along */
+            n = fuzz_size();
+            ptr = rt_tlsf_realloc(&t->parent, fuzz[i].ptr, n);
+            if (ptr == RT_NULL)
+            {
+                /* a failed realloc leaves the block as it was */
+                fails++;
+                fuzz_verify(i, fuzz[i].ptr, fuzz[i].size, step);
+            }
+            else
+            {
+                fuzz_verify(i, ptr, n < fuzz[i].size ? n : fuzz[i].size, step);
+                fuzz[i].ptr = ptr;
+                fuzz[i].size = n;
+                fuzz_fill(i);
+            }
+        }
+        else
+        {
+            n = fuzz_size();
+            ptr = op == 9 ? rt_tlsf_realloc(&t->parent, RT_NULL, n) : rt_tlsf_alloc(&t->parent, n);
+            if (ptr == RT_NULL)
+            {
+                fails++;
+            }
+            else
+            {
+                RTHOST_CHECK((rt_ubase_t)ptr % TLSF_ALIGN_SIZE == 0, "step %ld: %p unaligned", step, ptr);
+                fuzz[i].ptr = ptr;
+                fuzz[i].size = n;
+                fuzz_fill(i);
+            }
+        }
+        tlsf_check(t, step);
+        RTHOST_CHECK(rthost_irq_off == 0, "interrupts left off at step %ld", step);
+    }
+
+    for (i = 0; i < FUZZ_PTRS; i++)
+    {
+        if (fuzz[i].ptr)
+        {
+            fuzz_verify(i, fuzz[i].ptr, fuzz[i].size, step);
+            rt_tlsf_free(&t->parent, fuzz[i].ptr);
+        }
+    }
+    tlsf_check(t, step);
+
+    printf("%ld steps, %lu failed for lack of space, peak %d of %d bytes\n", steps, fails, (int)t->parent.max,
+           (int)t->parent.total);
+    RTHOST_CHECK(t->parent.used == 0 && t->heap_ptr->size == ((t->parent.total - SIZEOF_STRUCT_BLOCK) | TLSF_BLOCK_FREE),
+                 "the heap is not one free block again");
+    RTHOST_CHECK(rt_tlsf_detach(&t->parent) == RT_EOK, "detach failed");
+
+    return 0;
+}
@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./uart_sim
+ *
+ * drivers/drv_uart.c's uart1 DMA TX path under the serial V1 core
+ * (components/drivers/serial/serial.c), on a mock of the registers it
+ * uses: a DMA channel paced by the UART's TX DREQ, a 32 byte TX FIFO and
+ * the wire behind it, one byte time per step. The channel reads its buffer
+ * only as the FIFO takes the bytes, as the real one does.
+ *
+ * Opening the device claims and sets up the channel; every write goes out
+ * on the wire, whole and in order, with the writes queued behind a busy
+ * channel started from its completion interrupt; each buffer is handed
+ * back through tx_complete only once sent. And the driver sends from the
+ * caller's buffer without a copy, so a buffer rewritten while queued or
+ * in flight goes out rewritten: what sim800_http.c must not do to a
+ * buffer it has written.
+ */
+#include <string.h>
+
+#include "rthost.h"
+
+/* the writes come from a thread, which the data queue checks for */
+static struct rt_thread sim_thread;
+#define rt_thread_self() (&sim_thread)
+
+#include "../../rt-thread/components/drivers/ipc/dataqueue.c"
+#include "../../rt-thread/components/drivers/serial/serial.c"
+#include "../../drivers/drv_uart.c"
+
+#define SIM_FIFO        32          /* PL011 TX FIFO depth */
+#define SIM_WIRE_MAX    4096
+#define SIM_OTHER_CHAN  (1u << 11)  /* another channel on the shared DMA_IRQ_0 */
+
+uart_hw_t rthost_uart_hw[2];
+dma_hw_t rthost_dma_hw;
+
+static struct
+{
+    irq_handler_t exclusive;
+    irq_handler_t shared;
+    rt_bool_t enabled;
+} sim_irq[32];
+
+static struct
+{
+    rt_bool_t claimed;
+    rt_bool_t irq0;
+    dma_channel_config config;
+    volatile void *write_addr;
+    const rt_uint8_t *read_addr;
+    rt_uint32_t count;
+} sim_dma[NUM_DMA_CHANNELS];
+
+static rt_uint8_t sim_fifo[SIM_FIFO];
+static rt_uint32_t sim_fifo_len;
+static char sim_wire[SIM_WIRE_MAX];
+static rt_uint32_t sim_wire_len;
+static rt_device_t sim_dev;
+static const void *sim_done[16];
+static rt_uint32_t sim_done_count;
+
+void irq_set_exclusive_handler(unsigned int num, irq_handler_t handler)
+{
+    sim_irq[num].exclusive = handler;
+}
+
+void irq_add_shared_handler(unsigned int num, irq_handler_t handler, unsigned char order_priority)
+{
+    RTHOST_CHECK(sim_irq[num].shared == RT_NULL, "a second shared handler on IRQ %u", num);
+    sim_irq[num].shared = handler;
+}
+
+void irq_set_enabled(unsigned int num, bool enabled)
+{
+    sim_irq[num].enabled = enabled;
+}
+
+unsigned int uart_init(uart_inst_t *uart, unsigned int baudrate)
+{
+    return baudrate;
+}
+
+unsigned int uart_set_baudrate(uart_inst_t *uart, unsigned int baudrate)
+{
+    return baudrate;
+}
+
+void uart_set_hw_flow(uart_inst_t *uart, bool cts, bool rts)
+{
+}
+
+void uart_set_format(uart_inst_t *uart, unsigned int data_bits, unsigned int stop_bits, uart_parity_t parity)
+{
+}
+
+void uart_set_fifo_enabled(uart_inst_t *uart, bool enabled)
+{
+}
+
+void uart_set_irq_enables(uart_inst_t *uart, bool rx_has_data, bool tx_needs_data)
+{
+}
+
+bool uart_is_readable(uart_inst_t *uart)
+{
+    return false;
+}
+
+int dma_claim_unused_channel(bool required)
+{
+    int ch;
+
+    for (ch = 0; ch < NUM_DMA_CHANNELS && sim_dma[ch].claimed; ch++);
+    RTHOST_CHECK(ch < NUM_DMA_CHANNELS || !required, "no DMA channel left");
+    if (ch == NUM_DMA_CHANNELS)
+        return -1;
+    sim_dma[ch].claimed = RT_TRUE;
+
+    return ch;
+}
+
+dma_channel_config dma_channel_get_default_config(unsigned int channel)
+{
+    dma_channel_config c = {DMA_SIZE_32, true, false, 0x3f};
+
+    return c;
+}
+
+void dma_channel_configure(unsigned int channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, unsigned int transfer_count, bool trigger)
+{
+    RTHOST_CHECK(sim_dma[channel].claimed, "channel %u configured unclaimed", channel);
+    sim_dma[channel].config = *config;
+    sim_dma[channel].write_addr = write_addr;
+    sim_dma[channel].read_addr = (const rt_uint8_t *)read_addr;
+    sim_dma[channel].count = trigger ? transfer_count : 0;
+}
+
+void dma_channel_set_irq0_enabled(unsigned int channel, bool enabled)
+{
+    sim_dma[channel].irq0 = enabled;
+}
+
+void dma_channel_transfer_from_buffer_now(unsigned int channel, const volatile void *read_addr,
+                                          uint32_t transfer_count)
+{
+    RTHOST_CHECK(sim_dma[channel].count == 0, "channel %u restarted while busy", channel);
+    sim_dma[channel].read_addr = (const rt_uint8_t *)read_addr;
+    sim_dma[channel].count = transfer_count;
+}
+
+static void sim_dma_irq(rt_uint32_t pending);
+
+/* one byte time: the UART sends a byte, the channel tops the FIFO up */
+static void sim_step(void)
+{
+    int ch = uart1_dev.tx_dma_chan;
+
+    if (sim_fifo_len > 0)
+    {
+        RTHOST_CHECK(sim_wire_len < SIM_WIRE_MAX, "the wire is full");
+        sim_wire[sim_wire_len++] = sim_fifo[0];
+        memmove(sim_fifo, sim_fifo + 1, --sim_fifo_len);
+    }
+    if (ch < 0 || sim_dma[ch].count == 0)
+        return;
+
+    while (sim_dma[ch].count > 0 && sim_fifo_len < SIM_FIFO)
+    {
+        sim_fifo[sim_fifo_len++] = *sim_dma[ch].read_addr;
+        sim_dma[ch].read_addr += sim_dma[ch].config.read_increment;
+        sim_dma[ch].count--;
+    }
+    if (sim_dma[ch].count == 0)
+        sim_dma_irq((1u << ch) | SIM_OTHER_CHAN);
+}
+
+/*
+ * DMA_IRQ_0 with the given channels pending. INTS0 is write-one-to-clear,
+ * which plain memory is not: the handler must have stored exactly its own
+ * channel's bit, and the store is then applied.
+ */
+static void sim_dma_irq(rt_uint32_t pending)
+{
+    rt_uint32_t own = 1u << uart1_dev.tx_dma_chan;
+
+    if (!sim_irq[DMA_IRQ_0].enabled || sim_irq[DMA_IRQ_0].shared == RT_NULL)
+        return;
+    rthost_dma_hw.ints0 = pending;
+    sim_irq[DMA_IRQ_0].shared();
+    RTHOST_CHECK(rthost_dma_hw.ints0 == (pending & own ? own : pending),
+                 "INTS0 %#x after the handler, with %#x pending", rthost_dma_hw.ints0, pending);
+    rthost_dma_hw.ints0 = 0;
+}
+
+/* run the wire until the channel and the FIFO are idle */
+static void sim_drain(void)
+{
+    int steps = 0;
+
+    while (sim_fifo_len > 0 || sim_dma[uart1_dev.tx_dma_chan].count > 0)
+    {
+        sim_step();
+        RTHOST_CHECK(++steps < SIM_WIRE_MAX, "the channel never finished");
+    }
+}
+
+void uart_putc_raw(uart_inst_t *uart, char c)
+{
+    while (sim_fifo_len == SIM_FIFO)
+        sim_step();
+    sim_fifo[sim_fifo_len++] = c;
+}
+
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags)
+{
+    if (!strcmp(name, "uart1"))
+        sim_dev = dev;
+    dev->flag = flags;
+
+    return RT_EOK;
+}
+
+rt_ssize_t rt_device_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    return dev->write(dev, pos, buffer, size);
+}
+
+static rt_uint8_t sim_nest;
+
+void rt_interrupt_enter(void)
+{
+    sim_nest++;
+}
+
+void rt_interrupt_leave(void)
+{
+    sim_nest--;
+}
+
+rt_uint8_t rt_interrupt_get_nest(void)
+{
+    return sim_nest;
+}
+
+void rt_set_errno(rt_err_t no)
+{
+}
+
+void rt_enter_critical(void)
+{
+}
+
+void rt_exit_critical(void)
+{
+}
+
+rt_uint16_t rt_critical_level(void)
+{
+    return 0;
+}
+
+/* a full TX queue suspends the writer, which a single-threaded test must never hit */
+rt_err_t rt_thread_suspend_with_flag(rt_thread_t thread, int suspend_flag)
+{
+    RTHOST_CHECK(0, "the writer would block on a full TX queue");
+    return -RT_ERROR;
+}
+
+rt_err_t rt_thread_resume(rt_thread_t thread)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_timer_control(rt_timer_t timer, int cmd, void *arg)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_timer_start(rt_timer_t timer)
+{
+    return RT_EOK;
+}
+
+/* for interrupt TX, which uart1 does not use */
+void rt_completion_init(struct rt_completion *completion)
+{
+}
+
+rt_err_t rt_completion_wait(struct rt_completion *completion, rt_int32_t timeout)
+{
+    return RT_EOK;
+}
+
+void rt_completion_done(struct rt_completion *completion)
+{
+}
+
+static rt_err_t sim_tx_complete(rt_device_t dev, void *buffer)
+{
+    RTHOST_CHECK(sim_done_count < sizeof(sim_done) / sizeof(sim_done[0]), "too many writes completed");
+    sim_done[sim_done_count++] = buffer;
+
+    return RT_EOK;
+}
+
+static void sim_expect(const char *what, const char *wire)
+{
+    RTHOST_CHECK(sim_wire_len == strlen(wire) && !memcmp(sim_wire, wire, sim_wire_len),
+                 "%s: the wire has \"%.*s\", \"%s\" wanted", what, (int)sim_wire_len, sim_wire, wire);
+    sim_wire_len = 0;
+    sim_done_count = 0;
+}
+
+int main(void)
+{
+    static char lines[8][16], body[100], esc[1];
+    int ch, i;
+
+    RTHOST_CHECK(rt_hw_uart1_init() == RT_EOK && sim_dev != RT_NULL, "uart1 not registered");
+    RTHOST_CHECK(sim_dev->flag & RT_DEVICE_FLAG_DMA_TX, "uart1 does not offer DMA TX");
+    RTHOST_CHECK(sim_dev->init(sim_dev) == RT_EOK, "uart1 did not initialise");
+    RTHOST_CHECK(sim_dev->open(sim_dev, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX | RT_DEVICE_FLAG_DMA_TX) == RT_EOK,
+                 "uart1 did not open");
+    sim_dev->tx_complete = sim_tx_complete;
+
+    /* the channel: bytes from memory to the data register, paced by uart1 */
+    ch = uart1_dev.tx_dma_chan;
+    RTHOST_CHECK(ch >= 0 && sim_dma[ch].claimed, "no TX channel claimed");
+    RTHOST_CHECK(sim_dma[ch].write_addr == &rthost_uart_hw[1].dr && sim_dma[ch].config.dreq == DREQ_UART1_TX
+                 && sim_dma[ch].config.size == DMA_SIZE_8 && sim_dma[ch].config.read_increment
+                 && !sim_dma[ch].config.write_increment,
+                 "the TX channel does not feed uart1's data register a byte at a time");
+    RTHOST_CHECK(sim_dma[ch].irq0 && sim_irq[DMA_IRQ_0].enabled && sim_irq[DMA_IRQ_0].shared != RT_NULL,
+                 "the channel does not interrupt on DMA_IRQ_0");
+    RTHOST_CHECK(sim_irq[UART1_IRQ].enabled && sim_irq[UART1_IRQ].exclusive == pico_uart1_isr,
+                 "the RX interrupt is not set up");
+    RTHOST_CHECK((rthost_uart_hw[1].imsc & (UART_UARTIMSC_RXIM_BITS | UART_UARTIMSC_RTIM_BITS))
+                 == (UART_UARTIMSC_RXIM_BITS | UART_UARTIMSC_RTIM_BITS),
+                 "RX does not interrupt on the FIFO level and timeout");
+
+    /* another channel's interrupt is left alone */
+    sim_dma_irq(SIM_OTHER_CHAN);
+    RTHOST_CHECK(sim_done_count == 0, "another channel's interrupt completed a write");
+
+    /* one write: sent from the caller's buffer, handed back when done */
+    strcpy(lines[0], "AT\r\n");
+    RTHOST_CHECK(rt_device_write(sim_dev, 0, lines[0], 4) == 4, "the write was refused");
+    RTHOST_CHECK(sim_dma[ch].read_addr == (const rt_uint8_t *)lines[0] && sim_dma[ch].count == 4,
+                 "the channel was not started on the buffer");
+    RTHOST_CHECK(sim_done_count == 0, "a write completed before it was sent");
+    sim_drain();
+    RTHOST_CHECK(sim_done_count == 1 && sim_done[0] == lines[0], "the write was not handed back");
+    sim_expect("one write", "AT\r\n");
+
+    /* writes queued behind a busy channel follow from its interrupt */
+    for (i = 0; i < 8; i++)
+    {
+        rt_snprintf(lines[i], sizeof(lines[i]), "AT+L%d\r\n", i);
+        RTHOST_CHECK(rt_device_write(sim_dev, 0, lines[i], strlen(lines[i])) == (rt_ssize_t)strlen(lines[i]),
+                     "write %d was refused", i);
+    }
+    sim_drain();
+    RTHOST_CHECK(sim_done_count == 8, "%u of 8 writes handed back", sim_done_count);
+    for (i = 0; i < 8; i++)
+        RTHOST_CHECK(sim_done[i] == lines[i], "write %d handed back out of order", i);
+    sim_expect("eight writes", "AT+L0\r\nAT+L1\r\nAT+L2\r\nAT+L3\r\nAT+L4\r\nAT+L5\r\nAT+L6\r\nAT+L7\r\n");
+
+    /* polled bytes go out behind what the channel has put in the FIFO */
+    strcpy(lines[0], "ATE0\r\n");
+    rt_device_write(sim_dev, 0, lines[0], 6);
+    sim_step();
+    pico_uart1_putc(&uart1_dev.parent, 'Z');
+    sim_drain();
+    sim_expect("putc", "ATE0\r\nZ");
+
+    /* no copy: a buffer rewritten while in flight goes out rewritten */
+    memset(body, 'a', sizeof(body));
+    rt_device_write(sim_dev, 0, body, sizeof(body));
+    for (i = 0; i < 10; i++)
+        sim_step();
+    body[sizeof(body) - 1] = 'b';
+    sim_drain();
+    RTHOST_CHECK(sim_wire_len == sizeof(body) && sim_wire[sizeof(body) - 1] == 'b',
+                 "the body was copied before it was sent");
+    sim_wire_len = sim_done_count = 0;
+
+    /*
+     * Nor while queued: an SMS text and then, the prompt being late, the
+     * ESC that cancels it. Written over the text's first byte, the ESC
+     * goes out twice and the text is lost; from a byte of its own, both go.
+     */
+    strcpy(lines[0], "hello\x1a");
+    rt_device_write(sim_dev, 0, lines[0], 6);
+    strcpy(lines[1], "door open\x1a");
+    rt_device_write(sim_dev, 0, lines[1], 10);
+    lines[1][0] = 0x1b;
+    rt_device_write(sim_dev, 0, lines[1], 1);
+    sim_drain();
+    sim_expect("ESC over the text", "hello\x1a\x1boor open\x1a\x1b");
+
+    rt_device_write(sim_dev, 0, lines[0], 6);
+    strcpy(lines[1], "door open\x1a");
+    rt_device_write(sim_dev, 0, lines[1], 10);
+    esc[0] = 0x1b;
+    rt_device_write(sim_dev, 0, esc, 1);
+    sim_drain();
+    sim_expect("ESC of its own", "hello\x1a" "door open\x1a\x1b");
+
+    RTHOST_CHECK(rthost_irq_off == 0, "interrupts left off");
+    printf("uart1: DMA TX on channel %d, from the caller's buffers, handed back once sent\n", ch);
+
+    return 0;
+}
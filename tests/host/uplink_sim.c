@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     khair        the first version
+ */
+/*
+ * ./uplink_sim
+ *
+ * applications/uplink.c against a fake server, on the sample log's RAM
+ * flash and a RAM "upq" partition. A sample is logged every 2 s of
+ * simulated time, and uplink_step() is called as uplink_run() would. The
+ * server goes through an outage, a wrong key, a size limit and a sample
+ * it refuses; every sample but that one must reach it, once and in order,
+ * 20 s apart.
+ */
+#include <string.h>
+
+#include "rthost.h"
+
+#define SAMPLE_LOG_USING_SELFTEST
+#include "../../applications/sample_log.c"
+#undef DBG_TAG
+#undef DBG_LVL
+#include "../../applications/uplink.c"
+
+#define SIM_STEP            2           /* seconds between samples */
+#define SIM_NONE            0xffffffffu
+
+static rt_uint8_t upq[2 * UPLINK_SECTOR_SIZE];
+
+static const struct fal_partition log_part =
+{
+    .name = "logsim",
+    .flash_name = "logsim",
+    .len = 16 * 1024,
+};
+
+static const struct fal_partition upq_part =
+{
+    .name = "upq",
+    .flash_name = "upq",
+    .len = sizeof(upq),
+};
+
+const struct fal_partition *fal_partition_find(const char *name)
+{
+    if (!strcmp(name, log_part.name))
+        return &log_part;
+    if (!strcmp(name, upq_part.name))
+        return &upq_part;
+    return RT_NULL;
+}
+
+int fal_partition_read(const struct fal_partition *part, uint32_t addr, uint8_t *buf, size_t size)
+{
+    if (part == &upq_part)
+    {
+        memcpy(buf, upq + addr, size);
+        return size;
+    }
+    return sample_log_sim_flash.ops.read(addr, buf, size);
+}
+
+int fal_partition_write(const struct fal_partition *part, uint32_t addr, const uint8_t *buf, size_t size)
+{
+    size_t i;
+
+    if (part == &upq_part)
+    {
+        for (i = 0; i < size; i++)
+            upq[addr + i] &= buf[i];
+        return size;
+    }
+    return sample_log_sim_flash.ops.write(addr, buf, size);
+}
+
+int fal_partition_erase(const struct fal_partition *part, uint32_t addr, size_t size)
+{
+    if (part == &upq_part)
+    {
+        memset(upq + (addr & ~(UPLINK_SECTOR_SIZE - 1)), 0xff, UPLINK_SECTOR_SIZE);
+        return size;
+    }
+    return sample_log_sim_flash.ops.erase(addr, size);
+}
+
+/* the server, and the link to it */
+static struct
+{
+    int status;                     /* for every post, 0 for no answer */
+    rt_uint32_t max;                /* larger posts get 413 */
+    rt_uint32_t poison;             /* the time of a sample it answers 400 to */
+
+    rt_uint32_t posts, samples, last_time;
+    rt_uint32_t bad;                /* samples out of order, sent twice or spaced wrong */
+} server;
+
+static struct sim800_http_stat http_stat;
+
+const struct sim800_http_stat *sim800_http_get_stat(void)
+{
+    return &http_stat;
+}
+
+rt_uint32_t sample_batch_limit(void)
+{
+    return SAMPLE_BATCH_SIZE;
+}
+
+int sample_batch_post(const struct sample *s, rt_uint32_t n, rt_uint16_t boot, rt_uint32_t prev)
+{
+    rt_uint32_t i, gap;
+
+    server.posts++;
+    http_stat.last_status = server.status;
+    if (server.status == 0)
+    {
+        http_stat.last_status = -1;
+        return -RT_ETIMEOUT;
+    }
+    if (server.status == 200 && n > server.max)
+        http_stat.last_status = 413;
+    for (i = 0; i < n && http_stat.last_status == 200; i++)
+    {
+        if (s[i].time == server.poison)
+            http_stat.last_status = 400;
+    }
+    if (http_stat.last_status != 200)
+        return -RT_ERROR;
+
+    for (i = 0; i < n; i++)
+    {
+        /* 20 s apart, or 40 across the refused sample */
+        gap = s[i].time - server.last_time;
+        if (server.samples > 0 && gap != UPLINK_SAMPLE_INTERVAL
+            && !(gap == 2 * UPLINK_SAMPLE_INTERVAL && server.last_time + UPLINK_SAMPLE_INTERVAL == server.poison))
+            server.bad++;
+        server.last_time = s[i].time;
+        server.samples++;
+    }
+
+    return RT_EOK;
+}
+
+static rt_uint32_t sim_now(void)
+{
+    return rthost_tick / RT_TICK_PER_SECOND;
+}
+
+static rt_uint32_t sim_next_sample;
+
+/* logs the samples due up to now */
+static void sim_log(void)
+{
+    struct sample s;
+
+    while (sim_next_sample <= sim_now())
+    {
+        s.time = sim_next_sample;
+        s.temperature = 400 + s.time / 60 % 7;
+        s.humidity = 6000 - s.time / 90 % 11;
+        sample_log_append(&sample_log, &s);
+        sample_log_write(&sample_log, RT_FALSE);
+        sim_next_sample += SIM_STEP;
+    }
+}
+
+/* runs the uplink for `seconds` of simulated time */
+static void sim_run(rt_uint32_t seconds)
+{
+    rt_uint32_t end = sim_now() + seconds, wait;
+
+    while (sim_now() < end)
+    {
+        sim_log();
+        wait = uplink_step(&uplink);
+        rthost_tick += wait * RT_TICK_PER_SECOND;
+    }
+    sim_log();
+}
+
+/* the server has had every sample up to the last batch that could be due */
+static void sim_check_caught_up(const char *what)
+{
+    rt_uint32_t behind = sim_now() - server.last_time;
+
+    printf("%-14s %5d posts, %5d samples, last %6d s (%4d s behind), denied %d, rejected %d, batch %d\n",
+           what, server.posts, server.samples, server.last_time, behind, uplink.stat.denied, uplink.stat.rejected,
+           uplink.limit);
+    RTHOST_CHECK(server.bad == 0, "%s: %d samples out of order", what, server.bad);
+    RTHOST_CHECK(behind <= SAMPLE_BATCH_MAX_AGE + SAMPLE_BATCH_SIZE * UPLINK_SAMPLE_INTERVAL,
+                 "%s: the server is %d s behind", what, behind);
+}
+
+int main(void)
+{
+    rt_uint32_t samples, denied;
+
+    server.status = 200;
+    server.max = SAMPLE_BATCH_SIZE;
+    server.poison = SIM_NONE;
+
+    memset(sample_log_sim, 0xff, sizeof(sample_log_sim));
+    memset(upq, 0xff, sizeof(upq));
+    sample_log_setup(&sample_log, "slog");
+    RTHOST_CHECK(sample_log_open(&sample_log, "logsim") == RT_EOK, "no log");
+    RTHOST_CHECK(uplink_init() == RT_EOK, "no upq");
+
+    sim_run(3600);
+    sim_check_caught_up("online");
+
+    /* no answer for an hour: everything is kept and goes out after */
+    server.status = 0;
+    samples = server.samples;
+    sim_run(3600);
+    RTHOST_CHECK(server.samples == samples, "samples accepted during an outage");
+    server.status = 200;
+    sim_run(3600);
+    sim_check_caught_up("outage");
+
+    /* a wrong key: denied, and nothing skipped */
+    denied = uplink.stat.denied;
+    server.status = 401;
+    sim_run(3600);
+    server.status = 200;
+    RTHOST_CHECK(uplink.stat.denied > denied, "401 not counted as denied");
+    sim_run(3600);
+    sim_check_caught_up("denied");
+    RTHOST_CHECK(uplink.stat.rejected == 0, "samples skipped on 401");
+
+    /* at most 7 samples a post for a while: batches split, nothing skipped */
+    server.max = 7;
+    sim_run(3600);
+    sim_check_caught_up("413");
+    RTHOST_CHECK(uplink.stat.rejected == 0 && uplink.limit <= 7, "413 was not split");
+    server.max = SAMPLE_BATCH_SIZE;
+    sim_run(3600);
+    RTHOST_CHECK(uplink.limit == SAMPLE_BATCH_SIZE, "the batch size did not grow back");
+
+    /* one sample the server will never take: only that one is skipped */
+    server.poison = (sim_now() / UPLINK_SAMPLE_INTERVAL + 50) * UPLINK_SAMPLE_INTERVAL;
+    sim_run(7200);
+    sim_check_caught_up("400");
+    RTHOST_CHECK(uplink.stat.rejected == 1, "%d samples skipped for one refused", uplink.stat.rejected);
+    RTHOST_CHECK(server.last_time > server.poison, "stuck at the refused sample");
+
+    RTHOST_CHECK(uplink.stat.lost == 0 && uplink.stat.thinned == 0 && uplink.stat.errors == 0,
+                 "lost %d pages, thinned %d samples, %d flash errors", uplink.stat.lost, uplink.stat.thinned,
+                 uplink.stat.errors);
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2006-2021, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-17     khair        decoder for "trace dump"
+#
+# Turns the "TRACE " lines printed by the msh command "trace dump" into
+# a Chrome trace, for chrome://tracing or https://ui.perfetto.dev:
+#
+#   python tools/trace2json.py console.log > trace.json
+#
+# Each core is a process. On core0 every thread gets a track with the
+# slices it ran, interrupts and timer callbacks get a track each, and the
+# IPC events are instants on the track of whoever did them. Markers go on
+# a track of their core. The log may hold other output and several dumps,
+# the last one is used.
+
+import sys
+import json
+import argparse
+
+parser = argparse.ArgumentParser(description='decode a "trace dump" into Chrome trace JSON')
+parser.add_argument('log', type=argparse.FileType('r'), nargs='?', default=sys.stdin,
+                    help='console log holding the dump, stdin by default')
+parser.add_argument('-o', '--output', type=argparse.FileType('w'), default=sys.stdout,
+                    help='JSON file to write, stdout by default')
+
+VERSION = 1
+
+# record types, as in applications/trace.c
+SWITCH, IRQ_ENTER, IRQ_EXIT, IPC_TRYTAKE, IPC_TAKE, IPC_PUT, \
+    TIMER_ENTER, TIMER_EXIT, MARK, BEGIN, END = range(1, 12)
+
+# markers, as in applications/trace.h
+MARKERS = {1: 'sample', 2: 'display flush', 3: 'at send', 4: 'at ack'}
+
+# object classes, as in rtdef.h
+CLASSES = {1: 'thread', 2: 'sem', 3: 'mutex', 4: 'event', 5: 'mailbox', 6: 'mq', 10: 'timer'}
+
+EXCEPTIONS = {2: 'NMI', 3: 'HardFault', 11: 'SVCall', 14: 'PendSV', 15: 'SysTick'}
+
+# tracks that are not threads; thread tracks are their control block address
+TID_IRQ, TID_TIMER, TID_MARKER = 1, 2, 3
+
+
+def irq_name(number):
+    if number in EXCEPTIONS:
+        return EXCEPTIONS[number]
+    if number >= 16:
+        return 'IRQ %d' % (number - 16)
+    return 'exception %d' % number
+
+
+def parse(lines):
+    '''the objects, the time of the dump and the events of each core of the last dump'''
+    objects, events, now = {}, {}, None
+
+    for line in lines:
+        at = line.find('TRACE ')
+        if at < 0:
+            continue
+        field = line[at:].split()
+        try:
+            if field[1] == 'H' and len(field) >= 5:
+                if int(field[2], 16) != VERSION:
+                    sys.stderr.write('unknown trace version %s\n' % field[2])
+                    continue
+                objects, events, now = {}, {}, int(field[4], 16)
+            elif field[1] == 'O' and len(field) >= 4 and now is not None:
+                name = field[4] if len(field) > 4 else ''
+                objects[int(field[2], 16)] = (field[3], name)
+            elif field[1] == 'E' and len(field) >= 6 and now is not None:
+                core = int(field[2], 16)
+                events.setdefault(core, []).append(
+                    (int(field[3], 16), int(field[4], 16), int(field[5], 16)))
+        except ValueError:
+            # a line garbled by other output
+            continue
+
+    return objects, events, now
+
+
+def unwrap(events, now):
+    '''absolute times: the records are oldest first and all before the dump,
+    so walking back from it undoes the 32-bit wrap'''
+    out = []
+    t = now
+    last = now & 0xffffffff
+    for time, what, obj in reversed(events):
+        t -= (last - time) & 0xffffffff
+        last = time
+        out.append((t, what >> 24, what & 0xffffff, obj))
+    out.reverse()
+    return out
+
+
+class Core(object):
+    def __init__(self, pid, objects, out):
+        self.pid = pid
+        self.objects = objects
+        self.out = out
+        self.thread = None              # running thread and since when
+        self.since = 0
+        self.irqs = []                  # open interrupts, innermost last
+        self.timers = []
+        self.marks = []
+        self.tids = set()
+
+    def name(self, obj):
+        if obj in self.objects:
+            return self.objects[obj][1]
+        return '0x%08x' % obj
+
+    def slice(self, tid, name, start, end, args=None):
+        self.tids.add(tid)
+        event = {'ph': 'X', 'pid': self.pid, 'tid': tid, 'name': name, 'ts': start, 'dur': end - start}
+        if args:
+            event['args'] = args
+        self.out.append(event)
+
+    def instant(self, tid, name, ts, args=None):
+        self.tids.add(tid)
+        event = {'ph': 'i', 's': 't', 'pid': self.pid, 'tid': tid, 'name': name, 'ts': ts}
+        if args:
+            event['args'] = args
+        self.out.append(event)
+
+    def context(self):
+        '''the track of whatever runs now'''
+        if self.irqs:
+            return TID_IRQ
+        if self.thread is not None:
+            return self.thread
+        return TID_MARKER
+
+    def event(self, ts, kind, arg, obj):
+        if kind == SWITCH:
+            if self.thread is not None:
+                self.slice(self.thread, self.name(self.thread), self.since, ts)
+            self.thread, self.since = obj, ts
+        elif kind == IRQ_ENTER:
+            self.irqs.append((arg, ts))
+        elif kind == IRQ_EXIT:
+            # an exit whose entry fell off the ring has nothing to close
+            if self.irqs:
+                number, start = self.irqs.pop()
+                self.slice(TID_IRQ, irq_name(number), start, ts)
+        elif kind in (IPC_TRYTAKE, IPC_TAKE, IPC_PUT):
+            action = {IPC_TRYTAKE: 'trytake', IPC_TAKE: 'take', IPC_PUT: 'put'}[kind]
+            self.instant(self.context(), '%s %s' % (action, self.name(obj)),
+                         ts, {'class': CLASSES.get(arg, arg), 'object': '0x%08x' % obj})
+        elif kind == TIMER_ENTER:
+            self.timers.append((obj, ts))
+        elif kind == TIMER_EXIT:
+            if self.timers:
+                timer, start = self.timers.pop()
+                self.slice(TID_TIMER, self.name(timer), start, ts)
+        elif kind == MARK:
+            self.instant(TID_MARKER, MARKERS.get(arg, 'marker %d' % arg), ts, {'value': obj})
+        elif kind == BEGIN:
+            self.marks.append((arg, obj, ts))
+        elif kind == END:
+            if self.marks:
+                marker, value, start = self.marks.pop()
+                self.slice(TID_MARKER, MARKERS.get(marker, 'marker %d' % marker), start, ts,
+                           {'value': value, MARKERS.get(arg, 'end'): obj})
+
+    def close(self, ts):
+        '''whatever is still open at the dump ends there'''
+        if self.thread is not None:
+            self.slice(self.thread, self.name(self.thread), self.since, ts)
+        for number, start in self.irqs:
+            self.slice(TID_IRQ, irq_name(number), start, ts)
+        for timer, start in self.timers:
+            self.slice(TID_TIMER, self.name(timer), start, ts)
+        for marker, value, start in self.marks:
+            self.slice(TID_MARKER, MARKERS.get(marker, 'marker %d' % marker), start, ts, {'value': value})
+
+    def metadata(self):
+        self.out.append({'ph': 'M', 'pid': self.pid, 'name': 'process_name',
+                         'args': {'name': 'core%d' % self.pid}})
+        for tid in self.tids:
+            if tid == TID_IRQ:
+                name = 'interrupts'
+            elif tid == TID_TIMER:
+                name = 'timers'
+            elif tid == TID_MARKER:
+                name = 'markers'
+            else:
+                name = self.name(tid)
+            self.out.append({'ph': 'M', 'pid': self.pid, 'tid': tid, 'name': 'thread_name',
+                             'args': {'name': name}})
+            # threads first, the other tracks below them
+            self.out.append({'ph': 'M', 'pid': self.pid, 'tid': tid, 'name': 'thread_sort_index',
+                             'args': {'sort_index': tid if tid <= TID_MARKER else 0}})
+
+
+def main():
+    args = parser.parse_args()
+    objects, events, now = parse(args.log)
+    if now is None:
+        sys.stderr.write('no "TRACE H" line, nothing to decode\n')
+        return 1
+
+    cores = dict((core, unwrap(records, now)) for core, records in events.items())
+    start = min([e[0][0] for e in cores.values() if e] or [now])
+
+    out = []
+    for pid in sorted(cores):
+        core = Core(pid, objects, out)
+        for ts, kind, arg, obj in cores[pid]:
+            core.event(ts - start, kind, arg, obj)
+        core.close(now - start)
+        core.metadata()
+
+    json.dump({'traceEvents': out, 'displayTimeUnit': 'ns'}, args.output, indent=1)
+    args.output.write('\n')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())